@@ -0,0 +1,263 @@
+// [C++ STL]
+#include <memory>
+#include <string>
+#include <utility>
+
+// [Styio]
+#include "StyioException/Exception.hpp"
+#include "StyioAST/AST.hpp"
+#include "StyioAST/ASTArena.hpp"
+#include "StyioAnalyzer/ASTAnalyzer.hpp"
+#include "StyioCodeGen/CodeGenVisitor.hpp"
+#include "StyioIR/FlatIR/FlatIR.hpp"
+#include "StyioIR/StyioIR.hpp"
+#include "StyioJIT/StyioJIT_ORC.hpp"
+#include "StyioParser/Parser.hpp"
+#include "StyioParser/Tokenizer.hpp"
+#include "StyioSource/SourceFile.hpp"
+
+// [LLVM]
+#include "llvm/Support/TargetSelect.h"
+
+// [Google Benchmark]
+#include <benchmark/benchmark.h>
+
+// [Bench]
+#include "ProgramGen.hpp"
+
+/*
+  Compiler throughput, one stage at a time.
+
+  Every benchmark times a single stage of the pipeline on a generated
+  program; whatever the stage needs (the tokens, the AST, ...) is made
+  with the timer paused, and so is the cleanup.
+
+    ./styio_bench --benchmark_filter='parse/mixed'
+*/
+
+enum class StyioBenchStage
+{
+  Tokenize,
+  Parse,
+  TypeInfer,
+  ToStyioIR,
+  ToLLVMIR,
+  JIT,
+
+  /* the flat StyioIR, against ToLLVMIR */
+  ToFlatIR,
+  ToLLVMIRFlat,
+};
+
+/* The program of the last (shape, size), as large ones take a while to make */
+static const std::string&
+get_program(StyioProgramShape shape, size_t size) {
+  static StyioProgramShape last_shape;
+  static size_t last_size = 0;
+  static std::string program;
+
+  if (program.empty() || last_shape != shape || last_size != size) {
+    program = generate_program(shape, size);
+    last_shape = shape;
+    last_size = size;
+  }
+
+  return program;
+}
+
+/* Everything the stages after parsing work on */
+struct StyioBenchProgram
+{
+  std::unique_ptr<StyioSourceFile> source;
+  ASTArena arena;
+  MainBlockAST* ast = nullptr;
+
+  StyioAnalyzer analyzer;
+  StyioIR* ir = nullptr;
+  StyioFlatIR flat_ir;
+
+  std::unique_ptr<StyioToLLVM> generator;
+};
+
+static void
+parse_program(StyioBenchProgram& program) {
+  ASTArena::Scope scope(program.arena);
+
+  StyioContext context(program.source.get(), StyioTokenizer::tokenize(program.source->text()));
+  program.ast = parse_main_block(context);
+}
+
+static void
+make_generator(StyioBenchProgram& program) {
+  llvm::ExitOnError exit_on_error;
+  program.generator = std::make_unique<StyioToLLVM>(exit_on_error(StyioJIT_ORC::Create()));
+}
+
+/* Run the stages before `stage`, with the timer paused */
+static void
+prepare(StyioBenchProgram& program, StyioBenchStage stage) {
+  if (stage > StyioBenchStage::Parse) {
+    parse_program(program);
+  }
+
+  ASTArena::Scope scope(program.arena);
+
+  if (stage > StyioBenchStage::TypeInfer) {
+    program.analyzer.typeInfer(program.ast);
+  }
+
+  if (stage > StyioBenchStage::ToStyioIR) {
+    program.ir = program.analyzer.toStyioIR(program.ast);
+  }
+
+  if (stage >= StyioBenchStage::ToLLVMIR) {
+    make_generator(program);
+  }
+
+  if (stage == StyioBenchStage::JIT) {
+    program.ir->toLLVMIR(program.generator.get());
+  }
+
+  if (stage == StyioBenchStage::ToLLVMIRFlat) {
+    program.flat_ir = StyioFlatIR::from(program.ir);
+  }
+}
+
+static void
+run(StyioBenchProgram& program, StyioBenchStage stage) {
+  ASTArena::Scope scope(program.arena);
+
+  switch (stage) {
+    case StyioBenchStage::Tokenize: {
+      auto stream = StyioTokenizer::tokenize(program.source->text());
+      benchmark::DoNotOptimize(stream.tokens.data());
+    } break;
+
+    case StyioBenchStage::Parse: {
+      parse_program(program);
+      benchmark::DoNotOptimize(program.ast);
+    } break;
+
+    case StyioBenchStage::TypeInfer: {
+      program.analyzer.typeInfer(program.ast);
+    } break;
+
+    case StyioBenchStage::ToStyioIR: {
+      program.ir = program.analyzer.toStyioIR(program.ast);
+      benchmark::DoNotOptimize(program.ir);
+    } break;
+
+    case StyioBenchStage::ToLLVMIR: {
+      program.ir->toLLVMIR(program.generator.get());
+    } break;
+
+    case StyioBenchStage::JIT: {
+      void* main_addr = program.generator->jit_main();
+      benchmark::DoNotOptimize(main_addr);
+    } break;
+
+    case StyioBenchStage::ToFlatIR: {
+      program.flat_ir = StyioFlatIR::from(program.ir);
+      benchmark::DoNotOptimize(program.flat_ir.nodes.data());
+    } break;
+
+    case StyioBenchStage::ToLLVMIRFlat: {
+      program.generator->toLLVMIR(program.flat_ir);
+    } break;
+  }
+}
+
+static void
+BM_Stage(benchmark::State& state, StyioBenchStage stage, StyioProgramShape shape) {
+  const std::string& code = get_program(shape, state.range(0));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto program = std::make_unique<StyioBenchProgram>();
+    program->source.reset(StyioSourceFile::Create(get_shape_name(shape), code));
+    prepare(*program, stage);
+    state.ResumeTiming();
+
+    run(*program, stage);
+
+    state.PauseTiming();
+    program.reset();
+    state.ResumeTiming();
+  }
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * code.size());
+}
+
+static const char*
+get_stage_name(StyioBenchStage stage) {
+  switch (stage) {
+    case StyioBenchStage::Tokenize:
+      return "tokenize";
+    case StyioBenchStage::Parse:
+      return "parse";
+    case StyioBenchStage::TypeInfer:
+      return "typeInfer";
+    case StyioBenchStage::ToStyioIR:
+      return "toStyioIR";
+    case StyioBenchStage::ToLLVMIR:
+      return "toLLVMIR";
+    case StyioBenchStage::JIT:
+      return "jit";
+    case StyioBenchStage::ToFlatIR:
+      return "toFlatIR";
+    case StyioBenchStage::ToLLVMIRFlat:
+      return "toLLVMIR-flat";
+  }
+
+  return "unknown";
+}
+
+static int
+register_stage_benchmarks() {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  llvm::InitializeNativeTargetAsmParser();
+
+  const StyioBenchStage stages[] = {
+    StyioBenchStage::Tokenize,
+    StyioBenchStage::Parse,
+    StyioBenchStage::TypeInfer,
+    StyioBenchStage::ToStyioIR,
+    StyioBenchStage::ToLLVMIR,
+    StyioBenchStage::JIT,
+    StyioBenchStage::ToFlatIR,
+    StyioBenchStage::ToLLVMIRFlat,
+  };
+
+  const StyioProgramShape shapes[] = {
+    StyioProgramShape::DeepExprs,
+    StyioProgramShape::Bindings,
+    StyioProgramShape::Functions,
+    StyioProgramShape::Pipelines,
+    StyioProgramShape::Comments,
+    StyioProgramShape::Mixed,
+  };
+
+  for (auto stage : stages) {
+    /*
+      1 KB to 100 MB. The StyioIR and LLVM stages stop at 10 MB: StyioIR
+      nodes are never freed, and LLVM needs gigabytes for 100 MB of code.
+    */
+    size_t max_size = (stage >= StyioBenchStage::ToStyioIR) ? (10 << 20) : (100 << 20);
+
+    for (auto shape : shapes) {
+      std::string name = std::string(get_stage_name(stage)) + "/" + get_shape_name(shape);
+
+      auto bench = benchmark::RegisterBenchmark(name.c_str(), BM_Stage, stage, shape);
+      for (size_t size = 1 << 10; size <= max_size; size *= 10) {
+        bench->Arg(int64_t(size));
+      }
+
+      bench->Unit(benchmark::kMillisecond)->UseRealTime();
+    }
+  }
+
+  return 0;
+}
+
+static int stage_benchmarks = register_stage_benchmarks();
@@ -0,0 +1,134 @@
+// [C++ STL]
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// [Styio]
+#include "ProgramGen.hpp"
+
+/* A fixed-seed LCG: the same program on every machine and every run */
+class StyioProgramRng
+{
+private:
+  uint64_t state = 0x5d1e5d1e5d1e5d1eull;
+
+public:
+  uint32_t next() {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return static_cast<uint32_t>(state >> 33);
+  }
+
+  uint32_t below(uint32_t n) {
+    return next() % n;
+  }
+};
+
+static const char* binops[] = {" + ", " - ", " * ", " / ", " % "};
+
+static void
+append_deep_expr(std::string& out, size_t i, StyioProgramRng& rng) {
+  out += "# e_" + std::to_string(i) + " (a: i32, b: i32) : i32 = a";
+
+  /* 64 operands: deep enough to stress precedence climbing */
+  for (int k = 0; k < 63; k++) {
+    out += binops[rng.below(5)];
+
+    switch (rng.below(3)) {
+      case 0:
+        out += "a";
+        break;
+      case 1:
+        out += "b";
+        break;
+      default:
+        out += std::to_string(1 + rng.below(1000));
+        break;
+    }
+  }
+
+  out += "\n";
+}
+
+static void
+append_binding(std::string& out, size_t i, StyioProgramRng& rng) {
+  out += "# c_" + std::to_string(i) + " : i32 = " + std::to_string(rng.below(100000)) + "\n";
+}
+
+static void
+append_function(std::string& out, size_t i, StyioProgramRng& rng) {
+  std::string name = "f_" + std::to_string(i);
+
+  out += "# " + name + " (a: i32, b: i32) : i32 => {\n";
+  out += "  << a * " + std::to_string(1 + rng.below(10)) + " + b\n";
+  out += "}\n";
+  out += name + "(" + std::to_string(rng.below(100)) + ", " + std::to_string(rng.below(100)) + ")\n";
+}
+
+static void
+append_pipeline(std::string& out, size_t i, StyioProgramRng& rng) {
+  out += "# p_" + std::to_string(i) + " (xs: i32) >> (x) => >_(x * " + std::to_string(1 + rng.below(10)) + ")\n";
+}
+
+static void
+append_comments(std::string& out, size_t i, StyioProgramRng& rng) {
+  out += "// line comment number " + std::to_string(i) + ", nothing to see here\n";
+  out += "/*\n  a block comment, which the tokenizer skips in one go,\n  however long it is\n*/\n";
+  if (rng.below(4) == 0) {
+    append_binding(out, i, rng);
+  }
+}
+
+const char*
+get_shape_name(StyioProgramShape shape) {
+  switch (shape) {
+    case StyioProgramShape::DeepExprs:
+      return "deep_exprs";
+    case StyioProgramShape::Bindings:
+      return "bindings";
+    case StyioProgramShape::Functions:
+      return "functions";
+    case StyioProgramShape::Pipelines:
+      return "pipelines";
+    case StyioProgramShape::Comments:
+      return "comments";
+    case StyioProgramShape::Mixed:
+      return "mixed";
+  }
+
+  return "unknown";
+}
+
+std::string
+generate_program(StyioProgramShape shape, size_t size) {
+  std::string out;
+  out.reserve(size + 1024);
+
+  StyioProgramRng rng;
+
+  for (size_t i = 0; i == 0 || out.size() < size; i++) {
+    StyioProgramShape this_shape = shape;
+    if (shape == StyioProgramShape::Mixed) {
+      this_shape = static_cast<StyioProgramShape>(i % 5);
+    }
+
+    switch (this_shape) {
+      case StyioProgramShape::DeepExprs:
+        append_deep_expr(out, i, rng);
+        break;
+      case StyioProgramShape::Bindings:
+        append_binding(out, i, rng);
+        break;
+      case StyioProgramShape::Functions:
+        append_function(out, i, rng);
+        break;
+      case StyioProgramShape::Pipelines:
+        append_pipeline(out, i, rng);
+        break;
+      default:
+        append_comments(out, i, rng);
+        break;
+    }
+  }
+
+  return out;
+}
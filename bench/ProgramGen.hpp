@@ -0,0 +1,34 @@
+#pragma once
+#ifndef STYIO_BENCH_PROGRAM_GEN_H_
+#define STYIO_BENCH_PROGRAM_GEN_H_
+
+// [C++ STL]
+#include <cstddef>
+#include <string>
+
+/*
+  Shapes of synthetic programs, each stressing one part of the compiler.
+  Only constructs the current parser accepts at the top level are used.
+*/
+enum class StyioProgramShape
+{
+  DeepExprs, /* long chains of binary operators */
+  Bindings,  /* many named constants, `# c : i32 = 1` */
+  Functions, /* many small functions, and calls to them */
+  Pipelines, /* many `>>` iterations */
+  Comments,  /* mostly comments, some code */
+  Mixed,     /* all of the above, in turns */
+};
+
+const char*
+get_shape_name(StyioProgramShape shape);
+
+/*
+  A program of `shape` of about `size` bytes (at least one statement).
+  The same arguments always give the same text, so that the numbers of
+  two runs are comparable.
+*/
+std::string
+generate_program(StyioProgramShape shape, size_t size);
+
+#endif
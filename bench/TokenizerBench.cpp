@@ -0,0 +1,54 @@
+// [C++ STL]
+#include <string>
+#include <vector>
+
+// [Styio]
+#include "StyioParser/Tokenizer.hpp"
+#include "StyioParser/TokenizerScan.hpp"
+
+// [Google Benchmark]
+#include <benchmark/benchmark.h>
+
+/* Indented, commented Styio-looking text of about `size` bytes. */
+static std::string
+make_source(size_t size) {
+  static const char* lines[] = {
+    "# add := (a: i32, b: i32) => a + b\n",
+    "    // accumulate the running total of the long names\n",
+    "    some_rather_long_variable_name = another_long_identifier_here + 1234567\n",
+    "    ratio = 3.14159265 * counter_value_with_a_long_name / 2.5\n",
+    "    /* block comments are skipped in one go, however long they are */\n",
+    "    >_(\"hello, world\")\n",
+    "\n",
+  };
+
+  std::string text;
+  text.reserve(size + 128);
+  for (size_t i = 0; text.size() < size; i++) {
+    text += lines[i % (sizeof(lines) / sizeof(lines[0]))];
+  }
+
+  return text;
+}
+
+static void
+BM_Tokenize(benchmark::State& state, StyioScanMode mode) {
+  std::string code = make_source(state.range(0));
+
+  size_t num_of_tokens = 0;
+  for (auto _ : state) {
+    auto stream = StyioTokenizer::tokenize(code, mode);
+    num_of_tokens = stream.tokens.size() + stream.trivia.size();
+    benchmark::DoNotOptimize(stream.tokens.data());
+  }
+
+  state.SetLabel(get_scan_kernels(mode).name);
+  state.SetBytesProcessed(int64_t(state.iterations()) * code.size());
+  state.counters["tokens/s"] = benchmark::Counter(
+    double(num_of_tokens) * state.iterations(), benchmark::Counter::kIsRate
+  );
+}
+
+BENCHMARK_CAPTURE(BM_Tokenize, scalar, StyioScanMode::Scalar)->Range(1 << 12, 1 << 24);
+BENCHMARK_CAPTURE(BM_Tokenize, sse2, StyioScanMode::SSE2)->Range(1 << 12, 1 << 24);
+BENCHMARK_CAPTURE(BM_Tokenize, auto, StyioScanMode::Auto)->Range(1 << 12, 1 << 24);
@@ -12,6 +12,7 @@ using std::vector;
 #include "../StyioAnalyzer/ASTAnalyzer.hpp"
 #include "../StyioToString/ToStringVisitor.hpp"
 #include "../StyioToken/Token.hpp"
+#include "ASTArena.hpp"
 #include "ASTDecl.hpp"
 
 // [LLVM]
@@ -28,13 +29,22 @@ class StyioAST
 public:
   virtual ~StyioAST() {}
 
+  /* Allocation: from the current ASTArena, if any (ASTArena.cpp) */
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr);
+
   /* Type Hint */
   virtual const StyioNodeType getNodeType() const = 0;
 
   virtual const StyioDataType getDataType() const = 0;
 
   /* StyioAST to String */
-  virtual std::string toString(StyioRepr* visitor, int indent = 0) = 0;
+  std::string toString(StyioRepr* visitor, int indent = 0) {
+    return visitor->toString(this, indent);
+  }
+
+  /* Write into the output of `visitor`, see StyioReprWriter */
+  virtual void writeRepr(StyioRepr* visitor, int indent = 0) = 0;
 
   /* Type Inference */
   virtual void typeInfer(StyioAnalyzer* visitor) = 0;
@@ -52,8 +62,8 @@ public:
   using StyioAST::getDataType;
   using StyioAST::getNodeType;
 
-  std::string toString(StyioRepr* visitor, int indent = 0) override {
-    return visitor->toString(static_cast<Derived*>(this), indent);
+  void writeRepr(StyioRepr* visitor, int indent = 0) override {
+    visitor->write(static_cast<Derived*>(this), indent);
   }
 
   void typeInfer(StyioAnalyzer* visitor) override {
@@ -90,7 +100,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -99,23 +109,31 @@ public:
 class NameAST : public StyioASTTraits<NameAST>
 {
 private:
-  string name_str;
+  StyioSymbol symbol = 0;
 
 public:
-  NameAST(string name) :
-      name_str(name) {
+  NameAST(StyioSymbol symbol) :
+      symbol(symbol) {
   }
 
   static NameAST* Create() {
-    return new NameAST("");
+    return new NameAST(0);
+  }
+
+  static NameAST* Create(StyioSymbol symbol) {
+    return new NameAST(symbol);
+  }
+
+  static NameAST* Create(const string& name) {
+    return new NameAST(StyioSymbolTable::intern(name));
   }
 
-  static NameAST* Create(string name) {
-    return new NameAST(name);
+  StyioSymbol getSymbol() const {
+    return symbol;
   }
 
   const string& getAsStr() {
-    return name_str;
+    return StyioSymbolTable::name_of(symbol);
   }
 
   const StyioNodeType getNodeType() const {
@@ -123,14 +141,14 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
 class TypeAST : public StyioASTTraits<TypeAST>
 {
 public:
-  StyioDataType type = StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+  StyioDataType type = StyioDataType::Undefined;
 
   TypeAST() {}
 
@@ -141,13 +159,7 @@ public:
   TypeAST(
     string type_name
   ) {
-    auto it = DTypeTable.find(type_name);
-    if (it != DTypeTable.end()) {
-      type = it->second;
-    }
-    else {
-      type = StyioDataType{StyioDataTypeOption::Defined, type_name, 0};
-    }
+    type = StyioDataType::lookup(type_name);
   }
 
   static TypeAST* Create() {
@@ -167,7 +179,7 @@ public:
   }
 
   string getTypeName() {
-    return type.name;
+    return string(type.name());
   }
 
   const StyioNodeType getNodeType() const {
@@ -182,16 +194,24 @@ public:
 class TypeTupleAST : public StyioASTTraits<TypeTupleAST>
 {
 private:
-  TypeTupleAST() {}
+  TypeTupleAST() :
+      type(StyioDataType::getTuple({})) {
+  }
 
   TypeTupleAST(
     std::vector<TypeAST*> type_list
   ) :
       type_list(type_list) {
+    std::vector<StyioDataType> elements;
+    for (auto t : type_list) {
+      elements.push_back(t->getDataType());
+    }
+    type = StyioDataType::getTuple(elements);
   }
 
 public:
   std::vector<TypeAST*> type_list;
+  StyioDataType type;
 
   static TypeTupleAST* Create() {
     return new TypeTupleAST();
@@ -206,7 +226,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Tuple, "TypeTuple", 0};
+    return type;
   }
 };
 
@@ -229,7 +249,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -250,7 +270,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -279,7 +299,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Bool, "Boolean", 1};
+    return StyioDataType::Bool;
   }
 };
 
@@ -317,7 +337,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Integer, "int", num_of_bit};
+    return StyioDataType::getInteger(num_of_bit);
   }
 };
 
@@ -328,7 +348,7 @@ class FloatAST : public StyioASTTraits<FloatAST>
 {
 public:
   string value;
-  TypeAST* data_type = TypeAST::Create(StyioDataType{StyioDataTypeOption::Float, "Float", 64});
+  TypeAST* data_type = TypeAST::Create(StyioDataType::F64);
 
   FloatAST(const string& value) :
       value(value) {
@@ -383,7 +403,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -413,7 +433,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -444,7 +464,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -483,7 +503,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -502,7 +522,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -516,7 +536,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -535,7 +555,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -561,7 +581,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -613,7 +633,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 
   void setDataType(StyioDataType type) {
@@ -637,7 +657,7 @@ public:
   }
 
   bool isTyped() {
-    return (var_type && (var_type->getDataType().option != StyioDataTypeOption::Undefined));
+    return (var_type && (not var_type->getDataType().isUndefined()));
   }
 };
 
@@ -650,7 +670,8 @@ class ParamAST : public VarAST
 private:
   ParamAST(NameAST* name) :
       VarAST(name),
-      var_name(name) {
+      var_name(name),
+      var_type(VarAST::var_type) {
   }
 
   ParamAST(
@@ -685,7 +706,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 
   static ParamAST* Create(NameAST* name) {
@@ -733,7 +754,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -756,7 +777,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -790,7 +811,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -827,7 +848,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -870,7 +891,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -907,7 +928,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -940,7 +961,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -968,7 +989,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -1055,7 +1076,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -1135,7 +1156,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -1170,7 +1191,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -1203,7 +1224,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -1306,7 +1327,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -1338,7 +1359,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -1397,7 +1418,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -1458,7 +1479,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -1549,7 +1570,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -1576,7 +1597,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -1613,7 +1634,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -1645,7 +1666,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 
   VarAST* getVar() {
@@ -1683,7 +1704,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 
   VarAST* getVar() {
@@ -1730,7 +1751,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Struct, name->getAsStr(), 0};
+    return StyioDataType::getStruct(name->getAsStr());
   }
 };
 
@@ -1766,7 +1787,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -1792,7 +1813,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -1823,7 +1844,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -1867,7 +1888,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -2027,7 +2048,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -2050,7 +2071,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 
   static MatchCasesAST* make(StyioAST* value, CasesAST* cases) {
@@ -2081,7 +2102,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -2105,7 +2126,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -2128,7 +2149,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::String, "#name", 0};
+    return StyioDataType::String;
   }
 };
 
@@ -2194,7 +2215,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -2221,7 +2242,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -2263,7 +2284,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -2310,7 +2331,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -2345,7 +2366,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -2459,7 +2480,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 
   bool hasName() {
@@ -2716,7 +2737,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "TupleOp", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -2754,7 +2775,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -2827,7 +2848,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -2877,7 +2898,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "undefined", 0};
+    return StyioDataType::Undefined;
   }
 };
 
@@ -2905,7 +2926,7 @@ public:
   }
 
   const StyioDataType getDataType() const {
-    return StyioDataType{StyioDataTypeOption::Undefined, "TupleOp", 0};
+    return StyioDataType::Undefined;
   }
 };
 
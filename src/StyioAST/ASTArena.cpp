@@ -0,0 +1,93 @@
+// [C++ STL]
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+// [Styio]
+#include "AST.hpp"
+#include "ASTArena.hpp"
+
+thread_local ASTArena* ASTArena::current_arena = nullptr;
+
+void
+ASTArena::grow(size_t min_size) {
+  size_t size = std::max(next_chunk_size, min_size);
+  char* data = static_cast<char*>(::operator new(size));
+
+  chunks.push_back(Chunk{data, size});
+  cursor = data;
+  limit = data + size;
+
+  /* double up to 16 MiB per chunk */
+  next_chunk_size = std::min<size_t>(next_chunk_size * 2, 16 * 1024 * 1024);
+}
+
+void*
+ASTArena::allocate_node(size_t size) {
+  void* ptr = allocate(size, alignof(std::max_align_t));
+
+  /*
+    All AST classes derive from StyioAST alone, through single
+    inheritance, so the StyioAST subobject sits at the very start of
+    every node and this pointer can be used to destroy it later.
+  */
+  nodes.push_back(static_cast<StyioAST*>(ptr));
+  return ptr;
+}
+
+bool
+ASTArena::forget_node(void* ptr) {
+  auto it = std::find(nodes.rbegin(), nodes.rend(), static_cast<StyioAST*>(ptr));
+  if (it == nodes.rend()) {
+    return false;
+  }
+
+  nodes.erase(std::next(it).base());
+  return true;
+}
+
+void
+ASTArena::release() {
+  for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+    (*it)->~StyioAST();
+  }
+  nodes.clear();
+
+  for (auto const& chunk : chunks) {
+    ::operator delete(chunk.data);
+  }
+  chunks.clear();
+
+  cursor = nullptr;
+  limit = nullptr;
+  bytes_in_use = 0;
+}
+
+/*
+  StyioAST: Allocation
+*/
+
+void*
+StyioAST::operator new(size_t size) {
+  if (auto arena = ASTArena::current()) {
+    return arena->allocate_node(size);
+  }
+
+  return ::operator new(size);
+}
+
+void
+StyioAST::operator delete(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+
+  /* a node of the current arena: only reachable when its constructor threw */
+  if (auto arena = ASTArena::current()) {
+    if (arena->forget_node(ptr)) {
+      return;
+    }
+  }
+
+  ::operator delete(ptr);
+}
@@ -0,0 +1,124 @@
+#pragma once
+#ifndef STYIO_AST_ARENA_H_
+#define STYIO_AST_ARENA_H_
+
+// [C++ STL]
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class StyioAST;
+
+/*
+  ASTArena: a bump allocator for AST nodes, one per compilation.
+
+  Every `*AST::Create()` ends up in StyioAST::operator new, which takes
+  memory from the current arena of this thread (see ASTArena::Scope).
+  Nodes are laid out next to each other in the order the parser creates
+  them, and they are all destroyed and freed at once by release(),
+  or when the arena goes away.
+
+  Without a current arena, nodes fall back to the global heap,
+  and live forever as they used to.
+
+  Usage:
+    ASTArena arena;
+    {
+      ASTArena::Scope scope(arena);
+      auto ast = parse_main_block(context);
+      ...
+    }
+    arena.release();
+*/
+class ASTArena
+{
+private:
+  struct Chunk
+  {
+    char* data;
+    size_t size;
+  };
+
+  std::vector<Chunk> chunks;
+  char* cursor = nullptr;
+  char* limit = nullptr;
+  size_t next_chunk_size;
+
+  /* nodes to destroy on release(), in the order of creation */
+  std::vector<StyioAST*> nodes;
+
+  size_t bytes_in_use = 0;
+
+  static thread_local ASTArena* current_arena;
+
+  void grow(size_t min_size);
+
+public:
+  explicit ASTArena(size_t first_chunk_size = 64 * 1024) :
+      next_chunk_size(first_chunk_size) {
+  }
+
+  ASTArena(const ASTArena&) = delete;
+  ASTArena& operator=(const ASTArena&) = delete;
+
+  ~ASTArena() {
+    release();
+  }
+
+  /* Raw memory, freed by release() */
+  void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+    size_t pad = (align - reinterpret_cast<uintptr_t>(cursor) % align) % align;
+    if (size + pad > size_t(limit - cursor)) {
+      grow(size + align);
+      pad = (align - reinterpret_cast<uintptr_t>(cursor) % align) % align;
+    }
+
+    char* p = cursor + pad;
+    cursor = p + size;
+    bytes_in_use += size;
+    return p;
+  }
+
+  /* Memory for an AST node, which will be destroyed by release() */
+  void* allocate_node(size_t size);
+
+  /* Undo allocate_node(), if its constructor threw */
+  bool forget_node(void* ptr);
+
+  /* Destroy all nodes and free all chunks. The arena can be reused. */
+  void release();
+
+  size_t num_of_nodes() const {
+    return nodes.size();
+  }
+
+  size_t num_of_bytes() const {
+    return bytes_in_use;
+  }
+
+  static ASTArena* current() {
+    return current_arena;
+  }
+
+  /* Make `arena` the current arena of this thread for a while. */
+  class Scope
+  {
+  private:
+    ASTArena* previous;
+
+  public:
+    explicit Scope(ASTArena& arena) :
+        previous(current_arena) {
+      current_arena = &arena;
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    ~Scope() {
+      current_arena = previous;
+    }
+  };
+};
+
+#endif
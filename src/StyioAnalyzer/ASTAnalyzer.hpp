@@ -4,8 +4,11 @@
 
 // [STL]
 #include <iostream>
+#include <optional>
 #include <string>
 #include <unordered_map>
+#include <variant>
+#include <vector>
 
 using std::string;
 using std::unordered_map;
@@ -13,6 +16,9 @@ using std::unordered_map;
 // [Styio]
 #include "../StyioAST/ASTDecl.hpp"
 #include "../StyioIR/IRDecl.hpp"
+#include "../StyioToken/Symbol.hpp"
+#include "../StyioToken/Token.hpp"
+#include "TypeUnify.hpp"
 
 // Generic Visitor
 template <typename... Types>
@@ -132,13 +138,139 @@ using StyioAnalyzerVisitor = AnalyzerVisitor<
 
 class StyioAnalyzer : public StyioAnalyzerVisitor
 {
-  unordered_map<string, FunctionAST*> func_defs;
+  StyioSymbolMap<FunctionAST> func_defs;
+
+  /* Resolved signatures of the functions so far, see StyioDataType::getFunc() */
+  StyioSymbolMap<const StyioTypeInfo> func_types;
+
+  /*
+    Type Inference
+
+    typeInfer() walks a statement and turns what it sees into constraints
+    on type variables: a binding has the type of its value, an argument
+    the type of its parameter, a return the type of its function. At the
+    end of the outermost typeInfer(), i.e. of each top-level statement,
+    the constraints are solved and the types are written back into the
+    AST (TypeAST, IntAST::num_of_bit), where toStyioIR() picks them up.
+  */
+  StyioTypeUnifier unifier;
+
+  /* Type of the node that typeInfer() visited last, see infer() */
+  std::optional<StyioTypeVar> last_var;
+
+  /* Names bound in the statement being inferred, innermost binding of each */
+  unordered_map<StyioSymbol, StyioTypeVar> scope_index;
+
+  /* Undo log of scope_index, innermost last, see VarScope */
+  struct ScopeVar
+  {
+    StyioSymbol name;
+    StyioTypeVar var;
+    std::optional<StyioTypeVar> shadowed;
+  };
+
+  std::vector<ScopeVar> scope_vars;
+
+  /* Solved types of the top-level names of earlier statements */
+  StyioSymbolMap<const StyioTypeInfo> var_types;
+
+  /* Return type of each function we are in, innermost last */
+  std::vector<StyioTypeVar> ret_vars;
+
+  /* Written back by solve() */
+  struct FuncSig
+  {
+    std::vector<StyioTypeVar> params;
+    StyioTypeVar ret;
+  };
+
+  std::vector<std::pair<StyioTypeVar, TypeAST*>> typed_nodes;
+  std::vector<std::pair<StyioTypeVar, IntAST*>> int_literals;
+  unordered_map<StyioSymbol, FuncSig> func_sigs;
+
+  /* typeInfer() calls in progress, solve() when the outermost ends */
+  size_t num_of_open = 0;
+
+  struct InferUnit
+  {
+    StyioAnalyzer& analyzer;
+
+    InferUnit(StyioAnalyzer& analyzer) :
+        analyzer(analyzer) {
+      analyzer.num_of_open += 1;
+    }
+
+    ~InferUnit() {
+      analyzer.num_of_open -= 1;
+      if (analyzer.num_of_open == 0) {
+        analyzer.solve();
+      }
+    }
+  };
+
+  /* Names bound from here on go out of scope with it */
+  struct VarScope
+  {
+    StyioAnalyzer& analyzer;
+    size_t num_of_outer;
+
+    VarScope(StyioAnalyzer& analyzer) :
+        analyzer(analyzer), num_of_outer(analyzer.scope_vars.size()) {
+    }
+
+    ~VarScope() {
+      analyzer.unbind_vars(num_of_outer);
+    }
+  };
+
+  StyioTypeVar infer(StyioAST* ast);
+
+  /* Fixed if `type` was written, filled in by solve() if not */
+  StyioTypeVar typed_var(TypeAST* type);
+
+  std::optional<StyioTypeVar> lookup_var(StyioSymbol name);
+  void bind_var(StyioSymbol name, StyioTypeVar var);
+  void unbind_vars(size_t num_of_outer);
+
+  /* unify(), or StyioTypeError if `a` and `b` can never be one type */
+  void constrain(StyioTypeVar a, StyioTypeVar b, const char* where);
+  void constrain(StyioTypeVar var, StyioDataType type, bool is_fixed, const char* where);
+
+  /* Type of the elements of a collection, for iterators */
+  StyioTypeVar element_var(StyioAST* collection);
+
+  void infer_iterator(IteratorAST* ast);
+
+  void infer_func(
+    NameAST* name,
+    const std::vector<ParamAST*>& params,
+    std::variant<TypeAST*, TypeTupleAST*>& ret_type,
+    StyioAST* body,
+    bool body_is_ret_expr
+  );
+
+  void solve();
 
 public:
   StyioAnalyzer() {}
 
   ~StyioAnalyzer() {}
 
+  /* Forget a top-level name, e.g. a function whose definition is gone */
+  void forget(StyioSymbol name) {
+    func_defs.erase(name);
+    func_types.erase(name);
+    var_types.erase(name);
+  }
+
+  /* Resolved type of a function, Undefined if there is no such function */
+  StyioDataType getFuncType(StyioSymbol name) const {
+    if (func_types.contains(name)) {
+      return StyioDataType{func_types.get(name)};
+    }
+    return StyioDataType::Undefined;
+  }
+
   /* Styio AST Type Inference */
 
   void typeInfer(BoolAST* ast);
@@ -10,6 +10,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <variant>
 #include <vector>
 
 // [Styio]
@@ -18,6 +19,32 @@
 #include "../StyioToken/Token.hpp"
 #include "Util.hpp"
 
+/* The type typeInfer() solved for, Undefined if it could not */
+static SGType*
+toSGRetType(const std::variant<TypeAST*, TypeTupleAST*>& ret_type) {
+  if (std::holds_alternative<TypeTupleAST*>(ret_type)) {
+    auto tuple = std::get<TypeTupleAST*>(ret_type);
+    return SGType::Create(tuple ? tuple->getDataType() : StyioDataType::Undefined);
+  }
+
+  auto type = std::get<TypeAST*>(ret_type);
+  return SGType::Create(type ? type->getDataType() : StyioDataType::Undefined);
+}
+
+static std::vector<SGFuncArg*>
+toSGFuncArgs(const std::vector<ParamAST*>& params) {
+  std::vector<SGFuncArg*> args;
+
+  for (auto param : params) {
+    args.push_back(SGFuncArg::Create(
+      param->getName(),
+      SGType::Create(param->getDType() ? param->getDType()->getDataType() : StyioDataType::Undefined)
+    ));
+  }
+
+  return args;
+}
+
 StyioIR*
 StyioAnalyzer::toStyioIR(CommentAST* ast) {
   return SGConstInt::Create(0);
@@ -35,7 +62,7 @@ StyioAnalyzer::toStyioIR(EmptyAST* ast) {
 
 StyioIR*
 StyioAnalyzer::toStyioIR(NameAST* ast) {
-  return SGResId::Create(ast->getAsStr());
+  return SGResId::Create(ast->getSymbol());
 }
 
 StyioIR*
@@ -60,7 +87,7 @@ StyioAnalyzer::toStyioIR(IntAST* ast) {
 
 StyioIR*
 StyioAnalyzer::toStyioIR(FloatAST* ast) {
-  return SGConstFloat::Create(ast->value);
+  return SGConstFloat::Create(ast->value, ast->getDataType().num_of_bit());
 }
 
 StyioIR*
@@ -153,7 +180,7 @@ StyioAnalyzer::toStyioIR(StructAST* ast) {
     elems.push_back(static_cast<SGVar*>(arg->toStyioIR(this)));
   }
 
-  return SGStruct::Create(SGResId::Create(ast->name->getAsStr()), elems);
+  return SGStruct::Create(SGResId::Create(ast->name->getSymbol()), elems);
 }
 
 StyioIR*
@@ -198,11 +225,52 @@ StyioAnalyzer::toStyioIR(ListOpAST* ast) {
 
 StyioIR*
 StyioAnalyzer::toStyioIR(BinCompAST* ast) {
-  return SGConstInt::Create(0);
+  StyioOpType op;
+  switch (ast->getSign()) {
+    case CompType::EQ:
+      op = StyioOpType::Equal;
+      break;
+    case CompType::GT:
+      op = StyioOpType::Greater_Than;
+      break;
+    case CompType::GE:
+      op = StyioOpType::Greater_Than_Equal;
+      break;
+    case CompType::LT:
+      op = StyioOpType::Less_Than;
+      break;
+    case CompType::LE:
+      op = StyioOpType::Less_Than_Equal;
+      break;
+    case CompType::NE:
+    default:
+      op = StyioOpType::Not_Equal;
+      break;
+  }
+
+  return SGCond::Create(ast->getLHS()->toStyioIR(this), ast->getRHS()->toStyioIR(this), op);
 }
 
+/* !(a) is an SGCond without rhs */
 StyioIR*
 StyioAnalyzer::toStyioIR(CondAST* ast) {
+  switch (ast->getSign()) {
+    case LogicType::RAW:
+      return ast->getValue()->toStyioIR(this);
+
+    case LogicType::NOT:
+      return SGCond::Create(ast->getValue()->toStyioIR(this), nullptr, StyioOpType::Logic_NOT);
+
+    case LogicType::AND:
+      return SGCond::Create(ast->getLHS()->toStyioIR(this), ast->getRHS()->toStyioIR(this), StyioOpType::Logic_AND);
+
+    case LogicType::OR:
+      return SGCond::Create(ast->getLHS()->toStyioIR(this), ast->getRHS()->toStyioIR(this), StyioOpType::Logic_OR);
+
+    case LogicType::XOR:
+      return SGCond::Create(ast->getLHS()->toStyioIR(this), ast->getRHS()->toStyioIR(this), StyioOpType::Logic_XOR);
+  }
+
   return SGConstInt::Create(0);
 }
 
@@ -274,12 +342,17 @@ StyioAnalyzer::toStyioIR(PassAST* ast) {
 
 StyioIR*
 StyioAnalyzer::toStyioIR(ReturnAST* ast) {
-  return SGConstInt::Create(0);
+  return SGReturn::Create(ast->getExpr()->toStyioIR(this));
 }
 
 StyioIR*
 StyioAnalyzer::toStyioIR(FuncCallAST* ast) {
-  return SGConstInt::Create(0);
+  std::vector<StyioIR*> args;
+  for (auto arg : ast->getArgList()) {
+    args.push_back(arg->toStyioIR(this));
+  }
+
+  return SGCall::Create(SGResId::Create(ast->func_name->getSymbol()), args);
 }
 
 StyioIR*
@@ -334,12 +407,38 @@ StyioAnalyzer::toStyioIR(AnonyFuncAST* ast) {
 
 StyioIR*
 StyioAnalyzer::toStyioIR(FunctionAST* ast) {
-  return SGConstInt::Create(0);
+  if (ast->func_name == nullptr) {
+    return SGConstInt::Create(0);
+  }
+
+  SGBlock* body;
+  if (ast->func_body->getNodeType() == StyioNodeType::Block) {
+    body = static_cast<SGBlock*>(ast->func_body->toStyioIR(this));
+  }
+  else {
+    body = SGBlock::Create({ast->func_body->toStyioIR(this)});
+  }
+
+  return SGFunc::Create(
+    toSGRetType(ast->ret_type),
+    SGResId::Create(ast->func_name->getSymbol()),
+    toSGFuncArgs(ast->params),
+    body
+  );
 }
 
 StyioIR*
 StyioAnalyzer::toStyioIR(SimpleFuncAST* ast) {
-  return SGConstInt::Create(0);
+  if (ast->func_name == nullptr) {
+    return SGConstInt::Create(0);
+  }
+
+  return SGFunc::Create(
+    toSGRetType(ast->ret_type),
+    SGResId::Create(ast->func_name->getSymbol()),
+    toSGFuncArgs(ast->params),
+    SGBlock::Create({SGReturn::Create(ast->ret_expr->toStyioIR(this))})
+  );
 }
 
 StyioIR*
@@ -369,7 +468,17 @@ StyioAnalyzer::toStyioIR(MatchCasesAST* ast) {
 
 StyioIR*
 StyioAnalyzer::toStyioIR(BlockAST* ast) {
-  return SGConstInt::Create(0);
+  std::vector<StyioIR*> ir_stmts;
+
+  for (auto stmt : ast->stmts) {
+    ir_stmts.push_back(stmt->toStyioIR(this));
+  }
+
+  for (auto stmt : ast->followings) {
+    ir_stmts.push_back(stmt->toStyioIR(this));
+  }
+
+  return SGBlock::Create(ir_stmts);
 }
 
 StyioIR*
@@ -10,10 +10,12 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <variant>
 #include <vector>
 
 // [Styio]
 #include "../StyioAST/AST.hpp"
+#include "../StyioException/Exception.hpp"
 #include "../StyioToken/Token.hpp"
 #include "Util.hpp"
 
@@ -31,6 +33,9 @@ StyioAnalyzer::typeInfer(EmptyAST* ast) {
 
 void
 StyioAnalyzer::typeInfer(NameAST* ast) {
+  if (auto var = lookup_var(ast->getSymbol())) {
+    last_var = *var;
+  }
 }
 
 void
@@ -47,10 +52,19 @@ StyioAnalyzer::typeInfer(BoolAST* ast) {
 
 void
 StyioAnalyzer::typeInfer(IntAST* ast) {
+  InferUnit unit(*this);
+
+  /* `int` until the context decides the width, an explicit width is fixed */
+  last_var = unifier.fresh(ast->getDataType(), ast->num_of_bit != 0);
+  int_literals.push_back({*last_var, ast});
 }
 
 void
 StyioAnalyzer::typeInfer(FloatAST* ast) {
+  InferUnit unit(*this);
+
+  last_var = unifier.fresh(ast->getDataType());
+  typed_nodes.push_back({*last_var, ast->data_type});
 }
 
 void
@@ -67,10 +81,22 @@ StyioAnalyzer::typeInfer(TypeConvertAST*) {
 
 void
 StyioAnalyzer::typeInfer(VarAST* ast) {
+  InferUnit unit(*this);
+
+  last_var = typed_var(ast->getDType());
+  bind_var(ast->getName()->getSymbol(), *last_var);
 }
 
 void
 StyioAnalyzer::typeInfer(ParamAST* ast) {
+  InferUnit unit(*this);
+
+  last_var = typed_var(ast->getDType());
+  bind_var(ast->var_name->getSymbol(), *last_var);
+
+  if (ast->val_init) {
+    constrain(*last_var, infer(ast->val_init), "default value");
+  }
 }
 
 void
@@ -87,51 +113,38 @@ StyioAnalyzer::typeInfer(OptKwArgAST* ast) {
 */
 void
 StyioAnalyzer::typeInfer(FlexBindAST* ast) {
-  /* FlexBindAST -> VarAST -> DTypeAST -> StyioDataType */
-  auto var_type = ast->getVar()->getDType()->type;
-
-  /* var type is not declared, try to deduce from the type of value */
-  if (var_type.option == StyioDataTypeOption::Undefined) {
-    ast->getValue()->typeInfer(this);
-
-    switch (ast->getValue()->getNodeType()) {
-      case StyioNodeType::Integer: {
-        ast->getVar()->setDataType(ast->getValue()->getDataType());
-      } break;
+  InferUnit unit(*this);
 
-      case StyioNodeType::Float: {
-        ast->getVar()->setDataType(ast->getValue()->getDataType());
-      } break;
+  VarAST* var = ast->getVar();
+  StyioSymbol name = var->getName()->getSymbol();
 
-      case StyioNodeType::BinOp: {
-        ast->getVar()->setDataType(ast->getValue()->getDataType());
-      } break;
+  StyioTypeVar value = infer(ast->getValue());
 
-      case StyioNodeType::Tuple: {
-        ast->getVar()->setDataType(ast->getValue()->getDataType());
-      } break;
-
-      default:
-        break;
-    }
+  /* a = 1; a = 2: the second one is an assignment to the first one */
+  std::optional<StyioTypeVar> bound = lookup_var(name);
+  if (bound && not var->isTyped()) {
+    typed_nodes.push_back({*bound, var->getDType()});
   }
-  /* if var type has been declared, the type of value must be converted to whatever declared */
   else {
-    switch (ast->getValue()->getNodeType()) {
-      case StyioNodeType::BinOp: {
-        static_cast<BinOpAST*>(ast->getValue())->setDType(var_type);
-      } break;
-
-      default:
-        break;
-    }
-
-    ast->getValue()->typeInfer(this);
+    bound = typed_var(var->getDType());
+    bind_var(name, *bound);
   }
+
+  constrain(*bound, value, "binding");
+  last_var = *bound;
 }
 
 void
 StyioAnalyzer::typeInfer(FinalBindAST* ast) {
+  InferUnit unit(*this);
+
+  StyioTypeVar value = infer(ast->getValue());
+
+  StyioTypeVar bound = typed_var(ast->getVar()->getDType());
+  bind_var(ast->getVar()->getName()->getSymbol(), bound);
+
+  constrain(bound, value, "binding");
+  last_var = bound;
 }
 
 void
@@ -144,23 +157,27 @@ StyioAnalyzer::typeInfer(StructAST* ast) {
 
 void
 StyioAnalyzer::typeInfer(TupleAST* ast) {
-  /* if no element against the consistency, the tuple will have a type. */
-  auto elements = ast->getElements();
+  InferUnit unit(*this);
 
+  /* if no element against the consistency, the tuple will have a type. */
   bool is_consistent = true;
-  StyioDataType aggregated_type = elements[0]->getDataType();
-  if (aggregated_type.isUndefined()) {
-    for (size_t i = 1; i < elements.size(); i += 1) {
-      if (not(elements[i]->getDataType()).equals(aggregated_type)) {
-        is_consistent = false;
-      }
+  std::optional<StyioTypeVar> elem;
+  for (auto element : ast->getElements()) {
+    StyioTypeVar var = infer(element);
+    if (not elem) {
+      elem = var;
+    }
+    else if (not unifier.unify(*elem, var)) {
+      is_consistent = false;
     }
   }
 
-  if (is_consistent) {
+  if (elem && is_consistent) {
     ast->setConsistency(is_consistent);
-    ast->setDataType(aggregated_type);
+    typed_nodes.push_back({*elem, ast->getDTypeObj()});
   }
+
+  last_var = unifier.fresh();
 }
 
 void
@@ -173,6 +190,10 @@ StyioAnalyzer::typeInfer(ExtractorAST* ast) {
 
 void
 StyioAnalyzer::typeInfer(RangeAST* ast) {
+  InferUnit unit(*this);
+
+  element_var(ast);
+  last_var = unifier.fresh();
 }
 
 void
@@ -181,23 +202,10 @@ StyioAnalyzer::typeInfer(SetAST* ast) {
 
 void
 StyioAnalyzer::typeInfer(ListAST* ast) {
-  /* if no element against the consistency, the tuple will have a type. */
-  auto elements = ast->getElements();
-
-  bool is_consistent = true;
-  StyioDataType aggregated_type = elements[0]->getDataType();
-  if (aggregated_type.isUndefined()) {
-    for (size_t i = 1; i < elements.size(); i += 1) {
-      if (not(elements[i]->getDataType()).equals(aggregated_type)) {
-        is_consistent = false;
-      }
-    }
-  }
+  InferUnit unit(*this);
 
-  if (is_consistent) {
-    ast->setConsistency(is_consistent);
-    ast->setDataType(aggregated_type);
-  }
+  element_var(ast);
+  last_var = unifier.fresh();
 }
 
 void
@@ -210,148 +218,75 @@ StyioAnalyzer::typeInfer(ListOpAST* ast) {
 
 void
 StyioAnalyzer::typeInfer(BinCompAST* ast) {
+  InferUnit unit(*this);
+
+  constrain(infer(ast->getLHS()), infer(ast->getRHS()), "comparison");
+  last_var = unifier.fresh(StyioDataType::Bool, true);
 }
 
 void
 StyioAnalyzer::typeInfer(CondAST* ast) {
+  InferUnit unit(*this);
+
+  for (StyioAST* operand : {ast->getValue(), ast->getLHS(), ast->getRHS()}) {
+    if (operand) {
+      constrain(infer(operand), StyioDataType::Bool, /* is_fixed */ false, "condition");
+    }
+  }
+
+  last_var = unifier.fresh(StyioDataType::Bool, true);
 }
 
 /*
-  Int -> Int => Pass
-  Int -> Float => Pass
+  1 + 2       => i64 (a literal without context)
+  1 + 2.0     => f64
+  a + 1       => i32, if a: i32 (and 1 becomes i32)
+  a < b       => bool
 */
 void
 StyioAnalyzer::typeInfer(BinOpAST* ast) {
-  auto lhs = ast->getLHS();
-  auto rhs = ast->getRHS();
-
-  if (ast->getType().isUndefined()) {
-    lhs->typeInfer(this);
-    rhs->typeInfer(this);
-
-    auto op = ast->getOp();
-    auto lhs_hint = lhs->getNodeType();
-    auto rhs_hint = rhs->getNodeType();
-
-    switch (lhs_hint) {
-      case StyioNodeType::Integer: {
-        switch (rhs_hint) {
-          case StyioNodeType::Integer: {
-            auto lhs_int = static_cast<IntAST*>(lhs);
-            auto rhs_int = static_cast<IntAST*>(rhs);
-
-            if (op == StyioOpType::Binary_Add || op == StyioOpType::Binary_Sub || op == StyioOpType::Binary_Mul) {
-              ast->setDType(getMaxType(lhs_int->getDataType(), rhs_int->getDataType()));
-            }
-            else if (op == StyioOpType::Binary_Div) {
-              // 0 / n = 0
-              if (std::stoi(lhs_int->getValue()) == 0) {
-                ast->setDType(getMaxType(lhs_int->getDataType(), rhs_int->getDataType()));
-              }
-            }
-          } break;
-
-          case StyioNodeType::Float: {
-            auto lhs_int = static_cast<IntAST*>(lhs);
-            auto rhs_float = static_cast<FloatAST*>(rhs);
-
-            if (op == StyioOpType::Binary_Add || op == StyioOpType::Binary_Sub || op == StyioOpType::Binary_Mul || op == StyioOpType::Binary_Div) {
-              ast->setDType(getMaxType(lhs_int->getDataType(), rhs_float->getDataType()));
-            }
-          } break;
-
-          case StyioNodeType::BinOp: {
-            auto lhs_expr = static_cast<IntAST*>(lhs);
-            auto rhs_expr = static_cast<BinOpAST*>(rhs);
-
-            if (op == StyioOpType::Binary_Add || op == StyioOpType::Binary_Sub || op == StyioOpType::Binary_Mul || op == StyioOpType::Binary_Div) {
-              ast->setDType(getMaxType(lhs_expr->getDataType(), rhs_expr->getDataType()));
-            }
-          } break;
-
-          default:
-            break;
-        }
-      } break;
-
-      case StyioNodeType::Float: {
-        switch (rhs_hint) {
-          case StyioNodeType::Integer: {
-            auto lhs_float = static_cast<FloatAST*>(lhs);
-            auto rhs_int = static_cast<IntAST*>(rhs);
-
-            if (op == StyioOpType::Binary_Add || op == StyioOpType::Binary_Sub || op == StyioOpType::Binary_Mul || op == StyioOpType::Binary_Div) {
-              ast->setDType(getMaxType(lhs_float->getDataType(), rhs_int->getDataType()));
-            }
-          } break;
-
-          case StyioNodeType::Float: {
-            auto lhs_float = static_cast<FloatAST*>(lhs);
-            auto rhs_float = static_cast<FloatAST*>(rhs);
-
-            if (op == StyioOpType::Binary_Add || op == StyioOpType::Binary_Sub || op == StyioOpType::Binary_Mul || op == StyioOpType::Binary_Div) {
-              ast->setDType(getMaxType(lhs_float->getDataType(), rhs_float->getDataType()));
-            }
-          } break;
-
-          default:
-            break;
-        }
-      } break;
-
-      case StyioNodeType::BinOp: {
-        switch (rhs_hint) {
-          case StyioNodeType::Integer: {
-            auto lhs_expr = static_cast<BinOpAST*>(lhs);
-            auto rhs_expr = static_cast<IntAST*>(rhs);
-
-            if (op == StyioOpType::Binary_Add || op == StyioOpType::Binary_Sub || op == StyioOpType::Binary_Mul || op == StyioOpType::Binary_Div) {
-              ast->setDType(getMaxType(lhs_expr->getType(), rhs_expr->getDataType()));
-            }
-          } break;
-
-          case StyioNodeType::Float: {
-            auto lhs_binop = static_cast<BinOpAST*>(lhs);
-            auto rhs_float = static_cast<FloatAST*>(rhs);
-
-            if (op == StyioOpType::Binary_Add || op == StyioOpType::Binary_Sub || op == StyioOpType::Binary_Mul || op == StyioOpType::Binary_Div) {
-              ast->setDType(getMaxType(lhs_binop->getType(), rhs_float->getDataType()));
-            }
-          } break;
-
-          case StyioNodeType::BinOp: {
-            auto lhs_binop = static_cast<BinOpAST*>(lhs);
-            auto rhs_binop = static_cast<BinOpAST*>(rhs);
-
-            if (op == StyioOpType::Binary_Add || op == StyioOpType::Binary_Sub || op == StyioOpType::Binary_Mul || op == StyioOpType::Binary_Div) {
-              ast->setDType(getMaxType(lhs_binop->getType(), rhs_binop->getType()));
-            }
-          } break;
-
-          default:
-            break;
-        }
-      } break;
-
-      default:
-        break;
-    }
-  }
-  else {
-    /* transfer the type of this binop to the child binop */
-    if (lhs->getNodeType() == StyioNodeType::BinOp) {
-      auto lhs_binop = static_cast<BinOpAST*>(lhs);
-      lhs_binop->setDType(ast->getType());
-      lhs->typeInfer(this);
-    }
-
-    if (rhs->getNodeType() == StyioNodeType::BinOp) {
-      auto rhs_binop = static_cast<BinOpAST*>(rhs);
-      rhs_binop->setDType(ast->getType());
-      rhs->typeInfer(this);
-    }
-
-    return;
+  InferUnit unit(*this);
+
+  StyioTypeVar lhs = infer(ast->getLHS());
+  StyioTypeVar rhs = infer(ast->getRHS());
+
+  switch (ast->getOp()) {
+    /* both operands and the result have one type */
+    case StyioOpType::Binary_Add:
+    case StyioOpType::Binary_Sub:
+    case StyioOpType::Binary_Mul:
+    case StyioOpType::Binary_Div:
+    case StyioOpType::Binary_Pow:
+    case StyioOpType::Binary_Mod: {
+      constrain(lhs, rhs, "operands");
+
+      /* a type set from outside, e.g. by an older pass, is kept */
+      StyioTypeVar result = typed_var(ast->data_type);
+      constrain(result, lhs, "operands");
+
+      last_var = result;
+    } break;
+
+    case StyioOpType::Greater_Than:
+    case StyioOpType::Less_Than:
+    case StyioOpType::Greater_Than_Equal:
+    case StyioOpType::Less_Than_Equal:
+    case StyioOpType::Equal:
+    case StyioOpType::Not_Equal: {
+      constrain(lhs, rhs, "comparison");
+      last_var = unifier.fresh(StyioDataType::Bool, true);
+    } break;
+
+    case StyioOpType::Logic_AND:
+    case StyioOpType::Logic_OR:
+    case StyioOpType::Logic_XOR: {
+      constrain(lhs, StyioDataType::Bool, /* is_fixed */ false, "logic operand");
+      constrain(rhs, StyioDataType::Bool, /* is_fixed */ false, "logic operand");
+      last_var = unifier.fresh(StyioDataType::Bool, true);
+    } break;
+
+    default:
+      break;
   }
 }
 
@@ -401,42 +336,66 @@ StyioAnalyzer::typeInfer(PassAST* ast) {
 
 void
 StyioAnalyzer::typeInfer(ReturnAST* ast) {
+  InferUnit unit(*this);
+
+  StyioTypeVar value = infer(ast->getExpr());
+  if (not ret_vars.empty()) {
+    constrain(ret_vars.back(), value, "return");
+  }
+
+  last_var = value;
 }
 
 void
 StyioAnalyzer::typeInfer(FuncCallAST* ast) {
-  if (not func_defs.contains(ast->getNameAsStr())) {
-    std::cout << "func " << ast->getNameAsStr() << " not exist" << std::endl;
-    return;
+  InferUnit unit(*this);
+
+  std::vector<StyioTypeVar> arg_vars;
+  for (auto arg : ast->getArgList()) {
+    arg_vars.push_back(infer(arg));
   }
 
-  vector<StyioDataType> arg_types;
+  StyioSymbol name = ast->func_name->getSymbol();
 
-  for (auto arg : ast->getArgList()) {
-    switch (arg->getNodeType()) {
-      case StyioNodeType::Integer: {
-        arg_types.push_back(static_cast<IntAST*>(arg)->getDataType());
-      } break;
+  /* defined in an earlier statement, the signature is known */
+  if (func_types.contains(name)) {
+    auto sig = StyioDataType{func_types.get(name)}.elements();
 
-      case StyioNodeType::Float: {
-        arg_types.push_back(static_cast<FloatAST*>(arg)->getDataType());
-      } break;
+    if (arg_vars.size() + 1 != sig.size()) {
+      throw StyioTypeError(
+        ast->getNameAsStr() + ": expects " + std::to_string(sig.size() - 1) + " arguments, got " + std::to_string(arg_vars.size())
+      );
+    }
 
-      default:
-        break;
+    for (size_t i = 0; i < arg_vars.size(); i++) {
+      if (not sig[i].isUndefined()) {
+        constrain(arg_vars[i], sig[i], /* is_fixed */ true, "argument");
+      }
     }
+
+    last_var = unifier.fresh(sig.back(), not sig.back().isUndefined());
+    return;
   }
 
-  auto func_args = func_defs[ast->getNameAsStr()]->params;
+  /* defined in this statement, e.g. a recursive call */
+  if (auto it = func_sigs.find(name); it != func_sigs.end()) {
+    FuncSig const& func = it->second;
 
-  if (arg_types.size() != func_args.size()) {
-    std::cout << "arg list not match" << std::endl;
+    if (arg_vars.size() != func.params.size()) {
+      throw StyioTypeError(
+        ast->getNameAsStr() + ": expects " + std::to_string(func.params.size()) + " arguments, got " + std::to_string(arg_vars.size())
+      );
+    }
+
+    for (size_t i = 0; i < arg_vars.size(); i++) {
+      constrain(func.params[i], arg_vars[i], "argument");
+    }
+
+    last_var = func.ret;
     return;
   }
 
-  for (size_t i = 0; i < func_args.size(); i++) {
-    func_args[i]->setDataType(arg_types[i]);
-  }
+  throw StyioTypeError(ast->getNameAsStr() + ": no such function");
 }
 
 void
@@ -473,6 +432,13 @@ StyioAnalyzer::typeInfer(HashTagNameAST* ast) {
 
 void
 StyioAnalyzer::typeInfer(CondFlowAST* ast) {
+  InferUnit unit(*this);
+
+  for (StyioAST* part : {static_cast<StyioAST*>(ast->getCond()), ast->getThen(), ast->getElse()}) {
+    if (part) {
+      infer(part);
+    }
+  }
 }
 
 void
@@ -481,20 +447,34 @@ StyioAnalyzer::typeInfer(AnonyFuncAST* ast) {
 
 void
 StyioAnalyzer::typeInfer(FunctionAST* ast) {
-  func_defs[ast->getNameAsStr()] = ast;
+  InferUnit unit(*this);
+
+  if (ast->func_name) {
+    func_defs[ast->func_name->getSymbol()] = ast;
+  }
+
+  infer_func(ast->func_name, ast->params, ast->ret_type, ast->func_body, /* body_is_ret_expr */ false);
 }
 
 void
 StyioAnalyzer::typeInfer(SimpleFuncAST* ast) {
-  // func_defs[ast->func_name->getAsStr()] = ast;
+  InferUnit unit(*this);
+
+  infer_func(ast->func_name, ast->params, ast->ret_type, ast->ret_expr, /* body_is_ret_expr */ true);
 }
 
 void
 StyioAnalyzer::typeInfer(IteratorAST* ast) {
+  InferUnit unit(*this);
+
+  infer_iterator(ast);
 }
 
 void
 StyioAnalyzer::typeInfer(IterSeqAST* ast) {
+  InferUnit unit(*this);
+
+  infer_iterator(ast);
 }
 
 
@@ -512,12 +492,307 @@ StyioAnalyzer::typeInfer(MatchCasesAST* ast) {
 
 void
 StyioAnalyzer::typeInfer(BlockAST* ast) {
+  InferUnit unit(*this);
+  VarScope scope(*this);
+
+  for (auto stmt : ast->stmts) {
+    infer(stmt);
+  }
+
+  for (auto stmt : ast->followings) {
+    infer(stmt);
+  }
 }
 
 void
 StyioAnalyzer::typeInfer(MainBlockAST* ast) {
-  auto stmts = ast->getStmts();
-  for (auto const& s : stmts) {
-    s->typeInfer(this);
+  /* no InferUnit here: each statement is solved when it ends */
+  for (auto const& s : ast->getStmts()) {
+    infer(s);
+  }
+}
+
+/*
+  =================
+    Constraints
+  =================
+*/
+
+StyioTypeVar
+StyioAnalyzer::infer(StyioAST* ast) {
+  last_var.reset();
+  ast->typeInfer(this);
+
+  if (last_var) {
+    return *last_var;
+  }
+
+  /* nothing to infer: whatever the node says, e.g. bool for `true` */
+  StyioDataType type = ast->getDataType();
+  return unifier.fresh(type, not type.isUndefined());
+}
+
+StyioTypeVar
+StyioAnalyzer::typed_var(TypeAST* type) {
+  if (type == nullptr) {
+    return unifier.fresh();
+  }
+
+  StyioTypeVar var = unifier.fresh(type->type, /* is_fixed */ true);
+  typed_nodes.push_back({var, type});
+  return var;
+}
+
+std::optional<StyioTypeVar>
+StyioAnalyzer::lookup_var(StyioSymbol name) {
+  if (auto it = scope_index.find(name); it != scope_index.end()) {
+    return it->second;
+  }
+
+  /* a top-level name of an earlier statement keeps its solved type */
+  if (var_types.contains(name)) {
+    return unifier.fresh(StyioDataType{var_types.get(name)}, /* is_fixed */ true);
+  }
+
+  return std::nullopt;
+}
+
+void
+StyioAnalyzer::bind_var(StyioSymbol name, StyioTypeVar var) {
+  std::optional<StyioTypeVar> shadowed;
+  if (auto it = scope_index.find(name); it != scope_index.end()) {
+    shadowed = it->second;
+  }
+
+  scope_vars.push_back(ScopeVar{name, var, shadowed});
+  scope_index[name] = var;
+}
+
+void
+StyioAnalyzer::unbind_vars(size_t num_of_outer) {
+  while (scope_vars.size() > num_of_outer) {
+    ScopeVar const& entry = scope_vars.back();
+    if (entry.shadowed) {
+      scope_index[entry.name] = *entry.shadowed;
+    }
+    else {
+      scope_index.erase(entry.name);
+    }
+    scope_vars.pop_back();
+  }
+}
+
+/*
+  a: i32 = "x"  => error
+  a: i32 = 1.5  => a is i32, codegen converts 1.5
+*/
+void
+StyioAnalyzer::constrain(StyioTypeVar a, StyioTypeVar b, const char* where) {
+  if (unifier.unify(a, b)) {
+    return;
+  }
+
+  StyioDataType type_a = unifier.resolve(a);
+  StyioDataType type_b = unifier.resolve(b);
+
+  /* two written scalars, e.g. an i16 passed as i32: codegen converts them */
+  auto is_scalar = [](StyioDataType type)
+  {
+    return type == StyioDataType::Bool || type.isInteger() || type.isFloat();
+  };
+
+  if (is_scalar(type_a) && is_scalar(type_b)) {
+    return;
+  }
+
+  throw StyioTypeError(
+    std::string(where) + ": " + std::string(type_a.name()) + " does not match " + std::string(type_b.name())
+  );
+}
+
+void
+StyioAnalyzer::constrain(StyioTypeVar var, StyioDataType type, bool is_fixed, const char* where) {
+  constrain(var, unifier.fresh(type, is_fixed), where);
+}
+
+StyioTypeVar
+StyioAnalyzer::element_var(StyioAST* collection) {
+  switch (collection->getNodeType()) {
+    case StyioNodeType::List: {
+      auto list = static_cast<ListAST*>(collection);
+
+      bool is_consistent = true;
+      StyioTypeVar elem = unifier.fresh();
+      for (auto element : list->getElements()) {
+        if (not unifier.unify(elem, infer(element))) {
+          is_consistent = false;
+        }
+      }
+
+      if (is_consistent) {
+        list->setConsistency(true);
+        typed_nodes.push_back({elem, list->getDTypeObj()});
+      }
+
+      return elem;
+    } break;
+
+    case StyioNodeType::Range: {
+      auto range = static_cast<RangeAST*>(collection);
+
+      StyioTypeVar elem = unifier.fresh();
+      for (StyioAST* bound : {range->getStart(), range->getEnd(), range->getStep()}) {
+        if (bound) {
+          constrain(elem, infer(bound), "range");
+        }
+      }
+
+      return elem;
+    } break;
+
+    case StyioNodeType::Id:
+    case StyioNodeType::Variable:
+    case StyioNodeType::Param: {
+      StyioSymbol name = (collection->getNodeType() == StyioNodeType::Id)
+                           ? static_cast<NameAST*>(collection)->getSymbol()
+                           : static_cast<VarAST*>(collection)->getName()->getSymbol();
+
+      /* a list known from an earlier statement */
+      if (auto var = lookup_var(name)) {
+        StyioDataType type = unifier.resolve(*var);
+        if (type.option() == StyioDataTypeOption::List) {
+          return unifier.fresh(type.elements()[0], true);
+        }
+      }
+    } break;
+
+    default:
+      infer(collection);
+      break;
+  }
+
+  return unifier.fresh();
+}
+
+/*
+  [1, 2, 3] >> (x) => { ... }: x is the type of the elements
+*/
+void
+StyioAnalyzer::infer_iterator(IteratorAST* ast) {
+  VarScope scope(*this);
+
+  StyioTypeVar elem = element_var(ast->collection);
+
+  for (auto param : ast->params) {
+    constrain(infer(param), elem, "iterator");
+  }
+
+  for (auto stmt : ast->following) {
+    infer(stmt);
+  }
+}
+
+/*
+  # f(a: i32, b) => a + b
+
+  The parameters and the return type are variables like any other:
+  b is i32 because of a + b, and so is the result.
+*/
+void
+StyioAnalyzer::infer_func(
+  NameAST* name,
+  const std::vector<ParamAST*>& params,
+  std::variant<TypeAST*, TypeTupleAST*>& ret_type,
+  StyioAST* body,
+  bool body_is_ret_expr
+) {
+  VarScope scope(*this);
+
+  FuncSig sig;
+
+  for (auto param : params) {
+    sig.params.push_back(infer(param));
+  }
+
+  if (std::holds_alternative<TypeTupleAST*>(ret_type)) {
+    auto tuple = std::get<TypeTupleAST*>(ret_type);
+    sig.ret = unifier.fresh(tuple ? tuple->getDataType() : StyioDataType::Undefined, true);
+  }
+  else {
+    /* not written: a TypeAST to write the inferred one to */
+    if (std::get<TypeAST*>(ret_type) == nullptr) {
+      ret_type = TypeAST::Create();
+    }
+    sig.ret = typed_var(std::get<TypeAST*>(ret_type));
+  }
+
+  if (name) {
+    func_sigs.insert_or_assign(name->getSymbol(), sig);
+  }
+
+  if (body) {
+    ret_vars.push_back(sig.ret);
+
+    StyioTypeVar value = infer(body);
+    if (body_is_ret_expr) {
+      constrain(sig.ret, value, "return");
+    }
+
+    ret_vars.pop_back();
+  }
+}
+
+/*
+  Write the solution back, then start over with an empty unifier:
+  a top-level name keeps the type it was solved to, see lookup_var().
+*/
+void
+StyioAnalyzer::solve() {
+  auto concrete = [this](StyioTypeVar var)
+  {
+    StyioDataType type = unifier.resolve(var);
+    /* a literal that nothing constrained */
+    if (type == StyioDataType::Int) {
+      return StyioDataType::I64;
+    }
+    return type;
+  };
+
+  for (auto const& [var, node] : typed_nodes) {
+    StyioDataType type = concrete(var);
+    if (not type.isUndefined()) {
+      node->setType(type);
+    }
+  }
+
+  for (auto const& [var, node] : int_literals) {
+    StyioDataType type = concrete(var);
+    if (type.isInteger()) {
+      node->num_of_bit = type.num_of_bit();
+    }
+  }
+
+  for (auto const& [name, func] : func_sigs) {
+    std::vector<StyioDataType> param_types;
+    for (auto param : func.params) {
+      param_types.push_back(concrete(param));
+    }
+
+    func_types[name] = StyioDataType::getFunc(param_types, concrete(func.ret)).info;
+  }
+
+  /* what is still in scope was bound at the top level */
+  for (auto const& entry : scope_vars) {
+    var_types[entry.name] = concrete(entry.var).info;
   }
+
+  typed_nodes.clear();
+  int_literals.clear();
+  func_sigs.clear();
+  scope_vars.clear();
+  scope_index.clear();
+  ret_vars.clear();
+
+  unifier.clear();
+  last_var.reset();
 }
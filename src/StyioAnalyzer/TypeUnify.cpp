@@ -0,0 +1,129 @@
+// [C++ STL]
+#include <algorithm>
+
+// [Styio]
+#include "TypeUnify.hpp"
+
+StyioDataType
+joinTypes(StyioDataType a, StyioDataType b) {
+  if (a == b) {
+    return a;
+  }
+
+  if (a.isUndefined()) {
+    return b;
+  }
+
+  if (b.isUndefined()) {
+    return a;
+  }
+
+  /* int (literal) fits in any number */
+  if (a == StyioDataType::Int && (b.isInteger() || b.isFloat())) {
+    return b;
+  }
+
+  if (b == StyioDataType::Int && (a.isInteger() || a.isFloat())) {
+    return a;
+  }
+
+  if (a.isInteger() && b.isInteger()) {
+    return StyioDataType::getInteger(std::max(a.num_of_bit(), b.num_of_bit()));
+  }
+
+  if (a.isFloat() && b.isFloat()) {
+    return StyioDataType::getFloat(std::max(a.num_of_bit(), b.num_of_bit()));
+  }
+
+  if (a.isFloat() && b.isInteger()) {
+    return a;
+  }
+
+  if (a.isInteger() && b.isFloat()) {
+    return b;
+  }
+
+  return StyioDataType::Undefined;
+}
+
+StyioTypeVar
+StyioTypeUnifier::fresh(StyioDataType type, bool is_fixed) {
+  StyioTypeVar var = StyioTypeVar(slots.size());
+  slots.push_back(Slot{var, type, is_fixed and not type.isUndefined()});
+  return var;
+}
+
+StyioTypeVar
+StyioTypeUnifier::find(StyioTypeVar var) {
+  while (slots[var].parent != var) {
+    /* path halving */
+    slots[var].parent = slots[slots[var].parent].parent;
+    var = slots[var].parent;
+  }
+  return var;
+}
+
+bool
+StyioTypeUnifier::unify(StyioTypeVar a, StyioTypeVar b) {
+  a = find(a);
+  b = find(b);
+
+  if (a == b) {
+    return true;
+  }
+
+  Slot& sa = slots[a];
+  Slot& sb = slots[b];
+
+  StyioDataType joined;
+  if (sa.is_fixed && sb.is_fixed) {
+    if (sa.type != sb.type) {
+      return false;
+    }
+    joined = sa.type;
+  }
+  else if (sa.is_fixed) {
+    if (joinTypes(sa.type, sb.type).isUndefined() && not sb.type.isUndefined()) {
+      return false;
+    }
+    joined = sa.type;
+  }
+  else if (sb.is_fixed) {
+    if (joinTypes(sa.type, sb.type).isUndefined() && not sa.type.isUndefined()) {
+      return false;
+    }
+    joined = sb.type;
+  }
+  else {
+    joined = joinTypes(sa.type, sb.type);
+    if (joined.isUndefined() && not (sa.type.isUndefined() && sb.type.isUndefined())) {
+      return false;
+    }
+  }
+
+  /* the smaller index stays the root, it is the older variable */
+  if (b < a) {
+    std::swap(a, b);
+  }
+
+  slots[b].parent = a;
+  slots[a].type = joined;
+  slots[a].is_fixed = sa.is_fixed || sb.is_fixed;
+
+  return true;
+}
+
+bool
+StyioTypeUnifier::unify(StyioTypeVar var, StyioDataType type, bool is_fixed) {
+  return unify(var, fresh(type, is_fixed));
+}
+
+StyioDataType
+StyioTypeUnifier::resolve(StyioTypeVar var) {
+  return slots[find(var)].type;
+}
+
+bool
+StyioTypeUnifier::is_fixed(StyioTypeVar var) {
+  return slots[find(var)].is_fixed;
+}
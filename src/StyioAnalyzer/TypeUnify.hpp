@@ -0,0 +1,70 @@
+#pragma once
+#ifndef STYIO_TYPE_UNIFY_H_
+#define STYIO_TYPE_UNIFY_H_
+
+// [C++ STL]
+#include <cstdint>
+#include <vector>
+
+// [Styio]
+#include "../StyioToken/Token.hpp"
+
+/*
+  StyioTypeVar: a type that is not known yet, an index into the unifier.
+*/
+using StyioTypeVar = uint32_t;
+
+/*
+  StyioTypeUnifier: union-find over type variables.
+
+  Every variable is bound to a StyioDataType, Undefined until something
+  constrains it. A variable is *fixed* if the programmer wrote its type;
+  a fixed type is never changed by unification, the other side has to
+  fit into it. Free numeric types join to the wider of the two:
+
+    int (literal) ~ i32  => i32
+    i32 ~ i64            => i64
+    i32 ~ f32            => f32
+
+  Two fixed types that differ, or two types that do not join, are a
+  conflict: unify() returns false and both sides keep their types.
+*/
+class StyioTypeUnifier
+{
+private:
+  struct Slot
+  {
+    StyioTypeVar parent;
+    StyioDataType type;
+    bool is_fixed;
+  };
+
+  std::vector<Slot> slots;
+
+public:
+  StyioTypeVar fresh(StyioDataType type = StyioDataType::Undefined, bool is_fixed = false);
+
+  StyioTypeVar find(StyioTypeVar var);
+
+  bool unify(StyioTypeVar a, StyioTypeVar b);
+
+  /* Same as unifying with a fresh variable of `type` */
+  bool unify(StyioTypeVar var, StyioDataType type, bool is_fixed = false);
+
+  StyioDataType resolve(StyioTypeVar var);
+
+  bool is_fixed(StyioTypeVar var);
+
+  size_t size() const {
+    return slots.size();
+  }
+
+  void clear() {
+    slots.clear();
+  }
+};
+
+/* The type both `a` and `b` fit in, or Undefined if there is none */
+StyioDataType joinTypes(StyioDataType a, StyioDataType b);
+
+#endif  // STYIO_TYPE_UNIFY_H_
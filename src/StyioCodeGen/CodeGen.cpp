@@ -1,45 +1,314 @@
 // [C++ STL]
+#include <algorithm>
+#include <exception>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 // [Styio]
+#include "../StyioIR/GenIR/GenIR.hpp"
+#include "../StyioUtil/Phases.hpp"
 #include "CodeGenVisitor.hpp"
+
+// [LLVM]
+#include "llvm/Analysis/CGSCCPassManager.h"
+#include "llvm/Analysis/LoopAnalysisManager.h"
+#include "llvm/IR/PassInstrumentation.h"
+#include "llvm/IR/PassManager.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Passes/StandardInstrumentations.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
 
 void
-StyioToLLVM::print_llvm_ir() {
-  std::cout << "\033[1;32mLLVM IR\033[0m" << std::endl;
+StyioToLLVM::print_llvm_ir(std::string_view note) {
+  std::cout << "\033[1;32mLLVM IR\033[0m";
+  if (not note.empty()) {
+    std::cout << " \033[1;33m" << note << "\033[0m";
+  }
+  std::cout << std::endl;
 
   /* llvm ir -> stdout */
   theModule->print(llvm::outs(), nullptr);
   /* llvm ir -> stderr */
   // llvm_module -> print(llvm::errs(), nullptr);
 
+  for (auto const& partition : partitions) {
+    partition->theModule->print(llvm::outs(), nullptr);
+  }
+
   std::cout << std::endl;
 }
 
+size_t
+StyioToLLVM::num_of_instructions() const {
+  size_t count = 0;
+  for (auto const& func : *theModule) {
+    count += func.getInstructionCount();
+  }
+  for (auto const& partition : partitions) {
+    count += partition->num_of_instructions();
+  }
+  return count;
+}
+
+std::vector<const llvm::Module*>
+StyioToLLVM::get_modules() const {
+  std::vector<const llvm::Module*> modules = {theModule.get()};
+  for (auto const& partition : partitions) {
+    modules.push_back(partition->theModule.get());
+  }
+  return modules;
+}
+
+bool
+StyioToLLVM::verify_module() {
+  /* true if broken */
+  bool is_broken = llvm::verifyModule(*theModule, &llvm::errs());
+  for (auto const& partition : partitions) {
+    is_broken |= llvm::verifyModule(*partition->theModule, &llvm::errs());
+  }
+  return not is_broken;
+}
+
+/* Call `work(i)` for i < n on n threads (this one too), then rethrow the first exception */
+static void
+run_in_parallel(size_t n, const std::function<void(size_t)>& work) {
+  std::vector<std::exception_ptr> errors(n);
+  auto guarded = [&](size_t i) {
+    try {
+      work(i);
+    }
+    catch (...) {
+      errors[i] = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < n; i++) {
+    workers.emplace_back(guarded, i);
+  }
+
+  guarded(0);
+
+  for (auto& w : workers) {
+    w.join();
+  }
+
+  for (auto const& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
 void
-StyioToLLVM::execute() {
-  std::cout << "\033[1;32mJIT\033[0m" << std::endl;
+StyioToLLVM::lower_in_parallel(StyioIR* program, size_t num_of_modules) {
+  auto entry = dynamic_cast<SGMainEntry*>(program);
+  if (entry == nullptr || num_of_modules <= 1) {
+    program->toLLVMIR(this);
+    return;
+  }
+
+  std::vector<SGFunc*> funcs;
+  std::vector<StyioIR*> main_stmts;
+  for (auto stmt : entry->stmts) {
+    if (auto func = dynamic_cast<SGFunc*>(stmt)) {
+      funcs.push_back(func);
+    }
+    else {
+      main_stmts.push_back(stmt);
+    }
+  }
+
+  num_of_modules = std::min(num_of_modules, funcs.size() + 1);
+
+  for (size_t m = 1; m < num_of_modules; m++) {
+    partitions.emplace_back(new StyioToLLVM(
+      theModule->getDataLayout(),
+      llvm::Triple(theModule->getTargetTriple()),
+      "styio." + std::to_string(m)
+    ));
+  }
+
+  run_in_parallel(num_of_modules, [&](size_t m) {
+    StyioToLLVM& generator = (m == 0) ? *this : *partitions[m - 1];
+
+    for (auto func : funcs) {
+      generator.declare_func(func);
+    }
+
+    for (size_t i = m; i < funcs.size(); i += num_of_modules) {
+      funcs[i]->toLLVMIR(&generator);
+    }
+
+    /* every function is declared in front of main, wherever it is defined */
+    if (m == 0) {
+      /* its own owner: an outer scope of this thread would adopt it otherwise */
+      StyioIRNodes main_nodes;
+      SGMainEntry* main_entry = nullptr;
+      {
+        StyioIRNodes::Scope scope(main_nodes);
+        main_entry = SGMainEntry::Create(main_stmts);
+      }
+      main_entry->toLLVMIR(&generator);
+    }
+  });
+}
+
+/*
+  The same pipelines as `clang -O1` .. `-O3`, so mem2reg (SROA), inlining,
+  loop and vector passes all come with them. The target machine of the
+  JIT gives the cost models, without it nothing would be vectorized.
+*/
+void
+StyioToLLVM::optimize(llvm::OptimizationLevel level) {
+  run_in_parallel(partitions.size() + 1, [&](size_t m) {
+    llvm::Module& module = (m == 0) ? *theModule : *partitions[m - 1]->theModule;
+    optimize_module(module, level, theORCJIT->getTargetMachineBuilder());
+  });
+}
+
+void
+StyioToLLVM::optimize_module(
+  llvm::Module& module,
+  llvm::OptimizationLevel level,
+  llvm::orc::JITTargetMachineBuilder JTMB
+) {
+  if (level == llvm::OptimizationLevel::O0) {
+    return;
+  }
+
+  std::unique_ptr<llvm::TargetMachine> target_machine;
+  if (auto created = JTMB.createTargetMachine()) {
+    target_machine = std::move(*created);
+  }
+  else {
+    /* still optimize, only without the target's cost models */
+    llvm::consumeError(created.takeError());
+  }
 
-  auto RT = theORCJIT->getMainJITDylib().createResourceTracker();
-  auto TSM = llvm::orc::ThreadSafeModule(std::move(theModule), std::move(theContext));
+  llvm::LoopAnalysisManager LAM;
+  llvm::FunctionAnalysisManager FAM;
+  llvm::CGSCCAnalysisManager CGAM;
+  llvm::ModuleAnalysisManager MAM;
+
+  llvm::PassInstrumentationCallbacks PIC;
+  llvm::StandardInstrumentations SI(module.getContext(), /* DebugLogging */ false);
+  SI.registerCallbacks(PIC, &MAM);
+
+  llvm::PassBuilder PB(target_machine.get(), llvm::PipelineTuningOptions(), std::nullopt, &PIC);
+
+  PB.registerModuleAnalyses(MAM);
+  PB.registerCGSCCAnalyses(CGAM);
+  PB.registerFunctionAnalyses(FAM);
+  PB.registerLoopAnalyses(LAM);
+  PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+  llvm::ModulePassManager MPM = PB.buildPerModuleDefaultPipeline(level);
+  MPM.run(module, MAM);
+}
+
+void
+StyioToLLVM::set_cache_key(const std::string& key) {
+  theModule->setModuleIdentifier(key);
+}
+
+void
+StyioToLLVM::load_object(std::unique_ptr<llvm::MemoryBuffer> object) {
   llvm::ExitOnError exit_on_error;
-  exit_on_error(theORCJIT->addModule(std::move(TSM), RT));
+  exit_on_error(theORCJIT->addObject(std::move(object)));
+  theModule.reset();
+}
+
+void*
+StyioToLLVM::jit_main() {
+  if (theModule) {
+    for (auto const& func : *theModule) {
+      num_of_functions += func.isDeclaration() ? 0 : 1;
+    }
+    for (auto const& partition : partitions) {
+      for (auto const& func : *partition->theModule) {
+        num_of_functions += func.isDeclaration() ? 0 : 1;
+      }
+    }
+
+    StyioPhase add_module_phase("jit-add-module");
+    auto TSM = llvm::orc::ThreadSafeModule(std::move(theModule), std::move(theContext));
+    llvm::ExitOnError exit_on_error;
+    if (theTiers) {
+      /* tier 0, with the counters and stubs */
+      exit_on_error(theTiers->add_module(std::move(TSM)));
+    }
+    else {
+      auto RT = theORCJIT->getMainJITDylib().createResourceTracker();
+      exit_on_error(theORCJIT->addModule(std::move(TSM), RT));
+
+      /* compiled on the threads of the JIT, as main looks them up */
+      for (auto& partition : partitions) {
+        exit_on_error(theORCJIT->addModule(
+          llvm::orc::ThreadSafeModule(std::move(partition->theModule), std::move(partition->theContext)), RT
+        ));
+      }
+      partitions.clear();
+    }
+    add_module_phase.end();
+  }
 
-  // Look up the JIT'd code entry point.
+  // Look up the JIT'd code entry point, which compiles the module.
+  StyioPhase materialize_phase("jit-materialize");
   auto ExprSymbol = theORCJIT->lookup("main");
+  materialize_phase.count("functions", theORCJIT->getNumOfMaterializedFunctions());
+  materialize_phase.end();
+
   if (!ExprSymbol) {
+    llvm::consumeError(ExprSymbol.takeError());
+    return nullptr;
+  }
+
+  return ExprSymbol->getAddress().toPtr<void*>();
+}
+
+void
+StyioToLLVM::execute() {
+  std::cout << "\033[1;32mJIT\033[0m" << std::endl;
+
+  void* main_addr = jit_main();
+  if (main_addr == nullptr) {
     std::cout << "main not found" << std::endl;
     return;
-  } 
+  }
   else {
     std::cout << "main found" << std::endl;
   }
 
   // Cast the entry point address to a function pointer.
-  int (*FP)() = ExprSymbol->getAddress().toPtr<int (*)()>();
+  int (*FP)() = reinterpret_cast<int (*)()>(main_addr);
 
   // Call into JIT'd code.
-  std::cout << "result: " << FP() << std::endl;
+  StyioPhase execute_phase("execute");
+  size_t num_of_materialized = theORCJIT->getNumOfMaterializedFunctions();
+  int result = FP();
+  /* lazily compiled on their first call */
+  execute_phase.count("functions", theORCJIT->getNumOfMaterializedFunctions() - num_of_materialized);
+  if (theTiers) {
+    /* so far, the background thread may still be at it */
+    execute_phase.count("tier-ups", theTiers->get_num_of_tier_ups());
+  }
+  execute_phase.end();
+
+  std::cout << "result: " << result << std::endl;
+
+  if (theORCJIT->isLazy() && num_of_functions > 0) {
+    std::cout
+      << "functions compiled: " << theORCJIT->getNumOfMaterializedFunctions()
+      << " of " << num_of_functions << std::endl;
+  }
 }
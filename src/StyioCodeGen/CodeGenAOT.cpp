@@ -0,0 +1,127 @@
+// [C++ STL]
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// [Styio]
+#include "CodeGenVisitor.hpp"
+
+// [LLVM]
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+
+#ifndef STYIO_RUNTIME_LIB
+#define STYIO_RUNTIME_LIB "libstyio_extern.a"
+#endif
+
+/*
+  Ahead of time: the module as it would be JIT-compiled, written for the
+  target of the JIT, but position independent, as executables are PIE by
+  default. The codegen passes change the module they run on, so each
+  output is emitted from a copy of it.
+*/
+bool
+StyioToLLVM::emit_native(const std::string& path, llvm::CodeGenFileType file_type) {
+  llvm::orc::JITTargetMachineBuilder JTMB = theORCJIT->getTargetMachineBuilder();
+  JTMB.setRelocationModel(llvm::Reloc::PIC_);
+
+  auto target_machine = JTMB.createTargetMachine();
+  if (not target_machine) {
+    llvm::errs() << "styio: " << llvm::toString(target_machine.takeError()) << "\n";
+    return false;
+  }
+
+  std::error_code ec;
+  llvm::raw_fd_ostream out(path, ec, llvm::sys::fs::OF_None);
+  if (ec) {
+    llvm::errs() << "styio: cannot write " << path << ": " << ec.message() << "\n";
+    return false;
+  }
+
+  llvm::legacy::PassManager PM;
+  if ((*target_machine)->addPassesToEmitFile(PM, out, nullptr, file_type)) {
+    llvm::errs() << "styio: the target cannot emit this kind of file\n";
+    return false;
+  }
+
+  std::unique_ptr<llvm::Module> module = llvm::CloneModule(*theModule);
+  PM.run(*module);
+  out.flush();
+
+  return true;
+}
+
+bool
+StyioToLLVM::emit_bitcode(const std::string& path) {
+  std::error_code ec;
+  llvm::raw_fd_ostream out(path, ec, llvm::sys::fs::OF_None);
+  if (ec) {
+    llvm::errs() << "styio: cannot write " << path << ": " << ec.message() << "\n";
+    return false;
+  }
+
+  llvm::WriteBitcodeToFile(*theModule, out);
+  out.flush();
+
+  return true;
+}
+
+/*
+  The runtime (StyioExtern) is C++, so the C++ compiler driver links:
+  $CXX, else c++. $STYIO_RUNTIME_LIB replaces the static runtime that
+  was built with this compiler.
+*/
+bool
+StyioToLLVM::emit_executable(const std::string& path) {
+  llvm::SmallString<128> object_path;
+  if (auto ec = llvm::sys::fs::createTemporaryFile("styio", "o", object_path)) {
+    llvm::errs() << "styio: cannot create a temporary file: " << ec.message() << "\n";
+    return false;
+  }
+
+  if (not emit_native(std::string(object_path), llvm::CodeGenFileType::ObjectFile)) {
+    llvm::sys::fs::remove(object_path);
+    return false;
+  }
+
+  const char* cxx = std::getenv("CXX");
+  auto linker = llvm::sys::findProgramByName(cxx ? cxx : "c++");
+  if (not linker) {
+    llvm::errs() << "styio: no linker found (" << (cxx ? cxx : "c++") << "), set $CXX\n";
+    llvm::sys::fs::remove(object_path);
+    return false;
+  }
+
+  const char* runtime = std::getenv("STYIO_RUNTIME_LIB");
+  std::vector<llvm::StringRef> args = {
+    *linker,
+    object_path,
+    runtime ? runtime : STYIO_RUNTIME_LIB,
+    "-o",
+    path,
+  };
+
+  std::string error;
+  int status = llvm::sys::ExecuteAndWait(*linker, args, std::nullopt, {}, 0, 0, &error);
+  llvm::sys::fs::remove(object_path);
+
+  if (status != 0) {
+    llvm::errs() << "styio: linking " << path << " failed";
+    if (not error.empty()) {
+      llvm::errs() << ": " << error;
+    }
+    llvm::errs() << "\n";
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,153 @@
+// [C++ STL]
+#include <string>
+#include <vector>
+
+// [Styio]
+#include "../StyioIR/FlatIR/FlatIR.hpp"
+#include "CodeGenVisitor.hpp"
+
+// [LLVM]
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+
+/*
+  The flat IR gives the same instructions as the StyioIR visitor in
+  CodeGenG.cpp: what is more than a leaf is lowered by the same emit_*
+  helpers there, only the walk over the nodes differs.
+*/
+llvm::Value*
+StyioToLLVM::toLLVMIR(const StyioFlatIR& ir) {
+  if (ir.root == StyioFlatNone) {
+    return theBuilder->getInt64(0);
+  }
+
+  return flat_to_llvm_ir(ir, ir.root);
+}
+
+llvm::Value*
+StyioToLLVM::flat_to_llvm_ir(const StyioFlatIR& ir, StyioFlatRef ref) {
+  const StyioFlatNode& node = ir[ref];
+
+  switch (node.kind) {
+    case StyioFlatKind::ResId: {
+      if (named_values.contains(node.symbol)) {
+        return named_values.get(node.symbol);
+      }
+
+      if (mutable_variables.contains(node.symbol)) {
+        llvm::AllocaInst* variable = mutable_variables.get(node.symbol);
+        return theBuilder->CreateLoad(variable->getAllocatedType(), variable);
+      }
+
+      return theBuilder->getInt64(0);
+    }
+
+    case StyioFlatKind::ConstBool:
+      return llvm::ConstantInt::getBool(*theContext, node.int_value != 0);
+
+    case StyioFlatKind::ConstInt: {
+      auto type = llvm::cast<llvm::IntegerType>(get_llvm_type(StyioDataType::getInteger(node.num_of_bit)));
+      return llvm::ConstantInt::get(type, node.int_value, /* isSigned */ true);
+    }
+
+    case StyioFlatKind::ConstBigInt: {
+      auto type = llvm::cast<llvm::IntegerType>(get_llvm_type(StyioDataType::getInteger(node.num_of_bit)));
+      return llvm::ConstantInt::get(type, ir.texts[node.a], /* radix */ 10);
+    }
+
+    case StyioFlatKind::ConstFloat:
+      return llvm::ConstantFP::get(get_llvm_type(StyioDataType::getFloat(node.num_of_bit)), node.float_value);
+
+    case StyioFlatKind::ConstChar:
+      return theBuilder->getInt8(uint8_t(node.int_value));
+
+    case StyioFlatKind::ConstString:
+      return llvm::ConstantDataArray::getString(*theContext, ir.texts[node.a], /* AddNull */ true);
+
+    case StyioFlatKind::BinOp: {
+      llvm::Value* l_val = flat_to_llvm_ir(ir, node.a);
+      llvm::Value* r_val = flat_to_llvm_ir(ir, node.b);
+      return emit_binop(node.getOp(), node.getType(), l_val, r_val);
+    }
+
+    case StyioFlatKind::Cond: {
+      llvm::Value* l_val = flat_to_llvm_ir(ir, node.a);
+      llvm::Value* r_val = node.b == StyioFlatNone ? nullptr : flat_to_llvm_ir(ir, node.b);
+      return emit_cond(node.getOp(), l_val, r_val);
+    }
+
+    case StyioFlatKind::FlexBind:
+      return emit_flex_bind(node.symbol, get_llvm_type(node.getType()), [&]() {
+        return flat_to_llvm_ir(ir, node.a);
+      });
+
+    case StyioFlatKind::FinalBind:
+      return emit_final_bind(node.symbol, get_llvm_type(node.getType()), [&]() {
+        return flat_to_llvm_ir(ir, node.a);
+      });
+
+    case StyioFlatKind::Func:
+      return flat_func_to_llvm_ir(ir, node);
+
+    case StyioFlatKind::Call: {
+      auto args = ir.list(node.b);
+      return emit_call(node.symbol, args.size(), [&](size_t i) {
+        return flat_to_llvm_ir(ir, args[i]);
+      });
+    }
+
+    case StyioFlatKind::Return:
+      return emit_return(flat_to_llvm_ir(ir, node.a));
+
+    case StyioFlatKind::Block: {
+      for (StyioFlatRef stmt : ir.list(node.b)) {
+        flat_to_llvm_ir(ir, stmt);
+      }
+
+      return theBuilder->getInt64(0);
+    }
+
+    case StyioFlatKind::MainEntry:
+      return emit_main([&]() {
+        for (StyioFlatRef stmt : ir.list(node.b)) {
+          flat_to_llvm_ir(ir, stmt);
+        }
+      });
+
+    case StyioFlatKind::FuncArg:
+    case StyioFlatKind::Unsupported:
+      break;
+  }
+
+  return theBuilder->getInt64(0);
+}
+
+llvm::Value*
+StyioToLLVM::flat_func_to_llvm_ir(const StyioFlatIR& ir, const StyioFlatNode& node) {
+  std::vector<llvm::Type*> llvm_func_args;
+  std::vector<StyioSymbol> arg_names;
+  for (StyioFlatRef arg : ir.list(node.b)) {
+    llvm_func_args.push_back(get_llvm_type(ir[arg].getType()));
+    arg_names.push_back(ir[arg].symbol);
+  }
+
+  llvm::Function* llvm_func =
+    llvm::Function::Create(
+      llvm::FunctionType::get(
+        /* Result (Type) */ get_llvm_type(node.getType()),
+        /* Params (Type) */ llvm_func_args,
+        /* isVarArg */ false
+      ),
+      llvm::GlobalValue::ExternalLinkage,
+      StyioSymbolTable::name_of(node.symbol),
+      *theModule
+    );
+
+  return emit_func(llvm_func, arg_names, [&]() {
+    flat_to_llvm_ir(ir, node.a);
+  });
+}
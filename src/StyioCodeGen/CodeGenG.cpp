@@ -1,6 +1,7 @@
 // [C++ STL]
 #include <cstdio>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <optional>
@@ -50,16 +51,47 @@
 #include "llvm/Transforms/Scalar/SimplifyCFG.h"
 #include "llvm/Transforms/Utils.h"
 
+/*
+  Integers are signed: a wider integer is sign-extended, a narrower one
+  truncated. Anything that is not a number is returned as it is.
+*/
+llvm::Value*
+StyioToLLVM::coerce(llvm::Value* value, llvm::Type* type) {
+  llvm::Type* from = value->getType();
+
+  if (from == type) {
+    return value;
+  }
+
+  if (from->isIntegerTy() && type->isIntegerTy()) {
+    return theBuilder->CreateSExtOrTrunc(value, type);
+  }
+
+  if (from->isIntegerTy() && type->isFloatingPointTy()) {
+    return theBuilder->CreateSIToFP(value, type);
+  }
+
+  if (from->isFloatingPointTy() && type->isIntegerTy()) {
+    return theBuilder->CreateFPToSI(value, type);
+  }
+
+  if (from->isFloatingPointTy() && type->isFloatingPointTy()) {
+    return theBuilder->CreateFPCast(value, type);
+  }
+
+  return value;
+}
+
 llvm::Value*
 StyioToLLVM::toLLVMIR(SGResId* node) {
-  const string& name = node->as_str();
+  StyioSymbol name = node->symbol();
 
   if (named_values.contains(name)) {
-    return named_values[name];
+    return named_values.get(name);
   }
 
   if (mutable_variables.contains(name)) {
-    llvm::AllocaInst* variable = mutable_variables[name];
+    llvm::AllocaInst* variable = mutable_variables.get(name);
     return theBuilder->CreateLoad(variable->getAllocatedType(), variable);
   }
 
@@ -78,12 +110,23 @@ StyioToLLVM::toLLVMIR(SGConstBool* node) {
 
 llvm::Value*
 StyioToLLVM::toLLVMIR(SGConstInt* node) {
-  return theBuilder->getInt64(std::stol(node->value));
+  auto type = llvm::cast<llvm::IntegerType>(node->toLLVMType(this));
+
+  if (node->canonical) {
+    return llvm::ConstantInt::get(type, *node->canonical, /* isSigned */ true);
+  }
+
+  /* not canonicalized, or wider than 64 bits */
+  return llvm::ConstantInt::get(type, node->value, /* radix */ 10);
 }
 
 llvm::Value*
 StyioToLLVM::toLLVMIR(SGConstFloat* node) {
-  return llvm::ConstantFP::get(*theContext, llvm::APFloat(std::stod(node->value)));
+  if (node->canonical) {
+    return llvm::ConstantFP::get(node->toLLVMType(this), *node->canonical);
+  }
+
+  return llvm::ConstantFP::get(node->toLLVMType(this), node->value);
 }
 
 llvm::Value*
@@ -116,11 +159,30 @@ StyioToLLVM::toLLVMIR(SGCast* node) {
 
 llvm::Value*
 StyioToLLVM::toLLVMIR(SGBinOp* node) {
-  StyioDataType data_type = node->data_type->data_type;
   llvm::Value* l_val = node->lhs_expr->toLLVMIR(this);
   llvm::Value* r_val = node->rhs_expr->toLLVMIR(this);
+  return emit_binop(node->operand, node->data_type->data_type, l_val, r_val);
+}
+
+llvm::Value*
+StyioToLLVM::emit_binop(StyioOpType op, StyioDataType data_type, llvm::Value* l_val, llvm::Value* r_val) {
+
+  /* not inferred: whatever the left operand is */
+  if (data_type.isUndefined()) {
+    if (l_val->getType()->isFloatingPointTy()) {
+      data_type = StyioDataType::getFloat(l_val->getType()->getPrimitiveSizeInBits());
+    }
+    else {
+      data_type = StyioDataType::getInteger(l_val->getType()->getPrimitiveSizeInBits());
+    }
+  }
 
-  switch (node->operand) {
+  /* operands in the width of the result, e.g. 1 (i64 literal) in a + 1 on i32 */
+  llvm::Type* llvm_type = get_llvm_type(data_type);
+  l_val = coerce(l_val, llvm_type);
+  r_val = coerce(r_val, llvm_type);
+
+  switch (op) {
     case StyioOpType::Binary_Add: {
       if (data_type.isInteger()) {
         return theBuilder->CreateAdd(l_val, r_val);
@@ -185,8 +247,83 @@ StyioToLLVM::toLLVMIR(SGBinOp* node) {
 
 llvm::Value*
 StyioToLLVM::toLLVMIR(SGCond* node) {
-  auto output = theBuilder->getInt32(0);
-  return output;
+  llvm::Value* l_val = node->lhs_expr->toLLVMIR(this);
+  llvm::Value* r_val = node->rhs_expr ? node->rhs_expr->toLLVMIR(this) : nullptr;
+  return emit_cond(node->operand, l_val, r_val);
+}
+
+llvm::Value*
+StyioToLLVM::emit_cond(StyioOpType op, llvm::Value* l_val, llvm::Value* r_val) {
+  if (op == StyioOpType::Logic_NOT) {
+    return theBuilder->CreateNot(coerce(l_val, theBuilder->getInt1Ty()));
+  }
+
+  switch (op) {
+    case StyioOpType::Logic_AND:
+      return theBuilder->CreateAnd(coerce(l_val, theBuilder->getInt1Ty()), coerce(r_val, theBuilder->getInt1Ty()));
+
+    case StyioOpType::Logic_OR:
+      return theBuilder->CreateOr(coerce(l_val, theBuilder->getInt1Ty()), coerce(r_val, theBuilder->getInt1Ty()));
+
+    case StyioOpType::Logic_XOR:
+      return theBuilder->CreateXor(coerce(l_val, theBuilder->getInt1Ty()), coerce(r_val, theBuilder->getInt1Ty()));
+
+    default:
+      break;
+  }
+
+  /* compare in the wider of both, floats if either is one */
+  llvm::Type* l_type = l_val->getType();
+  llvm::Type* r_type = r_val->getType();
+  llvm::Type* type;
+  if (l_type->isFloatingPointTy() || r_type->isFloatingPointTy()) {
+    type = theBuilder->getDoubleTy();
+  }
+  else {
+    type = l_type->getPrimitiveSizeInBits() < r_type->getPrimitiveSizeInBits() ? r_type : l_type;
+  }
+
+  l_val = coerce(l_val, type);
+  r_val = coerce(r_val, type);
+
+  if (type->isFloatingPointTy()) {
+    switch (op) {
+      case StyioOpType::Equal:
+        return theBuilder->CreateFCmpOEQ(l_val, r_val);
+      case StyioOpType::Not_Equal:
+        return theBuilder->CreateFCmpONE(l_val, r_val);
+      case StyioOpType::Greater_Than:
+        return theBuilder->CreateFCmpOGT(l_val, r_val);
+      case StyioOpType::Greater_Than_Equal:
+        return theBuilder->CreateFCmpOGE(l_val, r_val);
+      case StyioOpType::Less_Than:
+        return theBuilder->CreateFCmpOLT(l_val, r_val);
+      case StyioOpType::Less_Than_Equal:
+        return theBuilder->CreateFCmpOLE(l_val, r_val);
+      default:
+        break;
+    }
+  }
+  else {
+    switch (op) {
+      case StyioOpType::Equal:
+        return theBuilder->CreateICmpEQ(l_val, r_val);
+      case StyioOpType::Not_Equal:
+        return theBuilder->CreateICmpNE(l_val, r_val);
+      case StyioOpType::Greater_Than:
+        return theBuilder->CreateICmpSGT(l_val, r_val);
+      case StyioOpType::Greater_Than_Equal:
+        return theBuilder->CreateICmpSGE(l_val, r_val);
+      case StyioOpType::Less_Than:
+        return theBuilder->CreateICmpSLT(l_val, r_val);
+      case StyioOpType::Less_Than_Equal:
+        return theBuilder->CreateICmpSLE(l_val, r_val);
+      default:
+        break;
+    }
+  }
+
+  return theBuilder->getFalse();
 }
 
 llvm::Value*
@@ -205,32 +342,26 @@ StyioToLLVM::toLLVMIR(SGVar* node) {
 */
 llvm::Value*
 StyioToLLVM::toLLVMIR(SGFlexBind* node) {
-  std::string varname = node->var->var_name->as_str();
-  llvm::AllocaInst* variable;
+  return emit_flex_bind(node->var->var_name->symbol(), node->toLLVMType(this), [&]() {
+    return node->value->toLLVMIR(this);
+  });
+}
 
+llvm::AllocaInst*
+StyioToLLVM::emit_flex_bind(StyioSymbol varname, llvm::Type* type, const std::function<llvm::Value*()>& value) {
   if (named_values.contains(varname)) {
     /* ERROR */
     throw StyioNotImplemented("if a immutable variable is re-defined ...");
   }
 
   if (mutable_variables.contains(varname)) {
-    variable = mutable_variables[varname];
-  }
-  else {
-    variable = theBuilder->CreateAlloca(
-      node->toLLVMType(this),
-      nullptr,
-      varname.c_str()
-    );
-
-    theBuilder->CreateStore(
-      node->value->toLLVMIR(this),
-      variable
-    );
-
-    mutable_variables[varname] = variable;
+    return mutable_variables.get(varname);
   }
 
+  llvm::AllocaInst* variable = theBuilder->CreateAlloca(type, nullptr, StyioSymbolTable::name_of(varname));
+  theBuilder->CreateStore(coerce(value(), type), variable);
+
+  mutable_variables[varname] = variable;
   return variable;
 }
 
@@ -240,23 +371,24 @@ StyioToLLVM::toLLVMIR(SGFlexBind* node) {
 */
 llvm::Value*
 StyioToLLVM::toLLVMIR(SGFinalBind* node) {
-  std::string varname = node->var->var_name->as_str();
+  return emit_final_bind(node->var->var_name->symbol(), node->toLLVMType(this), [&]() {
+    return node->value->toLLVMIR(this);
+  });
+}
+
+llvm::AllocaInst*
+StyioToLLVM::emit_final_bind(StyioSymbol varname, llvm::Type* type, const std::function<llvm::Value*()>& value) {
   if (named_values.contains(varname)) {
     /* ERROR */
     throw StyioNotImplemented("if a immutable variable is re-defined ...");
   }
 
-  llvm::AllocaInst* variable = theBuilder->CreateAlloca(
-    node->toLLVMType(this),
-    nullptr,
-    varname.c_str()
-  );
-
-  auto value = node->value->toLLVMIR(this);
-  named_values[varname] = value;
+  llvm::AllocaInst* variable = theBuilder->CreateAlloca(type, nullptr, StyioSymbolTable::name_of(varname));
 
-  theBuilder->CreateStore(value, variable);
+  auto coerced = coerce(value(), type);
+  named_values[varname] = coerced;
 
+  theBuilder->CreateStore(coerced, variable);
   return variable;
 }
 
@@ -265,98 +397,112 @@ StyioToLLVM::toLLVMIR(SGFuncArg* node) {
   return theBuilder->getInt64(0);
 }
 
+llvm::Function*
+StyioToLLVM::declare_func(SGFunc* node) {
+  std::vector<llvm::Type*> llvm_func_args;
+  for (auto& arg : node->func_args) {
+    llvm_func_args.push_back(arg->toLLVMType(this));
+  }
+
+  return llvm::Function::Create(
+    llvm::FunctionType::get(
+      /* Result (Type) */ node->ret_type->toLLVMType(this),
+      /* Params (Type) */ llvm_func_args,
+      /* isVarArg */ false
+    ),
+    llvm::GlobalValue::ExternalLinkage,
+    node->func_name->as_str(),
+    *theModule
+  );
+}
+
 llvm::Value*
 StyioToLLVM::toLLVMIR(SGFunc* node) {
-  auto latest_insert_point = theBuilder->saveIP();
+  /* declared already when the functions were split into modules */
+  llvm::Function* llvm_func = theModule->getFunction(node->func_name->as_str());
+  if (llvm_func == nullptr || not llvm_func->isDeclaration()) {
+    llvm_func = declare_func(node);
+  }
 
-  std::string fname = node->func_name->as_str();
+  std::vector<StyioSymbol> arg_names;
+  for (auto const& arg : node->func_args) {
+    arg_names.push_back(StyioSymbolTable::intern(arg->id));
+  }
 
-  if (node->func_args.empty()) {
-    llvm::Function* llvm_func = llvm::Function::Create(
-      llvm::FunctionType::get(
-        /* Result (Type) */ node->ret_type->toLLVMType(this),
-        /* isVarArg */ false
-      ),
-      llvm::GlobalValue::ExternalLinkage,
-      fname,
-      *theModule
-    );
+  return emit_func(llvm_func, arg_names, [&]() {
+    node->func_block->toLLVMIR(this);
+  });
+}
 
-    llvm::BasicBlock* llvm_basic_block = llvm::BasicBlock::Create(
-      *theContext,
-      (fname + "_entry"),
-      llvm_func
-    );
+llvm::Function*
+StyioToLLVM::emit_func(llvm::Function* llvm_func, const std::vector<StyioSymbol>& arg_names, const std::function<void()>& body) {
+  auto latest_insert_point = theBuilder->saveIP();
 
-    theBuilder->SetInsertPoint(llvm_basic_block);
+  llvm::BasicBlock* block = llvm::BasicBlock::Create(
+    *theContext,
+    (llvm_func->getName().str() + "_entry"),
+    llvm_func
+  );
 
-    node->func_block->toLLVMIR(this);
-  }
-  else {
-    std::vector<llvm::Type*> llvm_func_args;
-    for (auto& arg : node->func_args) {
-      llvm_func_args.push_back(arg->toLLVMType(this));
-    }
+  theBuilder->SetInsertPoint(block);
 
-    llvm::Function* llvm_func =
-      llvm::Function::Create(
-        llvm::FunctionType::get(
-          /* Result (Type) */ node->ret_type->toLLVMType(this),
-          /* Params (Type) */ llvm_func_args,
-          /* isVarArg */ false
-        ),
-        llvm::GlobalValue::ExternalLinkage,
-        fname,
-        *theModule
-      );
-
-    for (size_t i = 0; i < llvm_func->arg_size(); i++) {
-      llvm_func->getArg(i)->setName(node->func_args[i]->id);
-    }
+  /* The names of the caller are not visible in the function */
+  auto outer_named_values = std::move(named_values);
+  auto outer_mutable_variables = std::move(mutable_variables);
+  named_values.clear();
+  mutable_variables.clear();
 
-    llvm::BasicBlock* block = llvm::BasicBlock::Create(
-      *theContext,
-      (fname + "_entry"),
-      llvm_func
-    );
+  for (size_t i = 0; i < llvm_func->arg_size(); i++) {
+    llvm_func->getArg(i)->setName(StyioSymbolTable::name_of(arg_names[i]));
+    named_values[arg_names[i]] = llvm_func->getArg(i);
+  }
 
-    theBuilder->SetInsertPoint(block);
+  body();
 
-    /* Initialize Arguments */
-    // for (auto& arg : llvm_func->args()) {
-    //   llvm::AllocaInst* alloca_inst = theBuilder->CreateAlloca(
-    //     llvm::Type::getInt32Ty(*theContext),
-    //     nullptr,
-    //     arg.getName()
-    //   );
+  /* fell off the end */
+  if (theBuilder->GetInsertBlock()->getTerminator() == nullptr) {
+    theBuilder->CreateRet(llvm::Constant::getNullValue(llvm_func->getReturnType()));
+  }
 
-    //   auto init_val = theBuilder->getInt32(0);
+  named_values = std::move(outer_named_values);
+  mutable_variables = std::move(outer_mutable_variables);
 
-    //   theBuilder->CreateStore(&arg, alloca_inst);
+  theBuilder->restoreIP(latest_insert_point);
 
-    //   // mut_vars[std::string(arg.getName())] = alloca_inst;
-    // }
+  return llvm_func;
+}
 
-    node->func_block->toLLVMIR(this);
+llvm::Value*
+StyioToLLVM::toLLVMIR(SGCall* node) {
+  return emit_call(node->func_name->symbol(), node->func_args.size(), [&](size_t i) {
+    return node->func_args[i]->toLLVMIR(this);
+  });
+}
 
-    // for (auto& arg : llvm_func->args()) {
-    //   mut_vars.erase(std::string(arg.getName()));
-    // }
+llvm::Value*
+StyioToLLVM::emit_call(StyioSymbol name, size_t num_of_args, const std::function<llvm::Value*(size_t)>& arg) {
+  llvm::Function* callee = theModule->getFunction(StyioSymbolTable::name_of(name));
+  if (callee == nullptr || callee->arg_size() != num_of_args) {
+    return theBuilder->getInt64(0);
   }
 
-  theBuilder->restoreIP(latest_insert_point);
+  std::vector<llvm::Value*> args;
+  for (size_t i = 0; i < num_of_args; i++) {
+    args.push_back(coerce(arg(i), callee->getArg(i)->getType()));
+  }
 
-  return theBuilder->getInt64(0);
+  return theBuilder->CreateCall(callee, args);
 }
 
 llvm::Value*
-StyioToLLVM::toLLVMIR(SGCall* node) {
-  return theBuilder->getInt64(0);
+StyioToLLVM::toLLVMIR(SGReturn* node) {
+  return emit_return(node->expr->toLLVMIR(this));
 }
 
 llvm::Value*
-StyioToLLVM::toLLVMIR(SGReturn* node) {
-  return theBuilder->CreateRet(node->expr->toLLVMIR(this));
+StyioToLLVM::emit_return(llvm::Value* value) {
+  llvm::Type* ret_type = theBuilder->GetInsertBlock()->getParent()->getReturnType();
+  return theBuilder->CreateRet(coerce(value, ret_type));
 }
 
 llvm::Value*
@@ -375,6 +521,15 @@ StyioToLLVM::toLLVMIR(SGEntry* node) {
 
 llvm::Value*
 StyioToLLVM::toLLVMIR(SGMainEntry* node) {
+  return emit_main([&]() {
+    for (auto const& s : node->stmts) {
+      s->toLLVMIR(this);
+    }
+  });
+}
+
+llvm::Function*
+StyioToLLVM::emit_main(const std::function<void()>& stmts) {
   /*
     Get Void Type: llvm::Type::getVoidTy(*llvm_context)
     Use Void Type: nullptr
@@ -390,13 +545,12 @@ StyioToLLVM::toLLVMIR(SGMainEntry* node) {
   /* Add statements to the current basic block */
   theBuilder->SetInsertPoint(entry_block);
 
-  for (auto const& s : node->stmts) {
-    s->toLLVMIR(this);
-  }
-
-  // entry_block->getInstList()
+  stmts();
 
-  theBuilder->CreateRet(theBuilder->getInt32(0));
+  /* unless a top-level return already did */
+  if (theBuilder->GetInsertBlock()->getTerminator() == nullptr) {
+    theBuilder->CreateRet(theBuilder->getInt32(0));
+  }
 
   return main_func;
 }
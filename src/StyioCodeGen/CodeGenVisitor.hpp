@@ -3,34 +3,30 @@
 #define STYIO_CODE_GEN_VISITOR_H_
 
 // [STL]
+#include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 // [Styio]
+#include "../StyioIR/FlatIR/FlatIR.hpp"
 #include "../StyioIR/IRDecl.hpp"
 #include "../StyioJIT/StyioJIT_ORC.hpp"
+#include "../StyioJIT/TieredJIT.hpp"
+#include "../StyioToken/Symbol.hpp"
+#include "../StyioToken/Token.hpp"
 
 // [LLVM]
-#include "llvm/Analysis/CGSCCPassManager.h" /* CGSCCAnalysisManager */
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/LLVMContext.h"
-#include "llvm/IR/LegacyPassManager.h" /* FunctionPassManager */
 #include "llvm/IR/Module.h"
-#include "llvm/IR/PassInstrumentation.h" /* PassInstrumentationCallbacks */
-#include "llvm/IR/PassManager.h"         /* LoopAnalysisManager, FunctionAnalysisManager, ModuleAnalysisManager */
 #include "llvm/IR/Type.h"
 #include "llvm/IR/Value.h"
-#include "llvm/Passes/PassBuilder.h"                 /* PassBuilder */
-#include "llvm/Passes/StandardInstrumentations.h"    /* StandardInstrumentations.h */
-#include "llvm/Support/TargetSelect.h"               /* InitializeNativeTarget, InitializeNativeTargetAsmPrinter, InitializeNativeTargetAsmParser */
-#include "llvm/Transforms/InstCombine/InstCombine.h" /* InstCombinePass */
-#include "llvm/Transforms/Scalar.h"
-#include "llvm/Transforms/Scalar/GVN.h"         /* GVNPass */
-#include "llvm/Transforms/Scalar/Reassociate.h" /* ReassociatePass */
-#include "llvm/Transforms/Scalar/SimplifyCFG.h" /* SimplifyCFGPass */
-#include "llvm/Transforms/Utils.h"
+#include "llvm/Passes/OptimizationLevel.h" /* OptimizationLevel */
+#include "llvm/Support/CodeGen.h"          /* CodeGenFileType */
+#include "llvm/Support/TargetSelect.h"     /* InitializeNativeTarget, InitializeNativeTargetAsmPrinter, InitializeNativeTargetAsmParser */
 
 using std::string;
 using std::unordered_map;
@@ -115,49 +111,42 @@ class StyioToLLVM : public StyioCodeGenVisitor
   unique_ptr<llvm::IRBuilder<>> theBuilder;
 
   std::unique_ptr<StyioJIT_ORC> theORCJIT;
+  std::unique_ptr<StyioTieredJIT> theTiers; /* null unless StyioJITOptions::tiered */
 
-  unique_ptr<llvm::FunctionPassManager> theFPM;
-  unique_ptr<llvm::LoopAnalysisManager> theLAM;
-  unique_ptr<llvm::FunctionAnalysisManager> theFAM;
-  unique_ptr<llvm::CGSCCAnalysisManager> theCGAM;
-  unique_ptr<llvm::ModuleAnalysisManager> theMAM;
-  unique_ptr<llvm::PassInstrumentationCallbacks> thePIC;
-  unique_ptr<llvm::StandardInstrumentations> theSI;
-  llvm::PassBuilder thePB;
+  /* Names of the function being lowered, swapped out for the callee's (sparse: per function) */
+  StyioSymbolHashMap<llvm::AllocaInst> mutable_variables; /* [FlexBind] Mutable Variables */
+  StyioSymbolHashMap<llvm::Value> named_values;           /* [FinalBind] Named Values = Immutable Variables */
 
-  unordered_map<string, llvm::AllocaInst*> mutable_variables; /* [FlexBind] Mutable Variables */
-  unordered_map<string, llvm::Value*> named_values;  /* [FinalBind] Named Values = Immutable Variables */
+  size_t num_of_functions = 0; /* with a body, handed to the JIT */
+
+  /* [Parallel] The other modules of lower_in_parallel, lowered by their own generators */
+  std::vector<std::unique_ptr<StyioToLLVM>> partitions;
+
+  /* [Parallel] A generator of one partition, not connected to a JIT */
+  StyioToLLVM(const llvm::DataLayout& data_layout, const llvm::Triple& triple, const std::string& module_name) :
+      theContext(std::make_unique<llvm::LLVMContext>()),
+      theModule(std::make_unique<llvm::Module>(module_name, *theContext)),
+      theBuilder(std::make_unique<llvm::IRBuilder<>>(*theContext)) {
+    theModule->setDataLayout(data_layout);
+    theModule->setTargetTriple(triple.str());
+  }
+
+  /* [Flat IR] One node, see toLLVMIR(const StyioFlatIR&) */
+  llvm::Value* flat_to_llvm_ir(const StyioFlatIR& ir, StyioFlatRef ref);
+  llvm::Value* flat_func_to_llvm_ir(const StyioFlatIR& ir, const StyioFlatNode& node);
 
 public:
   StyioToLLVM(std::unique_ptr<StyioJIT_ORC> styio_jit) :
       theContext(std::make_unique<llvm::LLVMContext>()),
       theModule(std::make_unique<llvm::Module>("styio", *theContext)),
       theBuilder(std::make_unique<llvm::IRBuilder<>>(*theContext)),
-      theORCJIT(std::move(styio_jit)),
-      theFPM(std::make_unique<llvm::FunctionPassManager>()),
-      theLAM(std::make_unique<llvm::LoopAnalysisManager>()),
-      theFAM(std::make_unique<llvm::FunctionAnalysisManager>()),
-      theCGAM(std::make_unique<llvm::CGSCCAnalysisManager>()),
-      theMAM(std::make_unique<llvm::ModuleAnalysisManager>()),
-      thePIC(std::make_unique<llvm::PassInstrumentationCallbacks>()),
-      theSI(std::make_unique<llvm::StandardInstrumentations>(*theContext, /*DebugLogging*/ true)) {
+      theORCJIT(std::move(styio_jit)) {
     theModule->setDataLayout(theORCJIT->getDataLayout());
+    theModule->setTargetTriple(theORCJIT->getTargetTriple().str());
 
-    theSI->registerCallbacks(*thePIC, theMAM.get());
-
-    // Add transform passes.
-    // Do simple "peephole" optimizations and bit-twiddling optimizations.
-    theFPM->addPass(llvm::InstCombinePass());
-    // Reassociate expressions.
-    theFPM->addPass(llvm::ReassociatePass());
-    // Eliminate common sub-expressions.
-    theFPM->addPass(llvm::GVNPass());
-    // Simplify the control flow graph (deleting unreachable blocks, etc).
-    theFPM->addPass(llvm::SimplifyCFGPass());
-
-    thePB.registerModuleAnalyses(*theMAM);
-    thePB.registerFunctionAnalyses(*theFAM);
-    thePB.crossRegisterProxies(*theLAM, *theFAM, *theCGAM, *theMAM);
+    if (theORCJIT->getOptions().tiered) {
+      theTiers = std::make_unique<StyioTieredJIT>(*theORCJIT);
+    }
   }
 
   ~StyioToLLVM() {}
@@ -166,9 +155,93 @@ public:
     return new StyioToLLVM(std::move(styio_jit));
   }
 
-  void print_llvm_ir();
+  /* `note` follows the title, e.g. "-O2" */
+  void print_llvm_ir(std::string_view note = "");
+
+  /* Check the module, print what is broken to stderr, false if anything is */
+  bool verify_module();
+
+  /* Run the default LLVM pipeline of `level` over the module, nothing at O0 */
+  void optimize(llvm::OptimizationLevel level);
+
+  /* The same for any module, tuned for the target of `JTMB` */
+  static void optimize_module(llvm::Module& module, llvm::OptimizationLevel level, llvm::orc::JITTargetMachineBuilder JTMB);
+
+  /*
+    Lower `program` (an SGMainEntry) into `num_of_modules` modules on as
+    many threads: the top-level functions are dealt out to the modules,
+    main stays in this one, and every module declares all the top-level
+    functions, so calls between modules are resolved by the JIT.
+  */
+  void lower_in_parallel(StyioIR* program, size_t num_of_modules);
+
+  /* The prototype of `node` in the module */
+  llvm::Function* declare_func(SGFunc* node);
+
+  /* [AOT] Write the module as an object file or assembly, false on errors */
+  bool emit_native(const std::string& path, llvm::CodeGenFileType file_type);
+
+  /* [AOT] Write the module as LLVM bitcode */
+  bool emit_bitcode(const std::string& path);
+
+  /* [AOT] Link the module and the static StyioExtern runtime into an executable */
+  bool emit_executable(const std::string& path);
+
+  /* Name the module by its StyioObjectCache key, the JIT then caches its object */
+  void set_cache_key(const std::string& key);
+
+  /* Run a compiled object (a cache hit) instead of the module, which is dropped */
+  void load_object(std::unique_ptr<llvm::MemoryBuffer> object);
+
+  /* Move the module (if any) into the JIT and compile it, null if there is no main */
+  void* jit_main();
+
+  /* jit_main(), then run main */
   void execute();
 
+  /* Instructions in the module(s) so far */
+  size_t num_of_instructions() const;
+
+  const llvm::Module& get_module() const {
+    return *theModule;
+  }
+
+  /* get_module(), then the module of each partition of lower_in_parallel */
+  std::vector<const llvm::Module*> get_modules() const;
+
+  /* LLVM type of a Styio type: i1, i8, iN, float, double, ptr, else i64 */
+  llvm::Type* get_llvm_type(StyioDataType type);
+
+  /* Convert a number to another width or kind, e.g. an i32 operand to f32 */
+  llvm::Value* coerce(llvm::Value* value, llvm::Type* type);
+
+  /* `l op r` in `data_type`, or in the type of `l` if that is undefined */
+  llvm::Value* emit_binop(StyioOpType op, StyioDataType data_type, llvm::Value* l_val, llvm::Value* r_val);
+
+  /* Compare or combine to an i1, `r_val` is null for ! */
+  llvm::Value* emit_cond(StyioOpType op, llvm::Value* l_val, llvm::Value* r_val);
+
+  /* A new variable `name` holding value(), lowered after its alloca; an existing one as it is */
+  llvm::AllocaInst* emit_flex_bind(StyioSymbol name, llvm::Type* type, const std::function<llvm::Value*()>& value);
+
+  /* An immutable `name`, value() from then on */
+  llvm::AllocaInst* emit_final_bind(StyioSymbol name, llvm::Type* type, const std::function<llvm::Value*()>& value);
+
+  /* Call `name` with arg(0) .. arg(num_of_args - 1), 0 if it has no such function */
+  llvm::Value* emit_call(StyioSymbol name, size_t num_of_args, const std::function<llvm::Value*(size_t)>& arg);
+
+  /* Return `value` from the current function, in its return type */
+  llvm::Value* emit_return(llvm::Value* value);
+
+  /* The body of `llvm_func`: body() sees its arguments as `arg_names`, and no names of the caller */
+  llvm::Function* emit_func(llvm::Function* llvm_func, const std::vector<StyioSymbol>& arg_names, const std::function<void()>& body);
+
+  /* int main() of the statements stmts() lowers */
+  llvm::Function* emit_main(const std::function<void()>& stmts);
+
+  /* Lower a StyioFlatIR: the same module as its StyioIR tree gives */
+  llvm::Value* toLLVMIR(const StyioFlatIR& ir);
+
   /* CodeGen Get LLVM Type */
   llvm::Type* toLLVMType(SGResId* node);
   llvm::Type* toLLVMType(SGType* node);
@@ -12,39 +12,79 @@
 #include "../StyioUtil/Util.hpp"
 #include "CodeGenVisitor.hpp"
 
+llvm::Type*
+StyioToLLVM::get_llvm_type(StyioDataType type) {
+  switch (type.option()) {
+    case StyioDataTypeOption::Bool:
+      return theBuilder->getInt1Ty();
+
+    case StyioDataTypeOption::Integer:
+      /* `int`: a literal that was never given a width */
+      if (type.num_of_bit() == 0) {
+        return theBuilder->getInt64Ty();
+      }
+      return theBuilder->getIntNTy(type.num_of_bit());
+
+    case StyioDataTypeOption::Float:
+      if (type.num_of_bit() == 32) {
+        return theBuilder->getFloatTy();
+      }
+      return theBuilder->getDoubleTy();
+
+    case StyioDataTypeOption::Char:
+      return theBuilder->getInt8Ty();
+
+    case StyioDataTypeOption::String:
+      return theBuilder->getPtrTy();
+
+    default:
+      return theBuilder->getInt64Ty();
+  }
+}
+
 llvm::Type*
 StyioToLLVM::toLLVMType(SGResId* node) {
+  StyioSymbol name = node->symbol();
+
+  if (named_values.contains(name)) {
+    return named_values.get(name)->getType();
+  }
+
+  if (mutable_variables.contains(name)) {
+    return mutable_variables.get(name)->getAllocatedType();
+  }
+
   return theBuilder->getInt64Ty();
 };
 
 llvm::Type*
 StyioToLLVM::toLLVMType(SGType* node) {
-  return theBuilder->getInt64Ty();
+  return get_llvm_type(node->data_type);
 };
 
 llvm::Type*
 StyioToLLVM::toLLVMType(SGConstBool* node) {
-  return theBuilder->getInt64Ty();
+  return theBuilder->getInt1Ty();
 };
 
 llvm::Type*
 StyioToLLVM::toLLVMType(SGConstInt* node) {
-  return theBuilder->getInt64Ty();
+  return get_llvm_type(StyioDataType::getInteger(node->num_of_bit));
 };
 
 llvm::Type*
 StyioToLLVM::toLLVMType(SGConstFloat* node) {
-  return theBuilder->getDoubleTy();
+  return get_llvm_type(StyioDataType::getFloat(node->num_of_bit));
 };
 
 llvm::Type*
 StyioToLLVM::toLLVMType(SGConstChar* node) {
-  return theBuilder->getInt64Ty();
+  return theBuilder->getInt8Ty();
 };
 
 llvm::Type*
 StyioToLLVM::toLLVMType(SGConstString* node) {
-  return theBuilder->getInt64Ty();
+  return theBuilder->getPtrTy();
 };
 
 llvm::Type*
@@ -69,7 +109,7 @@ StyioToLLVM::toLLVMType(SGBinOp* node) {
 
 llvm::Type*
 StyioToLLVM::toLLVMType(SGCond* node) {
-  return theBuilder->getInt64Ty();
+  return theBuilder->getInt1Ty();
 };
 
 llvm::Type*
@@ -99,12 +139,17 @@ StyioToLLVM::toLLVMType(SGFunc* node) {
 
 llvm::Type*
 StyioToLLVM::toLLVMType(SGCall* node) {
+  llvm::Function* callee = theModule->getFunction(node->func_name->as_str());
+  if (callee) {
+    return callee->getReturnType();
+  }
+
   return theBuilder->getInt64Ty();
 };
 
 llvm::Type*
 StyioToLLVM::toLLVMType(SGReturn* node) {
-  return theBuilder->getInt64Ty();
+  return node->expr->toLLVMType(this);
 };
 
 llvm::Type*
@@ -0,0 +1,67 @@
+#pragma once
+#ifndef STYIO_DIAGNOSTICS_H_
+#define STYIO_DIAGNOSTICS_H_
+
+// [C++ STL]
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct StyioDiagnostic
+{
+  size_t offset;       /* position in the source */
+  std::string message; /* formatted, with the marked line */
+};
+
+/*
+  StyioDiagnostics: errors collected during one pass of the parser.
+
+  When a StyioContext has a diagnostics buffer (recovery mode),
+  parse_main_block() records each error here, skips to the next
+  statement and goes on, so one run reports every broken statement
+  instead of stopping at the first one.
+*/
+class StyioDiagnostics
+{
+private:
+  std::vector<StyioDiagnostic> items;
+
+public:
+  void report(size_t offset, std::string message) {
+    items.push_back(StyioDiagnostic{offset, std::move(message)});
+  }
+
+  bool empty() const {
+    return items.empty();
+  }
+
+  size_t size() const {
+    return items.size();
+  }
+
+  const StyioDiagnostic& operator[](size_t i) const {
+    return items[i];
+  }
+
+  std::vector<StyioDiagnostic>::const_iterator begin() const {
+    return items.begin();
+  }
+
+  std::vector<StyioDiagnostic>::const_iterator end() const {
+    return items.end();
+  }
+
+  void clear() {
+    items.clear();
+  }
+
+  void print(std::ostream& out) const {
+    for (auto const& diag : items) {
+      out << diag.message << "\n";
+    }
+    out << items.size() << (items.size() == 1 ? " error" : " errors") << " found." << std::endl;
+  }
+};
+
+#endif
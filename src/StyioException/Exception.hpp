@@ -65,6 +65,25 @@ public:
   }
 };
 
+class StyioTypeError : public StyioBaseException
+{
+private:
+  std::string message;
+
+public:
+  StyioTypeError() :
+      message("\nStyio.TypeError: Undefined.") {}
+
+  StyioTypeError(std::string msg) :
+      message("\nStyio.TypeError: " + msg) {}
+
+  ~StyioTypeError() throw() {}
+
+  virtual const char* what() const throw() {
+    return message.c_str();
+  }
+};
+
 class StyioNotImplemented : public StyioBaseException
 {
 private:
@@ -84,6 +103,25 @@ public:
   }
 };
 
+class StyioIOError : public StyioBaseException
+{
+private:
+  std::string message;
+
+public:
+  StyioIOError() :
+      message("\nStyio.IOError: Undefined.") {}
+
+  StyioIOError(std::string msg) :
+      message("\nStyio.IOError: " + msg) {}
+
+  ~StyioIOError() throw() {}
+
+  virtual const char* what() const throw() {
+    return message.c_str();
+  }
+};
+
 class StyioUndefinedBehaviour : public StyioBaseException
 {
 private:
@@ -0,0 +1,148 @@
+// [C++ STL]
+#include <charconv>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// [Styio]
+#include "../GenIR/GenIR.hpp"
+#include "FlatIR.hpp"
+
+static StyioFlatRef
+flatten(StyioFlatIR& ir, StyioIR* node);
+
+static StyioFlatRef
+flatten_list(StyioFlatIR& ir, const std::vector<StyioIR*>& nodes) {
+  std::vector<StyioFlatRef> refs;
+  refs.reserve(nodes.size());
+  for (auto node : nodes) {
+    refs.push_back(flatten(ir, node));
+  }
+  return ir.add_list(refs);
+}
+
+static StyioFlatRef
+flatten_int(StyioFlatIR& ir, SGConstInt* node) {
+  StyioFlatNode flat;
+  flat.num_of_bit = uint16_t(node->num_of_bit == 0 ? 64 : node->num_of_bit);
+
+  if (node->canonical) {
+    flat.kind = StyioFlatKind::ConstInt;
+    flat.int_value = *node->canonical;
+    return ir.add(flat);
+  }
+
+  /* not canonicalized: parse it here, LLVM wraps it to its width */
+  const char* begin = node->value.data();
+  const char* end = begin + node->value.size();
+  uint64_t value = 0;
+  auto [ptr, ec] = std::from_chars(begin, end, value);
+
+  if (flat.num_of_bit <= 64 && ec == std::errc() && ptr == end) {
+    flat.kind = StyioFlatKind::ConstInt;
+    flat.int_value = int64_t(value);
+  }
+  else {
+    flat.kind = StyioFlatKind::ConstBigInt;
+    flat.a = ir.add_text(node->value);
+  }
+
+  return ir.add(flat);
+}
+
+static StyioFlatRef
+flatten(StyioFlatIR& ir, StyioIR* node) {
+  StyioFlatNode flat;
+
+  if (auto id = dynamic_cast<SGResId*>(node)) {
+    flat.kind = StyioFlatKind::ResId;
+    flat.symbol = id->symbol();
+  }
+  else if (auto b = dynamic_cast<SGConstBool*>(node)) {
+    flat.kind = StyioFlatKind::ConstBool;
+    flat.int_value = b->value;
+  }
+  else if (auto i = dynamic_cast<SGConstInt*>(node)) {
+    return flatten_int(ir, i);
+  }
+  else if (auto f = dynamic_cast<SGConstFloat*>(node)) {
+    flat.kind = StyioFlatKind::ConstFloat;
+    flat.num_of_bit = uint16_t(f->num_of_bit);
+    flat.float_value = f->canonical ? *f->canonical : std::strtod(f->value.c_str(), nullptr);
+  }
+  else if (auto c = dynamic_cast<SGConstChar*>(node)) {
+    flat.kind = StyioFlatKind::ConstChar;
+    flat.int_value = c->value;
+  }
+  else if (auto s = dynamic_cast<SGConstString*>(node)) {
+    flat.kind = StyioFlatKind::ConstString;
+    flat.a = ir.add_text(s->value);
+  }
+  else if (auto binop = dynamic_cast<SGBinOp*>(node)) {
+    flat.kind = StyioFlatKind::BinOp;
+    flat.op = uint8_t(binop->operand);
+    flat.a = flatten(ir, binop->lhs_expr);
+    flat.b = flatten(ir, binop->rhs_expr);
+    flat.type = binop->data_type->data_type.info;
+  }
+  else if (auto cond = dynamic_cast<SGCond*>(node)) {
+    flat.kind = StyioFlatKind::Cond;
+    flat.op = uint8_t(cond->operand);
+    flat.a = flatten(ir, cond->lhs_expr);
+    flat.b = cond->rhs_expr ? flatten(ir, cond->rhs_expr) : StyioFlatNone;
+  }
+  else if (auto bind = dynamic_cast<SGFlexBind*>(node)) {
+    flat.kind = StyioFlatKind::FlexBind;
+    flat.symbol = bind->var->var_name->symbol();
+    flat.type = bind->var->var_type->data_type.info;
+    flat.a = flatten(ir, bind->value);
+  }
+  else if (auto bind = dynamic_cast<SGFinalBind*>(node)) {
+    flat.kind = StyioFlatKind::FinalBind;
+    flat.symbol = bind->var->var_name->symbol();
+    flat.type = bind->var->var_type->data_type.info;
+    flat.a = flatten(ir, bind->value);
+  }
+  else if (auto func = dynamic_cast<SGFunc*>(node)) {
+    std::vector<StyioFlatRef> args;
+    for (auto arg : func->func_args) {
+      StyioFlatNode flat_arg;
+      flat_arg.kind = StyioFlatKind::FuncArg;
+      flat_arg.symbol = StyioSymbolTable::intern(arg->id);
+      flat_arg.type = arg->arg_type->data_type.info;
+      args.push_back(ir.add(flat_arg));
+    }
+
+    flat.kind = StyioFlatKind::Func;
+    flat.symbol = func->func_name->symbol();
+    flat.type = func->ret_type->data_type.info;
+    flat.a = flatten(ir, func->func_block);
+    flat.b = ir.add_list(args);
+  }
+  else if (auto call = dynamic_cast<SGCall*>(node)) {
+    flat.kind = StyioFlatKind::Call;
+    flat.symbol = call->func_name->symbol();
+    flat.b = flatten_list(ir, call->func_args);
+  }
+  else if (auto ret = dynamic_cast<SGReturn*>(node)) {
+    flat.kind = StyioFlatKind::Return;
+    flat.a = flatten(ir, ret->expr);
+  }
+  else if (auto block = dynamic_cast<SGBlock*>(node)) {
+    flat.kind = StyioFlatKind::Block;
+    flat.b = flatten_list(ir, block->stmts);
+  }
+  else if (auto entry = dynamic_cast<SGMainEntry*>(node)) {
+    flat.kind = StyioFlatKind::MainEntry;
+    flat.b = flatten_list(ir, entry->stmts);
+  }
+
+  return ir.add(flat);
+}
+
+StyioFlatIR
+StyioFlatIR::from(StyioIR* root) {
+  StyioFlatIR ir;
+  ir.root = flatten(ir, root);
+  return ir;
+}
@@ -0,0 +1,126 @@
+#pragma once
+#ifndef STYIO_FLAT_IR_H_
+#define STYIO_FLAT_IR_H_
+
+// [C++ STL]
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+// [Styio]
+#include "../../StyioToken/Symbol.hpp"
+#include "../../StyioToken/Token.hpp"
+#include "../IRDecl.hpp"
+
+/*
+  Styio Flat IR
+
+  The same program as a StyioIR tree, but every node is a 24-byte
+  StyioFlatNode in one vector, children are 32-bit indices into it, and
+  lowering is a switch over the kind instead of two virtual calls per
+  node. Children come before their parents, so the nodes can also be
+  walked front to back without following any index.
+
+  Lists of children (statements, arguments) are runs in `lists`:
+  [n, ref_1, .., ref_n], a node keeps the index of `n`.
+*/
+
+using StyioFlatRef = uint32_t;
+
+inline constexpr StyioFlatRef StyioFlatNone = UINT32_MAX;
+
+enum class StyioFlatKind : uint8_t
+{
+  Unsupported, /* not lowered yet, i64 0 like the visitor's stubs */
+
+  ResId,       /* symbol */
+  ConstBool,   /* int_value */
+  ConstInt,    /* int_value, num_of_bit */
+  ConstBigInt, /* texts[a], num_of_bit: wider than 64 bits */
+  ConstFloat,  /* float_value, num_of_bit */
+  ConstChar,   /* int_value */
+  ConstString, /* texts[a] */
+
+  BinOp, /* a op b, type */
+  Cond,  /* a op b, b is none for ! */
+
+  FlexBind,  /* symbol := a, type */
+  FinalBind, /* symbol : type = a */
+
+  FuncArg,   /* symbol, type */
+  Func,      /* symbol (args in b) => type { a } */
+  Call,      /* symbol(args in b) */
+  Return,    /* <| a */
+
+  Block,     /* stmts in b */
+  MainEntry, /* stmts in b */
+};
+
+struct StyioFlatNode
+{
+  StyioFlatKind kind = StyioFlatKind::Unsupported;
+  uint8_t op = 0; /* StyioOpType */
+  uint16_t num_of_bit = 0;
+
+  StyioFlatRef a = StyioFlatNone;
+  StyioFlatRef b = StyioFlatNone;
+  StyioSymbol symbol = 0;
+
+  union
+  {
+    int64_t int_value = 0;
+    double float_value;
+    const StyioTypeInfo* type;
+  };
+
+  StyioOpType getOp() const {
+    return StyioOpType(op);
+  }
+
+  StyioDataType getType() const {
+    return StyioDataType{type};
+  }
+};
+
+static_assert(sizeof(StyioFlatNode) == 24);
+
+class StyioFlatIR
+{
+public:
+  std::vector<StyioFlatNode> nodes;
+  std::vector<StyioFlatRef> lists;
+  std::vector<std::string> texts;
+
+  StyioFlatRef root = StyioFlatNone;
+
+  /* Copy a StyioIR tree */
+  static StyioFlatIR from(StyioIR* root);
+
+  const StyioFlatNode& operator[](StyioFlatRef ref) const {
+    return nodes[ref];
+  }
+
+  std::span<const StyioFlatRef> list(StyioFlatRef at) const {
+    return {lists.data() + at + 1, lists[at]};
+  }
+
+  StyioFlatRef add(const StyioFlatNode& node) {
+    nodes.push_back(node);
+    return StyioFlatRef(nodes.size() - 1);
+  }
+
+  StyioFlatRef add_list(std::span<const StyioFlatRef> refs) {
+    StyioFlatRef at = StyioFlatRef(lists.size());
+    lists.push_back(StyioFlatRef(refs.size()));
+    lists.insert(lists.end(), refs.begin(), refs.end());
+    return at;
+  }
+
+  StyioFlatRef add_text(std::string text) {
+    texts.push_back(std::move(text));
+    return StyioFlatRef(texts.size() - 1);
+  }
+};
+
+#endif
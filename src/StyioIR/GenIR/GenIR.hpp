@@ -3,6 +3,11 @@
 #define STYIO_GENERAL_IR_H_
 
 // [C++ STL]
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <optional>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -23,24 +28,32 @@
 class SGResId : public StyioIRTraits<SGResId>
 {
 private:
-  std::string id;
+  StyioSymbol id = 0;
 
 public:
-  SGResId(std::string id) :
+  SGResId(StyioSymbol id) :
       id(id) {
   }
 
   static SGResId* Create() {
-    return new SGResId("");
+    return new SGResId(0);
   }
 
-  static SGResId* Create(std::string id) {
+  static SGResId* Create(StyioSymbol id) {
     return new SGResId(id);
   }
 
-  const std::string& as_str() {
+  static SGResId* Create(const std::string& id) {
+    return new SGResId(StyioSymbolTable::intern(id));
+  }
+
+  StyioSymbol symbol() const {
     return id;
   }
+
+  const std::string& as_str() {
+    return StyioSymbolTable::name_of(id);
+  }
 };
 
 class SGType : public StyioIRTraits<SGType>
@@ -79,9 +92,12 @@ public:
 class SGConstInt : public StyioIRTraits<SGConstInt>
 {
 public:
-  std::string value;
+  std::string value; /* as written */
   size_t num_of_bit;
 
+  /* `value` parsed and wrapped to `num_of_bit`, unset if it is wider than 64 bits */
+  std::optional<int64_t> canonical;
+
   SGConstInt(
     std::string value,
     size_t numbits
@@ -91,7 +107,7 @@ public:
   }
 
   static SGConstInt* Create(long value) {
-    return new SGConstInt(std::to_string(value), 64);
+    return Create(int64_t(value), 64);
   }
 
   static SGConstInt* Create(std::string value) {
@@ -101,19 +117,45 @@ public:
   static SGConstInt* Create(std::string value, size_t numbits) {
     return new SGConstInt(value, numbits);
   }
+
+  /* An already canonical constant, e.g. a folded one */
+  static SGConstInt* Create(int64_t value, size_t numbits) {
+    auto node = new SGConstInt(std::to_string(value), numbits);
+    node->canonical = value;
+    return node;
+  }
 };
 
 class SGConstFloat : public StyioIRTraits<SGConstFloat>
 {
 public:
-  std::string value;
+  std::string value; /* as written */
+  size_t num_of_bit;
 
-  SGConstFloat(std::string value) :
-      value(value) {
+  /* `value` parsed, and rounded to float if `num_of_bit` is 32 */
+  std::optional<double> canonical;
+
+  SGConstFloat(std::string value, size_t numbits) :
+      value(value),
+      num_of_bit(numbits) {
   }
 
   static SGConstFloat* Create(std::string value) {
-    return new SGConstFloat(value);
+    return new SGConstFloat(value, 64);
+  }
+
+  static SGConstFloat* Create(std::string value, size_t numbits) {
+    return new SGConstFloat(value, numbits);
+  }
+
+  /* An already canonical constant, e.g. a folded one */
+  static SGConstFloat* Create(double value, size_t numbits) {
+    std::ostringstream text;
+    text << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
+
+    auto node = new SGConstFloat(text.str(), numbits);
+    node->canonical = value;
+    return node;
   }
 };
 
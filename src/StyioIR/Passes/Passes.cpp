@@ -0,0 +1,659 @@
+// [C++ STL]
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// [Styio]
+#include "../../StyioToken/Token.hpp"
+#include "../GenIR/GenIR.hpp"
+#include "../IOIR/IOIR.hpp"
+#include "Passes.hpp"
+
+/*
+  Walking StyioIR
+
+  StyioIR has no generic child list, so the passes share this walk over
+  the expression slots of a node. It stops at SGFunc, whose block is a
+  body of its own, and does not visit the names of SGVar / SGFunc /
+  SGCall: an SGResId reached through a slot is always a read.
+*/
+
+template <typename F>
+static void
+for_each_slot(StyioIR* node, F&& f) {
+  if (auto binop = dynamic_cast<SGBinOp*>(node)) {
+    f(binop->lhs_expr);
+    f(binop->rhs_expr);
+  }
+  else if (auto cond = dynamic_cast<SGCond*>(node)) {
+    f(cond->lhs_expr);
+    if (cond->rhs_expr) {
+      f(cond->rhs_expr);
+    }
+  }
+  else if (auto var = dynamic_cast<SGVar*>(node)) {
+    if (var->val_init) {
+      f(var->val_init);
+    }
+  }
+  else if (auto bind = dynamic_cast<SGFlexBind*>(node)) {
+    f(bind->value);
+  }
+  else if (auto bind = dynamic_cast<SGFinalBind*>(node)) {
+    f(bind->value);
+  }
+  else if (auto call = dynamic_cast<SGCall*>(node)) {
+    for (auto& arg : call->func_args) {
+      f(arg);
+    }
+  }
+  else if (auto ret = dynamic_cast<SGReturn*>(node)) {
+    f(ret->expr);
+  }
+  else if (auto block = dynamic_cast<SGBlock*>(node)) {
+    for (auto& stmt : block->stmts) {
+      f(stmt);
+    }
+  }
+  else if (auto fmt = dynamic_cast<SGFormatString*>(node)) {
+    for (auto& expr : fmt->exprs) {
+      f(expr);
+    }
+  }
+  else if (auto print = dynamic_cast<SIOPrint*>(node)) {
+    for (auto& expr : print->expr) {
+      f(expr);
+    }
+  }
+}
+
+/* Post-order: children are rewritten before `slot` itself */
+template <typename F>
+static void
+rewrite_post_order(StyioIR*& slot, F& f) {
+  for_each_slot(slot, [&f](StyioIR*& child) {
+    rewrite_post_order(child, f);
+  });
+  f(slot);
+}
+
+/* Computes nothing but its value: no calls, no I/O */
+static bool
+is_pure(StyioIR* node) {
+  if (dynamic_cast<SGCall*>(node)
+      || dynamic_cast<SIOPrint*>(node)
+      || dynamic_cast<SIORead*>(node)
+      || dynamic_cast<SGFunc*>(node)) {
+    return false;
+  }
+
+  bool pure = true;
+  for_each_slot(node, [&pure](StyioIR*& child) {
+    pure = pure && is_pure(child);
+  });
+  return pure;
+}
+
+/*
+  Constants
+
+  Integers are folded in 64 bits and wrapped to their width, the way
+  LLVM would compute them in iN. Wider integers are left to LLVM.
+*/
+
+static size_t
+width_of(size_t num_of_bit) {
+  return num_of_bit == 0 ? 64 : num_of_bit;
+}
+
+/* The low `num_of_bit` bits of `value`, sign-extended */
+static int64_t
+wrap_to(uint64_t value, size_t num_of_bit) {
+  num_of_bit = width_of(num_of_bit);
+  if (num_of_bit >= 64) {
+    return int64_t(value);
+  }
+
+  uint64_t sign = uint64_t(1) << (num_of_bit - 1);
+  uint64_t mask = (uint64_t(1) << num_of_bit) - 1;
+  value &= mask;
+  return int64_t((value ^ sign) - sign);
+}
+
+static double
+round_to(double value, size_t num_of_bit) {
+  return num_of_bit == 32 ? double(float(value)) : value;
+}
+
+static bool
+is_const_number(StyioIR* node) {
+  if (auto i = dynamic_cast<SGConstInt*>(node)) {
+    return i->canonical.has_value();
+  }
+
+  if (auto f = dynamic_cast<SGConstFloat*>(node)) {
+    return f->canonical.has_value();
+  }
+
+  return false;
+}
+
+static bool
+is_const(StyioIR* node) {
+  return is_const_number(node) || dynamic_cast<SGConstBool*>(node);
+}
+
+static double
+as_double(StyioIR* node) {
+  if (auto i = dynamic_cast<SGConstInt*>(node)) {
+    return double(*i->canonical);
+  }
+
+  return *static_cast<SGConstFloat*>(node)->canonical;
+}
+
+/* A constant of `type`, as StyioToLLVM::coerce would convert it; null if it can not */
+static StyioIR*
+const_as(StyioIR* value, StyioDataType type) {
+  if (type.isUndefined()) {
+    if (auto i = dynamic_cast<SGConstInt*>(value)) {
+      return SGConstInt::Create(*i->canonical, i->num_of_bit);
+    }
+    if (auto f = dynamic_cast<SGConstFloat*>(value)) {
+      return SGConstFloat::Create(*f->canonical, f->num_of_bit);
+    }
+    if (auto b = dynamic_cast<SGConstBool*>(value)) {
+      return SGConstBool::Create(b->value);
+    }
+    return nullptr;
+  }
+
+  if (type.isInteger() && width_of(type.num_of_bit()) <= 64) {
+    if (auto i = dynamic_cast<SGConstInt*>(value)) {
+      return SGConstInt::Create(wrap_to(uint64_t(*i->canonical), type.num_of_bit()), width_of(type.num_of_bit()));
+    }
+    return nullptr;
+  }
+
+  if (type.isFloat() && is_const_number(value)) {
+    return SGConstFloat::Create(round_to(as_double(value), type.num_of_bit()), type.num_of_bit());
+  }
+
+  if (type == StyioDataType::Bool) {
+    if (auto b = dynamic_cast<SGConstBool*>(value)) {
+      return SGConstBool::Create(b->value);
+    }
+  }
+
+  return nullptr;
+}
+
+static bool
+is_compare(StyioOpType op) {
+  switch (op) {
+    case StyioOpType::Equal:
+    case StyioOpType::Not_Equal:
+    case StyioOpType::Greater_Than:
+    case StyioOpType::Greater_Than_Equal:
+    case StyioOpType::Less_Than:
+    case StyioOpType::Less_Than_Equal:
+      return true;
+    default:
+      return false;
+  }
+}
+
+template <typename T>
+static bool
+compare(StyioOpType op, T l, T r) {
+  switch (op) {
+    case StyioOpType::Equal:
+      return l == r;
+    case StyioOpType::Not_Equal:
+      /* ordered, as StyioToLLVM emits it (fcmp one): false if either side is NaN */
+      return l < r || l > r;
+    case StyioOpType::Greater_Than:
+      return l > r;
+    case StyioOpType::Greater_Than_Equal:
+      return l >= r;
+    case StyioOpType::Less_Than:
+      return l < r;
+    case StyioOpType::Less_Than_Equal:
+    default:
+      return l <= r;
+  }
+}
+
+static StyioIR*
+fold_logic(StyioOpType op, StyioIR* lhs, StyioIR* rhs) {
+  auto l = dynamic_cast<SGConstBool*>(lhs);
+  auto r = dynamic_cast<SGConstBool*>(rhs);
+
+  if (op == StyioOpType::Logic_NOT) {
+    return l ? SGConstBool::Create(not l->value) : nullptr;
+  }
+
+  if (not l || not r) {
+    return nullptr;
+  }
+
+  switch (op) {
+    case StyioOpType::Logic_AND:
+      return SGConstBool::Create(l->value && r->value);
+    case StyioOpType::Logic_OR:
+      return SGConstBool::Create(l->value || r->value);
+    case StyioOpType::Logic_XOR:
+      return SGConstBool::Create(l->value != r->value);
+    default:
+      return nullptr;
+  }
+}
+
+static StyioIR*
+fold_compare(StyioOpType op, StyioIR* lhs, StyioIR* rhs) {
+  auto lb = dynamic_cast<SGConstBool*>(lhs);
+  auto rb = dynamic_cast<SGConstBool*>(rhs);
+  if (lb && rb) {
+    /* i1 is compared signed at run time, true < false there: only == and != agree */
+    if (op != StyioOpType::Equal && op != StyioOpType::Not_Equal) {
+      return nullptr;
+    }
+    return SGConstBool::Create(compare(op, lb->value, rb->value));
+  }
+
+  if (not is_const_number(lhs) || not is_const_number(rhs)) {
+    return nullptr;
+  }
+
+  auto li = dynamic_cast<SGConstInt*>(lhs);
+  auto ri = dynamic_cast<SGConstInt*>(rhs);
+  if (li && ri) {
+    return SGConstBool::Create(compare(op, *li->canonical, *ri->canonical));
+  }
+
+  return SGConstBool::Create(compare(op, as_double(lhs), as_double(rhs)));
+}
+
+static StyioIR*
+fold_int(StyioOpType op, int64_t l, int64_t r, size_t num_of_bit) {
+  uint64_t ul = uint64_t(l);
+  uint64_t ur = uint64_t(r);
+  int64_t min = wrap_to(uint64_t(1) << (width_of(num_of_bit) - 1), num_of_bit);
+
+  switch (op) {
+    case StyioOpType::Binary_Add:
+      return SGConstInt::Create(wrap_to(ul + ur, num_of_bit), num_of_bit);
+
+    case StyioOpType::Binary_Sub:
+      return SGConstInt::Create(wrap_to(ul - ur, num_of_bit), num_of_bit);
+
+    case StyioOpType::Binary_Mul:
+      return SGConstInt::Create(wrap_to(ul * ur, num_of_bit), num_of_bit);
+
+    case StyioOpType::Binary_Div: {
+      /* undefined at run time, leave it there */
+      if (r == 0 || (r == -1 && l == min)) {
+        return nullptr;
+      }
+      return SGConstInt::Create(wrap_to(uint64_t(l / r), num_of_bit), num_of_bit);
+    }
+
+    /* % and ** are not lowered by StyioToLLVM yet, a folded one would differ from run time */
+    default:
+      return nullptr;
+  }
+}
+
+static StyioIR*
+fold_float(StyioOpType op, double l, double r, size_t num_of_bit) {
+  double result;
+
+  switch (op) {
+    case StyioOpType::Binary_Add:
+      result = l + r;
+      break;
+    case StyioOpType::Binary_Sub:
+      result = l - r;
+      break;
+    case StyioOpType::Binary_Mul:
+      result = l * r;
+      break;
+    case StyioOpType::Binary_Div:
+      result = l / r;
+      break;
+    /* % and ** as in fold_int */
+    default:
+      return nullptr;
+  }
+
+  return SGConstFloat::Create(round_to(result, num_of_bit), num_of_bit);
+}
+
+/* `lhs op rhs` as a constant of `type`, null if it is not constant */
+static StyioIR*
+fold(StyioOpType op, StyioIR* lhs, StyioIR* rhs, StyioDataType type) {
+  switch (op) {
+    case StyioOpType::Logic_NOT:
+    case StyioOpType::Logic_AND:
+    case StyioOpType::Logic_OR:
+    case StyioOpType::Logic_XOR:
+      return fold_logic(op, lhs, rhs);
+    default:
+      break;
+  }
+
+  if (is_compare(op)) {
+    return fold_compare(op, lhs, rhs);
+  }
+
+  if (not is_const_number(lhs) || not is_const_number(rhs)) {
+    return nullptr;
+  }
+
+  auto li = dynamic_cast<SGConstInt*>(lhs);
+  auto ri = dynamic_cast<SGConstInt*>(rhs);
+
+  /* not inferred: what StyioToLLVM would take, the type of the left operand */
+  if (type.isUndefined()) {
+    type = li ? StyioDataType::getInteger(width_of(li->num_of_bit))
+              : StyioDataType::getFloat(static_cast<SGConstFloat*>(lhs)->num_of_bit);
+  }
+
+  if (type.isInteger()) {
+    size_t num_of_bit = width_of(type.num_of_bit());
+    if (not li || not ri || num_of_bit > 64) {
+      return nullptr;
+    }
+    return fold_int(op, wrap_to(uint64_t(*li->canonical), num_of_bit), wrap_to(uint64_t(*ri->canonical), num_of_bit), num_of_bit);
+  }
+
+  if (type.isFloat()) {
+    size_t num_of_bit = type.num_of_bit();
+    return fold_float(op, round_to(as_double(lhs), num_of_bit), round_to(as_double(rhs), num_of_bit), num_of_bit);
+  }
+
+  return nullptr;
+}
+
+/*
+  Canonical Literals
+*/
+
+size_t
+StyioCanonLiterals::run(std::vector<StyioIR*>& stmts) {
+  size_t count = 0;
+
+  auto canon = [&count](StyioIR*& slot) {
+    if (auto i = dynamic_cast<SGConstInt*>(slot)) {
+      if (i->canonical || width_of(i->num_of_bit) > 64) {
+        return;
+      }
+
+      /* parsed as unsigned, so that 2^64 - 1 is still -1 in i64 */
+      uint64_t value = 0;
+      const char* begin = i->value.data();
+      const char* end = begin + i->value.size();
+      bool negative = (begin != end && *begin == '-');
+      auto [ptr, ec] = std::from_chars(begin + negative, end, value);
+      if (ec != std::errc() || ptr != end) {
+        return;
+      }
+
+      i->num_of_bit = width_of(i->num_of_bit);
+      i->canonical = wrap_to(negative ? (0 - value) : value, i->num_of_bit);
+      count += 1;
+    }
+    else if (auto f = dynamic_cast<SGConstFloat*>(slot)) {
+      if (f->canonical) {
+        return;
+      }
+
+      char* end = nullptr;
+      double value = std::strtod(f->value.c_str(), &end);
+      if (end != f->value.c_str() + f->value.size()) {
+        return;
+      }
+
+      f->canonical = round_to(value, f->num_of_bit);
+      count += 1;
+    }
+  };
+
+  for (auto& stmt : stmts) {
+    rewrite_post_order(stmt, canon);
+  }
+
+  return count;
+}
+
+/*
+  Constant Folding
+*/
+
+size_t
+StyioConstFold::run(std::vector<StyioIR*>& stmts) {
+  size_t count = 0;
+
+  auto fold_slot = [&count](StyioIR*& slot) {
+    StyioIR* folded = nullptr;
+
+    if (auto binop = dynamic_cast<SGBinOp*>(slot)) {
+      folded = fold(binop->operand, binop->lhs_expr, binop->rhs_expr, binop->data_type->data_type);
+    }
+    else if (auto cond = dynamic_cast<SGCond*>(slot)) {
+      folded = fold(cond->operand, cond->lhs_expr, cond->rhs_expr, StyioDataType::Bool);
+    }
+
+    if (folded) {
+      slot = folded;
+      count += 1;
+    }
+  };
+
+  for (auto& stmt : stmts) {
+    rewrite_post_order(stmt, fold_slot);
+  }
+
+  return count;
+}
+
+/*
+  Constant Propagation
+
+  Statements are visited in order, each binding to a constant is
+  remembered until the name is bound again. The value of a binding is
+  rewritten before the binding itself is looked at, so `x := x + 1`
+  reads the old x.
+*/
+
+size_t
+StyioConstProp::run(std::vector<StyioIR*>& stmts) {
+  size_t count = 0;
+  std::unordered_map<StyioSymbol, StyioIR*> constants; /* name -> the constant, in the type of the binding */
+
+  auto bind = [&constants](SGVar* var, StyioIR* value, bool is_final) {
+    StyioSymbol name = var->var_name->symbol();
+    StyioIR* constant = (is_final && is_const(value)) ? const_as(value, var->var_type->data_type) : nullptr;
+
+    if (constant) {
+      constants[name] = constant;
+    }
+    else {
+      constants.erase(name);
+    }
+  };
+
+  auto replace = [&constants, &count](StyioIR*& slot) {
+    if (auto id = dynamic_cast<SGResId*>(slot)) {
+      auto it = constants.find(id->symbol());
+      if (it != constants.end()) {
+        slot = const_as(it->second, StyioDataType::Undefined);
+        count += 1;
+      }
+    }
+  };
+
+  /* Nested blocks continue the same scope, see StyioToLLVM::toLLVMIR(SGBlock*) */
+  auto visit = [&](auto& self, StyioIR*& stmt) -> void {
+    if (auto block = dynamic_cast<SGBlock*>(stmt)) {
+      for (auto& child : block->stmts) {
+        self(self, child);
+      }
+    }
+    else if (auto flex = dynamic_cast<SGFlexBind*>(stmt)) {
+      rewrite_post_order(flex->value, replace);
+      bind(flex->var, flex->value, false);
+    }
+    else if (auto final_bind = dynamic_cast<SGFinalBind*>(stmt)) {
+      rewrite_post_order(final_bind->value, replace);
+      bind(final_bind->var, final_bind->value, true);
+    }
+    else if (not dynamic_cast<SGFunc*>(stmt)) {
+      rewrite_post_order(stmt, replace);
+    }
+  };
+
+  for (auto& stmt : stmts) {
+    visit(visit, stmt);
+  }
+
+  return count;
+}
+
+/*
+  Dead Binding Elimination
+
+  Reads are counted in the whole body, nested functions included, since
+  they may share names with it. A binding is dropped if its name is
+  never read and its value is pure.
+*/
+
+static void
+count_reads(StyioIR* node, std::unordered_map<StyioSymbol, size_t>& reads) {
+  if (auto id = dynamic_cast<SGResId*>(node)) {
+    reads[id->symbol()] += 1;
+    return;
+  }
+
+  if (auto func = dynamic_cast<SGFunc*>(node)) {
+    for (auto stmt : func->func_block->stmts) {
+      count_reads(stmt, reads);
+    }
+    return;
+  }
+
+  for_each_slot(node, [&reads](StyioIR*& child) {
+    count_reads(child, reads);
+  });
+}
+
+static size_t
+drop_dead_binds(std::vector<StyioIR*>& stmts, const std::unordered_map<StyioSymbol, size_t>& reads) {
+  size_t count = 0;
+
+  auto is_dead = [&reads](SGVar* var, StyioIR* value) {
+    return not reads.contains(var->var_name->symbol()) && is_pure(value);
+  };
+
+  std::erase_if(stmts, [&](StyioIR* stmt) {
+    bool dead = false;
+
+    if (auto block = dynamic_cast<SGBlock*>(stmt)) {
+      count += drop_dead_binds(block->stmts, reads);
+    }
+    else if (auto flex = dynamic_cast<SGFlexBind*>(stmt)) {
+      dead = is_dead(flex->var, flex->value);
+    }
+    else if (auto final_bind = dynamic_cast<SGFinalBind*>(stmt)) {
+      dead = is_dead(final_bind->var, final_bind->value);
+    }
+
+    count += dead ? 1 : 0;
+    return dead;
+  });
+
+  return count;
+}
+
+size_t
+StyioDeadBinds::run(std::vector<StyioIR*>& stmts) {
+  std::unordered_map<StyioSymbol, size_t> reads;
+  for (auto stmt : stmts) {
+    count_reads(stmt, reads);
+  }
+
+  return drop_dead_binds(stmts, reads);
+}
+
+/*
+  Pass Manager
+*/
+
+StyioIRPassManager
+StyioIRPassManager::Default() {
+  StyioIRPassManager manager;
+  manager.add(std::make_unique<StyioCanonLiterals>());
+  manager.add(std::make_unique<StyioConstFold>());
+  manager.add(std::make_unique<StyioConstProp>());
+  manager.add(std::make_unique<StyioDeadBinds>());
+  return manager;
+}
+
+/* The main entry and the block of every function in it */
+static void
+collect_bodies(std::vector<StyioIR*>& stmts, std::vector<std::vector<StyioIR*>*>& bodies) {
+  for (auto stmt : stmts) {
+    if (auto func = dynamic_cast<SGFunc*>(stmt)) {
+      bodies.push_back(&func->func_block->stmts);
+      collect_bodies(func->func_block->stmts, bodies);
+    }
+    else if (auto block = dynamic_cast<SGBlock*>(stmt)) {
+      collect_bodies(block->stmts, bodies);
+    }
+  }
+}
+
+size_t
+StyioIRPassManager::run(StyioIR* program) {
+  auto entry = dynamic_cast<SGMainEntry*>(program);
+  if (entry == nullptr) {
+    return 0;
+  }
+
+  std::vector<std::vector<StyioIR*>*> bodies = {&entry->stmts};
+  collect_bodies(entry->stmts, bodies);
+
+  size_t total = 0;
+  for (size_t round = 0; round < max_rounds; round++) {
+    size_t num_of_round = 0;
+
+    for (size_t i = 0; i < passes.size(); i++) {
+      for (auto body : bodies) {
+        size_t n = passes[i]->run(*body);
+        num_of_rewrites[i] += n;
+        num_of_round += n;
+      }
+    }
+
+    total += num_of_round;
+    if (num_of_round == 0) {
+      break;
+    }
+  }
+
+  return total;
+}
+
+std::vector<std::pair<const char*, size_t>>
+StyioIRPassManager::get_stats() const {
+  std::vector<std::pair<const char*, size_t>> stats;
+  for (size_t i = 0; i < passes.size(); i++) {
+    stats.emplace_back(passes[i]->name(), num_of_rewrites[i]);
+  }
+  return stats;
+}
@@ -0,0 +1,109 @@
+#pragma once
+#ifndef STYIO_IR_PASSES_H_
+#define STYIO_IR_PASSES_H_
+
+// [C++ STL]
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// [Styio]
+#include "../IRDecl.hpp"
+
+/*
+  StyioIRPass: one rewrite of the statements of a body.
+
+  A body is the main entry or the block of a function, the two scopes
+  StyioToLLVM knows about. A pass may rewrite expressions in place, or
+  replace and drop statements, and returns how many rewrites it made.
+*/
+class StyioIRPass
+{
+public:
+  virtual ~StyioIRPass() {}
+
+  virtual const char* name() const = 0;
+
+  virtual size_t run(std::vector<StyioIR*>& stmts) = 0;
+};
+
+/* Parse every literal once: SGConstInt / SGConstFloat `canonical` */
+class StyioCanonLiterals : public StyioIRPass
+{
+public:
+  const char* name() const override {
+    return "canon-literals";
+  }
+
+  size_t run(std::vector<StyioIR*>& stmts) override;
+};
+
+/* SGBinOp / SGCond on constants -> constant */
+class StyioConstFold : public StyioIRPass
+{
+public:
+  const char* name() const override {
+    return "const-fold";
+  }
+
+  size_t run(std::vector<StyioIR*>& stmts) override;
+};
+
+/* x : i32 := 5, then x + 1 -> 5 + 1, in the type of x */
+class StyioConstProp : public StyioIRPass
+{
+public:
+  const char* name() const override {
+    return "const-prop";
+  }
+
+  size_t run(std::vector<StyioIR*>& stmts) override;
+};
+
+/* Drop bindings that are never read and compute nothing with side effects */
+class StyioDeadBinds : public StyioIRPass
+{
+public:
+  const char* name() const override {
+    return "dead-binds";
+  }
+
+  size_t run(std::vector<StyioIR*>& stmts) override;
+};
+
+/*
+  StyioIRPassManager: runs its passes over every body of a program, in
+  the order they were added, and again while they still rewrite
+  something (folding makes constants to propagate, which makes more to
+  fold), at most `max_rounds` times.
+
+  Usage:
+    StyioIRPassManager passes = StyioIRPassManager::Default();
+    passes.run(styio_ir);
+*/
+class StyioIRPassManager
+{
+private:
+  std::vector<std::unique_ptr<StyioIRPass>> passes;
+  std::vector<size_t> num_of_rewrites; /* per pass, over all runs */
+
+public:
+  static constexpr size_t max_rounds = 8;
+
+  /* canon-literals, const-fold, const-prop, dead-binds */
+  static StyioIRPassManager Default();
+
+  void add(std::unique_ptr<StyioIRPass> pass) {
+    passes.push_back(std::move(pass));
+    num_of_rewrites.push_back(0);
+  }
+
+  /* Rewrite `program` (an SGMainEntry) in place, the number of rewrites */
+  size_t run(StyioIR* program);
+
+  /* (pass name, rewrites) */
+  std::vector<std::pair<const char*, size_t>> get_stats() const;
+};
+
+#endif
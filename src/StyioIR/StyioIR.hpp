@@ -3,7 +3,10 @@
 #define STYIO_IR_BASE_H_
 
 // [C++ STL]
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <vector>
 
 // [LLVM]
 #include "llvm/IR/Type.h"
@@ -16,11 +19,26 @@
 
 class StyioIR
 {
+private:
+  /* nodes created by this thread, for `--time-phases` */
+  static inline thread_local size_t num_of_created = 0;
+
 public:
+  StyioIR();
+
   virtual ~StyioIR() {}
 
+  static size_t get_num_of_created() {
+    return num_of_created;
+  }
+
   /* StyioAST to String */
-  virtual std::string toString(StyioRepr* visitor, int indent = 0) = 0;
+  std::string toString(StyioRepr* visitor, int indent = 0) {
+    return visitor->toString(this, indent);
+  }
+
+  /* Write into the output of `visitor`, see StyioReprWriter */
+  virtual void writeRepr(StyioRepr* visitor, int indent = 0) = 0;
 
   /* Get LLVM Type */
   virtual llvm::Type* toLLVMType(StyioToLLVM* visitor) = 0;
@@ -29,12 +47,82 @@ public:
   virtual llvm::Value* toLLVMIR(StyioToLLVM* visitor) = 0;
 };
 
+/*
+  StyioIRNodes: owns the nodes that this thread creates while it is the
+  current owner (see StyioIRNodes::Scope), and deletes them all at once,
+  e.g. the StyioIR of one statement of a StyioSession.
+
+  Without a current owner, nodes live forever as they used to.
+
+  Usage:
+    StyioIRNodes nodes;
+    {
+      StyioIRNodes::Scope scope(nodes);
+      ir = ast->toStyioIR(&analyzer);
+    }
+*/
+class StyioIRNodes
+{
+private:
+  std::vector<std::unique_ptr<StyioIR>> nodes;
+
+  static inline thread_local StyioIRNodes* current_nodes = nullptr;
+
+public:
+  StyioIRNodes() {}
+
+  StyioIRNodes(const StyioIRNodes&) = delete;
+  StyioIRNodes& operator=(const StyioIRNodes&) = delete;
+
+  /* `node` is deleted with this owner */
+  void adopt(StyioIR* node) {
+    nodes.emplace_back(node);
+  }
+
+  size_t num_of_nodes() const {
+    return nodes.size();
+  }
+
+  static StyioIRNodes* current() {
+    return current_nodes;
+  }
+
+  /* Make `nodes` the current owner of this thread for a while. */
+  class Scope
+  {
+  private:
+    StyioIRNodes* previous;
+
+  public:
+    explicit Scope(StyioIRNodes& nodes) :
+        previous(current_nodes) {
+      current_nodes = &nodes;
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    ~Scope() {
+      current_nodes = previous;
+    }
+  };
+};
+
+/* Constructors of StyioIR nodes only store their operands, and do not throw */
+inline StyioIR::StyioIR() {
+  num_of_created += 1;
+
+  if (auto owner = StyioIRNodes::current()) {
+    owner->adopt(this);
+  }
+}
+
 template <class Derived>
 class StyioIRTraits : public StyioIR
 {
 public:
-  std::string toString(StyioRepr* visitor, int indent = 0) override {
-    return visitor->toString(static_cast<Derived*>(this), indent);
+  void writeRepr(StyioRepr* visitor, int indent = 0) override {
+    visitor->write(static_cast<Derived*>(this), indent);
   }
 
   llvm::Type* toLLVMType(StyioToLLVM* visitor) override {
@@ -0,0 +1,205 @@
+// [C++ STL]
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// [Styio]
+#include "ObjectCache.hpp"
+
+// [LLVM]
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA256.h"
+#include "llvm/Support/raw_ostream.h"
+
+#ifndef STYIO_VERSION
+#define STYIO_VERSION "unknown"
+#endif
+
+namespace fs = std::filesystem;
+
+/* Modules that were not given a key (e.g. "styio") are not cached */
+static bool
+is_key(llvm::StringRef key) {
+  return key.size() == 64 && llvm::all_of(key, llvm::isHexDigit);
+}
+
+StyioObjectCache::StyioObjectCache(std::string dir, uint64_t max_bytes) :
+    dir(std::move(dir)), max_bytes(max_bytes) {
+  std::error_code ec;
+  fs::create_directories(this->dir, ec);
+}
+
+std::string
+StyioObjectCache::get_default_dir() {
+  if (const char* dir = std::getenv("STYIO_CACHE_DIR")) {
+    return dir;
+  }
+
+  if (const char* dir = std::getenv("XDG_CACHE_HOME")) {
+    return (fs::path(dir) / "styio").string();
+  }
+
+  if (const char* home = std::getenv("HOME")) {
+    return (fs::path(home) / ".cache" / "styio").string();
+  }
+
+  return (fs::temp_directory_path() / "styio-cache").string();
+}
+
+std::string
+StyioObjectCache::make_key(
+  const std::vector<std::string_view>& sources,
+  unsigned opt_level,
+  const llvm::orc::JITTargetMachineBuilder& JTMB
+) {
+  llvm::SHA256 hasher;
+
+  /* every field ends with a 0, so no two lists of fields hash the same */
+  auto add = [&hasher](llvm::StringRef field) {
+    hasher.update(field);
+    hasher.update(llvm::StringRef("\0", 1));
+  };
+
+  add("styio " STYIO_VERSION);
+  add("llvm " LLVM_VERSION_STRING);
+  add("-O" + std::to_string(opt_level));
+
+  add(JTMB.getTargetTriple().str());
+  add(JTMB.getCPU());
+  add(JTMB.getFeatures().getString());
+
+  add(std::to_string(sources.size()));
+  for (auto source : sources) {
+    add(std::to_string(source.size()));
+    add(llvm::StringRef(source.data(), source.size()));
+  }
+
+  return llvm::toHex(hasher.final(), /* LowerCase */ true);
+}
+
+std::string
+StyioObjectCache::get_path(llvm::StringRef key) const {
+  return (fs::path(dir) / (key.str() + ".o")).string();
+}
+
+std::unique_ptr<llvm::MemoryBuffer>
+StyioObjectCache::load(llvm::StringRef key) {
+  std::string path = get_path(key);
+
+  auto buffer = llvm::MemoryBuffer::getFile(path, /* IsText */ false, /* RequiresNullTerminator */ false);
+  if (not buffer) {
+    num_of_misses += 1;
+    return nullptr;
+  }
+
+  /* most recently used: eviction goes by the modification time */
+  std::error_code ec;
+  fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+
+  num_of_hits += 1;
+  return std::move(*buffer);
+}
+
+bool
+StyioObjectCache::store(llvm::StringRef key, llvm::MemoryBufferRef object) {
+  int fd;
+  llvm::SmallString<256> tmp_path;
+  std::string model = (fs::path(dir) / (key.str() + "-%%%%%%%%.tmp")).string();
+  if (llvm::sys::fs::createUniqueFile(model, fd, tmp_path)) {
+    return false;
+  }
+
+  {
+    llvm::raw_fd_ostream out(fd, /* shouldClose */ true);
+    out << object.getBuffer();
+    out.close();
+
+    if (out.has_error()) {
+      out.clear_error();
+      llvm::sys::fs::remove(tmp_path);
+      return false;
+    }
+  }
+
+  /* readers see the old entry or the new one, never half of it */
+  if (llvm::sys::fs::rename(tmp_path, get_path(key))) {
+    llvm::sys::fs::remove(tmp_path);
+    return false;
+  }
+
+  num_of_stores += 1;
+  evict();
+  return true;
+}
+
+void
+StyioObjectCache::evict() {
+  struct Entry
+  {
+    fs::path path;
+    uint64_t size;
+    fs::file_time_type used;
+  };
+
+  std::vector<Entry> entries;
+  uint64_t total = 0;
+
+  std::error_code ec;
+  for (auto it = fs::directory_iterator(dir, ec); not ec && it != fs::directory_iterator(); it.increment(ec)) {
+    if (it->path().extension() != ".o") {
+      continue;
+    }
+
+    std::error_code entry_ec;
+    uint64_t size = it->file_size(entry_ec);
+    auto used = it->last_write_time(entry_ec);
+    if (entry_ec) {
+      /* removed by another process meanwhile */
+      continue;
+    }
+
+    entries.push_back({it->path(), size, used});
+    total += size;
+  }
+
+  if (total <= max_bytes) {
+    return;
+  }
+
+  std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+    return a.used < b.used;
+  });
+
+  for (auto const& entry : entries) {
+    if (total <= max_bytes) {
+      break;
+    }
+
+    /* another process may have removed it already, it is gone either way */
+    fs::remove(entry.path, ec);
+    total -= entry.size;
+  }
+}
+
+void
+StyioObjectCache::notifyObjectCompiled(const llvm::Module* M, llvm::MemoryBufferRef Obj) {
+  if (is_key(M->getModuleIdentifier())) {
+    store(M->getModuleIdentifier(), Obj);
+  }
+}
+
+std::unique_ptr<llvm::MemoryBuffer>
+StyioObjectCache::getObject(const llvm::Module* M) {
+  if (is_key(M->getModuleIdentifier())) {
+    return load(M->getModuleIdentifier());
+  }
+
+  return nullptr;
+}
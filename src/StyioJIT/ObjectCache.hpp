@@ -0,0 +1,87 @@
+#pragma once
+#ifndef STYIO_OBJECT_CACHE_H_
+#define STYIO_OBJECT_CACHE_H_
+
+// [C++ STL]
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// [LLVM]
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+/*
+  StyioObjectCache: compiled objects on disk, one `<key>.o` per program.
+
+  The key is a hash of everything the object depends on (see make_key),
+  and is the module identifier of the module the JIT compiles, so the
+  compile layer finds the entry by itself. A hit can also be loaded
+  before any IR is made (load), which is what a warm start does.
+
+  Writers never touch a finished entry: an object is written to a unique
+  temporary file and renamed over `<key>.o`, which is atomic, so several
+  processes may fill the same cache. Reading an entry marks it as used;
+  after every store the least recently used entries are removed until
+  the cache fits in `max_bytes`.
+*/
+class StyioObjectCache : public llvm::ObjectCache
+{
+  std::string dir;
+  uint64_t max_bytes;
+
+  std::atomic<size_t> num_of_hits = 0;
+  std::atomic<size_t> num_of_misses = 0;
+  std::atomic<size_t> num_of_stores = 0;
+
+  std::string get_path(llvm::StringRef key) const;
+
+public:
+  StyioObjectCache(std::string dir, uint64_t max_bytes);
+
+  /* $STYIO_CACHE_DIR, else $XDG_CACHE_HOME/styio, else ~/.cache/styio */
+  static std::string get_default_dir();
+
+  /* Hex SHA-256 of the sources, the compiler, `opt_level` and the target */
+  static std::string make_key(
+    const std::vector<std::string_view>& sources,
+    unsigned opt_level,
+    const llvm::orc::JITTargetMachineBuilder& JTMB
+  );
+
+  /* The object of `key`, null if there is none */
+  std::unique_ptr<llvm::MemoryBuffer> load(llvm::StringRef key);
+
+  /* Write the object of `key`, then evict; false if it could not be written */
+  bool store(llvm::StringRef key, llvm::MemoryBufferRef object);
+
+  /* Remove the least recently used entries until the cache fits */
+  void evict();
+
+  /* [llvm::ObjectCache] keyed by the module identifier */
+  void notifyObjectCompiled(const llvm::Module* M, llvm::MemoryBufferRef Obj) override;
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* M) override;
+
+  const std::string& get_dir() const {
+    return dir;
+  }
+
+  size_t get_num_of_hits() const {
+    return num_of_hits;
+  }
+
+  size_t get_num_of_misses() const {
+    return num_of_misses;
+  }
+
+  size_t get_num_of_stores() const {
+    return num_of_stores;
+  }
+};
+
+#endif
@@ -1,51 +1,154 @@
 #ifndef STYIO_LLVM_EXECUTIONENGINE_ORC_JIT_H
 #define STYIO_LLVM_EXECUTIONENGINE_ORC_JIT_H
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "../StyioExtern/ExternLib.hpp"
+#include "ObjectCache.hpp"
 
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/ExecutionEngine/JITSymbol.h"
+#include "llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h"
 #include "llvm/ExecutionEngine/Orc/CompileUtils.h"
 #include "llvm/ExecutionEngine/Orc/Core.h"
 #include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
 #include "llvm/ExecutionEngine/Orc/ExecutorProcessControl.h"
 #include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
+#include "llvm/ExecutionEngine/Orc/IRTransformLayer.h"
+#include "llvm/ExecutionEngine/Orc/IndirectionUtils.h"
 #include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/ExecutionEngine/Orc/LazyReexports.h"
 #include "llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h"
 #include "llvm/ExecutionEngine/Orc/Shared/ExecutorSymbolDef.h"
+#include "llvm/ExecutionEngine/Orc/TaskDispatch.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/TargetParser/Host.h"
+
+/* How StyioJIT_ORC compiles */
+struct StyioJITOptions
+{
+  /*
+    Compile each function on its first call: the module is split per
+    function by a CompileOnDemandLayer, and every function is reached
+    through a lazy re-export (a stub) until it has been compiled.
+  */
+  bool lazy = false;
+
+  /*
+    Tier 0 compiles fast (no optimization, FastISel) and counts calls and
+    loop back-edges of every function. A function that reaches either
+    threshold is recompiled at -O3 in the background, see StyioTieredJIT.
+  */
+  bool tiered = false;
+  uint64_t tier_up_calls = 1000;
+  uint64_t tier_up_loops = 10000;
+
+  /*
+    More than one: modules are compiled on a pool of threads, so the
+    modules of a program (see StyioToLLVM::lower_in_parallel) are compiled
+    side by side when they are looked up together.
+  */
+  unsigned compile_threads = 1;
+
+  /* The -O level, for the code generator too (but tier 0 of tiered) */
+  unsigned opt_level = 0;
+
+  /*
+    Empty: the CPU of this machine and all of its features. A CPU alone
+    comes with the features of that CPU; the features (e.g. "+avx2,-fma")
+    are added on top.
+  */
+  std::string cpu;
+  std::string features;
+};
 
 class StyioJIT_ORC
 {
 private:
   std::unique_ptr<llvm::orc::ExecutionSession> ES;
 
+  StyioJITOptions Options;
+
+  llvm::orc::JITTargetMachineBuilder JTMB;
   llvm::DataLayout DL;
   llvm::orc::MangleAndInterner Mangle;
 
+  /* null: compile every module */
+  std::unique_ptr<StyioObjectCache> Cache;
+
   llvm::orc::RTDyldObjectLinkingLayer ObjectLayer;
   llvm::orc::IRCompileLayer CompileLayer;
 
+  /* Counts the functions that reach the compiler, then compiles them */
+  std::atomic<size_t> NumOfMaterialized = 0;
+  llvm::orc::IRTransformLayer CountLayer;
+
+  /* [Lazy] null unless StyioJITOptions::lazy */
+  std::unique_ptr<llvm::orc::LazyCallThroughManager> LCTM;
+  std::unique_ptr<llvm::orc::CompileOnDemandLayer> CODLayer;
+
   llvm::orc::JITDylib &MainJD;
 
+  /* A stub was called, but its function could not be compiled */
+  static void handleLazyCallThroughError() {
+    std::cerr << "styio: a lazily compiled function failed to compile" << std::endl;
+    std::exit(1);
+  }
+
+  llvm::Error enableLazyCompilation() {
+    auto LCTMOrErr = llvm::orc::createLocalLazyCallThroughManager(
+      JTMB.getTargetTriple(), *ES, llvm::orc::ExecutorAddr::fromPtr(&handleLazyCallThroughError)
+    );
+    if (!LCTMOrErr)
+      return LCTMOrErr.takeError();
+    LCTM = std::move(*LCTMOrErr);
+
+    CODLayer = std::make_unique<llvm::orc::CompileOnDemandLayer>(
+      *ES, CountLayer, *LCTM, llvm::orc::createLocalIndirectStubsManagerBuilder(JTMB.getTargetTriple())
+    );
+    /* one function per partition, not the whole module on the first call */
+    CODLayer->setPartitionFunction(llvm::orc::CompileOnDemandLayer::compileRequested);
+
+    return llvm::Error::success();
+  }
+
 public:
   StyioJIT_ORC(
     std::unique_ptr<llvm::orc::ExecutionSession> ES,
     llvm::orc::JITTargetMachineBuilder JTMB,
-    llvm::DataLayout DL
+    llvm::DataLayout DL,
+    std::unique_ptr<StyioObjectCache> Cache = nullptr
   ) :
       ES(std::move(ES)),
+      JTMB(JTMB),
       DL(std::move(DL)),
       Mangle(*this->ES, this->DL),
+      Cache(std::move(Cache)),
       ObjectLayer(*this->ES, []()
                   {
                     return std::make_unique<llvm::SectionMemoryManager>();
                   }),
-      CompileLayer(*this->ES, ObjectLayer, std::make_unique<llvm::orc::ConcurrentIRCompiler>(std::move(JTMB))),
+      CompileLayer(*this->ES, ObjectLayer, std::make_unique<llvm::orc::ConcurrentIRCompiler>(std::move(JTMB), this->Cache.get())),
+      CountLayer(*this->ES, CompileLayer, [this](llvm::orc::ThreadSafeModule TSM, llvm::orc::MaterializationResponsibility &) {
+        TSM.withModuleDo([this](llvm::Module &M) {
+          for (auto &F : M)
+            if (!F.isDeclaration())
+              NumOfMaterialized += 1;
+        });
+        return llvm::Expected<llvm::orc::ThreadSafeModule>(std::move(TSM));
+      }),
       MainJD(this->ES->createBareJITDylib("<main>")) {
     MainJD.addGenerator(llvm::cantFail(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(DL.getGlobalPrefix())));
 
@@ -61,7 +164,7 @@ public:
     //   DL.getGlobalPrefix(),
     //   [&](const llvm::orc::SymbolStringPtr &S) { return AllowList.count(S); })));
 
-    if (JTMB.getTargetTriple().isOSBinFormatCOFF()) {
+    if (this->JTMB.getTargetTriple().isOSBinFormatCOFF()) {
       ObjectLayer.setOverrideObjectFlagsWithResponsibilityFlags(true);
       ObjectLayer.setAutoClaimResponsibilityForObjectSymbols(true);
     }
@@ -72,26 +175,141 @@ public:
       ES->reportError(std::move(Err));
   }
 
-  static llvm::Expected<std::unique_ptr<StyioJIT_ORC>> Create() {
-    auto EPC = llvm::orc::SelfExecutorProcessControl::Create();
+  /* With a cache, modules named by StyioObjectCache::make_key are compiled once */
+  static llvm::Expected<std::unique_ptr<StyioJIT_ORC>> Create(
+    std::unique_ptr<StyioObjectCache> Cache = nullptr,
+    StyioJITOptions Options = {}
+  ) {
+    std::unique_ptr<llvm::orc::TaskDispatcher> D = nullptr;
+#if LLVM_ENABLE_THREADS
+    if (Options.compile_threads > 1)
+      D = std::make_unique<llvm::orc::DynamicThreadPoolTaskDispatcher>();
+#endif
+
+    auto EPC = llvm::orc::SelfExecutorProcessControl::Create(nullptr, std::move(D));
     if (!EPC)
       return EPC.takeError();
 
     auto ES = std::make_unique<llvm::orc::ExecutionSession>(std::move(*EPC));
 
-    llvm::orc::JITTargetMachineBuilder JTMB(ES->getExecutorProcessControl().getTargetTriple());
+    auto JTMB = makeTargetMachineBuilder(ES->getExecutorProcessControl().getTargetTriple(), Options);
+    if (!JTMB)
+      return JTMB.takeError();
 
-    auto DL = JTMB.getDefaultDataLayoutForTarget();
+    auto DL = JTMB->getDefaultDataLayoutForTarget();
     if (!DL)
       return DL.takeError();
 
-    return std::make_unique<StyioJIT_ORC>(std::move(ES), std::move(JTMB), std::move(*DL));
+    auto JIT = std::make_unique<StyioJIT_ORC>(std::move(ES), std::move(*JTMB), std::move(*DL), std::move(Cache));
+    JIT->Options = Options;
+
+    if (Options.lazy) {
+      if (auto Err = JIT->enableLazyCompilation())
+        return std::move(Err);
+    }
+
+    return JIT;
+  }
+
+  /* The host CPU and features unless overridden, see StyioJITOptions */
+  static llvm::Expected<llvm::orc::JITTargetMachineBuilder> makeTargetMachineBuilder(
+    const llvm::Triple &TT,
+    const StyioJITOptions &Options
+  ) {
+    llvm::orc::JITTargetMachineBuilder JTMB(TT);
+
+    if (Options.cpu.empty()) {
+      /* the host, as far as the triple is the host */
+      if (TT == llvm::Triple(llvm::sys::getProcessTriple())) {
+        auto Host = llvm::orc::JITTargetMachineBuilder::detectHost();
+        if (!Host)
+          return Host.takeError();
+        JTMB = std::move(*Host);
+      }
+    }
+    else {
+      std::string Error;
+      const llvm::Target *T = llvm::TargetRegistry::lookupTarget(TT.str(), Error);
+      if (!T)
+        return llvm::make_error<llvm::StringError>(Error, llvm::inconvertibleErrorCode());
+
+      /* the generic CPU, as an unknown one would warn on stderr */
+      std::unique_ptr<llvm::MCSubtargetInfo> STI(T->createMCSubtargetInfo(TT.str(), "", ""));
+      if (!STI || !STI->isCPUStringValid(Options.cpu))
+        return llvm::make_error<llvm::StringError>(
+          "unknown CPU '" + Options.cpu + "' for " + TT.str(), llvm::inconvertibleErrorCode()
+        );
+
+      JTMB.setCPU(Options.cpu);
+    }
+
+    if (!Options.features.empty()) {
+      llvm::SmallVector<llvm::StringRef, 8> Features;
+      llvm::StringRef(Options.features).split(Features, ',', -1, /* KeepEmpty */ false);
+      JTMB.addFeatures(std::vector<std::string>(Features.begin(), Features.end()));
+    }
+
+    if (Options.tiered) {
+      /* tier 0: as fast to compile as it gets, what is hot is compiled again */
+      JTMB.setCodeGenOptLevel(llvm::CodeGenOptLevel::None);
+      JTMB.getOptions().EnableFastISel = true;
+    }
+    else {
+      const llvm::CodeGenOptLevel Levels[] = {
+        llvm::CodeGenOptLevel::None,
+        llvm::CodeGenOptLevel::Less,
+        llvm::CodeGenOptLevel::Default,
+        llvm::CodeGenOptLevel::Aggressive,
+      };
+      JTMB.setCodeGenOptLevel(Levels[std::min(Options.opt_level, 3u)]);
+    }
+
+    return JTMB;
   }
 
   const llvm::DataLayout &getDataLayout() const {
     return DL;
   }
 
+  const llvm::Triple &getTargetTriple() const {
+    return JTMB.getTargetTriple();
+  }
+
+  /* The machine the JIT compiles for, e.g. for the cost models of the optimizer */
+  const llvm::orc::JITTargetMachineBuilder &getTargetMachineBuilder() const {
+    return JTMB;
+  }
+
+  const StyioJITOptions &getOptions() const {
+    return Options;
+  }
+
+  llvm::orc::ExecutionSession &getExecutionSession() {
+    return *ES;
+  }
+
+  /* Where compiled objects are linked, e.g. to add a compile layer of another level */
+  llvm::orc::ObjectLayer &getObjectLayer() {
+    return ObjectLayer;
+  }
+
+  llvm::orc::SymbolStringPtr mangle(llvm::StringRef Name) {
+    return Mangle(Name.str());
+  }
+
+  bool isLazy() const {
+    return CODLayer != nullptr;
+  }
+
+  /* Functions compiled so far; with lazy compilation, the ones called so far */
+  size_t getNumOfMaterializedFunctions() const {
+    return NumOfMaterialized;
+  }
+
+  StyioObjectCache *getObjectCache() {
+    return Cache.get();
+  }
+
   llvm::orc::JITDylib &getMainJITDylib() {
     return MainJD;
   }
@@ -99,7 +317,14 @@ public:
   llvm::Error addModule(llvm::orc::ThreadSafeModule TSM, llvm::orc::ResourceTrackerSP RT = nullptr) {
     if (!RT)
       RT = MainJD.getDefaultResourceTracker();
-    return CompileLayer.add(RT, std::move(TSM));
+    if (CODLayer)
+      return CODLayer->add(RT, std::move(TSM));
+    return CountLayer.add(RT, std::move(TSM));
+  }
+
+  /* An object that is compiled already, e.g. from the cache */
+  llvm::Error addObject(std::unique_ptr<llvm::MemoryBuffer> Obj) {
+    return ObjectLayer.add(MainJD, std::move(Obj));
   }
 
   llvm::Expected<llvm::orc::ExecutorSymbolDef> lookup(llvm::StringRef Name) {
@@ -0,0 +1,269 @@
+// [C++ STL]
+#include <iostream>
+#include <string>
+
+// [Styio]
+#include "../StyioCodeGen/CodeGenVisitor.hpp"
+#include "../StyioUtil/Phases.hpp"
+#include "TieredJIT.hpp"
+
+// [LLVM]
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Analysis/CFG.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/Passes/OptimizationLevel.h"
+#include "llvm/Transforms/Utils/BasicBlockUtils.h"
+
+/* [tier 0] called by the counters, see StyioTieredJIT::instrument */
+extern "C" void
+styio_tier_up(StyioTieredJIT* tiers, uint32_t index) {
+  tiers->request_tier_up(index);
+}
+
+StyioTieredJIT::StyioTieredJIT(StyioJIT_ORC& jit) :
+    jit(jit),
+    tier_up_calls(jit.getOptions().tier_up_calls),
+    tier_up_loops(jit.getOptions().tier_up_loops),
+    tier1_JTMB(jit.getTargetMachineBuilder()) {
+  tier1_JTMB.setCodeGenOptLevel(llvm::CodeGenOptLevel::Aggressive);
+  tier1_JTMB.getOptions().EnableFastISel = false;
+
+  tier1_layer = std::make_unique<llvm::orc::IRCompileLayer>(
+    jit.getExecutionSession(),
+    jit.getObjectLayer(),
+    std::make_unique<llvm::orc::ConcurrentIRCompiler>(tier1_JTMB)
+  );
+
+  stubs = llvm::orc::createLocalIndirectStubsManagerBuilder(jit.getTargetTriple())();
+
+  llvm::cantFail(jit.getMainJITDylib().define(llvm::orc::absoluteSymbols(llvm::orc::SymbolMap({
+    { jit.mangle("styio.tier_up"), { llvm::orc::ExecutorAddr::fromPtr(&styio_tier_up), llvm::JITSymbolFlags::Callable } }
+  }))));
+
+  worker = std::thread(&StyioTieredJIT::run, this);
+}
+
+StyioTieredJIT::~StyioTieredJIT() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    is_stopping = true;
+  }
+  wake_up.notify_all();
+  worker.join();
+}
+
+/*
+  A counter is an atomic add in the memory of the compiler, and when
+  the old value is one below the threshold (so exactly once), a call of
+  styio.tier_up. A threshold of 0 never tiers up. Back-edges are counted
+  in the block they leave, so a loop exit from that block counts too.
+*/
+void
+StyioTieredJIT::instrument(llvm::Module& M) {
+  llvm::IRBuilder<> builder(M.getContext());
+
+  llvm::FunctionCallee tier_up_func = M.getOrInsertFunction(
+    "styio.tier_up",
+    llvm::FunctionType::get(builder.getVoidTy(), {builder.getPtrTy(), builder.getInt32Ty()}, false)
+  );
+
+  auto count = [&](llvm::Instruction* before, std::atomic<uint64_t>& counter, uint64_t threshold, uint32_t index) {
+    builder.SetInsertPoint(before);
+
+    llvm::Value* counter_addr = builder.CreateIntToPtr(builder.getInt64(uintptr_t(&counter)), builder.getPtrTy());
+    llvm::Value* old_value = builder.CreateAtomicRMW(
+      llvm::AtomicRMWInst::Add, counter_addr, builder.getInt64(1), llvm::MaybeAlign(8), llvm::AtomicOrdering::Monotonic
+    );
+    llvm::Value* is_hot = builder.CreateICmpEQ(old_value, builder.getInt64(threshold - 1));
+
+    builder.SetInsertPoint(llvm::SplitBlockAndInsertIfThen(is_hot, before, /* Unreachable */ false));
+    builder.CreateCall(tier_up_func, {
+      builder.CreateIntToPtr(builder.getInt64(uintptr_t(this)), builder.getPtrTy()),
+      builder.getInt32(index)
+    });
+  };
+
+  std::vector<llvm::Function*> targets;
+  for (auto& F : M) {
+    if (not F.isDeclaration() && F.getName() != "main") {
+      targets.push_back(&F);
+    }
+  }
+
+  for (auto F : targets) {
+    uint32_t index;
+    std::atomic<uint64_t>* calls;
+    std::atomic<uint64_t>* loops;
+    {
+      /* the source of M is added next, see add_module */
+      std::lock_guard<std::mutex> lock(mutex);
+      index = uint32_t(functions.size());
+      functions.push_back({F->getName().str(), sources.size()});
+      calls = &counters.emplace_back(0);
+      loops = &counters.emplace_back(0);
+    }
+
+    if (tier_up_loops > 0) {
+      llvm::SmallVector<std::pair<const llvm::BasicBlock*, const llvm::BasicBlock*>> backedges;
+      llvm::FindFunctionBackedges(*F, backedges);
+
+      llvm::SmallPtrSet<const llvm::BasicBlock*, 8> latches;
+      for (auto const& [from, to] : backedges) {
+        if (latches.insert(from).second) {
+          count(const_cast<llvm::BasicBlock*>(from)->getTerminator(), *loops, tier_up_loops, index);
+        }
+      }
+    }
+
+    if (tier_up_calls > 0) {
+      /* after the allocas, which stay in the entry block */
+      auto entry = F->getEntryBlock().getFirstInsertionPt();
+      while (llvm::isa<llvm::AllocaInst>(*entry)) {
+        ++entry;
+      }
+      count(&*entry, *calls, tier_up_calls, index);
+    }
+
+    /* callers, and the function itself, go through the stub `name` */
+    std::string name = F->getName().str();
+    F->setName(name + ".tier0");
+    llvm::Function* stub = llvm::Function::Create(F->getFunctionType(), llvm::GlobalValue::ExternalLinkage, name, M);
+    F->replaceAllUsesWith(stub);
+  }
+}
+
+llvm::Error
+StyioTieredJIT::add_module(llvm::orc::ThreadSafeModule TSM) {
+  size_t first = functions.size();
+
+  /* one per module: a function tiers up from the module it came from */
+  llvm::orc::ThreadSafeModule source = llvm::orc::cloneToNewContext(TSM);
+  TSM.withModuleDo([this](llvm::Module& M) {
+    instrument(M);
+  });
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    sources.push_back(std::move(source));
+  }
+
+  /* the stubs exist before tier 0 is linked against them, and point nowhere yet */
+  llvm::orc::IndirectStubsManager::StubInitsMap stub_inits;
+  for (size_t i = first; i < functions.size(); i++) {
+    stub_inits[functions[i].name] = {llvm::orc::ExecutorAddr(), llvm::JITSymbolFlags::Exported | llvm::JITSymbolFlags::Callable};
+  }
+  if (auto err = stubs->createStubs(stub_inits)) {
+    return err;
+  }
+
+  llvm::orc::SymbolMap stub_symbols;
+  for (size_t i = first; i < functions.size(); i++) {
+    stub_symbols[jit.mangle(functions[i].name)] = stubs->findStub(functions[i].name, /* ExportedStubsOnly */ false);
+  }
+  if (auto err = jit.getMainJITDylib().define(llvm::orc::absoluteSymbols(std::move(stub_symbols)))) {
+    return err;
+  }
+
+  if (auto err = jit.addModule(std::move(TSM))) {
+    return err;
+  }
+
+  for (size_t i = first; i < functions.size(); i++) {
+    auto tier0 = jit.lookup(functions[i].name + ".tier0");
+    if (not tier0) {
+      return tier0.takeError();
+    }
+
+    if (auto err = stubs->updatePointer(functions[i].name, tier0->getAddress())) {
+      return err;
+    }
+  }
+
+  return llvm::Error::success();
+}
+
+void
+StyioTieredJIT::request_tier_up(uint32_t index) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    queue.push_back(index);
+  }
+  wake_up.notify_one();
+}
+
+void
+StyioTieredJIT::run() {
+  while (true) {
+    uint32_t index;
+
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wake_up.wait(lock, [this]() {
+        return is_stopping || not queue.empty();
+      });
+
+      if (is_stopping) {
+        return;
+      }
+
+      index = queue.front();
+      queue.pop_front();
+    }
+
+    tier_up(index);
+  }
+}
+
+void
+StyioTieredJIT::tier_up(uint32_t index) {
+  StyioPhase phase("tier-up");
+
+  std::string name;
+  llvm::orc::ThreadSafeModule* source;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    name = functions[index].name;
+    source = &sources[functions[index].source];
+  }
+
+  /* `name` alone, what it calls stays behind the stubs */
+  auto TSM = llvm::orc::cloneToNewContext(*source, [&name](const llvm::GlobalValue& GV) {
+    return GV.getName() == name || GV.hasLocalLinkage();
+  });
+
+  TSM.withModuleDo([&](llvm::Module& M) {
+    M.getFunction(name)->setName(name + ".tier1");
+    StyioToLLVM::optimize_module(M, llvm::OptimizationLevel::O3, tier1_JTMB);
+  });
+
+  if (auto err = tier1_layer->add(jit.getMainJITDylib(), std::move(TSM))) {
+    jit.getExecutionSession().reportError(std::move(err));
+    return;
+  }
+
+  auto tier1 = jit.lookup(name + ".tier1");
+  if (not tier1) {
+    jit.getExecutionSession().reportError(tier1.takeError());
+    return;
+  }
+
+  if (auto err = stubs->updatePointer(name, tier1->getAddress())) {
+    jit.getExecutionSession().reportError(std::move(err));
+    return;
+  }
+
+  num_of_tier_ups += 1;
+  phase.count("functions", 1);
+  phase.end();
+
+  if (StyioPhases::is_enabled()) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::cerr
+      << "tier-up: " << name
+      << " (calls " << counters[2 * index] << ", back-edges " << counters[2 * index + 1] << ")"
+      << std::endl;
+  }
+}
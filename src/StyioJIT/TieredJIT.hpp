@@ -0,0 +1,99 @@
+#pragma once
+#ifndef STYIO_TIERED_JIT_H_
+#define STYIO_TIERED_JIT_H_
+
+// [C++ STL]
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// [Styio]
+#include "StyioJIT_ORC.hpp"
+
+// [LLVM]
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
+#include "llvm/ExecutionEngine/Orc/IndirectionUtils.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Error.h"
+
+/*
+  StyioTieredJIT: two tiers on top of a StyioJIT_ORC made with
+  StyioJITOptions::tiered.
+
+  Every function `f` of the module (but main) is renamed to `f.tier0`,
+  and every call of `f` goes through an indirection stub named `f`,
+  which points at the current tier. Tier 0 is compiled by the JIT as it
+  is, plus two counters per function: calls, counted at the entry, and
+  loop back-edges. The counter that reaches its threshold first calls
+  back into the compiler, which queues `f`; a background thread then
+  compiles `f` alone from an untouched copy of the module at -O3, as
+  `f.tier1`, and points the stub at it. Calls already running in tier 0
+  finish there.
+*/
+class StyioTieredJIT
+{
+  StyioJIT_ORC& jit;
+
+  uint64_t tier_up_calls;
+  uint64_t tier_up_loops;
+
+  /* -O3 machine code, into the object layer of `jit` */
+  std::unique_ptr<llvm::orc::IRCompileLayer> tier1_layer;
+  llvm::orc::JITTargetMachineBuilder tier1_JTMB;
+
+  std::unique_ptr<llvm::orc::IndirectStubsManager> stubs;
+
+  /* the modules before instrumentation, the sources of tier 1 */
+  std::deque<llvm::orc::ThreadSafeModule> sources;
+
+  struct Tier0Function
+  {
+    std::string name;
+    size_t source; /* its module, in `sources` */
+  };
+
+  /* [2 * i] calls, [2 * i + 1] back-edges of functions[i], never moved */
+  std::deque<Tier0Function> functions;
+  std::deque<std::atomic<uint64_t>> counters;
+
+  /* `queue`, and what add_module() appends while the worker reads it */
+  std::mutex mutex;
+  std::condition_variable wake_up;
+  std::deque<uint32_t> queue;
+  bool is_stopping = false;
+  std::thread worker;
+
+  std::atomic<size_t> num_of_tier_ups = 0;
+
+  /* [worker] */
+  void run();
+  void tier_up(uint32_t index);
+
+public:
+  explicit StyioTieredJIT(StyioJIT_ORC& jit);
+
+  ~StyioTieredJIT();
+
+  /* Compile tier 0 of `TSM` and point every stub at it */
+  llvm::Error add_module(llvm::orc::ThreadSafeModule TSM);
+
+  /* Counters, the tier-up call and the stubs of add_module(), see above; IR only */
+  void instrument(llvm::Module& M);
+
+  /* [tier 0] a counter of functions[index] reached its threshold */
+  void request_tier_up(uint32_t index);
+
+  size_t get_num_of_tier_ups() const {
+    return num_of_tier_ups;
+  }
+};
+
+#endif
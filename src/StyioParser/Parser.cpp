@@ -17,6 +17,7 @@
 #include "../StyioUtil/Util.hpp"
 #include "BinExprMapper.hpp"
 #include "Parser.hpp"
+#include "Tokenizer.hpp"
 
 using std::string;
 using std::vector;
@@ -26,6 +27,54 @@ here() {
   std::cout << "here" << std::endl;
 }
 
+/* Text of a quoted literal ('c' or "str") without the quotes */
+static std::string_view
+unquote(std::string_view quoted) {
+  if (quoted.size() >= 2 && quoted.back() == quoted.front()) {
+    return quoted.substr(1, quoted.size() - 2);
+  }
+  return quoted.substr(1);
+}
+
+/*
+  Parse `length` bytes of the source at `offset` as one expression,
+  e.g. the `{expr}` inside a format string. The piece gets its own
+  tokens, shifted back to source offsets for the error messages.
+*/
+static StyioAST*
+parse_expr_at(StyioContext& context, size_t offset, size_t length) {
+  StyioTokenStream stream = StyioTokenizer::tokenize(context.get_code().substr(offset, length));
+  for (auto& tok : stream.tokens) {
+    tok.offset += offset;
+  }
+  for (auto& tok : stream.trivia) {
+    tok.offset += offset;
+  }
+
+  StyioContext inner(context.get_source(), std::move(stream));
+  StyioAST* expr = parse_expr(inner);
+
+  if (not inner.check(StyioTokenType::TOK_EOF)) {
+    throw StyioSyntaxError(inner.mark_cur_tok("Unexpected token in the format string"));
+  }
+
+  return expr;
+}
+
+/* \t\ or \f\ of a conditional flow, the closing backslash is optional */
+static bool
+match_cond_flag(StyioContext& context, std::string_view flag) {
+  if (context.check(StyioTokenType::TOK_BACKSLASH)
+      && context.check_ahead(1, StyioTokenType::NAME)
+      && context.tok_str(context.peek(1)) == flag) {
+    context.move_forward(2, "match_cond_flag");
+    context.match(StyioTokenType::TOK_BACKSLASH);
+    return true;
+  }
+
+  return false;
+}
+
 /*
   =================
   - id
@@ -45,14 +94,14 @@ parse_name_as_str(StyioContext& context) {
     throw StyioParseError(errmsg);
   }
 
-  auto name = context.cur_tok()->original;
+  std::string name(context.cur_tok_str());
   context.move_forward(1, "parse_name_as_str");
   return name;
 }
 
 std::string
 parse_name_as_str_unsafe(StyioContext& context) {
-  auto name = context.cur_tok()->original;
+  std::string name(context.cur_tok_str());
   context.move_forward(1, "parse_name_as_str_unsafe");
   return name;
 }
@@ -61,12 +110,10 @@ std::vector<std::string>
 parse_name_with_spaces_unsafe(StyioContext& context) {
   std::vector<std::string> name_seps;
   do {
-    name_seps.push_back(context.cur_tok()->original);
+    name_seps.emplace_back(context.cur_tok_str());
     context.move_forward(1);
-    while (context.check(StyioTokenType::TOK_SPACE) /* White Space */) {
-      context.move_forward(1);
-    }
-  } while (context.check(StyioTokenType::NAME) || context.check(StyioTokenType::INTEGER));
+  } while ((context.check(StyioTokenType::NAME) || context.check(StyioTokenType::INTEGER))
+           && not context.has_line_break_before() /* one line only */);
 
   return name_seps;
 }
@@ -75,12 +122,10 @@ HashTagNameAST*
 parse_name_for_hash_tag(StyioContext& context) {
   std::vector<std::string> name_seps;
   do {
-    name_seps.push_back(context.cur_tok()->original);
+    name_seps.emplace_back(context.cur_tok_str());
     context.move_forward(1);
-    while (context.check(StyioTokenType::TOK_SPACE) /* White Space */) {
-      context.move_forward(1);
-    }
-  } while (context.check(StyioTokenType::NAME) || context.check(StyioTokenType::INTEGER));
+  } while ((context.check(StyioTokenType::NAME) || context.check(StyioTokenType::INTEGER))
+           && not context.has_line_break_before() /* one line only */);
 
   return HashTagNameAST::Create(name_seps);
 }
@@ -92,26 +137,25 @@ parse_name(StyioContext& context) {
     throw StyioParseError(errmsg);
   }
 
-  auto ret_val = NameAST::Create(context.cur_tok()->original);
+  auto ret_val = NameAST::Create(context.cur_tok_symbol());
   context.move_forward(1, "parse_name");
   return ret_val;
 }
 
 NameAST*
 parse_name_unsafe(StyioContext& context) {
-  auto ret_val = NameAST::Create(context.cur_tok()->original);
+  auto ret_val = NameAST::Create(context.cur_tok_symbol());
   context.move_forward(1, "parse_name_unsafe");
   return ret_val;
 }
 
 StyioAST*
 parse_name_and_following_unsafe(StyioContext& context) {
-  auto name = NameAST::Create(context.cur_tok()->original);
+  auto name = NameAST::Create(context.cur_tok_symbol());
   context.move_forward(1);
 
   StyioAST* output = name;
 
-  context.skip();
   switch (context.cur_tok_type()) {
     /* + */
     case StyioTokenType::TOK_PLUS: {
@@ -157,7 +201,6 @@ parse_name_and_following_unsafe(StyioContext& context) {
     /* . */
     case StyioTokenType::TOK_DOT: {
       context.move_forward(1, "parse_name_and_following(TOK_DOT)");
-      context.skip();
       if (context.check(StyioTokenType::NAME)) {
         auto func_name = parse_name_unsafe(context);
         output = parse_call(context, func_name, name);
@@ -185,7 +228,7 @@ parse_name_and_following_unsafe(StyioContext& context) {
 
 TypeAST*
 parse_name_as_type_unsafe(StyioContext& context) {
-  auto name = context.cur_tok()->original;
+  std::string name(context.cur_tok_str());
   context.move_forward(1, "parse_name_as_type_unsafe");
   return TypeAST::Create(name);
 }
@@ -197,7 +240,7 @@ parse_int(StyioContext& context) {
     throw StyioParseError(errmsg);
   }
 
-  auto ret_val = IntAST::Create(context.cur_tok()->original);
+  auto ret_val = IntAST::Create(std::string(context.cur_tok_str()));
   context.move_forward(1, "parse_int");
   return ret_val;
 }
@@ -209,7 +252,7 @@ parse_float(StyioContext& context) {
     throw StyioParseError(errmsg);
   }
 
-  auto ret_val = FloatAST::Create(context.cur_tok()->original);
+  auto ret_val = FloatAST::Create(std::string(context.cur_tok_str()));
   context.move_forward(1, "parse_float");
   return ret_val;
 }
@@ -221,59 +264,34 @@ parse_string(StyioContext& context) {
     throw StyioParseError(errmsg);
   }
 
-  auto ret_val = StringAST::Create(context.cur_tok()->original);
+  auto ret_val = StringAST::Create(std::string(context.cur_tok_str()));
   context.move_forward(1, "parse_string");
   return ret_val;
 }
 
 StyioAST*
 parse_int_or_float(StyioContext& context) {
-  string digits = "";
-  /* it will include cur_char in the digits without checking */
-  do {
-    digits += context.get_curr_char();
-    context.move(1);
-  } while (context.check_isdigit());
-
-  // int f_exp = 0; /* Float Exponent (Base: 10) */
-  if (context.check_next('.')) {
-    if (context.peak_isdigit(1)) {
-      digits += ".";
-      context.move(1); /* cur_char moves from . to the next */
-      do {
-        digits += context.get_curr_char();
-        context.move(1);
-        // f_exp += 1;
-      } while (context.check_isdigit());
+  switch (context.cur_tok_type()) {
+    case StyioTokenType::INTEGER:
+      return parse_int(context);
 
-      return FloatAST::Create(digits);
-    }
-    else {
-      return IntAST::Create(digits);
-    }
-  }
+    case StyioTokenType::DECIMAL:
+      return parse_float(context);
 
-  return IntAST::Create(digits);
+    default:
+      throw StyioSyntaxError(context.mark_cur_tok("Expected a number"));
+  }
 }
 
 StyioAST*
 parse_char_or_string(StyioContext& context) {
-  /*
-    Danger!
-    when entering parse_char_or_string(),
-    the context -> get_curr_char() must be '
-    this line will drop the next 1 character anyway!
-  */
-  context.move(1);
-  string text = "";
-
-  while (not context.check_next('\'')) {
-    text += context.get_curr_char();
-    context.move(1);
+  if (context.cur_tok_type() != StyioTokenType::CHARACTER) {
+    string errmsg = string("parse_char_or_string(): False Invoke");
+    throw StyioParseError(errmsg);
   }
 
-  // eliminate ' at the end
-  context.move(1);
+  string text(unquote(context.cur_tok_str()));
+  context.move_forward(1, "parse_char_or_string");
 
   if (text.size() == 1) {
     return CharAST::Create(text);
@@ -285,52 +303,51 @@ parse_char_or_string(StyioContext& context) {
 
 FmtStrAST*
 parse_fmt_str(StyioContext& context) {
-  /*
-    Danger!
-    when entering parse_fmt_str(),
-    the context -> get_curr_char() must be "
-    this line will drop the next 1 character anyway!
-  */
-  context.move(1);
+  if (context.cur_tok_type() != StyioTokenType::STRING) {
+    string errmsg = string("parse_fmt_str(): False Invoke");
+    throw StyioParseError(errmsg);
+  }
+
+  /* `text` is a view of the source, so positions in it map back to offsets */
+  std::string_view text = context.cur_tok_str();
+  size_t text_start = context.cur_tok().offset;
+  size_t text_end = (text.size() >= 2 && text.back() == '\"') ? text.size() - 1 : text.size();
 
   vector<string> fragments;
   vector<StyioAST*> exprs;
   string textStr = "";
 
-  while (not context.check_next('\"')) {
-    if (context.check_next('{')) {
-      if (context.check_ahead(1, '{')) {
-        textStr += context.get_curr_char();
-        context.move(2);
+  for (size_t i = 1; i < text_end; i++) {
+    if (text[i] == '{' && i + 1 < text_end && text[i + 1] == '{') {
+      textStr += '{';
+      i += 1;
+    }
+    else if (text[i] == '}' && i + 1 < text_end && text[i + 1] == '}') {
+      textStr += '}';
+      i += 1;
+    }
+    else if (text[i] == '{') {
+      size_t close = text.find('}', i + 1);
+      if (close == std::string_view::npos || close >= text_end) {
+        throw StyioSyntaxError(context.mark_cur_tok("Expecting } in the format string"));
       }
-      else {
-        context.move(1);
 
-        exprs.push_back(parse_expr(context));
+      exprs.push_back(parse_expr_at(context, text_start + i + 1, close - i - 1));
 
-        context.find_drop('}');
+      fragments.push_back(textStr);
+      textStr.clear();
 
-        fragments.push_back(textStr);
-        textStr.clear();
-      }
+      i = close;
     }
-    else if (context.check_next('}')) {
-      if (context.check_ahead(1, '}')) {
-        textStr += context.get_curr_char();
-        context.move(2);
-      }
-      else {
-        string errmsg = string("Expecting: ") + "}" + "\n" + "But Got: " + context.get_curr_char();
-        throw StyioSyntaxError(errmsg);
-      }
+    else if (text[i] == '}') {
+      throw StyioSyntaxError(context.mark_cur_tok("Unexpected } in the format string, use }} instead"));
     }
     else {
-      textStr += context.get_curr_char();
-      context.move(1);
+      textStr += text[i];
     }
   }
-  // this line drops " at the end anyway!
-  context.move(1);
+
+  context.move_forward(1, "parse_fmt_str");
 
   fragments.push_back(textStr);
 
@@ -339,22 +356,18 @@ parse_fmt_str(StyioContext& context) {
 
 StyioAST*
 parse_path(StyioContext& context) {
-  context.move(1);
-
-  string text = "";
-
-  while (not context.check_next('"')) {
-    text += context.get_curr_char();
-    context.move(1);
+  if (context.cur_tok_type() != StyioTokenType::STRING) {
+    string errmsg = string("parse_path(): False Invoke");
+    throw StyioParseError(errmsg);
   }
 
-  // drop " at the end
-  context.move(1);
+  string text(unquote(context.cur_tok_str()));
+  context.move_forward(1, "parse_path");
 
   if (text.starts_with("/")) {
     return ResPathAST::Create(StyioPathType::local_absolute_unix_like, text);
   }
-  else if (std::isupper(text.at(0)) && text.at(1) == ':') {
+  else if (text.size() >= 2 && std::isupper(text.at(0)) && text.at(1) == ':') {
     return ResPathAST::Create(StyioPathType::local_absolute_windows, text);
   }
   else if (text.starts_with("http://")) {
@@ -393,19 +406,11 @@ parse_path(StyioContext& context) {
 
 TypeAST*
 parse_dtype(StyioContext& context) {
-  string text = "";
-
-  if (context.check_isal_()) {
-    text += context.get_curr_char();
-    context.move(1);
+  if (not context.check(StyioTokenType::NAME)) {
+    throw StyioSyntaxError(context.mark_cur_tok("Expected a type name"));
   }
 
-  while (context.check_isalnum_()) {
-    text += context.get_curr_char();
-    context.move(1);
-  }
-
-  return TypeAST::Create(text);
+  return parse_name_as_type_unsafe(context);
 }
 
 /*
@@ -417,32 +422,13 @@ parse_dtype(StyioContext& context) {
 
 ParamAST*
 parse_argument(StyioContext& context) {
-  string namestr = "";
-  /* it includes cur_char in the name without checking */
-  do {
-    namestr += context.get_curr_char();
-    context.move(1);
-  } while (context.check_isalnum_());
-
-  NameAST* name = NameAST::Create(namestr);
-  TypeAST* data_type;
-  StyioAST* default_value;
-
-  context.drop_white_spaces();
-
-  if (context.check_drop(':')) {
-    context.drop_white_spaces();
+  NameAST* name = parse_name(context);
 
-    data_type = parse_dtype(context);
-
-    context.drop_white_spaces();
-
-    if (context.check_drop('=')) {
-      context.drop_white_spaces();
-
-      default_value = parse_expr(context);
+  if (context.match(StyioTokenType::TOK_COLON) /* : */) {
+    TypeAST* data_type = parse_dtype(context);
 
-      return ParamAST::Create(name, data_type, default_value);
+    if (context.match(StyioTokenType::TOK_EQUAL) /* = */) {
+      return ParamAST::Create(name, data_type, parse_expr(context));
     }
     else {
       return ParamAST::Create(name, data_type);
@@ -457,18 +443,15 @@ VarTupleAST*
 parse_var_tuple(StyioContext& context) {
   vector<VarAST*> vars;
 
-  /* cur_char must be `(` which will be removed without checking */
-  context.move(1);
+  context.match_panic(StyioTokenType::TOK_LPAREN); /* ( */
 
   do {
-    context.drop_all_spaces_comments();
-
-    if (context.check_drop(')')) {
-      return new VarTupleAST(vars);
+    if (context.match(StyioTokenType::TOK_RPAREN) /* ) */) {
+      return VarTupleAST::Create(vars);
     }
     else {
-      if (context.check_drop('*')) {
-        // if (context.check_drop('*')) {
+      if (context.match(StyioTokenType::TOK_STAR) || context.match(StyioTokenType::BINOP_POW)) {
+        // if (**) {
         //   vars.push_back(OptKwArgAST::Create(parse_id(context)));
         // }
         // else {
@@ -479,9 +462,9 @@ parse_var_tuple(StyioContext& context) {
         vars.push_back(parse_argument(context));
       }
     }
-  } while (context.check_drop(','));
+  } while (context.match(StyioTokenType::TOK_COMMA) /* , */);
 
-  context.find_drop_panic(')');
+  context.try_match_panic(StyioTokenType::TOK_RPAREN); /* ) */
 
   return VarTupleAST::Create(vars);
 }
@@ -496,7 +479,6 @@ parse_resources(
 
   if (context.match_panic(StyioTokenType::TOK_LPAREN) /* ( */) {
     do {
-      context.skip();
       switch (context.cur_tok_type()) {
         /* ( */
         case StyioTokenType::TOK_RPAREN: {
@@ -507,9 +489,7 @@ parse_resources(
         case StyioTokenType::STRING: {
           auto the_str = parse_string(context);
 
-          context.skip();
           if (context.match(StyioTokenType::TOK_COLON) /* : */) {
-            context.skip();
             if (context.check(StyioTokenType::NAME) /* check! */) {
               auto the_type_name = parse_name_as_str(context);
               res_list.push_back(
@@ -527,9 +507,7 @@ parse_resources(
         case StyioTokenType::NAME: {
           auto the_name = parse_name(context);
 
-          context.skip();
           if (context.match(StyioTokenType::ARROW_SINGLE_LEFT)) {
-            context.skip();
             if (context.check(StyioTokenType::NAME)) {
               auto the_expr = parse_var_name_or_value_expr(context);
 
@@ -571,134 +549,47 @@ parse_resources(
 
 StyioAST*
 parse_cond_item(StyioContext& context) {
-  StyioAST* output;
-
-  context.drop_all_spaces();
-
-  output = parse_value_expr(context);
-
-  context.drop_all_spaces();
-
-  switch (context.get_curr_char()) {
-    case '=': {
-      context.move(1);
-
-      if (context.check_next('=')) {
-        context.move(1);
-
-        /*
-          Equal
-            expr == expr
-        */
-
-        // drop all spaces after ==
-        context.drop_all_spaces();
-
-        output = new BinCompAST(
-          CompType::EQ, (output), parse_value_expr(context)
-        );
-      };
-    }
-
-    break;
-
-    case '!': {
-      context.move(1);
-
-      if (context.check_next('=')) {
-        context.move(1);
-
-        /*
-          Not Equal
-            expr != expr
-        */
-
-        // drop all spaces after !=
-        context.drop_all_spaces();
-
-        output = new BinCompAST(
-          CompType::NE, (output), parse_value_expr(context)
-        );
-      };
-    }
-
-    break;
-
-    case '>': {
-      context.move(1);
-
-      if (context.check_next('=')) {
-        context.move(1);
-
-        /*
-          Greater Than and Equal
-            expr >= expr
-        */
+  StyioAST* output = parse_value_expr(context);
 
-        // drop all spaces after >=
-        context.drop_all_spaces();
-
-        output = new BinCompAST(
-          CompType::GE, (output), parse_value_expr(context)
-        );
-      }
-      else {
-        /*
-          Greater Than
-            expr > expr
-        */
-
-        // drop all spaces after >
-        context.drop_all_spaces();
-
-        output = new BinCompAST(
-          CompType::GT, (output), parse_value_expr(context)
-        );
-      };
-    }
-
-    break;
-
-    case '<': {
-      context.move(1);
-
-      if (context.check_next('=')) {
-        context.move(1);
-
-        /*
-          Less Than and Equal
-            expr <= expr
-        */
+  CompType comp;
+  switch (context.cur_tok_type()) {
+    /* expr == expr */
+    case StyioTokenType::BINOP_EQ:
+      comp = CompType::EQ;
+      break;
 
-        // drop all spaces after <=
-        context.drop_all_spaces();
+    /* expr != expr */
+    case StyioTokenType::BINOP_NE:
+      comp = CompType::NE;
+      break;
 
-        output = new BinCompAST(
-          CompType::LE, (output), parse_value_expr(context)
-        );
-      }
-      else {
-        /*
-          Less Than
-            expr < expr
-        */
+    /* expr >= expr */
+    case StyioTokenType::BINOP_GE:
+      comp = CompType::GE;
+      break;
 
-        // drop all spaces after <
-        context.drop_all_spaces();
+    /* expr > expr */
+    case StyioTokenType::TOK_RANGBRAC:
+      comp = CompType::GT;
+      break;
 
-        output = new BinCompAST(
-          CompType::LT, (output), parse_value_expr(context)
-        );
-      };
-    }
+    /* expr <= expr */
+    case StyioTokenType::BINOP_LE:
+      comp = CompType::LE;
+      break;
 
-    break;
+    /* expr < expr */
+    case StyioTokenType::TOK_LANGBRAC:
+      comp = CompType::LT;
+      break;
 
     default:
-      break;
+      return output;
   }
 
-  return output;
+  context.move_forward(1, "parse_cond_item");
+
+  return new BinCompAST(comp, output, parse_value_expr(context));
 }
 
 /*
@@ -730,7 +621,7 @@ parse_var_name_or_value_expr(StyioContext& context) {
       output = parse_index_op(context, varname);
     }
     else if (context.check(StyioTokenType::TOK_LPAREN) /* ( */) {
-      output = parse_index_op(context, varname);
+      output = parse_call(context, varname);
     }
     else {
       output = varname;
@@ -745,33 +636,57 @@ parse_var_name_or_value_expr(StyioContext& context) {
   else if (context.check(StyioTokenType::STRING)) {
     output = parse_string(context);
   }
+  else {
+    throw StyioSyntaxError(context.mark_cur_tok("Expected a name or a value"));
+  }
 
   return output;
 }
 
 StyioAST*
 parse_value_expr(StyioContext& context) {
-  StyioAST* output;
+  switch (context.cur_tok_type()) {
+    case StyioTokenType::NAME:
+      return parse_var_name_or_value_expr(context);
 
-  if (isalpha(context.get_curr_char()) || context.check_next('_')) {
-    return parse_var_name_or_value_expr(context);
-  }
-  else if (isdigit(context.get_curr_char())) {
-    return parse_int_or_float(context);
-  }
-  else if (context.check_next('|')) {
-    return parse_size_of(context);
+    case StyioTokenType::INTEGER:
+    case StyioTokenType::DECIMAL:
+      return parse_int_or_float(context);
+
+    case StyioTokenType::TOK_PIPE:
+      return parse_size_of(context);
+
+    default:
+      throw StyioParseError(context.mark_cur_tok("parse_value() // Unexpected value expression"));
   }
+}
+
+/* Binary operator of a token, Undefined if it is not one */
+static StyioOpType
+get_binop_type(StyioTokenType type) {
+  switch (type) {
+    case StyioTokenType::TOK_PLUS:
+      return StyioOpType::Binary_Add;
+    case StyioTokenType::TOK_MINUS:
+      return StyioOpType::Binary_Sub;
+    case StyioTokenType::TOK_STAR:
+      return StyioOpType::Binary_Mul;
+    case StyioTokenType::BINOP_POW:
+      return StyioOpType::Binary_Pow;
+    case StyioTokenType::TOK_SLASH:
+      return StyioOpType::Binary_Div;
+    case StyioTokenType::TOK_PERCENT:
+      return StyioOpType::Binary_Mod;
 
-  string errmsg = string("parse_value() // Unexpected value expression, starting with ") + char(context.get_curr_char());
-  throw StyioParseError(errmsg);
+    default:
+      return StyioOpType::Undefined;
+  }
 }
 
 StyioAST*
 parse_binop_item(StyioContext& context) {
   StyioAST* output;
 
-  context.skip();
   switch (context.cur_tok_type()) {
     /* name */
     case StyioTokenType::NAME: {
@@ -783,12 +698,18 @@ parse_binop_item(StyioContext& context) {
       output = parse_int(context);
     } break;
 
+    /* 0.0 */
+    case StyioTokenType::DECIMAL: {
+      output = parse_float(context);
+    } break;
+
     /* "string" */
     case StyioTokenType::STRING: {
       output = parse_string(context);
     } break;
 
     default: {
+      throw StyioSyntaxError(context.mark_cur_tok("Expected an operand"));
     } break;
   }
 
@@ -803,7 +724,6 @@ parse_tuple_exprs(StyioContext& context) {
   context.try_match_panic(StyioTokenType::TOK_LPAREN);
 
   do {
-    context.skip();
     if (context.check(StyioTokenType::TOK_RPAREN) /* ) */) {
       break; /* early stop */
     }
@@ -815,7 +735,6 @@ parse_tuple_exprs(StyioContext& context) {
 
   the_tuple = TupleAST::Create(elems);
 
-  context.skip();
 
   switch (context.cur_tok_type()) {
     case StyioTokenType::ITERATOR: {
@@ -831,133 +750,34 @@ parse_tuple_exprs(StyioContext& context) {
 
 StyioAST*
 parse_expr(StyioContext& context) {
+  StyioContext::Nesting nesting(context);
+
   StyioAST* output;
 
-  context.skip();
   switch (context.cur_tok_type()) {
     /* name */
     case StyioTokenType::NAME: {
-      output = parse_name_and_following_unsafe(context);
+      return parse_name_and_following_unsafe(context);
     } break;
 
     /* 0 */
     case StyioTokenType::INTEGER: {
       output = parse_int(context);
-
-      switch (context.cur_tok_type()) {
-        case StyioTokenType::TOK_PLUS: {
-          context.move_forward(1);
-          output = parse_binop_rhs(context, output, StyioOpType::Binary_Add);
-        } break;
-
-        case StyioTokenType::TOK_MINUS: {
-          context.move_forward(1);
-          output = parse_binop_rhs(context, output, StyioOpType::Binary_Sub);
-        } break;
-
-        case StyioTokenType::TOK_STAR: {
-          context.move_forward(1);
-          if (context.check_drop('*')) {
-            output = parse_binop_rhs(context, output, StyioOpType::Binary_Pow);
-          }
-          else {
-            output = parse_binop_rhs(context, output, StyioOpType::Binary_Mul);
-          }
-        } break;
-
-        case StyioTokenType::TOK_SLASH: {
-          context.move_forward(1);
-          output = parse_binop_rhs(context, output, StyioOpType::Binary_Div);
-        } break;
-
-        case StyioTokenType::TOK_PERCENT: {
-          context.move_forward(1);
-          output = parse_binop_rhs(context, output, StyioOpType::Binary_Mod);
-        } break;
-
-        default:
-          break;
-      }
     } break;
 
     /* 0.0 */
     case StyioTokenType::DECIMAL: {
       output = parse_float(context);
-
-      switch (context.cur_tok_type()) {
-        case StyioTokenType::TOK_PLUS: {
-          context.move_forward(1);
-          output = parse_binop_rhs(context, output, StyioOpType::Binary_Add);
-        } break;
-
-        case StyioTokenType::TOK_MINUS: {
-          context.move_forward(1);
-          output = parse_binop_rhs(context, output, StyioOpType::Binary_Sub);
-        } break;
-
-        case StyioTokenType::TOK_STAR: {
-          context.move_forward(1);
-          if (context.check_drop('*')) {
-            output = parse_binop_rhs(context, output, StyioOpType::Binary_Pow);
-          }
-          else {
-            output = parse_binop_rhs(context, output, StyioOpType::Binary_Mul);
-          }
-        } break;
-
-        case StyioTokenType::TOK_SLASH: {
-          context.move_forward(1);
-          output = parse_binop_rhs(context, output, StyioOpType::Binary_Div);
-        } break;
-
-        case StyioTokenType::TOK_PERCENT: {
-          context.move_forward(1);
-          output = parse_binop_rhs(context, output, StyioOpType::Binary_Mod);
-        } break;
-
-        default:
-          break;
-      }
     } break;
 
     /* "string" */
     case StyioTokenType::STRING: {
       output = parse_string(context);
+    } break;
 
-      switch (context.cur_tok_type()) {
-        case StyioTokenType::TOK_PLUS: {
-          context.move_forward(1);
-          output = parse_binop_rhs(context, output, StyioOpType::Binary_Add);
-        } break;
-
-        case StyioTokenType::TOK_MINUS: {
-          context.move_forward(1);
-          output = parse_binop_rhs(context, output, StyioOpType::Binary_Sub);
-        } break;
-
-        case StyioTokenType::TOK_STAR: {
-          context.move_forward(1);
-          if (context.check_drop('*')) {
-            output = parse_binop_rhs(context, output, StyioOpType::Binary_Pow);
-          }
-          else {
-            output = parse_binop_rhs(context, output, StyioOpType::Binary_Mul);
-          }
-        } break;
-
-        case StyioTokenType::TOK_SLASH: {
-          context.move_forward(1);
-          output = parse_binop_rhs(context, output, StyioOpType::Binary_Div);
-        } break;
-
-        case StyioTokenType::TOK_PERCENT: {
-          context.move_forward(1);
-          output = parse_binop_rhs(context, output, StyioOpType::Binary_Mod);
-        } break;
-
-        default:
-          break;
-      }
+    /* 'c' */
+    case StyioTokenType::CHARACTER: {
+      output = parse_char_or_string(context);
     } break;
 
     /* ( */
@@ -975,6 +795,12 @@ parse_expr(StyioContext& context) {
     } break;
   }
 
+  StyioOpType binop = get_binop_type(context.cur_tok_type());
+  if (binop != StyioOpType::Undefined) {
+    context.move_forward(1, "parse_expr");
+    output = parse_binop_rhs(context, output, binop);
+  }
+
   return output;
 }
 
@@ -990,27 +816,18 @@ StyioAST*
 parse_tuple(StyioContext& context) {
   vector<StyioAST*> exprs;
 
-  /*
-    Danger!
-    when entering parse_tuple(),
-    the context -> get_curr_char() must be (
-    this line will drop the next 1 character anyway!
-  */
-  context.move(1);
+  context.match_panic(StyioTokenType::TOK_LPAREN); /* ( */
 
   do {
-    context.drop_all_spaces_comments();
-
-    if (context.check_drop(')')) {
+    if (context.match(StyioTokenType::TOK_RPAREN) /* ) */) {
       return TupleAST::Create(exprs);
     }
     else {
       exprs.push_back(parse_expr(context));
-      context.drop_white_spaces();
     }
-  } while (context.check_drop(','));
+  } while (context.match(StyioTokenType::TOK_COMMA) /* , */);
 
-  context.find_drop_panic(')');
+  context.try_match_panic(StyioTokenType::TOK_RPAREN); /* ) */
 
   return TupleAST::Create(exprs);
 }
@@ -1029,17 +846,21 @@ parse_tuple_no_braces(StyioContext& context, StyioAST* first_element) {
   }
 
   do {
-    context.drop_all_spaces_comments();
-
     exprs.push_back(parse_expr(context));
-  } while (context.check_drop(','));
+  } while (context.match(StyioTokenType::TOK_COMMA) /* , */);
 
   TupleAST* the_tuple = TupleAST::Create(exprs);
 
   // no check for right brace ')'
 
-  if (context.check_tuple_ops()) {
-    return parse_tuple_operations(context, the_tuple);
+  switch (context.cur_tok_type()) {
+    case StyioTokenType::EXTRACTOR:
+    case StyioTokenType::ITERATOR:
+    case StyioTokenType::ARROW_DOUBLE_RIGHT:
+      return parse_tuple_operations(context, the_tuple);
+
+    default:
+      break;
   }
 
   return the_tuple;
@@ -1052,14 +873,12 @@ parse_list_exprs(StyioContext& context) {
   context.move_forward(1);
 
   do {
-    context.skip();
 
     if (context.match(StyioTokenType::TOK_RBOXBRAC) /* ] */) {
       return ListAST::Create(exprs);
     }
     else {
       exprs.push_back(parse_expr(context));
-      context.skip();
     }
   } while (context.try_match(StyioTokenType::TOK_COMMA) /* , */);
 
@@ -1072,27 +891,18 @@ StyioAST*
 parse_set(StyioContext& context) {
   vector<StyioAST*> exprs;
 
-  /*
-    Danger!
-    when entering parse_set(),
-    the current character must be {
-    this line will drop the next 1 character anyway!
-  */
-  context.move(1);
+  context.match_panic(StyioTokenType::TOK_LCURBRAC); /* { */
 
   do {
-    context.drop_all_spaces_comments();
-
-    if (context.check_drop('}')) {
+    if (context.match(StyioTokenType::TOK_RCURBRAC) /* } */) {
       return SetAST::Create(exprs);
     }
     else {
       exprs.push_back(parse_expr(context));
-      context.drop_white_spaces();
     }
-  } while (context.check_drop(','));
+  } while (context.match(StyioTokenType::TOK_COMMA) /* , */);
 
-  context.find_drop_panic('}');
+  context.try_match_panic(StyioTokenType::TOK_RCURBRAC); /* } */
 
   return SetAST::Create(exprs);
 }
@@ -1102,138 +912,53 @@ parse_struct(StyioContext& context, NameAST* name) {
   vector<ParamAST*> elems;
 
   do {
-    context.drop_all_spaces_comments();
-
-    if (context.check_drop('}')) {
+    if (context.match(StyioTokenType::TOK_RCURBRAC) /* } */) {
       return StructAST::Create(name, elems);
     }
     else {
       elems.push_back(parse_argument(context));
     }
-  } while (context.check_drop(',') or context.check_drop(';'));
+  } while (context.match(StyioTokenType::TOK_COMMA) /* , */
+           or context.match(StyioTokenType::TOK_SEMICOLON) /* ; */);
 
-  context.find_drop_panic('}');
+  context.try_match_panic(StyioTokenType::TOK_RCURBRAC); /* } */
 
   return StructAST::Create(name, elems);
 }
 
 StyioAST*
 parse_iterable(StyioContext& context) {
-  StyioAST* output = EmptyAST::Create();
-
-  if (isalpha(context.get_curr_char()) || context.check_next('_')) {
-    output = parse_name(context);
-
-    context.drop_all_spaces_comments();
-
-    switch (context.get_curr_char()) {
-      case '+': {
-        context.move(1);
-        output = parse_binop_rhs(context, output, StyioOpType::Binary_Add);
-      } break;
-
-      case '-': {
-        context.move(1);
-        output = parse_binop_rhs(context, output, StyioOpType::Binary_Sub);
-      } break;
-
-      case '*': {
-        context.move(1);
-        if (context.check_drop('*')) {
-          output = parse_binop_rhs(context, output, StyioOpType::Binary_Pow);
-        }
-        else {
-          output = parse_binop_rhs(context, output, StyioOpType::Binary_Mul);
-        }
-      } break;
-
-      case '/': {
-        context.move(1);
-        output = parse_binop_rhs(context, output, StyioOpType::Binary_Div);
-      } break;
-
-      case '%': {
-        context.move(1);
-        output = parse_binop_rhs(context, output, StyioOpType::Binary_Mod);
-      } break;
-
-      default:
-        break;
-    }
-
-    return output;
-  }
-  else {
-    switch (context.get_curr_char()) {
-      case '(': {
-        context.move(1);
-
-        vector<StyioAST*> exprs;
-        do {
-          context.drop_all_spaces_comments();
-
-          if (context.check_drop(')')) {
-            return new TupleAST((exprs));
-          }
-          else {
-            exprs.push_back(parse_expr(context));
-            context.drop_white_spaces();
-          }
-        } while (context.check_drop(','));
-
-        context.check_drop(')');
-
-        return TupleAST::Create(exprs);
-      }
-
-      case '[': {
-        context.move(1);
-
-        vector<StyioAST*> exprs;
-        do {
-          context.drop_all_spaces_comments();
-
-          if (context.check_drop(']')) {
-            return new ListAST((exprs));
-          }
-          else {
-            exprs.push_back(parse_expr(context));
-            context.drop_white_spaces();
-          }
-        } while (context.check_drop(','));
-
-        context.check_drop(']');
+  switch (context.cur_tok_type()) {
+    /* name, or name op expr */
+    case StyioTokenType::NAME: {
+      StyioAST* output = parse_name(context);
 
-        return ListAST::Create(exprs);
+      StyioOpType binop = get_binop_type(context.cur_tok_type());
+      if (binop != StyioOpType::Undefined) {
+        context.move_forward(1, "parse_iterable");
+        output = parse_binop_rhs(context, output, binop);
       }
 
-      case '{': {
-        context.move(1);
-
-        vector<StyioAST*> exprs;
-        do {
-          context.drop_all_spaces_comments();
+      return output;
+    }
 
-          if (context.check_drop('}')) {
-            return new SetAST((exprs));
-          }
-          else {
-            exprs.push_back(parse_expr(context));
-            context.drop_white_spaces();
-          }
-        } while (context.check_drop(','));
+    /* (a, b, ...) */
+    case StyioTokenType::TOK_LPAREN:
+      return parse_tuple(context);
 
-        context.check_drop('}');
+    /* [a, b, ...] */
+    case StyioTokenType::TOK_LBOXBRAC:
+      return parse_list_exprs(context);
 
-        return SetAST::Create(exprs);
-      }
+    /* {a, b, ...} */
+    case StyioTokenType::TOK_LCURBRAC:
+      return parse_set(context);
 
-      default:
-        break;
-    }
+    default:
+      break;
   }
 
-  return output;
+  return EmptyAST::Create();
 }
 
 /*
@@ -1248,31 +973,17 @@ parse_iterable(StyioContext& context) {
 
 SizeOfAST*
 parse_size_of(StyioContext& context) {
-  SizeOfAST* output;
+  context.match_panic(StyioTokenType::TOK_PIPE); /* | */
 
-  // eliminate | at the start
-  context.move(1);
+  if (not context.check(StyioTokenType::NAME)) {
+    throw StyioParseError(context.mark_cur_tok("|expr| // SizeOf: Unexpected expression"));
+  }
 
-  if (isalpha(context.get_curr_char()) || context.check_next('_')) {
-    StyioAST* var = parse_var_name_or_value_expr(context);
+  StyioAST* var = parse_var_name_or_value_expr(context);
 
-    // eliminate | at the end
-    if (context.check_next('|')) {
-      context.move(1);
+  context.match_panic(StyioTokenType::TOK_PIPE, "|expr| // SizeOf: Expecting | at the end"); /* | */
 
-      output = new SizeOfAST((var));
-    }
-    else {
-      string errmsg = string("|expr| // SizeOf: Expecting | at the end, but got .:| ") + char(context.get_curr_char()) + " |:.";
-      throw StyioSyntaxError(errmsg);
-    }
-  }
-  else {
-    string errmsg = string("|expr| // SizeOf: Unexpected expression, starting with .:| ") + char(context.get_curr_char()) + " |:.";
-    throw StyioParseError(errmsg);
-  }
-
-  return output;
+  return new SizeOfAST(var);
 }
 
 /*
@@ -1291,7 +1002,6 @@ parse_call(
   while (not context.check(StyioTokenType::TOK_RPAREN) /* ) */) {
     args.push_back(parse_expr(context));
     context.try_match(StyioTokenType::TOK_COMMA); /* , */
-    context.skip();
   }
 
   context.try_match_panic(StyioTokenType::TOK_RPAREN); /* ) */
@@ -1308,15 +1018,15 @@ AttrAST*
 parse_attr(
   StyioContext& context
 ) {
-  auto main_name = NameAST::Create(parse_name_as_str(context));
+  auto main_name = parse_name(context);
 
-  StyioAST* attr_name;
-  if (context.find_drop('.')) {
-    attr_name = NameAST::Create(parse_name_as_str(context));
+  StyioAST* attr_name = nullptr;
+  if (context.match(StyioTokenType::TOK_DOT) /* . */) {
+    attr_name = parse_name(context);
   }
-  else if (context.find_drop('[')) {
+  else if (context.match(StyioTokenType::TOK_LBOXBRAC) /* [ */) {
     /* Object["name"] */
-    if (context.check_next('"')) {
+    if (context.check(StyioTokenType::STRING)) {
       attr_name = parse_string(context);
     }
     /*
@@ -1325,6 +1035,8 @@ parse_attr(
     else {
       attr_name = parse_expr(context);
     }
+
+    context.try_match_panic(StyioTokenType::TOK_RBOXBRAC); /* ] */
   }
 
   return AttrAST::Create(main_name, attr_name);
@@ -1341,28 +1053,25 @@ parse_chain_of_call(
   StyioContext& context,
   StyioAST* callee
 ) {
-  while (true) {
-    std::string curr_token = parse_name_as_str(context);
-    context.drop_all_spaces_comments();
+  NameAST* curr_name = parse_name(context);
+
+  if (context.match(StyioTokenType::TOK_DOT) /* . */) {
+    AttrAST* temp = AttrAST::Create(callee, curr_name);
+    return parse_chain_of_call(context, temp);
+  }
+  else if (context.check(StyioTokenType::TOK_LPAREN) /* ( */) {
+    FuncCallAST* temp = parse_call(context, curr_name);
 
-    if (context.check_drop('.')) {
-      AttrAST* temp = AttrAST::Create(callee, NameAST::Create(curr_token));
+    if (context.match(StyioTokenType::TOK_DOT) /* . */) {
       return parse_chain_of_call(context, temp);
     }
-    else if (context.check_next('(')) {
-      FuncCallAST* temp = parse_call(context, NameAST::Create(curr_token));
-
-      if (context.check_drop('.')) {
-        return parse_chain_of_call(context, temp);
-      }
-      else {
-        temp->func_callee = callee;
-        return temp;
-      }
+    else {
+      temp->func_callee = callee;
+      return temp;
     }
-
-    return AttrAST::Create(callee, NameAST::Create(curr_token));
   }
+
+  return AttrAST::Create(callee, curr_name);
 }
 
 /*
@@ -1395,225 +1104,137 @@ parse_chain_of_call(
 
 StyioAST*
 parse_index_op(StyioContext& context, StyioAST* theList) {
-  StyioAST* output;
-
-  /*
-    the current character must be [
-    this line will drop the next 1 character anyway!
-  */
-  context.move(1);
-
-  do {
-    if (isalpha(context.get_curr_char()) || context.check_next('_')) {
-      output = new ListOpAST(
-        StyioNodeType::Access, (theList), parse_var_name_or_value_expr(context)
-      );
-    }
-    else if (isdigit(context.get_curr_char())) {
-      output = new ListOpAST(
-        StyioNodeType::Access_By_Index, (theList), parse_int(context)
-      );
-    }
-    else {
-      switch (context.get_curr_char()) {
-        /*
-          list["any"]
-        */
-        case '"': {
-          output = new ListOpAST(StyioNodeType::Access_By_Name, (theList), parse_string(context));
-        }
-
-        // You should NOT reach this line!
-        break;
-
-        /*
-          list[<]
-        */
-        case '<': {
-          context.move(1);
-
-          while (context.check_next('<')) {
-            context.move(1);
-          }
-
-          output = new ListOpAST(StyioNodeType::Get_Reversed, (theList));
-        }
-
-        // You should NOT reach this line!
-        break;
-
-        // list[?= item]
-        case '?': {
-          context.move(1);
-
-          if (context.check_drop('=')) {
-            context.drop_all_spaces_comments();
-
-            output = new ListOpAST(StyioNodeType::Get_Index_By_Value, (theList), parse_expr(context));
-          }
-          else if (context.check_drop('^')) {
-            context.drop_all_spaces_comments();
-
-            output = new ListOpAST(StyioNodeType::Get_Indices_By_Many_Values, (theList), parse_iterable(context));
-          }
-          else {
-            string errmsg = string("Expecting ?= or ?^, but got ") + char(context.get_curr_char());
-            throw StyioSyntaxError(errmsg);
-          }
-        }
-
-        // You should NOT reach this line!
-        break;
+  StyioAST* output = theList;
 
-        /*
-          list[^index]
-          list[^index <- value]
-        */
-        case '^': {
-          context.move(1);
-
-          context.drop_white_spaces();
-
-          StyioAST* index = parse_int(context);
-
-          context.drop_white_spaces();
-
-          /*
-            list[^index <- value]
-          */
-          if (context.check_drop("<-")) {
-            context.drop_white_spaces();
-
-            output = new ListOpAST(StyioNodeType::Insert_Item_By_Index, (theList), (index), parse_expr(context));
-          }
-          // list[^index]
-          else {
-            output = new ListOpAST(StyioNodeType::Access_By_Index, (theList), (index));
-          }
-        }
-        // You should NOT reach this line!
-        break;
-
-        /*
-          list[+: value]
-        */
-        case '+': {
-          context.move(1);
-
-          context.check_drop_panic(':');
-
-          context.drop_white_spaces();
-
-          StyioAST* expr = parse_expr(context);
-
-          context.drop_white_spaces();
-
-          output = new ListOpAST(
-            StyioNodeType::Append_Value, (theList), (expr)
-          );
-        }
-
-        // You should NOT reach this line!
-        break;
-
-        case '-': {
-          context.move(1);
+  while (context.match(StyioTokenType::TOK_LBOXBRAC) /* [ */) {
+    switch (context.cur_tok_type()) {
+      /*
+        list[name]
+      */
+      case StyioTokenType::NAME: {
+        output = new ListOpAST(StyioNodeType::Access, output, parse_var_name_or_value_expr(context));
+      } break;
 
-          context.check_drop_panic(':');
+      /*
+        list[0]
+      */
+      case StyioTokenType::INTEGER: {
+        output = new ListOpAST(StyioNodeType::Access_By_Index, output, parse_int(context));
+      } break;
 
-          context.drop_white_spaces();
+      /*
+        list["any"]
+      */
+      case StyioTokenType::STRING: {
+        output = new ListOpAST(StyioNodeType::Access_By_Name, output, parse_string(context));
+      } break;
 
-          /*
-            list[-: ^index]
-          */
-          if (context.check_drop('^')) {
-            context.drop_white_spaces();
+      /*
+        list[<]
+      */
+      case StyioTokenType::TOK_LANGBRAC:
+      case StyioTokenType::EXTRACTOR: {
+        context.move_forward(1, "parse_index_op(<)");
+        output = new ListOpAST(StyioNodeType::Get_Reversed, output);
+      } break;
 
-            if (isdigit(context.get_curr_char())) {
-              output = new ListOpAST(StyioNodeType::Remove_Item_By_Index, (theList), (parse_int(context)));
-            }
-            else {
-              /*
-                list[-: ^(i0, i1, ...)]
-              */
-              output = new ListOpAST(
-                StyioNodeType::Remove_Items_By_Many_Indices,
-                (theList),
-                (parse_iterable(context))
-              );
-            }
-          }
-          else if (context.check_drop('?')) {
-            switch (context.get_curr_char()) {
-              /*
-                list[-: ?= value]
-              */
-              case '=': {
-                context.move(1);
+      /*
+        list[?= item]
+      */
+      case StyioTokenType::MATCH: {
+        context.move_forward(1, "parse_index_op(?=)");
+        output = new ListOpAST(StyioNodeType::Get_Index_By_Value, output, parse_expr(context));
+      } break;
 
-                context.drop_white_spaces();
+      /*
+        list[?^ (v0, v1, ...)]
+      */
+      case StyioTokenType::TOK_QUEST: {
+        context.move_forward(1, "parse_index_op(?)");
+        context.match_panic(StyioTokenType::TOK_HAT, "Expecting ?= or ?^");
+        output = new ListOpAST(StyioNodeType::Get_Indices_By_Many_Values, output, parse_iterable(context));
+      } break;
 
-                output = new ListOpAST(StyioNodeType::Remove_Item_By_Value, (theList), parse_expr(context));
-              }
+      /*
+        list[^index]
+        list[^index <- value]
+      */
+      case StyioTokenType::TOK_HAT: {
+        context.move_forward(1, "parse_index_op(^)");
 
-              break;
+        StyioAST* index = parse_int(context);
 
-              /*
-                list[-: ?^ (v0, v1, ...)]
-              */
-              case '^': {
-                context.move(1);
+        if (context.match(StyioTokenType::ARROW_SINGLE_LEFT) /* <- */) {
+          output = new ListOpAST(StyioNodeType::Insert_Item_By_Index, output, index, parse_expr(context));
+        }
+        else {
+          output = new ListOpAST(StyioNodeType::Access_By_Index, output, index);
+        }
+      } break;
 
-                context.drop_white_spaces();
+      /*
+        list[+: value]
+      */
+      case StyioTokenType::TOK_PLUS: {
+        context.move_forward(1, "parse_index_op(+)");
+        context.match_panic(StyioTokenType::TOK_COLON); /* : */
 
-                output = new ListOpAST(
-                  StyioNodeType::Remove_Items_By_Many_Values,
-                  (theList),
-                  parse_iterable(context)
-                );
-              }
+        output = new ListOpAST(StyioNodeType::Append_Value, output, parse_expr(context));
+      } break;
 
-              break;
+      case StyioTokenType::TOK_MINUS: {
+        context.move_forward(1, "parse_index_op(-)");
+        context.match_panic(StyioTokenType::TOK_COLON); /* : */
 
-              default:
-                break;
-            }
+        /*
+          list[-: ^index]
+          list[-: ^(i0, i1, ...)]
+        */
+        if (context.match(StyioTokenType::TOK_HAT) /* ^ */) {
+          if (context.check(StyioTokenType::INTEGER)) {
+            output = new ListOpAST(StyioNodeType::Remove_Item_By_Index, output, parse_int(context));
           }
           else {
-            output = new ListOpAST(StyioNodeType::Remove_Item_By_Value, (theList), parse_expr(context));
+            output = new ListOpAST(StyioNodeType::Remove_Items_By_Many_Indices, output, parse_iterable(context));
           }
         }
-
-        // You should NOT reach this line!
-        break;
-
-        case ']': {
-          output = (theList);
+        /*
+          list[-: ?= value]
+        */
+        else if (context.match(StyioTokenType::MATCH) /* ?= */) {
+          output = new ListOpAST(StyioNodeType::Remove_Item_By_Value, output, parse_expr(context));
         }
-
-        // You should NOT reach this line!
-        break;
-
-        default: {
-          string errmsg = string("Unexpected List[Operation], starts with ") + char(context.get_curr_char());
-          throw StyioSyntaxError(errmsg);
+        /*
+          list[-: ?^ (v0, v1, ...)]
+        */
+        else if (context.match(StyioTokenType::TOK_QUEST) /* ? */) {
+          context.match_panic(StyioTokenType::TOK_HAT, "Expecting -: ?= or -: ?^");
+          output = new ListOpAST(StyioNodeType::Remove_Items_By_Many_Values, output, parse_iterable(context));
+        }
+        else {
+          output = new ListOpAST(StyioNodeType::Remove_Item_By_Value, output, parse_expr(context));
         }
+      } break;
 
-        // You should NOT reach this line!
-        break;
-      }
+      /*
+        list[]
+      */
+      case StyioTokenType::TOK_RBOXBRAC: {
+      } break;
+
+      default: {
+        throw StyioSyntaxError(context.mark_cur_tok("Unexpected List[Operation]"));
+      } break;
     }
-  } while (context.check_drop('['));
 
-  context.find_drop(']');
+    context.try_match_panic(StyioTokenType::TOK_RBOXBRAC); /* ] */
+  }
 
   return output;
 }
 
 StyioAST*
 parse_loop_or_iter(StyioContext& context, StyioAST* iterOverIt) {
-  context.drop_all_spaces_comments();
-
   if ((iterOverIt->getNodeType()) == StyioNodeType::Infinite) {
     return InfiniteLoopAST::Create();
   }
@@ -1630,20 +1251,10 @@ parse_list_or_loop(StyioContext& context) {
 
   StyioAST* startEl = parse_expr(context);
 
-  context.drop_white_spaces();
-
-  if (context.check_drop('.')) {
-    while (context.check_next('.')) {
-      context.move(1);
-    }
-
-    context.drop_white_spaces();
-
+  if (context.match(StyioTokenType::ELLIPSIS) /* .. */ || context.match(StyioTokenType::TOK_DOT) /* . */) {
     StyioAST* endEl = parse_expr(context);
 
-    context.drop_white_spaces();
-
-    context.check_drop_panic(']');
+    context.try_match_panic(StyioTokenType::TOK_RBOXBRAC); /* ] */
 
     if (startEl->getNodeType() == StyioNodeType::Integer && endEl->getNodeType() == StyioNodeType::Id) {
       output = new InfiniteAST((startEl), (endEl));
@@ -1658,39 +1269,33 @@ parse_list_or_loop(StyioContext& context) {
       throw StyioSyntaxError(errmsg);
     }
   }
-  else if (context.check_drop(',')) {
+  else if (context.match(StyioTokenType::TOK_COMMA) /* , */) {
     elements.push_back((startEl));
 
     do {
-      context.drop_all_spaces_comments();
-
-      if (context.check_drop(']')) {
+      if (context.match(StyioTokenType::TOK_RBOXBRAC) /* ] */) {
         return new ListAST(elements);
       }
       else {
         elements.push_back(parse_expr(context));
       }
-    } while (context.check_drop(','));
+    } while (context.match(StyioTokenType::TOK_COMMA) /* , */);
 
-    context.find_drop_panic(']');
+    context.try_match_panic(StyioTokenType::TOK_RBOXBRAC); /* ] */
 
     output = new ListAST((elements));
   }
   else {
     elements.push_back((startEl));
 
-    context.find_drop_panic(']');
+    context.try_match_panic(StyioTokenType::TOK_RBOXBRAC); /* ] */
 
     output = new ListAST((elements));
   }
 
-  while (context.check_next('[')) {
-    output = parse_index_op(context, (output));
-  }
-
-  context.drop_all_spaces();
+  output = parse_index_op(context, output);
 
-  if (context.check_drop(">>")) {
+  if (context.match(StyioTokenType::ITERATOR) /* >> */) {
     output = parse_loop_or_iter(context, (output));
   }
 
@@ -1699,19 +1304,12 @@ parse_list_or_loop(StyioContext& context) {
 
 StyioAST*
 parse_loop(StyioContext& context) {
-  StyioAST* output;
-
-  while (context.check_next('.')) {
-    context.move(1);
-  }
-
-  context.find_drop_panic(']');
+  /* [...] */
+  context.match(StyioTokenType::ELLIPSIS);
 
-  context.drop_all_spaces();
-
-  if (context.check_drop(">>")) {
-    context.drop_all_spaces();
+  context.try_match_panic(StyioTokenType::TOK_RBOXBRAC); /* ] */
 
+  if (context.match(StyioTokenType::ITERATOR) /* >> */) {
     return InfiniteLoopAST::Create();
   }
 
@@ -1736,338 +1334,206 @@ parse_loop(StyioContext& context) {
 
   For boolean expressions, go to parse_bool_expr.
 
-  hi, you need to pass the precedence as a parameter,
-  the reason is that, the internal part should know where to stop,
-  and that depends on the outer part.
-  the outer part should know where to create binop,
-  and this information comes from the internal part.
+  Precedence climbing with an explicit operator stack, so that
+  `1 + 2 + ... + n` takes O(n) time and a constant amount of C++ stack,
+  however long or deeply nested the expression is.
 */
+
 BinOpAST*
 parse_binop_rhs(
   StyioContext& context,
   StyioAST* lhs_ast,
   StyioOpType curr_token
 ) {
-  BinOpAST* output;
-
-  context.skip();
-  StyioAST* rhs_ast = parse_binop_item(context);
-
-  context.drop_all_spaces_comments();
-
-  StyioOpType next_token;
-  switch (context.cur_tok_type()) {
-    /* + */
-    case StyioTokenType::TOK_PLUS: {
-      context.move_forward(1, "parse_binop_rhs(TOK_PLUS)");
-      next_token = StyioOpType::Binary_Add;
-    } break;
-
-    /* - */
-    case StyioTokenType::TOK_MINUS: {
-      context.move_forward(1, "parse_binop_rhs(TOK_MINUS)");
-      next_token = StyioOpType::Binary_Sub;
-    } break;
+  vector<StyioAST*> operands = {lhs_ast};
+  vector<StyioOpType> operators = {curr_token};
 
-    /* * */
-    case StyioTokenType::TOK_STAR: {
-      context.move_forward(1, "parse_binop_rhs(TOK_STAR)");
-      next_token = StyioOpType::Binary_Mul;
-    } break;
+  /* (a op b) -> a */
+  auto reduce = [&]() {
+    StyioAST* rhs = operands.back();
+    operands.pop_back();
+    operands.back() = BinOpAST::Create(operators.back(), operands.back(), rhs);
+    operators.pop_back();
+  };
 
-    /* ** */
-    case StyioTokenType::BINOP_POW: {
-      context.move_forward(1, "parse_binop_rhs(BINOP_POW)");
-      next_token = StyioOpType::Binary_Pow;
-    } break;
+  while (true) {
+    operands.push_back(parse_binop_item(context));
 
-    /* / */
-    case StyioTokenType::TOK_SLASH: {
-      context.move_forward(1, "parse_binop_rhs(TOK_SLASH)");
-      next_token = StyioOpType::Binary_Div;
-    } break;
+    StyioOpType next_token = get_binop_type(context.cur_tok_type());
+    if (next_token == StyioOpType::Undefined) {
+      break;
+    }
+    context.move_forward(1, "parse_binop_rhs");
 
-    /* % */
-    case StyioTokenType::TOK_PERCENT: {
-      context.move_forward(1, "parse_binop_rhs(TOK_PERCENT)");
-      next_token = StyioOpType::Binary_Mod;
-    } break;
+    int next_prec = getOpPrecedence(next_token);
+    while (not operators.empty()) {
+      int top_prec = getOpPrecedence(operators.back());
+      if (top_prec > next_prec || (top_prec == next_prec && not isOpRightAssoc(next_token))) {
+        reduce();
+      }
+      else {
+        break;
+      }
+    }
 
-    default: {
-      return BinOpAST::Create(curr_token, lhs_ast, rhs_ast);
-    } break;
+    operators.push_back(next_token);
   }
 
-  if (next_token > curr_token) {
-    output = BinOpAST::Create(
-      curr_token,
-      lhs_ast,
-      parse_binop_rhs(
-        context,
-        rhs_ast,
-        next_token
-      )
-    );
-  }
-  else {
-    output = parse_binop_rhs(
-      context,
-      BinOpAST::Create(
-        curr_token,
-        lhs_ast,
-        rhs_ast
-      ),
-      next_token
-    );
+  while (not operators.empty()) {
+    reduce();
   }
 
-  return output;
+  return static_cast<BinOpAST*>(operands.back());
 }
 
-CondAST*
-parse_cond_rhs(StyioContext& context, StyioAST* lhsExpr) {
-  CondAST* condExpr;
-
-  context.drop_all_spaces();
-
-  switch (context.get_curr_char()) {
-    case '&': {
-      context.move(1);
-      context.check_drop_panic('&');
-
-      /*
-        support:
-          expr && \n
-          expression
-      */
-
-      context.drop_all_spaces();
-
-      condExpr = new CondAST(
-        LogicType::AND, (lhsExpr), parse_cond(context)
-      );
-    }
-
-    break;
-
-    case '|': {
-      context.move(1);
-      context.check_drop_panic('|');
-
-      /*
-        support:
-          expr || \n
-          expression
-      */
-
-      context.drop_all_spaces();
-
-      condExpr = new CondAST(
-        LogicType::OR, (lhsExpr), parse_cond(context)
-      );
-    }
-
-    break;
-
-    case '^': {
-      context.move(1);
+/* Operator and left operand of each `&&`, `||` and `^` whose right operand is still to come */
+using StyioPendingConds = std::vector<std::pair<LogicType, StyioAST*>>;
 
-      /*
-        support:
-          expr ^ \n
-          expression
-      */
-
-      context.drop_all_spaces();
+/*
+  The rest of a condition after `cond`, up to its `)`.
 
-      condExpr = new CondAST(
-        LogicType::XOR, (lhsExpr), parse_cond(context)
-      );
-    }
+  Returns true if it stops at a binary operator, which is pushed onto
+  `pending` with `cond` as its left operand: its right operand is the
+  next condition, see parse_cond().
+*/
+static bool
+parse_cond_rhs(StyioContext& context, CondAST*& cond, StyioPendingConds& pending) {
+  /* line breaks are trivia, `expr && \n expr` needs nothing special */
+  while (not context.check(StyioTokenType::TOK_RPAREN) /* ) */) {
+    switch (context.cur_tok_type()) {
+      /* expr && expr */
+      case StyioTokenType::LOGIC_AND: {
+        context.move_forward(1, "parse_cond_rhs(&&)");
+        pending.push_back({LogicType::AND, cond});
+        return true;
+      } break;
 
-    break;
+      /* expr || expr */
+      case StyioTokenType::LOGIC_OR: {
+        context.move_forward(1, "parse_cond_rhs(||)");
+        pending.push_back({LogicType::OR, cond});
+        return true;
+      } break;
 
-    case '!': {
-      context.move(1);
+      /* expr ^ expr */
+      case StyioTokenType::TOK_HAT: {
+        context.move_forward(1, "parse_cond_rhs(^)");
+        pending.push_back({LogicType::XOR, cond});
+        return true;
+      } break;
 
-      if (context.check_next('(')) {
-        context.move(1);
+      /* !(expr) */
+      case StyioTokenType::TOK_EXCLAM: {
+        context.move_forward(1, "parse_cond_rhs(!)");
+        context.match_panic(StyioTokenType::TOK_LPAREN); /* ( */
 
-        /*
-          support:
-            !( \n
-              expr
-            )
-        */
-        context.drop_all_spaces();
+        cond = new CondAST(LogicType::NOT, parse_cond(context));
 
-        condExpr = new CondAST(LogicType::NOT, parse_cond(context));
+        context.try_match_panic(StyioTokenType::TOK_RPAREN); /* ) */
+      } break;
 
-        context.find_drop_panic(')');
-      }
+      default: {
+        throw StyioSyntaxError(context.mark_cur_tok("Expecting &&, ||, ^ or !"));
+      } break;
     }
-
-    break;
-
-    default:
-      break;
-  }
-
-  context.drop_all_spaces();
-
-  while (!(context.check_next(')'))) {
-    condExpr = (parse_cond_rhs(context, (condExpr)));
   }
 
-  return condExpr;
+  return false;
 }
 
+/*
+  `a && b && ... && z` nests to the right, a && (b && (... && z)), but
+  the operators wait on `pending` rather than on the C++ stack: only
+  parentheses recurse, and they are limited by StyioContext::Nesting.
+*/
 CondAST*
 parse_cond(StyioContext& context) {
-  StyioAST* lhsExpr;
+  StyioContext::Nesting nesting(context);
 
-  context.drop_all_spaces_comments();
+  StyioPendingConds pending;
 
-  if (context.check_drop('(')) {
-    lhsExpr = parse_cond(context);
-    context.find_drop_panic(')');
-  }
-  else if (context.check_drop('!')) {
-    context.drop_all_spaces_comments();
-    if (context.check_drop('(')) {
-      /*
-        support:
-          !( \n
-            expr
-          )
-      */
-      context.drop_all_spaces();
+  while (true) {
+    StyioAST* lhsExpr;
+    CondAST* cond = nullptr;
+
+    if (context.match(StyioTokenType::TOK_LPAREN) /* ( */) {
+      lhsExpr = parse_cond(context);
+      context.try_match_panic(StyioTokenType::TOK_RPAREN); /* ) */
+    }
+    else if (context.match(StyioTokenType::TOK_EXCLAM) /* ! */) {
+      context.match_panic(StyioTokenType::TOK_LPAREN, "!(expr) // Expecting ( after !");
 
       lhsExpr = parse_cond(context);
 
-      context.drop_all_spaces();
+      context.try_match_panic(StyioTokenType::TOK_RPAREN); /* ) */
 
-      return new CondAST(LogicType::NOT, lhsExpr);
+      cond = new CondAST(LogicType::NOT, lhsExpr);
     }
     else {
-      string errmsg = string("!(expr) // Expecting ( after !, but got ") + char(context.get_curr_char());
-      throw StyioSyntaxError(errmsg);
+      lhsExpr = parse_cond_item(context);
     }
-  }
-  else {
-    lhsExpr = parse_cond_item(context);
-  }
-
-  // drop all spaces after first value
-  context.drop_all_spaces();
-
-  if (context.check_next("&&") || context.check_next("||")) {
-    return parse_cond_rhs(context, lhsExpr);
-  }
-  else {
-    return new CondAST(LogicType::RAW, lhsExpr);
-  }
-
-  string errmsg = string("parse_cond() : You should not reach this line!") + char(context.get_curr_char());
-  throw StyioParseError(errmsg);
-}
-
-StyioAST*
-parse_cond_flow(StyioContext& context) {
-  /*
-    Danger!
-    when entering parse_cond_flow(),
-    the context -> get_curr_char() must be ?
-    this line will drop the next 1 character anyway!
-  */
-  context.move(1);
-
-  context.drop_white_spaces();
-
-  if (context.check_drop('(')) {
-    CondAST* condition = parse_cond(context);
-
-    context.find_drop_panic(')');
-
-    /*
-      support:
-        ?() \n
-        \t\
-
-        ?() \n
-        \f\
-    */
-    context.drop_all_spaces_comments();
-
-    if (context.check_drop('\\')) {
-      StyioAST* block;
 
-      if (context.check_drop('t')) {
-        context.check_drop('\\');
-
-        /*
-          support:
-            \t\ \n
-            {}
-        */
+    if (cond == nullptr) {
+      if (context.match(StyioTokenType::LOGIC_AND) /* && */) {
+        pending.push_back({LogicType::AND, lhsExpr});
+        continue;
+      }
 
-        context.drop_all_spaces_comments();
+      if (context.match(StyioTokenType::LOGIC_OR) /* || */) {
+        pending.push_back({LogicType::OR, lhsExpr});
+        continue;
+      }
 
-        block = parse_block_only(context);
+      cond = new CondAST(LogicType::RAW, lhsExpr);
+    }
 
-        /*
-          support:
-            \t\ {} \n
-            \f\
-        */
-        context.drop_all_spaces_comments();
+    /* `cond` is the right operand of the innermost pending operator, and so on */
+    bool has_next = false;
+    while (not pending.empty() && not has_next) {
+      auto [op, lhs] = pending.back();
+      pending.pop_back();
 
-        if (context.check_drop('\\')) {
-          context.check_drop_panic('f');
+      cond = new CondAST(op, lhs, cond);
+      has_next = parse_cond_rhs(context, cond, pending);
+    }
 
-          context.check_drop('\\');
+    if (not has_next) {
+      return cond;
+    }
+  }
+}
 
-          /*
-            support:
-              \f\ \n
-              {}
-          */
-          context.drop_all_spaces_comments();
+StyioAST*
+parse_cond_flow(StyioContext& context) {
+  context.match_panic(StyioTokenType::TOK_QUEST); /* ? */
+  context.match_panic(StyioTokenType::TOK_LPAREN, "Missing ( for ?(`expr`).");
 
-          StyioAST* blockElse = parse_block_only(context);
+  CondAST* condition = parse_cond(context);
 
-          return new CondFlowAST(StyioNodeType::CondFlow_Both, (condition), (block), (blockElse));
-        }
-        else {
-          return new CondFlowAST(StyioNodeType::CondFlow_True, (condition), (block));
-        }
-      }
-      else if (context.check_drop('f')) {
-        context.check_drop('\\');
+  context.try_match_panic(StyioTokenType::TOK_RPAREN); /* ) */
 
-        /*
-          support:
-            \f\ \n
-            {}
-        */
-        context.drop_all_spaces_comments();
+  /*
+    ?() \t\ {} \f\ {}
+  */
+  if (match_cond_flag(context, "t")) {
+    StyioAST* block = parse_block_only(context);
 
-        block = parse_block_only(context);
+    if (match_cond_flag(context, "f")) {
+      StyioAST* blockElse = parse_block_only(context);
 
-        return new CondFlowAST(StyioNodeType::CondFlow_False, (condition), (block));
-      }
-      else {
-        string errmsg = string("parse_cond_flow() // Unexpected character ") + context.get_curr_char();
-        throw StyioSyntaxError(errmsg);
-      }
+      return new CondFlowAST(StyioNodeType::CondFlow_Both, (condition), (block), (blockElse));
+    }
+    else {
+      return new CondFlowAST(StyioNodeType::CondFlow_True, (condition), (block));
     }
   }
-  else {
-    string errmsg = string("Missing ( for ?(`expr`).");
-    throw StyioSyntaxError(errmsg);
+  else if (match_cond_flag(context, "f")) {
+    StyioAST* block = parse_block_only(context);
+
+    return new CondFlowAST(StyioNodeType::CondFlow_False, (condition), (block));
   }
 
-  throw StyioSyntaxError(context.label_cur_line(), string("Invalid Syntax"));
+  throw StyioSyntaxError(context.mark_cur_tok("Expecting \\t\\ or \\f\\"));
 }
 
 StyioAST*
@@ -2080,16 +1546,13 @@ parse_hash_tag(StyioContext& context) {
   StyioAST* ret_expr;
 
   /* TAG NAME */
-  context.skip();
   if (context.check(StyioTokenType::NAME)) {
     tag_name = parse_name_unsafe(context);
   }
 
   params = parse_params(context);
 
-  context.skip();
   if (context.match(StyioTokenType::TOK_COLON) /* : */) {
-    context.skip();
     if (context.check(StyioTokenType::NAME)) {
       auto type_name = parse_name_as_str_unsafe(context);
       ret_type = TypeAST::Create(type_name);
@@ -2097,7 +1560,6 @@ parse_hash_tag(StyioContext& context) {
     else if (context.match(StyioTokenType::TOK_LPAREN) /* ( */) {
       std::vector<TypeAST*> types;
       do {
-        context.skip();
         if (context.check(StyioTokenType::NAME)) {
           TypeAST* type_name = parse_name_as_type_unsafe(context);
           types.push_back(type_name);
@@ -2110,7 +1572,6 @@ parse_hash_tag(StyioContext& context) {
     }
   }
 
-  context.skip();
   /* Block */
   if (context.check(StyioTokenType::TOK_LCURBRAC) /* { */) {
     ret_expr = parse_block_with_forward(context);
@@ -2118,7 +1579,6 @@ parse_hash_tag(StyioContext& context) {
   }
   /* Block or Statement */
   else if (context.match(StyioTokenType::ARROW_DOUBLE_RIGHT) /* => */) {
-    context.skip();
     /* Block */
     if (context.check(StyioTokenType::TOK_LCURBRAC) /* { */) {
       ret_expr = parse_block_with_forward(context);
@@ -2132,14 +1592,12 @@ parse_hash_tag(StyioContext& context) {
   }
   /* SimpleFunc */
   else if (context.match(StyioTokenType::TOK_EQUAL) /* = */) {
-    context.skip();
     ret_expr = parse_expr(context);
 
     return SimpleFuncAST::Create(tag_name, false, params, ret_type, ret_expr);
   }
   /* SimpleFunc (Unique) */
   else if (context.match(StyioTokenType::WALRUS) /* := */) {
-    context.skip();
     ret_expr = parse_expr(context);
 
     return SimpleFuncAST::Create(tag_name, true, params, ret_expr);
@@ -2182,13 +1640,10 @@ parse_params(StyioContext& context) {
   context.try_match(StyioTokenType::TOK_LPAREN); /* ( */
 
   do {
-    context.skip();
     if (context.check(StyioTokenType::NAME)) {
       NameAST* var_name = parse_name(context);
 
-      context.skip();
       if (context.match(StyioTokenType::TOK_COLON) /* : */) {
-        context.skip();
         auto var_type = parse_name_as_str(context);
 
         params.push_back(ParamAST::Create(
@@ -2215,13 +1670,11 @@ parse_forward_as_list(
   std::vector<StyioAST*> following_exprs;
 
   while (true) {
-    context.skip();
     switch (context.cur_tok_type()) {
       /* => Block or Statement */
       case StyioTokenType::ARROW_DOUBLE_RIGHT: {
         context.move_forward(1);
 
-        context.skip();
         if (context.check(StyioTokenType::TOK_LCURBRAC) /* { */) {
           following_exprs.push_back(parse_block_only(context));
         }
@@ -2239,7 +1692,6 @@ parse_forward_as_list(
       case StyioTokenType::MATCH: {
         context.move_forward(1);
 
-        context.skip();
         /* { _ => ... } Cases */
         if (context.check(StyioTokenType::TOK_LCURBRAC) /* { */) {
           following_exprs.push_back(parse_cases_only(context));
@@ -2285,11 +1737,8 @@ parse_cases_only(StyioContext& context) {
   context.try_match_panic(StyioTokenType::TOK_LCURBRAC); /* { */
 
   while (not context.match(StyioTokenType::TOK_RCURBRAC) /* } */) {
-    context.skip();
     if (context.match(StyioTokenType::TOK_UNDLINE) /* _ */) {
-      context.skip();
       if (context.match(StyioTokenType::ARROW_DOUBLE_RIGHT) /* => */) {
-        context.skip();
         if (context.check(StyioTokenType::TOK_LCURBRAC) /* { */) {
           default_stmt = parse_block_only(context);
         }
@@ -2306,11 +1755,9 @@ parse_cases_only(StyioContext& context) {
       // StyioAST* left = parse_cond(context);
       StyioAST* left = parse_expr(context);
 
-      context.skip();
       if (context.match(StyioTokenType::ARROW_DOUBLE_RIGHT) /* => */) {
         StyioAST* right;
 
-        context.skip();
         if (context.check(StyioTokenType::TOK_LCURBRAC) /* { */) {
           right = parse_block_only(context);
         }
@@ -2326,7 +1773,6 @@ parse_cases_only(StyioContext& context) {
       }
     }
 
-    context.skip();
   }
 
   // for (size_t i = 0; i < case_pairs.size(); i++) {
@@ -2373,20 +1819,17 @@ parse_iterator_only(
   std::vector<ParamAST*> params;
   BlockAST* block;
 
-  context.skip();
 
   /* Iterator Sequence (Early Stop) */
   if (context.match(StyioTokenType::TOK_HASH) /* # */) {
     std::vector<HashTagNameAST*> hash_tags;
 
-    context.skip();
     if (context.check(StyioTokenType::NAME)) {
       hash_tags.push_back(HashTagNameAST::Create(parse_name_with_spaces_unsafe(context)));
     }
 
     while (context.try_match(StyioTokenType::TOK_RANGBRAC) /* > */) {
       if (context.try_match(StyioTokenType::TOK_HASH) /* # */) {
-        context.skip();
         if (context.check(StyioTokenType::NAME)) {
           hash_tags.push_back(HashTagNameAST::Create(parse_name_with_spaces_unsafe(context)));
         }
@@ -2406,7 +1849,6 @@ parse_iterator_only(
     params = parse_params(context);
   }
 
-  context.skip();
 
   if (context.try_match(StyioTokenType::ARROW_DOUBLE_RIGHT) /* => */) {
     if (context.try_match(StyioTokenType::TOK_LCURBRAC) /* { */) {
@@ -2424,7 +1866,6 @@ parse_iterator_only(
 
     do {
       if (context.try_match(StyioTokenType::TOK_HASH) /* # */) {
-        context.skip();
         if (context.check(StyioTokenType::NAME)) {
           hash_tags.push_back(HashTagNameAST::Create(parse_name_with_spaces_unsafe(context)));
         }
@@ -2466,13 +1907,13 @@ ExtractorAST*
 parse_tuple_operations(StyioContext& context, TupleAST* the_tuple) {
   ExtractorAST* result;
 
-  if (context.check_drop("<<")) {
+  if (context.match(StyioTokenType::EXTRACTOR) /* << */) {
     // parse_extractor
   }
-  else if (context.check_drop(">>")) {
+  else if (context.match(StyioTokenType::ITERATOR) /* >> */) {
     // parse_iterator
   }
-  else if (context.check_drop("=>")) {
+  else if (context.match(StyioTokenType::ARROW_DOUBLE_RIGHT) /* => */) {
     // parse_forward
   }
   else {
@@ -2492,7 +1933,7 @@ parse_codp(StyioContext& context, CODPAST* prev_op) {
 
   string name = parse_name_as_str(context);
 
-  context.find_drop_panic('{');
+  context.try_match_panic(StyioTokenType::TOK_LCURBRAC); /* { */
 
   vector<StyioAST*> op_args;
 
@@ -2501,18 +1942,16 @@ parse_codp(StyioContext& context, CODPAST* prev_op) {
   }
   else if (name == "sort" or name == "map") {
     do {
-      context.drop_all_spaces_comments();
       op_args.push_back(parse_attr(context));
-    } while (context.find_drop(','));
+    } while (context.match(StyioTokenType::TOK_COMMA) /* , */);
   }
   else if (name == "slice") {
     do {
-      context.drop_all_spaces_comments();
       op_args.push_back(parse_int(context));
-    } while (context.find_drop(','));
+    } while (context.match(StyioTokenType::TOK_COMMA) /* , */);
   }
 
-  context.find_drop_panic('}');
+  context.try_match_panic(StyioTokenType::TOK_RCURBRAC); /* } */
 
   curr_op = CODPAST::Create(name, op_args, prev_op);
 
@@ -2520,8 +1959,7 @@ parse_codp(StyioContext& context, CODPAST* prev_op) {
     prev_op->NextOp = curr_op;
   }
 
-  if (context.find_drop("=>")) {
-    context.drop_all_spaces_comments();
+  if (context.match(StyioTokenType::ARROW_DOUBLE_RIGHT) /* => */) {
     parse_codp(context, curr_op);
   }
 
@@ -2530,25 +1968,18 @@ parse_codp(StyioContext& context, CODPAST* prev_op) {
 
 StyioAST*
 parse_read_file(StyioContext& context, NameAST* id_ast) {
-  if (context.check_drop('@')) {
-    context.check_drop_panic('(');
+  context.match_panic(StyioTokenType::TOK_AT, "parse_read_file() // Expecting @"); /* @ */
+  context.match_panic(StyioTokenType::TOK_LPAREN); /* ( */
 
-    if (context.check_next('"')) {
-      auto path = parse_path(context);
+  if (not context.check(StyioTokenType::STRING)) {
+    throw StyioSyntaxError(context.mark_cur_tok("Expecting id or string"));
+  }
 
-      context.find_drop_panic(')');
+  auto path = parse_path(context);
 
-      return new ReadFileAST((id_ast), (path));
-    }
-    else {
-      string errmsg = string("Expecting id or string, but got ` ") + char(context.get_curr_char()) + " `";
-      throw StyioSyntaxError(errmsg);
-    }
-  }
-  else {
-    string errmsg = string("parse_read_file() // Expecting @ as first character but got ` ") + char(context.get_curr_char()) + " `";
-    throw StyioSyntaxError(errmsg);
-  }
+  context.try_match_panic(StyioTokenType::TOK_RPAREN); /* ) */
+
+  return new ReadFileAST((id_ast), (path));
 }
 
 StyioAST*
@@ -2560,7 +1991,6 @@ parse_print(StyioContext& context) {
   context.try_match_panic(StyioTokenType::TOK_LPAREN);  // (
 
   do {
-    context.skip();
 
     if (context.match(StyioTokenType::TOK_RPAREN) /* ) */) {
       return PrintAST::Create(exprs);
@@ -2603,7 +2033,7 @@ StyioAST*
 parse_stmt_or_expr(
   StyioContext& context
 ) {
-  context.skip();
+  StyioContext::Nesting nesting(context);
 
   switch (context.cur_tok_type()) {
     /* var_name / func_name */
@@ -2673,7 +2103,6 @@ parse_block_only(StyioContext& context) {
   while (
     context.cur_tok_type() != StyioTokenType::TOK_EOF
   ) {
-    context.skip();
     if (context.match(StyioTokenType::TOK_RCURBRAC) /* } */) {
       return BlockAST::Create(std::move(stmts));
     }
@@ -2687,12 +2116,120 @@ parse_block_only(StyioContext& context) {
   return BlockAST::Create(std::move(stmts));
 }
 
+/* Can a statement start with this token? Keep in sync with parse_stmt_or_expr(). */
+static bool
+is_stmt_start(StyioTokenType type) {
+  switch (type) {
+    case StyioTokenType::NAME:
+    case StyioTokenType::INTEGER:
+    case StyioTokenType::DECIMAL:
+    case StyioTokenType::TOK_AT:
+    case StyioTokenType::TOK_HASH:
+    case StyioTokenType::PRINT:
+    case StyioTokenType::TOK_LPAREN:
+    case StyioTokenType::ELLIPSIS:
+    case StyioTokenType::EXTRACTOR:
+    case StyioTokenType::TOK_EOF:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+static int
+bracket_depth_of(StyioTokenType type) {
+  switch (type) {
+    case StyioTokenType::TOK_LPAREN:
+    case StyioTokenType::TOK_LBOXBRAC:
+    case StyioTokenType::TOK_LCURBRAC:
+      return 1;
+
+    case StyioTokenType::TOK_RPAREN:
+    case StyioTokenType::TOK_RBOXBRAC:
+    case StyioTokenType::TOK_RCURBRAC:
+      return -1;
+
+    default:
+      return 0;
+  }
+}
+
+/*
+  Recovery: skip the rest of the statement that started at token
+  `stmt_start`, up to the next line break or `;` outside of the
+  brackets it has opened. Moves at least one token, unless at EOF.
+*/
+static void
+skip_to_next_stmt(StyioContext& context, size_t stmt_start) {
+  auto const& tokens = context.get_tokens();
+
+  int depth = 0;
+  for (size_t i = stmt_start; i < context.cur_tok_index(); i++) {
+    depth = std::max(0, depth + bracket_depth_of(tokens[i].type));
+  }
+
+  while (not context.check(StyioTokenType::TOK_EOF)) {
+    depth = std::max(0, depth + bracket_depth_of(context.cur_tok_type()));
+    bool after_semicolon = context.check(StyioTokenType::TOK_SEMICOLON);
+
+    context.move_forward(1, "skip_to_next_stmt");
+
+    if (depth == 0 && (after_semicolon || context.has_line_break_before())) {
+      break;
+    }
+  }
+}
+
+/*
+  One top-level statement.
+
+  In recovery mode (the context has a StyioDiagnostics), a broken
+  statement is recorded and skipped, and the result is null. A token
+  that cannot start any statement, the most common mistake, is caught
+  up front without throwing; other errors unwind once, to the statement
+  they belong to.
+*/
+StyioAST*
+parse_top_level_stmt(StyioContext& context) {
+  StyioDiagnostics* diagnostics = context.get_diagnostics();
+
+  if (diagnostics == nullptr) {
+    return parse_stmt_or_expr(context);
+  }
+
+  size_t stmt_start = context.cur_tok_index();
+
+  if (not is_stmt_start(context.cur_tok_type())) {
+    diagnostics->report(
+      context.cur_tok().offset,
+      StyioSyntaxError(context.mark_cur_tok("No Statement Starts With This")).what()
+    );
+    skip_to_next_stmt(context, stmt_start);
+    return nullptr;
+  }
+
+  try {
+    return parse_stmt_or_expr(context);
+  }
+  catch (StyioBaseException& e) {
+    diagnostics->report(context.cur_tok().offset, e.what());
+    skip_to_next_stmt(context, stmt_start);
+    return nullptr;
+  }
+}
+
 MainBlockAST*
 parse_main_block(StyioContext& context) {
   vector<StyioAST*> statements;
 
   while (true) {
-    StyioAST* stmt = parse_stmt_or_expr(context);
+    StyioAST* stmt = parse_top_level_stmt(context);
+
+    /* broken, see the diagnostics */
+    if (stmt == nullptr) {
+      continue;
+    }
 
     if ((stmt->getNodeType()) == StyioNodeType::End) {
       break;
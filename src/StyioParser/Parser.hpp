@@ -2,6 +2,14 @@
 #ifndef STYIO_PARSER_H_
 #define STYIO_PARSER_H_
 
+// [C++ STL]
+#include <algorithm>
+#include <cassert>
+#include <span>
+
+// [Styio]
+#include "../StyioException/Diagnostics.hpp"
+#include "../StyioSource/SourceFile.hpp"
 #include "../StyioToken/Token.hpp"
 
 using std::pair;
@@ -20,17 +28,32 @@ using std::unique_ptr;
 class StyioContext;
 class StyioParser;
 
+/*
+  StyioContext: the parser state.
+
+  The parser only ever looks at tokens: one cursor (`index_of_token`)
+  into the significant tokens, plus at most `max_lookahead` tokens
+  of lookahead through peek(). Compound operators (`=>`, `>>`, `:=`,
+  `?=`, `|>`, ...) come from the tokenizer as single tokens, so every
+  decision is a compare on token types.
+*/
 class StyioContext
 {
-private:
-  size_t cur_pos = 0; /* current position */
+public:
+  static constexpr size_t max_lookahead = 4;
+
+  /* Levels of brackets and blocks an expression may nest in, see Nesting */
+  static constexpr size_t max_nesting = 256;
 
+private:
   string file_name;
-  string code;
-  vector<pair<size_t, size_t>> line_seps; /* line separations */
+  std::string_view code;
+  const StyioSourceFile* source; /* owns `code` and the line index */
 
   size_t index_of_token = 0;
-  std::vector<StyioToken*> tokens;
+  std::vector<StyioToken> tokens;      /* significant tokens only */
+  std::vector<StyioToken> trivia;      /* spaces, line breaks, comments */
+  std::vector<uint32_t> trivia_bounds; /* see StyioTokenStream */
 
   shared_ptr<StyioAST> ast;
   unordered_map<string, shared_ptr<StyioAST>> constants;
@@ -38,129 +61,171 @@ private:
 
   bool debug_mode = false;
 
-  std::vector<std::vector<std::pair<size_t, size_t>>> token_segmentation; /* offset, length */
-  std::vector<std::pair<size_t, size_t>> token_coordinates;               /* row, col */
-  std::vector<std::string> token_lines;                                   /* lines */
-
-  StyioRepr* ast_repr = new StyioRepr();
+  /* recovery mode if not null, see parse_main_block() */
+  StyioDiagnostics* diagnostics = nullptr;
 
-  void initialize_token_coordinates_and_segmentations() {
-    /* token_segmentation */
-    size_t offset = 0;
-    std::vector<std::pair<size_t, size_t>> seg_line;
-
-    /* token_coordinates */
-    size_t row = 0;
-    size_t col = 0;
-
-    /* token_lines */
-    for (size_t i = 0; i < tokens.size(); i++) {
-      token_coordinates.push_back(std::make_pair(row, col));
-
-      if (tokens[i]->type == StyioTokenType::TOK_LF) {
-        /* token_coordinates */
-        seg_line.push_back(std::make_pair(offset, tokens[i]->length()));
-        token_segmentation.push_back(seg_line);
-        seg_line.clear();
-        offset = 0; /* reset to the start of the line */
-
-        /* tok_loc */
-        row += 1;
-        col = 0;
-      }
-      else {
-        /* token_segmentation */
-        seg_line.push_back(std::make_pair(offset, tokens[i]->length()));
-        offset += tokens[i]->length();
-
-        /* token_coordinates */
-        col += 1;
-      }
-    }
-  }
-
-  void initialize_token_lines() {
-    /* token_lines */
-    std::string tmp_line;
-    for (auto c : code) {
-      tmp_line += c;
-
-      if (c == '\n') {
-        token_lines.push_back(tmp_line);
-        tmp_line.clear();
-      }
-    }
-  }
+  size_t nesting = 0;
 
 public:
   StyioContext(
-    const string& file_name,
-    const string& code_text,
-    vector<pair<size_t, size_t>> line_seps,
-    std::vector<StyioToken*> tokens,
+    const StyioSourceFile* source,
+    StyioTokenStream stream,
     bool debug_mode = false
   ) :
-      file_name(file_name),
-      code(code_text),
-      line_seps(line_seps),
-      tokens(tokens),
+      file_name(source->get_file_name()),
+      code(source->text()),
+      source(source),
+      tokens(std::move(stream.tokens)),
+      trivia(std::move(stream.trivia)),
+      trivia_bounds(std::move(stream.trivia_bounds)),
       debug_mode(debug_mode) {
-    initialize_token_coordinates_and_segmentations();
-    initialize_token_lines();
   }
 
   static StyioContext* Create(
-    const string& file_name,
-    const string& code_text,
-    vector<pair<size_t, size_t>> line_seps,
-    std::vector<StyioToken*> tokens,
+    const StyioSourceFile* source,
+    StyioTokenStream stream,
     bool debug_mode = false
   ) {
     return new StyioContext(
-      file_name,
-      code_text,
-      line_seps,
-      tokens,
+      source,
+      std::move(stream),
       debug_mode
     );
   }
 
   /* Get `code` */
-  const string&
+  std::string_view
   get_code() const {
     return code;
   }
 
+  /* Get `source` */
+  const StyioSourceFile*
+  get_source() const {
+    return source;
+  }
+
+  /* Collect errors into `diags` and keep parsing, instead of stopping at the first one */
+  void
+  enable_recovery(StyioDiagnostics* diags) {
+    diagnostics = diags;
+  }
+
+  /* Get `diagnostics`, null unless in recovery mode */
+  StyioDiagnostics*
+  get_diagnostics() const {
+    return diagnostics;
+  }
+
+  /* Get `tokens` */
+  const std::vector<StyioToken>&
+  get_tokens() const {
+    return tokens;
+  }
+
+  /*
+    Nesting: one level of the parser's recursion, e.g. into the elements
+    of a tuple. The C++ stack grows with every level, so deeper input is
+    a syntax error instead of a stack overflow.
+
+    Usage:
+      StyioContext::Nesting nesting(context);
+  */
+  class Nesting
+  {
+  private:
+    StyioContext& context;
+
+  public:
+    explicit Nesting(StyioContext& context) :
+        context(context) {
+      if (context.nesting == max_nesting) {
+        throw StyioSyntaxError(context.mark_cur_tok(
+          "Nested too deeply, at most " + std::to_string(max_nesting) + " levels"
+        ));
+      }
+      context.nesting += 1;
+    }
+
+    Nesting(const Nesting&) = delete;
+    Nesting& operator=(const Nesting&) = delete;
+
+    ~Nesting() {
+      context.nesting -= 1;
+    }
+  };
+
   /*
     === Token Start
   */
 
-  StyioToken* cur_tok() {
+  const StyioToken& cur_tok() {
     return tokens.at(index_of_token);
   }
 
   StyioTokenType cur_tok_type() {
-    return tokens.at(index_of_token)->type;
+    return tokens.at(index_of_token).type;
+  }
+
+  size_t cur_tok_index() const {
+    return index_of_token;
   }
 
-  void move_forward(size_t steps = 1, std::string caller = "") {
-    // std::cout << "[" << index_of_token << "] " << caller << "(`" << cur_tok()->as_str() << "`)" << ", step: " << steps << std::endl;
+  /* LL(k): the k-th token after the current one, TOK_EOF past the end */
+  const StyioToken& peek(size_t k) const {
+    assert(k < max_lookahead && "peek(): lookahead is too far");
+    return tokens[std::min(index_of_token + k, tokens.size() - 1)];
+  }
+
+  StyioTokenType peek_type(size_t k) const {
+    return peek(k).type;
+  }
 
-    for (size_t i = 0; i < steps; i++) {
-      this->cur_pos += tokens.at(index_of_token)->length();
-      this->index_of_token += 1;
+  /* Text of a token, viewed in place from `code` */
+  std::string_view tok_str(const StyioToken& tok) const {
+    return tok.text(code);
+  }
+
+  std::string_view cur_tok_str() {
+    return tok_str(cur_tok());
+  }
+
+  /* Interned text of the current token (NAME tokens come with it) */
+  StyioSymbol cur_tok_symbol() {
+    const StyioToken& tok = cur_tok();
+    if (tok.type == StyioTokenType::NAME) {
+      return tok.symbol;
     }
+    return StyioSymbolTable::intern(tok_str(tok));
   }
 
-  inline void skip() {
-    while (cur_tok()->type == StyioTokenType::TOK_SPACE         /* white spaces */
-           || cur_tok()->type == StyioTokenType::TOK_LF         /* \n */
-           || cur_tok()->type == StyioTokenType::TOK_CR         /* \r */
-           || cur_tok()->type == StyioTokenType::COMMENT_LINE   // comments like this
-           || cur_tok()->type == StyioTokenType::COMMENT_CLOSED /* comments like this */
-    ) {
-      this->move_forward(1, "skip");
+  /* Trivia (spaces, line breaks, comments) right before the current token */
+  std::span<const StyioToken> cur_trivia() const {
+    return std::span<const StyioToken>(
+      trivia.data() + trivia_bounds[index_of_token],
+      trivia_bounds[index_of_token + 1] - trivia_bounds[index_of_token]
+    );
+  }
+
+  /* Is the current token on a new line? */
+  bool has_line_break_before() const {
+    for (auto const& tok : cur_trivia()) {
+      if (tok.type == StyioTokenType::TOK_LF || tok.type == StyioTokenType::TOK_CR) {
+        return true;
+      }
     }
+
+    return false;
+  }
+
+  void move_forward(size_t steps = 1, const char* caller = "") {
+    // std::cout << "[" << index_of_token << "] " << caller << "(`" << cur_tok().as_str(code) << "`)" << ", step: " << steps << std::endl;
+
+    if (steps == 0) {
+      return;
+    }
+
+    index_of_token = std::min(index_of_token + steps, tokens.size() - 1);
   }
 
   /* check length of consecutive sequence of token */
@@ -170,7 +235,7 @@ public:
 
     while (
       start + count < tokens.size()
-      && tokens.at(start + count)->type == type
+      && tokens.at(start + count).type == type
     ) {
       count += 1;
     }
@@ -182,52 +247,14 @@ public:
     return type == cur_tok_type();
   }
 
-  bool try_check(StyioTokenType target) {
-    // just match
-    if (tokens.at(index_of_token)->type == target) {
-      return true;
-    }
-
-    size_t offset = 0;
-    while (index_of_token + offset < tokens.size()) {
-      switch (tokens.at(index_of_token + offset)->type) {
-        /* white spaces */
-        case StyioTokenType::TOK_SPACE: {
-          offset += 1;
-        } break;
-
-        /* \n */
-        case StyioTokenType::TOK_LF: {
-          offset += 1;
-        } break;
-
-        /* \r */
-        case StyioTokenType::TOK_CR: {
-          offset += 1;
-        } break;
-
-        // comments like this
-        case StyioTokenType::COMMENT_LINE: {
-          offset += 1;
-        } break;
-
-        /* comments like this */
-        case StyioTokenType::COMMENT_CLOSED: {
-          offset += 1;
-        } break;
-
-        default: {
-          if (tokens.at(index_of_token + offset)->type == target) {
-            return true;
-          }
-          else {
-            return false;
-          }
-        } break;
-      }
-    }
+  /* check(), k tokens ahead */
+  bool check_ahead(size_t k, StyioTokenType type) const {
+    return type == peek_type(k);
+  }
 
-    return false;
+  /* same as check(), trivia is not in the token stream */
+  bool try_check(StyioTokenType target) {
+    return check(target);
   }
 
   bool match(StyioTokenType type) {
@@ -256,215 +283,50 @@ public:
     }
   }
 
-  bool map_match(StyioTokenType target) {
-    auto it = StyioTokenMap.find(target);
-    /* found */
-    if (it != StyioTokenMap.end()) {
-      bool is_same = true;
-      auto tok_seq = it->second;
-      for (size_t i = 0; i < tok_seq.size(); i++) {
-        if (tok_seq.at(i) != tokens.at(index_of_token + i)->type) {
-          std::cout << "map match " << StyioToken::getTokName(tok_seq.at(i)) << " not equal "
-                    << StyioToken::getTokName(tokens.at(index_of_token + i)->type) << std::endl;
-          is_same = false;
-        }
-      }
-
-      if (is_same) {
-        move_forward(tok_seq.size(), "map_match");
-      }
-
-      return is_same;
-    }
-    /* not found */
-    else {
-      std::string errmsg = "Undefined: " + StyioToken::getTokName(target) + " not found in StyioTokenMap.";
-      throw StyioSyntaxError(label_cur_line(cur_pos, errmsg));
-    }
-  }
-
+  /* same as match(), trivia is not in the token stream */
   bool try_match(StyioTokenType target) {
-    // just match
-    if (tokens.at(index_of_token)->type == target) {
-      move_forward(1, "try_match");
-      return true;
-    }
-
-    size_t offset = 0;
-    while (index_of_token + offset < tokens.size()) {
-      switch (tokens.at(index_of_token + offset)->type) {
-        /* white spaces */
-        case StyioTokenType::TOK_SPACE: {
-          offset += 1;
-        } break;
-
-        /* \n */
-        case StyioTokenType::TOK_LF: {
-          offset += 1;
-        } break;
-
-        /* \r */
-        case StyioTokenType::TOK_CR: {
-          offset += 1;
-        } break;
-
-        // comments like this
-        case StyioTokenType::COMMENT_LINE: {
-          offset += 1;
-        } break;
-
-        /* comments like this */
-        case StyioTokenType::COMMENT_CLOSED: {
-          offset += 1;
-        } break;
-
-        default: {
-          if (tokens.at(index_of_token + offset)->type == target) {
-            move_forward(offset + 1, "try_match");
-            return true;
-          }
-          else {
-            return false;
-          }
-        } break;
-      }
-    }
-
-    return false;
+    return match(target);
   }
 
   bool try_match_panic(StyioTokenType target, std::string errmsg = "") {
-    // just match
-    if (tokens.at(index_of_token)->type == target) {
+    if (cur_tok_type() == target) {
       move_forward(1, "try_match_panic");
       return true;
     }
 
-    // skip spaces and match token
-    size_t offset = 0;
-    while (index_of_token + offset < tokens.size()) {
-      switch (tokens.at(index_of_token + offset)->type) {
-        /* white spaces */
-        case StyioTokenType::TOK_SPACE: {
-          offset += 1;
-        } break;
-
-        /* \n */
-        case StyioTokenType::TOK_LF: {
-          offset += 1;
-        } break;
-
-        /* \r */
-        case StyioTokenType::TOK_CR: {
-          offset += 1;
-        } break;
-
-        // comments like this
-        case StyioTokenType::COMMENT_LINE: {
-          offset += 1;
-        } break;
-
-        /* comments like this */
-        case StyioTokenType::COMMENT_CLOSED: {
-          offset += 1;
-        } break;
-
-        default: {
-          if (tokens.at(index_of_token + offset)->type == target) {
-            move_forward(offset + 1, "try_match_panic");
-            return true;
-          }
-          else {
-            if (errmsg.empty()) {
-              throw StyioSyntaxError(
-                string("try_match_panic(token)")
-                + label_cur_line(
-                  cur_pos,
-                  std::string("which is expected to be ") + StyioToken::getTokName(target)
-                )
-              );
-            }
-            else {
-              throw StyioSyntaxError(label_cur_line(cur_pos, errmsg));
-            }
-          }
-        } break;
-      }
+    if (cur_tok_type() == StyioTokenType::TOK_EOF) {
+      throw StyioParseError(label_cur_line(
+        cur_tok().offset,
+        "try_match_panic(token): Couldn't find " + StyioToken::getTokName(target) + " until the end of the file."
+      ));
     }
 
-    throw StyioParseError(label_cur_line(
-      cur_pos,
-      "try_match_panic(token): Couldn't find " + StyioToken::getTokName(target) + " until the end of the file."
-    ));
+    if (errmsg.empty()) {
+      throw StyioSyntaxError(
+        string("try_match_panic(token)")
+        + label_cur_line(
+          cur_tok().offset,
+          std::string("which is expected to be ") + StyioToken::getTokName(target)
+        )
+      );
+    }
+    else {
+      throw StyioSyntaxError(label_cur_line(cur_tok().offset, errmsg));
+    }
   }
 
   /*
     === Token End ===
   */
 
-  /* Get `pos` */
-  size_t get_curr_pos() {
-    return cur_pos;
-  }
-
-  /* Get Current Character */
-  char& get_curr_char() {
-    return code.at(cur_pos);
-  }
-
   size_t find_line_index(
     int p = -1
   ) {
-    const size_t total_lines = line_seps.size();
-    size_t line_index = 0;
-
     if (p < 0) {
-      p = cur_pos;
-    }
-
-    if (debug_mode) {
-      cout << "find_line_index(), starts with position: " << p << " current character: " << get_curr_char() << "\ninitial: line [" << line_index << "]" << endl;
-    }
-
-    bool binary_search = false;
-    if (binary_search) {
-      line_index = total_lines / 2;
-
-      for (size_t i = 0; i < total_lines; i++) {
-        if (debug_mode) {
-          cout << "[" << line_index << "] is ";
-        }
-
-        if (p < line_seps[line_index].first) {
-          line_index = line_index / 2;
-          if (debug_mode) {
-            cout << "too large, go to: [" << line_index << "]" << endl;
-          }
-        }
-        else if (p > (line_seps[line_index].first + line_seps[line_index].second)) {
-          line_index = (line_index + total_lines) / 2;
-          if (debug_mode) {
-            cout << "too small, go to: [" << line_index << "]" << endl;
-          }
-        }
-        else {
-          if (debug_mode) {
-            cout << "result: [" << line_index << "]" << endl;
-          }
-          break;
-        }
-      }
-    }
-    else {
-      for (size_t curr_line_index = 0; curr_line_index < total_lines; curr_line_index += 1) {
-        if (line_seps[curr_line_index].first <= cur_pos
-            && cur_pos <= (line_seps[curr_line_index].first + line_seps[curr_line_index].second)) {
-          return curr_line_index;
-        }
-      }
+      p = cur_tok().offset;
     }
 
-    return line_index;
+    return source->line_of(p);
   }
 
   string label_cur_line(
@@ -474,17 +336,18 @@ public:
     string output("\n");
 
     if (start < 0)
-      start = cur_pos;
+      start = cur_tok().offset;
 
     size_t lindex = find_line_index(start);
-    size_t offset = start - line_seps[lindex].first;
+    size_t offset = start - source->line_start(lindex);
+    std::string_view line = source->line_text(lindex);
 
     output += "File \"" + file_name + "\", Line " + std::to_string(lindex) + ", At " + std::to_string(offset) + ":\n\n";
-    output += code.substr(line_seps[lindex].first, line_seps[lindex].second) + "\n";
+    output += std::string(line) + "\n";
     output += std::string(offset, ' ') + std::string("^");
 
     if (endswith.empty()) {
-      output += std::string(line_seps[lindex].second - offset - 1, '-') + "\n";
+      output += std::string(line.length() > offset ? line.length() - offset - 1 : 0, '-') + "\n";
     }
     else {
       output += " " + endswith + "\n";
@@ -496,463 +359,33 @@ public:
   std::string mark_cur_tok(std::string comment = "") {
     std::string result;
 
-    auto row_num = token_coordinates[index_of_token].first;
-    auto col_num = token_coordinates[index_of_token].second;
+    auto& tok = tokens[index_of_token];
+    auto [row_num, offset] = source->coordinate_of(tok.offset);
+    std::string_view that_line = source->line_text(row_num);
 
-    auto offset = token_segmentation[row_num][col_num].first;
-    auto length = token_segmentation[row_num][col_num].second;
+    size_t length = std::min<size_t>(tok.length, that_line.length() - std::min(offset, that_line.length()));
 
-    auto that_line = token_lines[row_num];
-
-    result += that_line;
-    result += std::string(offset, ' ') + std::string(length, '^') + std::string((that_line.length() - offset - length), '-') + " " + comment;
+    result += std::string(that_line) + "\n";
+    result += std::string(offset, ' ') + std::string(length, '^') + std::string((that_line.length() - std::min(offset + length, that_line.length())), '-') + " " + comment;
 
     return result;
   }
 
-  // No Boundary Check !
-  // | + n => move forward n steps
-  // | - n => move backward n steps
-  void move(size_t steps) {
-    cur_pos += steps;
-  }
-
-  /* Check Value */
-  bool check_next(char value) {
-    return (code.at(cur_pos)) == value;
-  }
-
-  /* Check Value */
-  bool check_next(const string& value) {
-    return code.compare(cur_pos, value.size(), value) == 0;
-  }
-
-  /* Move Until */
-  void move_until(char value) {
-    while (not check_next(value)) {
-      move(1);
-    }
-  }
-
-  void move_until(const string& value) {
-    while (not check_next(value)) {
-      move(1);
-    }
-  }
-
-  /* Check & Drop */
-  bool check_drop(char value) {
-    if (check_next(value)) {
-      move(1);
-      return true;
-    }
-    else {
-      return false;
-    }
-  }
-
-  /* Check & Drop */
-  bool check_drop(const string& value) {
-    if (check_next(value)) {
-      move(value.size());
-      return true;
-    }
-    else {
-      return false;
-    }
-  }
-
-  /* Find & Drop */
-  bool find_drop(char value) {
-    /* ! No Boundary Check ! */
-    while (true) {
-      if (isspace(get_curr_char())) {
-        move(1);
-      }
-      else if (check_next("//")) {
-        pass_over('\n');
-      }
-      else if (check_next("/*")) {
-        pass_over("*/");
-      }
-      else {
-        if (check_next(value)) {
-          move(1);
-          return true;
-        }
-        else {
-          return false;
-        }
-      }
-    }
-
-    return false;
-  }
-
-  /* Find & Drop */
-  bool find_drop(string value) {
-    /* ! No Boundary Check ! */
-    while (true) {
-      if (isspace(get_curr_char())) {
-        move(1);
-      }
-      else if (check_next("//")) {
-        pass_over('\n');
-      }
-      else if (check_next("/*")) {
-        pass_over("*/");
-      }
-      else {
-        if ((code.substr(cur_pos, value.size())) == value) {
-          move(value.size());
-          return true;
-        }
-        else {
-          return false;
-        }
-      }
-    }
-  }
-
-  /* Pass Over */
-  void pass_over(char value) {
-    /* ! No Boundary Check ! */
-    while (true) {
-      if (check_next(value)) {
-        move(1);
-        break;
-      }
-      else {
-        move(1);
-      }
-    }
-  }
-
-  /* Pass Over */
-  void pass_over(const string& value) {
-    /* ! No Boundary Check ! */
-    while (true) {
-      if (check_next(value)) {
-        move(value.size());
-        break;
-      }
-      else {
-        move(1);
-      }
-    }
-  }
-
-  /* Peak Check */
-  bool check_ahead(int steps, char value) {
-    return (code.at(cur_pos + steps) == value);
-  }
-
-  /*
-    usage:
-    1. the current position is after a known operator
-    like: a + b
-             ^     right here, after +, the current position is a white space
-    2. there is a variable or a value behind the current position
-    like: 1 + 2
-             ^     this space is followed by the value of 2
-    3. the expected operator is behind that variable or value
-    like: 1 + 2 * 3
-             ^     curr_pos is a white space, the expected operator is *, which is behind 2.
-  */
-  string peak_operator(int num = 1) {
-    int tmp_pos = cur_pos;
-    int offset = 1;
-
-    for (size_t i = 0; i < num; i++) {
-      while (true) {
-        if (isspace(code.at(tmp_pos))) {
-          tmp_pos += 1;
-        }
-        else if (code.compare(tmp_pos, 2, string("//")) == 0) {
-          tmp_pos += 2;
-
-          while (code.at(tmp_pos) != '\n') {
-            tmp_pos += 1;
-          } /* warning: no boundary check */
-          tmp_pos += 1;
-        }
-        /* match */ /* like */ /* this */
-        else if (code.compare(tmp_pos, 2, string("/*")) == 0) {
-          tmp_pos += 2;
-
-          while (code.compare(tmp_pos, 2, string("*/")) != 0) {
-            tmp_pos += 1;
-          } /* warning: no boundary check */
-          tmp_pos += 2;
-        } /* warning: no boundary check */
-        else if (isalnum(code.at(tmp_pos)) || (code.at(tmp_pos) == '_')) {
-          tmp_pos += 1;
-        }
-        else if (code.at(tmp_pos) == EOF) {
-          return "EOF";
-        }
-        else {
-          break;
-        }
-      }
-
-      /* that is: not space, not alpha, not number, not _ , and not comment*/
-      while (
-        not(isspace(code.at(tmp_pos))                      /* not space */
-            || code.compare(tmp_pos, 2, string("/*")) != 0 /* not comment */
-            || isalnum(code.at(tmp_pos)) || (code.at(tmp_pos) == '_') /* not alpha, not number, not _ */)
-      ) {
-        offset += 1;
-      }
-    }
-
-    // std::cout << "peak tmp_pos: " << tmp_pos << " " << code.at(tmp_pos) << std::endl;
-    // std::cout << "peak offset: " << offset << std::endl;
-    // std::cout << "peak operator: " << code.substr(tmp_pos, offset) << std::endl;
-
-    return code.substr(tmp_pos, offset);
-  }
-
-  bool peak_isdigit(int steps) {
-    return isdigit(code.at(cur_pos + steps));
-  }
-
-  /* Drop White Spaces */
-  void drop_white_spaces() {
-    while (check_next(' ')) {
-      move(1);
-    }
-  }
-
-  /* Drop Spaces */
-  void drop_all_spaces() {
-    while (isspace(code.at(cur_pos))) {
-      move(1);
-    }
-  }
-
-  /* Drop Spaces & Comments */
-  void drop_all_spaces_comments() {
-    /* ! No Boundary Check ! */
-    while (true) {
-      if (isspace(code.at(cur_pos))) {
-        move(1);
-      }
-      else if (check_next("//")) {
-        pass_over('\n');
-      }
-      else if (check_next("/*")) {
-        pass_over("*/");
-      }
-      else {
-        break;
-      }
-    }
-  }
-
-  /* Match(Next) -> Panic */
-  bool check_drop_panic(char value, std::string errmsg = "") {
-    if (check_next(value)) {
-      move(1);
-      return true;
-    }
-
-    if (errmsg.empty()) {
-      throw StyioSyntaxError(string("check_drop_panic(char)") + label_cur_line(cur_pos, std::string("which is expected to be ") + std::string(1, char(value))));
-    }
-    else {
-      throw StyioSyntaxError(label_cur_line(cur_pos, errmsg));
-    }
-  }
-
-  /* (Char) Find & Drop -> Panic */
-  bool find_drop_panic(char value) {
-    /* ! No Boundary Check ! */
-    while (true) {
-      if (isspace(get_curr_char())) {
-        move(1);
-      }
-      else if (check_next("//")) {
-        pass_over('\n');
-      }
-      else if (check_next("/*")) {
-        pass_over("*/");
-      }
-      else {
-        if (check_next(value)) {
-          move(1);
-          return true;
-        }
-        else {
-          string errmsg = string("find_drop_panic(char)") + label_cur_line(cur_pos, std::string("which is expected to be ") + std::string(1, char(value)));
-          throw StyioSyntaxError(errmsg);
-        }
-      }
-    }
-  }
-
-  /* (String) Find & Drop -> Panic */
-  bool find_drop_panic(string value) {
-    /* ! No Boundary Check ! */
-    while (true) {
-      if (isspace(get_curr_char()))
-        move(1);
-      else if (check_next("//"))
-        pass_over('\n');
-      else if (check_next("/*"))
-        pass_over("*/");
-      else {
-        if (check_next(value)) {
-          move(value.size());
-          return true;
-        }
-        else {
-          string errmsg = string("find_drop_panic(string)") + label_cur_line(cur_pos, std::string("which is expected to be ") + value);
-          throw StyioSyntaxError(errmsg);
-        }
-      }
-    }
-  }
-
-  /* Find & Drop -> Panic */
-  bool find_panic(const string& value) {
-    /* ! No Boundary Check ! */
-    while (true) {
-      if (isspace(get_curr_char())) {
-        move(1);
-      }
-      else if (check_next("//")) {
-        pass_over('\n');
-      }
-      else if (check_next("/*")) {
-        pass_over("*/");
-      }
-      else {
-        if (check_next(value)) {
-          move(value.size());
-          return true;
-        }
-        else {
-          string errmsg = string("find_panic(string)") + label_cur_line(cur_pos, std::string("which is expected to be ") + value);
-          throw StyioSyntaxError(errmsg);
-        }
-      }
-    }
-  }
-
-  /* Check isalpha or _ */
-  bool check_isal_() {
-    return isalpha(code.at(cur_pos)) || (code.at(cur_pos) == '_');
-  }
-
-  /* Check isalpha or isnum or _ */
-  bool check_isalnum_() {
-    return isalnum(code.at(cur_pos)) || (code.at(cur_pos) == '_');
-  }
-
-  /* Check isdigit */
-  bool check_isdigit() {
-    return isdigit(code.at(cur_pos));
-  }
-
-  /* Tuple Operations */
-  bool check_tuple_ops() {
-    return check_next("<<")     // extract
-           or check_next(">>")  // iterate
-           or check_next("=>")  // next
-      ;
-  }
-
-  /* Check Chain of Data Processing */
-  bool check_codp() {
-    return check_next("filter")
-           or check_next("sort")
-           or check_next("map")
-           or check_next("slice")
-           or check_next("print");
-  }
-
-  /* Check Binary Operator */
-  bool check_binop() {
-    if (code.at(cur_pos) == '+' || code.at(cur_pos) == '-') {
-      return true;
-    }
-    else if (code.at(cur_pos) == '*' || code.at(cur_pos) == '%') {
-      return true;
-    }
-    else if (code.at(cur_pos) == '/') {
-      /* Comments */
-      if ((code.at(cur_pos + 1)) == '*' || code.at(cur_pos + 1) == '/') {
-        return false;
-      }
-      else {
-        return true;
-      }
-    }
-    else if (code.at(cur_pos) == '%') {
-      return true;
-    }
-
-    return false;
-  }
-
-  std::tuple<bool, StyioOpType> get_binop_token() {
-    switch (code.at(cur_pos)) {
-      case '+': {
-        return {true, StyioOpType::Binary_Add};
-      } break;
-
-      case '-': {
-        return {true, StyioOpType::Binary_Sub};
-      } break;
-
-      case '*': {
-        return {true, StyioOpType::Binary_Mul};
-      } break;
-
-      case '/': {
-        switch (code.at(cur_pos + 1)) {
-          case '*': {
-            return {false, StyioOpType::Comment_MultiLine};
-          } break;
-
-          case '/': {
-            return {false, StyioOpType::Comment_SingleLine};
-          } break;
-
-          default: {
-            return {true, StyioOpType::Binary_Div};
-          } break;
-        }
-      } break;
-
-      case '%': {
-        return {true, StyioOpType::Binary_Mod};
-      } break;
-
-      default:
-        break;
-    }
-
-    return {false, StyioOpType::Undefined};
-  }
-
   void
   show_code_with_linenum() {
-    for (size_t i = 0; i < line_seps.size(); i++) {
-      std::string line = code.substr(line_seps.at(i).first, line_seps.at(i).second);
-
-      std::regex newline_regex("\n");
-      std::string replaced_text = std::regex_replace(line, newline_regex, "[NEWLINE]");
+    for (size_t i = 0; i < source->line_count(); i++) {
+      size_t start = source->line_start(i);
+      std::string_view line = source->line_text(i);
 
       std::cout
-        << "|" << i << "|-[" << line_seps.at(i).first << ":" << (line_seps.at(i).first + line_seps.at(i).second) << "] "
+        << "|" << i << "|-[" << start << ":" << (start + line.length()) << "] "
         << line << std::endl;
     }
   }
 
   void show_ast(StyioAST* ast) {
-    std::cout << ast->toString(ast_repr) << std::endl;
+    StyioRepr ast_repr;
+    std::cout << ast->toString(&ast_repr) << std::endl;
   }
 };
 
@@ -994,7 +427,7 @@ parse_int(StyioContext& context);
   parse_int_or_float
 */
 StyioAST*
-parse_int_or_float(StyioContext& context, char& cur_char);
+parse_int_or_float(StyioContext& context);
 
 /*
   parse_string
@@ -1131,7 +564,7 @@ parse_list_or_loop(StyioContext& context);
   parse_loop
 */
 StyioAST*
-parse_loop(StyioContext& context, char& cur_char);
+parse_loop(StyioContext& context);
 
 /*
   parse_simple_value
@@ -1267,6 +700,13 @@ parse_backward(StyioContext& context, bool is_func = false);
 CODPAST*
 parse_codp(StyioContext& context, CODPAST* prev_op = nullptr);
 
+/*
+  parse_top_level_stmt: one statement of the main block,
+  null if it is broken and the context is in recovery mode
+*/
+StyioAST*
+parse_top_level_stmt(StyioContext& context);
+
 MainBlockAST*
 parse_main_block(StyioContext& context);
 
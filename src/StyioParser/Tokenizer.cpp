@@ -12,46 +12,63 @@
 #include <vector>
 
 // [Styio]
-#include "../StyioAST/AST.hpp"
 #include "../StyioException/Exception.hpp"
 #include "../StyioToken/Token.hpp"
 #include "../StyioUtil/Util.hpp"
 #include "Tokenizer.hpp"
+#include "TokenizerScan.hpp"
+
+/* The source has no EOF sentinel, pretend there is one. */
+static inline char
+char_at(std::string_view code, size_t pos) {
+  return pos < code.length() ? code[pos] : char(EOF);
+}
 
 size_t
-count_consecutive(const std::string &text, size_t start, char target) {
+count_consecutive(std::string_view text, size_t start, char target) {
   size_t count = 0;
 
   while (start + count < text.length()
-         && text.at(start + count) == target) {
+         && text[start + count] == target) {
     count += 1;
   }
 
   return count;
 }
 
-std::vector<StyioToken *>
-StyioTokenizer::tokenize(std::string code) {
-  std::vector<StyioToken *> tokens;
-  unsigned long long loc = 0; /* local position */
+StyioTokenStream
+StyioTokenizer::tokenize(std::string_view code, StyioScanMode mode) {
+  const StyioScanKernels& scan = get_scan_kernels(mode);
+  const char* end = code.data() + code.length();
+
+  StyioTokenStream stream;
+  /* rough guess, good enough to avoid most reallocations */
+  stream.tokens.reserve(code.length() / 4 + 1);
+  stream.trivia_bounds.reserve(code.length() / 4 + 2);
+  stream.trivia.reserve(code.length() / 8 + 1);
+
+  size_t loc = 0; /* local position */
 
-  while (loc < code.length() - 1) {
+  while (loc <= code.length()) {
     /* Spaces and Comments */
-    switch (code.at(loc)) {
-      case ' ': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_SPACE, " "));
-        loc += 1;
+    switch (char_at(code, loc)) {
+      /* a run of spaces and tabs is one token */
+      case ' ':
+      case '\t': {
+        size_t count = scan.skip_blanks(code.data() + loc, end);
+        stream.push(StyioToken::Create(StyioTokenType::TOK_SPACE, loc, count));
+        loc += count;
       } break;
 
       /* LF */
       case '\n': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_LF, "\n"));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_LF, loc, 1));
         loc += 1;
       } break;
 
       /* CR */
       case '\r': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_CR, "\r"));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_CR, loc, 1));
         loc += 1;
       } break;
 
@@ -61,183 +78,192 @@ StyioTokenizer::tokenize(std::string code) {
 
     // commments
     if (code.compare(loc, 2, "//") == 0) {
-      std::string literal = "//";
+      size_t start = loc;
       loc += 2;
+      loc += scan.find_line_end(code.data() + loc, end);
 
-      while (code.at(loc) != '\n'
-             && code.at(loc) != '\r'
-             && code.at(loc) != EOF) {
-        literal += code.at(loc);
-        loc += 1;
-      }
-
-      tokens.push_back(StyioToken::Create(StyioTokenType::COMMENT_LINE, literal));
+      stream.push(StyioToken::Create(StyioTokenType::COMMENT_LINE, start, loc - start));
     }
     /* comments */
     else if (code.compare(loc, 2, "/*") == 0) {
-      std::string literal = "/*";
+      size_t start = loc;
       loc += 2;
+      loc += scan.find_comment_end(code.data() + loc, end);
+      loc = std::min(loc + 2, code.length());
 
-      while (not(code.compare(loc, 2, "*/") == 0)) {
-        literal += code.at(loc);
-        loc += 1;
-      }
-
-      literal += "*/";
-      loc += 2;
-
-      tokens.push_back(StyioToken::Create(StyioTokenType::COMMENT_CLOSED, literal));
+      stream.push(StyioToken::Create(StyioTokenType::COMMENT_CLOSED, start, loc - start));
     }
 
     /* varname / typename */
-    if (isalpha(code.at(loc)) || (code.at(loc) == '_')) {
-      std::string literal;
+    if (isalpha(char_at(code, loc)) || (char_at(code, loc) == '_')) {
+      size_t start = loc;
+      loc += 1 + scan.skip_name(code.data() + loc + 1, end);
 
-      do {
-        literal += code.at(loc);
-        loc += 1;
-      } while (isalnum(code.at(loc)) || (code.at(loc) == '_'));
-
-      if (literal == "_") {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_UNDLINE, "_"));
+      if (loc - start == 1 && char_at(code, start) == '_') {
+        stream.push(StyioToken::Create(StyioTokenType::TOK_UNDLINE, start, 1));
       }
       else {
-        tokens.push_back(StyioToken::Create(StyioTokenType::NAME, literal));
+        stream.push(StyioToken::Create(
+          StyioTokenType::NAME,
+          start,
+          loc - start,
+          StyioSymbolTable::intern(code.substr(start, loc - start))
+        ));
       }
     }
     /* integer / float / decimal */
-    else if (isdigit(code.at(loc))) {
-      std::string literal;
-
-      do {
-        literal += code.at(loc);
-        loc += 1;
-      } while (isdigit(code.at(loc)));
+    else if (isdigit(char_at(code, loc))) {
+      size_t start = loc;
+      loc += 1 + scan.skip_digits(code.data() + loc + 1, end);
 
       /* If Float: xxx.yyy */
-      if (code.at(loc) == '.' && isdigit(code.at(loc + 1))) {
+      if (char_at(code, loc) == '.' && isdigit(char_at(code, loc + 1))) {
         /* include '.' */
-        literal += code.at(loc);
         loc += 1;
 
         /* include yyy */
-        do {
-          literal += code.at(loc);
-          loc += 1;
-        } while (isdigit(code.at(loc)));
+        loc += 1 + scan.skip_digits(code.data() + loc + 1, end);
 
-        tokens.push_back(StyioToken::Create(StyioTokenType::DECIMAL, literal));
+        stream.push(StyioToken::Create(StyioTokenType::DECIMAL, start, loc - start));
       }
       else {
-        tokens.push_back(StyioToken::Create(StyioTokenType::INTEGER, literal));
+        stream.push(StyioToken::Create(StyioTokenType::INTEGER, start, loc - start));
       }
     }
 
-    switch (code.at(loc)) {
+    switch (char_at(code, loc)) {
       // -1
       case EOF: {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_EOF, std::to_string(EOF)));
-        return tokens;
+        stream.push(StyioToken::Create(StyioTokenType::TOK_EOF, loc, 0));
+        return stream;
       } break;
 
       // 33
       case '!': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_EXCLAM, "!"));
-        loc += 1;
+        /* != BINOP_NE */
+        if (char_at(code, loc + 1) == '=') {
+          stream.push(StyioToken::Create(StyioTokenType::BINOP_NE, loc, 2));
+          loc += 2;
+        }
+        else {
+          stream.push(StyioToken::Create(StyioTokenType::TOK_EXCLAM, loc, 1));
+          loc += 1;
+        }
       } break;
 
       // 34
       case '\"': {
-        std::string literal = "\"";
+        size_t start = loc;
         loc += 1;
 
-        while (code.at(loc) != '\"') {
-          literal += code.at(loc);
+        while (loc < code.length() && code[loc] != '\"') {
           loc += 1;
         }
 
-        literal += "\"";
-        loc += 1;
+        loc = std::min(loc + 1, code.length());
 
-        tokens.push_back(StyioToken::Create(StyioTokenType::STRING, literal));
+        stream.push(StyioToken::Create(StyioTokenType::STRING, start, loc - start));
       } break;
 
       // 35
       case '#': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_HASH, "#"));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_HASH, loc, 1));
         loc += 1;
       } break;
 
       // 36
       case '$': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_DOLLAR, "$"));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_DOLLAR, loc, 1));
         loc += 1;
       } break;
 
       // 37
       case '%': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_PERCENT, "%"));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_PERCENT, loc, 1));
         loc += 1;
       } break;
 
       // 38
       case '&': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_AMP, "&"));
-        loc += 1;
+        /* && LOGIC_AND */
+        if (char_at(code, loc + 1) == '&') {
+          stream.push(StyioToken::Create(StyioTokenType::LOGIC_AND, loc, 2));
+          loc += 2;
+        }
+        else {
+          stream.push(StyioToken::Create(StyioTokenType::TOK_AMP, loc, 1));
+          loc += 1;
+        }
       } break;
 
       // 39
       case '\'': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_SQUOTE, "\'"));
-        loc += 1;
+        /* 'c' CHARACTER, on a single line */
+        size_t end_of_char = code.find_first_of("'\n", loc + 1);
+
+        if (end_of_char != std::string_view::npos && code[end_of_char] == '\'') {
+          stream.push(StyioToken::Create(StyioTokenType::CHARACTER, loc, end_of_char + 1 - loc));
+          loc = end_of_char + 1;
+        }
+        else {
+          stream.push(StyioToken::Create(StyioTokenType::TOK_SQUOTE, loc, 1));
+          loc += 1;
+        }
       } break;
 
       // 40
       case '(': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_LPAREN, "("));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_LPAREN, loc, 1));
         loc += 1;
       } break;
 
       // 41
       case ')': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_RPAREN, ")"));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_RPAREN, loc, 1));
         loc += 1;
       } break;
 
       // 42
       case '*': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_STAR, "*"));
-        loc += 1;
+        /* ** BINOP_POW */
+        if (char_at(code, loc + 1) == '*') {
+          stream.push(StyioToken::Create(StyioTokenType::BINOP_POW, loc, 2));
+          loc += 2;
+        }
+        else {
+          stream.push(StyioToken::Create(StyioTokenType::TOK_STAR, loc, 1));
+          loc += 1;
+        }
       } break;
 
       // 43
       case '+': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_PLUS, "+"));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_PLUS, loc, 1));
         loc += 1;
       } break;
 
       // 44
       case ',': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_COMMA, ","));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_COMMA, loc, 1));
         loc += 1;
       } break;
 
       // 45
       case '-': {
         /* -> ARROW_SINGLE_RIGHT */
-        if (loc + 1 < code.size() && code.at(loc + 1) == '>') {
-          tokens.push_back(StyioToken::Create(StyioTokenType::ARROW_SINGLE_RIGHT, "->"));
+        if (loc + 1 < code.size() && char_at(code, loc + 1) == '>') {
+          stream.push(StyioToken::Create(StyioTokenType::ARROW_SINGLE_RIGHT, loc, 2));
           loc += 2;
         }
         /* -- SINGLE_SEP_LINE */
-        else if (loc + 1 < code.size() && code.at(loc + 1) == '-') {
+        else if (loc + 1 < code.size() && char_at(code, loc + 1) == '-') {
           size_t count = 2 + count_consecutive(code, loc + 2, '-');
-          tokens.push_back(StyioToken::Create(StyioTokenType::SINGLE_SEP_LINE, std::string(count, '-')));
+          stream.push(StyioToken::Create(StyioTokenType::SINGLE_SEP_LINE, loc, count));
           loc += count;
         }
         else {
           /* - TOK_MINUS */
-          tokens.push_back(StyioToken::Create(StyioTokenType::TOK_MINUS, "-"));
+          stream.push(StyioToken::Create(StyioTokenType::TOK_MINUS, loc, 1));
           loc += 1;
         }
       } break;
@@ -247,10 +273,10 @@ StyioTokenizer::tokenize(std::string code) {
         size_t count = 1 + count_consecutive(code, loc + 1, '.');
 
         if (count == 1) {
-          tokens.push_back(StyioToken::Create(StyioTokenType::TOK_DOT, "."));
+          stream.push(StyioToken::Create(StyioTokenType::TOK_DOT, loc, 1));
         }
         else {
-          tokens.push_back(StyioToken::Create(StyioTokenType::ELLIPSIS, std::string(count, '.')));
+          stream.push(StyioToken::Create(StyioTokenType::ELLIPSIS, loc, count));
         }
 
         // anyway
@@ -259,18 +285,18 @@ StyioTokenizer::tokenize(std::string code) {
 
       // 47
       case '/': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_SLASH, "/"));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_SLASH, loc, 1));
         loc += 1;
       } break;
 
       // 58
       case ':': {
-        if (loc + 1 < code.length() && code.at(loc + 1) == '=') {
-          tokens.push_back(StyioToken::Create(StyioTokenType::WALRUS, ":="));
+        if (loc + 1 < code.length() && char_at(code, loc + 1) == '=') {
+          stream.push(StyioToken::Create(StyioTokenType::WALRUS, loc, 2));
           loc += 2;
         }
         else {
-          tokens.push_back(StyioToken::Create(StyioTokenType::TOK_COLON, ":"));
+          stream.push(StyioToken::Create(StyioTokenType::TOK_COLON, loc, 1));
           loc += 1;
         }
 
@@ -278,7 +304,7 @@ StyioTokenizer::tokenize(std::string code) {
 
       // 59
       case ';': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_SEMICOLON, ";"));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_SEMICOLON, loc, 1));
         loc += 1;
       } break;
 
@@ -286,11 +312,21 @@ StyioTokenizer::tokenize(std::string code) {
       case '<': {
         size_t count = 1 + count_consecutive(code, loc + 1, '<');
 
-        if (count == 1) {
-          tokens.push_back(StyioToken::Create(StyioTokenType::TOK_LANGBRAC, "<"));
+        /* <= BINOP_LE */
+        if (count == 1 && char_at(code, loc + 1) == '=') {
+          stream.push(StyioToken::Create(StyioTokenType::BINOP_LE, loc, 2));
+          count = 2;
+        }
+        /* <- ARROW_SINGLE_LEFT */
+        else if (count == 1 && char_at(code, loc + 1) == '-') {
+          stream.push(StyioToken::Create(StyioTokenType::ARROW_SINGLE_LEFT, loc, 2));
+          count = 2;
+        }
+        else if (count == 1) {
+          stream.push(StyioToken::Create(StyioTokenType::TOK_LANGBRAC, loc, 1));
         }
         else {
-          tokens.push_back(StyioToken::Create(StyioTokenType::EXTRACTOR, std::string(count, '<')));
+          stream.push(StyioToken::Create(StyioTokenType::EXTRACTOR, loc, count));
         }
 
         // anyway
@@ -299,26 +335,26 @@ StyioTokenizer::tokenize(std::string code) {
 
       // 61
       case '=': {
-        if (loc + 1 < code.size() && code.at(loc + 1) == '>') {
-          tokens.push_back(StyioToken::Create(StyioTokenType::ARROW_DOUBLE_RIGHT, "=>"));
+        if (loc + 1 < code.size() && char_at(code, loc + 1) == '>') {
+          stream.push(StyioToken::Create(StyioTokenType::ARROW_DOUBLE_RIGHT, loc, 2));
           loc += 2;
         }
-        else if (loc + 1 < code.size() && code.at(loc + 1) == '=') {
+        else if (loc + 1 < code.size() && char_at(code, loc + 1) == '=') {
           size_t count = 2 + count_consecutive(code, loc + 2, '=');
 
           /* == BINOP_EQ */
           if (count == 2) {
-            tokens.push_back(StyioToken::Create(StyioTokenType::BINOP_EQ, "=="));
+            stream.push(StyioToken::Create(StyioTokenType::BINOP_EQ, loc, 2));
           }
           /* === DOUBLE_SEP_LINE */
           else {
-            tokens.push_back(StyioToken::Create(StyioTokenType::DOUBLE_SEP_LINE, std::string(count, '=')));
+            stream.push(StyioToken::Create(StyioTokenType::DOUBLE_SEP_LINE, loc, count));
           }
           loc += count;
         }
         else {
           /* = TOK_EQUAL */
-          tokens.push_back(StyioToken::Create(StyioTokenType::TOK_EQUAL, "="));
+          stream.push(StyioToken::Create(StyioTokenType::TOK_EQUAL, loc, 1));
           loc += 1;
         }
       } break;
@@ -326,31 +362,36 @@ StyioTokenizer::tokenize(std::string code) {
       // 62
       case '>': {
         // std::cout << ">" << std::endl;
-        if (loc + 1 < code.size() && code.at(loc + 1) == '_') {
+        if (loc + 1 < code.size() && char_at(code, loc + 1) == '_') {
           // std::cout << ">_" << std::endl;
-          tokens.push_back(StyioToken::Create(StyioTokenType::PRINT, ">_"));
+          stream.push(StyioToken::Create(StyioTokenType::PRINT, loc, 2));
           loc += 2;
         }
-        else if (loc + 1 < code.size() && code.at(loc + 1) == '>') {
+        else if (loc + 1 < code.size() && char_at(code, loc + 1) == '>') {
           // std::cout << "multi >" << std::endl;
           size_t count = 2 + count_consecutive(code, loc + 2, '>');
-          tokens.push_back(StyioToken::Create(StyioTokenType::ITERATOR, std::string(count, '>')));
+          stream.push(StyioToken::Create(StyioTokenType::ITERATOR, loc, count));
           loc += count;
         }
+        /* >= BINOP_GE */
+        else if (char_at(code, loc + 1) == '=') {
+          stream.push(StyioToken::Create(StyioTokenType::BINOP_GE, loc, 2));
+          loc += 2;
+        }
         else {
-          tokens.push_back(StyioToken::Create(StyioTokenType::TOK_RANGBRAC, ">"));
+          stream.push(StyioToken::Create(StyioTokenType::TOK_RANGBRAC, loc, 1));
           loc += 1;
         }
       } break;
 
       // 63
       case '?': {
-        if (loc + 1 < code.length() && code.at(loc + 1) == '=') {
-          tokens.push_back(StyioToken::Create(StyioTokenType::MATCH, "?="));
+        if (loc + 1 < code.length() && char_at(code, loc + 1) == '=') {
+          stream.push(StyioToken::Create(StyioTokenType::MATCH, loc, 2));
           loc += 2;
         }
         else {
-          tokens.push_back(StyioToken::Create(StyioTokenType::TOK_QUEST, "?"));
+          stream.push(StyioToken::Create(StyioTokenType::TOK_QUEST, loc, 1));
           loc += 1;
         }
 
@@ -358,67 +399,79 @@ StyioTokenizer::tokenize(std::string code) {
 
       // 64
       case '@': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_AT, "@"));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_AT, loc, 1));
         loc += 1;
       } break;
 
       // 91
       case '[': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_LBOXBRAC, "["));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_LBOXBRAC, loc, 1));
         loc += 1;
       } break;
 
       // 92
       case '\\': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_BACKSLASH, "\\"));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_BACKSLASH, loc, 1));
         loc += 1;
       } break;
 
       // 93
       case ']': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_RBOXBRAC, "]"));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_RBOXBRAC, loc, 1));
         loc += 1;
       } break;
 
       // 94
       case '^': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_HAT, "^"));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_HAT, loc, 1));
         loc += 1;
       } break;
 
       // 95
       case '_': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_UNDLINE, "_"));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_UNDLINE, loc, 1));
         loc += 1;
       } break;
 
       // 96
       case '`': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_BQUOTE, "`"));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_BQUOTE, loc, 1));
         loc += 1;
       } break;
 
       // 123
       case '{': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_LCURBRAC, "{"));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_LCURBRAC, loc, 1));
         loc += 1;
       } break;
 
       // 124
       case '|': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_PIPE, "|"));
-        loc += 1;
+        /* || LOGIC_OR */
+        if (char_at(code, loc + 1) == '|') {
+          stream.push(StyioToken::Create(StyioTokenType::LOGIC_OR, loc, 2));
+          loc += 2;
+        }
+        /* |> PIPE_FORWARD */
+        else if (char_at(code, loc + 1) == '>') {
+          stream.push(StyioToken::Create(StyioTokenType::PIPE_FORWARD, loc, 2));
+          loc += 2;
+        }
+        else {
+          stream.push(StyioToken::Create(StyioTokenType::TOK_PIPE, loc, 1));
+          loc += 1;
+        }
       } break;
 
       // 125
       case '}': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_RCURBRAC, "}"));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_RCURBRAC, loc, 1));
         loc += 1;
       } break;
 
       // 126
       case '~': {
-        tokens.push_back(StyioToken::Create(StyioTokenType::TOK_TILDE, "~"));
+        stream.push(StyioToken::Create(StyioTokenType::TOK_TILDE, loc, 1));
         loc += 1;
       } break;
 
@@ -427,5 +480,6 @@ StyioTokenizer::tokenize(std::string code) {
     }
   }
 
-  return tokens;
+  stream.push(StyioToken::Create(StyioTokenType::TOK_EOF, code.length(), 0));
+  return stream;
 }
\ No newline at end of file
@@ -4,15 +4,21 @@
 
 // [C++ STL]
 #include <string>
+#include <string_view>
 #include <vector>
 
 // [Styio]
 #include "../StyioToken/Token.hpp"
+#include "TokenizerScan.hpp"
 
 class StyioTokenizer
 {
 public:
-  static std::vector<StyioToken *> tokenize(std::string code);
+  /* `mode` picks the scanning kernels, see TokenizerScan.hpp */
+  static StyioTokenStream tokenize(
+    std::string_view code,
+    StyioScanMode mode = StyioScanMode::Auto
+  );
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,339 @@
+// [C++ STL]
+#include <cstddef>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define STYIO_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+// [Styio]
+#include "TokenizerScan.hpp"
+
+/*
+  =================
+    Scalar
+  =================
+*/
+
+static inline bool
+is_blank(char c) {
+  return c == ' ' || c == '\t';
+}
+
+static inline bool
+is_name_char(char c) {
+  return (c >= 'a' && c <= 'z')
+         || (c >= 'A' && c <= 'Z')
+         || (c >= '0' && c <= '9')
+         || c == '_';
+}
+
+static inline bool
+is_digit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+static size_t
+scalar_skip_blanks(const char* p, const char* end) {
+  const char* q = p;
+  while (q < end && is_blank(*q)) {
+    q += 1;
+  }
+  return q - p;
+}
+
+static size_t
+scalar_skip_name(const char* p, const char* end) {
+  const char* q = p;
+  while (q < end && is_name_char(*q)) {
+    q += 1;
+  }
+  return q - p;
+}
+
+static size_t
+scalar_skip_digits(const char* p, const char* end) {
+  const char* q = p;
+  while (q < end && is_digit(*q)) {
+    q += 1;
+  }
+  return q - p;
+}
+
+static size_t
+scalar_find_line_end(const char* p, const char* end) {
+  const char* q = p;
+  while (q < end && *q != '\n' && *q != '\r') {
+    q += 1;
+  }
+  return q - p;
+}
+
+static size_t
+scalar_find_comment_end(const char* p, const char* end) {
+  const char* q = p;
+  while (q + 1 < end && not(q[0] == '*' && q[1] == '/')) {
+    q += 1;
+  }
+  return (q + 1 < end) ? (q - p) : (end - p);
+}
+
+static const StyioScanKernels scalar_kernels = {
+  "scalar",
+  scalar_skip_blanks,
+  scalar_skip_name,
+  scalar_skip_digits,
+  scalar_find_line_end,
+  scalar_find_comment_end,
+};
+
+#ifdef STYIO_SCAN_X86
+
+/*
+  =================
+    SSE2
+  =================
+
+  Byte range checks use the usual trick for the missing unsigned compare:
+  shift [lo, hi] down to [-128, -128 + (hi - lo)], then one signed compare.
+*/
+
+static inline __m128i
+sse2_in_range(__m128i x, char lo, char hi) {
+  __m128i t = _mm_add_epi8(x, _mm_set1_epi8(char(0x80 - lo)));
+  return _mm_cmplt_epi8(t, _mm_set1_epi8(char(0x80 + (hi - lo) + 1)));
+}
+
+struct SSE2Name
+{
+  static __m128i match(__m128i x) {
+    /* 'a' - 'A' == 0x20 */
+    __m128i lower = _mm_or_si128(x, _mm_set1_epi8(0x20));
+    return _mm_or_si128(
+      _mm_or_si128(sse2_in_range(lower, 'a', 'z'), sse2_in_range(x, '0', '9')),
+      _mm_cmpeq_epi8(x, _mm_set1_epi8('_'))
+    );
+  }
+};
+
+struct SSE2Blank
+{
+  static __m128i match(__m128i x) {
+    return _mm_or_si128(
+      _mm_cmpeq_epi8(x, _mm_set1_epi8(' ')),
+      _mm_cmpeq_epi8(x, _mm_set1_epi8('\t'))
+    );
+  }
+};
+
+struct SSE2Digit
+{
+  static __m128i match(__m128i x) {
+    return sse2_in_range(x, '0', '9');
+  }
+};
+
+struct SSE2LineEnd
+{
+  static __m128i match(__m128i x) {
+    return _mm_or_si128(
+      _mm_cmpeq_epi8(x, _mm_set1_epi8('\n')),
+      _mm_cmpeq_epi8(x, _mm_set1_epi8('\r'))
+    );
+  }
+};
+
+/* consume while `Mask` holds */
+template <typename Mask, size_t (*tail)(const char*, const char*)>
+size_t
+sse2_skip(const char* p, const char* end) {
+  const char* q = p;
+  while (end - q >= 16) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(q));
+    unsigned mask = ~unsigned(_mm_movemask_epi8(Mask::match(x))) & 0xFFFF;
+    if (mask != 0) {
+      return (q - p) + __builtin_ctz(mask);
+    }
+    q += 16;
+  }
+  return (q - p) + tail(q, end);
+}
+
+/* stop at the first byte where `Mask` holds */
+template <typename Mask, size_t (*tail)(const char*, const char*)>
+size_t
+sse2_find(const char* p, const char* end) {
+  const char* q = p;
+  while (end - q >= 16) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(q));
+    unsigned mask = unsigned(_mm_movemask_epi8(Mask::match(x)));
+    if (mask != 0) {
+      return (q - p) + __builtin_ctz(mask);
+    }
+    q += 16;
+  }
+  return (q - p) + tail(q, end);
+}
+
+static size_t
+sse2_find_comment_end(const char* p, const char* end) {
+  const char* q = p;
+  /* compare q[i] with '*' and q[i + 1] with '/' */
+  while (end - q >= 17) {
+    __m128i star = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(q)), _mm_set1_epi8('*'));
+    __m128i slash = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(q + 1)), _mm_set1_epi8('/'));
+    unsigned mask = unsigned(_mm_movemask_epi8(_mm_and_si128(star, slash)));
+    if (mask != 0) {
+      return (q - p) + __builtin_ctz(mask);
+    }
+    q += 16;
+  }
+  return (q - p) + scalar_find_comment_end(q, end);
+}
+
+static const StyioScanKernels sse2_kernels = {
+  "sse2",
+  sse2_skip<SSE2Blank, scalar_skip_blanks>,
+  sse2_skip<SSE2Name, scalar_skip_name>,
+  sse2_skip<SSE2Digit, scalar_skip_digits>,
+  sse2_find<SSE2LineEnd, scalar_find_line_end>,
+  sse2_find_comment_end,
+};
+
+/*
+  =================
+    AVX2
+  =================
+
+  Same as SSE2, 32 bytes at a time.
+  Compiled for AVX2 regardless of the global flags, and only called
+  after get_scan_kernels() has checked the CPU.
+*/
+
+#define STYIO_AVX2 __attribute__((target("avx2")))
+
+STYIO_AVX2 static inline __m256i
+avx2_in_range(__m256i x, char lo, char hi) {
+  __m256i t = _mm256_add_epi8(x, _mm256_set1_epi8(char(0x80 - lo)));
+  return _mm256_cmpgt_epi8(_mm256_set1_epi8(char(0x80 + (hi - lo) + 1)), t);
+}
+
+struct AVX2Name
+{
+  STYIO_AVX2 static __m256i match(__m256i x) {
+    __m256i lower = _mm256_or_si256(x, _mm256_set1_epi8(0x20));
+    return _mm256_or_si256(
+      _mm256_or_si256(avx2_in_range(lower, 'a', 'z'), avx2_in_range(x, '0', '9')),
+      _mm256_cmpeq_epi8(x, _mm256_set1_epi8('_'))
+    );
+  }
+};
+
+struct AVX2Blank
+{
+  STYIO_AVX2 static __m256i match(__m256i x) {
+    return _mm256_or_si256(
+      _mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')),
+      _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\t'))
+    );
+  }
+};
+
+struct AVX2Digit
+{
+  STYIO_AVX2 static __m256i match(__m256i x) {
+    return avx2_in_range(x, '0', '9');
+  }
+};
+
+struct AVX2LineEnd
+{
+  STYIO_AVX2 static __m256i match(__m256i x) {
+    return _mm256_or_si256(
+      _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\n')),
+      _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\r'))
+    );
+  }
+};
+
+template <typename Mask, size_t (*tail)(const char*, const char*)>
+STYIO_AVX2 size_t
+avx2_skip(const char* p, const char* end) {
+  const char* q = p;
+  while (end - q >= 32) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(q));
+    unsigned mask = ~unsigned(_mm256_movemask_epi8(Mask::match(x)));
+    if (mask != 0) {
+      return (q - p) + __builtin_ctz(mask);
+    }
+    q += 32;
+  }
+  return (q - p) + tail(q, end);
+}
+
+template <typename Mask, size_t (*tail)(const char*, const char*)>
+STYIO_AVX2 size_t
+avx2_find(const char* p, const char* end) {
+  const char* q = p;
+  while (end - q >= 32) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(q));
+    unsigned mask = unsigned(_mm256_movemask_epi8(Mask::match(x)));
+    if (mask != 0) {
+      return (q - p) + __builtin_ctz(mask);
+    }
+    q += 32;
+  }
+  return (q - p) + tail(q, end);
+}
+
+STYIO_AVX2 static size_t
+avx2_find_comment_end(const char* p, const char* end) {
+  const char* q = p;
+  while (end - q >= 33) {
+    __m256i star = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(q)), _mm256_set1_epi8('*'));
+    __m256i slash = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(q + 1)), _mm256_set1_epi8('/'));
+    unsigned mask = unsigned(_mm256_movemask_epi8(_mm256_and_si256(star, slash)));
+    if (mask != 0) {
+      return (q - p) + __builtin_ctz(mask);
+    }
+    q += 32;
+  }
+  return (q - p) + scalar_find_comment_end(q, end);
+}
+
+static const StyioScanKernels avx2_kernels = {
+  "avx2",
+  avx2_skip<AVX2Blank, scalar_skip_blanks>,
+  avx2_skip<AVX2Name, scalar_skip_name>,
+  avx2_skip<AVX2Digit, scalar_skip_digits>,
+  avx2_find<AVX2LineEnd, scalar_find_line_end>,
+  avx2_find_comment_end,
+};
+
+static bool
+host_has_avx2() {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+
+#endif
+
+const StyioScanKernels&
+get_scan_kernels(StyioScanMode mode) {
+#ifdef STYIO_SCAN_X86
+  switch (mode) {
+    case StyioScanMode::Scalar:
+      return scalar_kernels;
+
+    case StyioScanMode::SSE2:
+      return sse2_kernels;
+
+    case StyioScanMode::AVX2:
+    case StyioScanMode::Auto:
+      return host_has_avx2() ? avx2_kernels : sse2_kernels;
+  }
+#endif
+
+  return scalar_kernels;
+}
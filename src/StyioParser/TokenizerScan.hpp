@@ -0,0 +1,50 @@
+#pragma once
+#ifndef STYIO_TOKENIZER_SCAN_H_
+#define STYIO_TOKENIZER_SCAN_H_
+
+// [C++ STL]
+#include <cstddef>
+
+/*
+  Scanning kernels used by StyioTokenizer.
+
+  Each kernel looks at [p, end) and returns how many bytes it consumed,
+  or the offset of what it was looking for (end - p if not found).
+
+  Scalar:  one byte at a time, the reference implementation.
+  SSE2:    16 bytes at a time (x86-64 baseline).
+  AVX2:    32 bytes at a time, only if the host supports it.
+  Auto:    the best one available on this machine, chosen at runtime.
+*/
+enum class StyioScanMode
+{
+  Auto,
+  Scalar,
+  SSE2,
+  AVX2,
+};
+
+struct StyioScanKernels
+{
+  const char* name;
+
+  /* run of ' ' and '\t' */
+  size_t (*skip_blanks)(const char* p, const char* end);
+
+  /* run of [A-Za-z0-9_] */
+  size_t (*skip_name)(const char* p, const char* end);
+
+  /* run of [0-9] */
+  size_t (*skip_digits)(const char* p, const char* end);
+
+  /* first '\n' or '\r' */
+  size_t (*find_line_end)(const char* p, const char* end);
+
+  /* first "*\/" */
+  size_t (*find_comment_end)(const char* p, const char* end);
+};
+
+const StyioScanKernels&
+get_scan_kernels(StyioScanMode mode = StyioScanMode::Auto);
+
+#endif
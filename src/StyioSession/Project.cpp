@@ -0,0 +1,196 @@
+// [C++ STL]
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <numeric>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// [Styio]
+#include "../StyioAST/AST.hpp"
+#include "../StyioException/Exception.hpp"
+#include "../StyioParser/Parser.hpp"
+#include "../StyioParser/Tokenizer.hpp"
+#include "../StyioUtil/Phases.hpp"
+#include "Project.hpp"
+
+/* Top-level statements that are moved before all others by merge() */
+static bool
+is_declaration(StyioAST* stmt) {
+  switch (stmt->getNodeType()) {
+    case StyioNodeType::Func:
+    case StyioNodeType::SimpleFunc:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+std::vector<std::string>
+StyioProject::find_sources(const std::string& root) {
+  namespace fs = std::filesystem;
+
+  std::error_code ec;
+  if (not fs::is_directory(root, ec)) {
+    throw StyioIOError("Can't open package " + root + ": not a directory");
+  }
+
+  std::vector<std::string> paths;
+  for (auto const& entry : fs::recursive_directory_iterator(root, ec)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".styio") {
+      paths.push_back(entry.path().string());
+    }
+  }
+
+  if (ec) {
+    throw StyioIOError("Can't read package " + root + ": " + ec.message());
+  }
+
+  std::sort(paths.begin(), paths.end());
+  return paths;
+}
+
+void
+StyioProject::parse_unit(StyioUnit& unit) {
+  try {
+    unit.source.reset(StyioSourceFile::Open(unit.path));
+  }
+  catch (StyioIOError& e) {
+    unit.diagnostics.report(0, e.what());
+    return;
+  }
+
+  /* the nodes of this file go to its own arena, on this thread */
+  unit.arena = std::make_unique<ASTArena>();
+  ASTArena::Scope scope(*unit.arena);
+
+  StyioPhase tokenize_phase("tokenize");
+  StyioTokenStream stream = StyioTokenizer::tokenize(unit.source->text());
+  tokenize_phase.count("bytes", unit.source->text().size());
+  tokenize_phase.count("tokens", stream.tokens.size());
+  tokenize_phase.end();
+
+  StyioPhase parse_phase("parse");
+  StyioContext context(unit.source.get(), std::move(stream));
+  context.enable_recovery(&unit.diagnostics);
+
+  unit.ast = parse_main_block(context);
+  parse_phase.count("ast nodes", unit.arena->num_of_nodes());
+}
+
+void
+StyioProject::parse(const std::vector<std::string>& paths, size_t num_of_threads) {
+  units.clear();
+  for (auto const& path : paths) {
+    auto unit = std::make_unique<StyioUnit>();
+    unit->path = path;
+    units.push_back(std::move(unit));
+  }
+
+  if (num_of_threads == 0) {
+    num_of_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  num_of_threads = std::min(num_of_threads, units.size());
+
+  /* largest first, so that no thread is left with a big file at the end */
+  std::vector<size_t> order(units.size());
+  std::iota(order.begin(), order.end(), 0);
+
+  if (num_of_threads > 1) {
+    std::vector<uintmax_t> sizes(units.size(), 0);
+    for (size_t i = 0; i < units.size(); i++) {
+      std::error_code ec;
+      sizes[i] = std::filesystem::file_size(units[i]->path, ec);
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&sizes](size_t a, size_t b) {
+      return sizes[a] > sizes[b];
+    });
+  }
+
+  std::atomic<size_t> next_unit(0);
+
+  auto worker = [&]() {
+    for (size_t i = next_unit++; i < order.size(); i = next_unit++) {
+      parse_unit(*units[order[i]]);
+    }
+  };
+
+  if (num_of_threads <= 1) {
+    worker();
+    return;
+  }
+
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < num_of_threads; t++) {
+    workers.emplace_back(worker);
+  }
+
+  /* this thread works too */
+  worker();
+
+  for (auto& w : workers) {
+    w.join();
+  }
+}
+
+bool
+StyioProject::has_errors() const {
+  return std::any_of(units.begin(), units.end(), [](auto const& unit) {
+    return not unit->diagnostics.empty();
+  });
+}
+
+void
+StyioProject::print_diagnostics(std::ostream& out) const {
+  size_t num_of_errors = 0;
+
+  for (auto const& unit : units) {
+    if (unit->diagnostics.empty()) {
+      continue;
+    }
+
+    out << "File \"" << unit->path << "\":\n";
+    for (auto const& diag : unit->diagnostics) {
+      out << diag.message << "\n";
+    }
+
+    num_of_errors += unit->diagnostics.size();
+  }
+
+  out << num_of_errors << (num_of_errors == 1 ? " error" : " errors") << " found." << std::endl;
+}
+
+MainBlockAST*
+StyioProject::merge() const {
+  /* nothing to merge, keep the order of the source */
+  if (units.size() == 1) {
+    return units.front()->ast;
+  }
+
+  std::vector<StyioAST*> decls;
+  std::vector<StyioAST*> others;
+
+  for (auto const& unit : units) {
+    if (unit->ast == nullptr) {
+      continue;
+    }
+
+    for (auto stmt : unit->ast->getStmts()) {
+      if (is_declaration(stmt)) {
+        decls.push_back(stmt);
+      }
+      else {
+        others.push_back(stmt);
+      }
+    }
+  }
+
+  decls.insert(decls.end(), others.begin(), others.end());
+  return MainBlockAST::Create(decls);
+}
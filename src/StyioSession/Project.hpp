@@ -0,0 +1,79 @@
+#pragma once
+#ifndef STYIO_PROJECT_H_
+#define STYIO_PROJECT_H_
+
+// [C++ STL]
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// [Styio]
+#include "../StyioAST/ASTArena.hpp"
+#include "../StyioAST/ASTDecl.hpp"
+#include "../StyioException/Diagnostics.hpp"
+#include "../StyioSource/SourceFile.hpp"
+
+/*
+  StyioUnit: one source file of a project, parsed on its own.
+*/
+struct StyioUnit
+{
+  std::string path;
+  std::unique_ptr<StyioSourceFile> source; /* null if it can't be read */
+
+  std::unique_ptr<ASTArena> arena; /* owns `ast` */
+  MainBlockAST* ast = nullptr;
+
+  StyioDiagnostics diagnostics; /* syntax errors, or the I/O error */
+};
+
+/*
+  StyioProject: the front-end of a multi-file compilation.
+
+  Each file is tokenized and parsed by itself, into its own StyioContext
+  and its own ASTArena, so the files share nothing but the symbol and
+  type tables (both thread-safe) and are parsed in parallel. Workers take
+  the next file from a shared counter, largest files first.
+
+  merge() then puts the top-level statements of all files into one
+  MainBlockAST for the analyzer: the declarations of every file first,
+  so that a file may use what another one defines, then the rest, in
+  the order of the files.
+
+  Usage:
+    StyioProject project;
+    project.parse(paths, num_of_threads);
+    if (not project.has_errors()) {
+      MainBlockAST* program = project.merge();
+    }
+*/
+class StyioProject
+{
+private:
+  std::vector<std::unique_ptr<StyioUnit>> units;
+
+  static void parse_unit(StyioUnit& unit);
+
+public:
+  /* All `.styio` files under `root`, sorted by path. Throws StyioIOError. */
+  static std::vector<std::string> find_sources(const std::string& root);
+
+  /* Parse `paths` on up to `num_of_threads` threads, 0 for one per core. */
+  void parse(const std::vector<std::string>& paths, size_t num_of_threads = 0);
+
+  const std::vector<std::unique_ptr<StyioUnit>>& get_units() const {
+    return units;
+  }
+
+  bool has_errors() const;
+
+  /* Diagnostics of every file, in the order of the files */
+  void print_diagnostics(std::ostream& out) const;
+
+  /* One program of all files, allocated in the current ASTArena (if more than one) */
+  MainBlockAST* merge() const;
+};
+
+#endif
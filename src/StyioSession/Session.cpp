@@ -0,0 +1,358 @@
+// [C++ STL]
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// [Styio]
+#include "../StyioAST/AST.hpp"
+#include "../StyioException/Exception.hpp"
+#include "../StyioIR/GenIR/GenIR.hpp"
+#include "../StyioParser/Parser.hpp"
+#include "../StyioParser/Tokenizer.hpp"
+#include "Session.hpp"
+
+/* Most statements are small, don't start each of them with 64 KiB */
+static constexpr size_t stmt_arena_size = 1024;
+
+/* Tokens of code[begin, end), at their offsets in `code` */
+static StyioTokenStream
+tokenize_range(std::string_view code, size_t begin, size_t end) {
+  StyioTokenStream stream = StyioTokenizer::tokenize(code.substr(begin, end - begin));
+
+  for (auto& tok : stream.tokens) {
+    tok.offset += begin;
+  }
+  for (auto& tok : stream.trivia) {
+    tok.offset += begin;
+  }
+
+  return stream;
+}
+
+/* FNV-1a over the types and the text of tokens[first, last) */
+static uint64_t
+hash_tokens(std::string_view code, const std::vector<StyioToken>& tokens, size_t first, size_t last) {
+  uint64_t hash = 14695981039346656037ull;
+
+  auto mix = [&hash](unsigned char byte) {
+    hash ^= byte;
+    hash *= 1099511628211ull;
+  };
+
+  for (size_t i = first; i < last; i++) {
+    auto type = static_cast<uint32_t>(tokens[i].type);
+    for (size_t b = 0; b < sizeof(type); b++) {
+      mix((type >> (8 * b)) & 0xFF);
+    }
+
+    for (char c : tokens[i].text(code)) {
+      mix(static_cast<unsigned char>(c));
+    }
+  }
+
+  return hash;
+}
+
+/* Top-level names bound by a statement */
+static std::vector<StyioSymbol>
+defined_names(StyioAST* ast) {
+  if (ast == nullptr) {
+    return {};
+  }
+
+  switch (ast->getNodeType()) {
+    case StyioNodeType::MutBind:
+      return {static_cast<FlexBindAST*>(ast)->getVar()->getName()->getSymbol()};
+
+    case StyioNodeType::FinalBind:
+      return {static_cast<FinalBindAST*>(ast)->getVar()->getName()->getSymbol()};
+
+    case StyioNodeType::Func:
+      return {static_cast<FunctionAST*>(ast)->func_name->getSymbol()};
+
+    case StyioNodeType::SimpleFunc:
+      return {static_cast<SimpleFuncAST*>(ast)->func_name->getSymbol()};
+
+    default:
+      return {};
+  }
+}
+
+bool
+StyioSession::parse_range(size_t begin, size_t end, std::vector<StyioSessionStmt>& out) {
+  std::string_view code = source->text();
+
+  StyioContext context(source.get(), tokenize_range(code, begin, end));
+  auto const& tokens = context.get_tokens();
+
+  StyioDiagnostics diagnostics;
+  context.enable_recovery(&diagnostics);
+
+  bool hit_end = false;
+
+  while (not context.check(StyioTokenType::TOK_EOF)) {
+    StyioSessionStmt stmt;
+    stmt.arena = std::make_unique<ASTArena>(stmt_arena_size);
+
+    size_t first = context.cur_tok_index();
+    size_t num_of_errors = diagnostics.size();
+
+    {
+      ASTArena::Scope scope(*stmt.arena);
+      stmt.ast = parse_top_level_stmt(context);
+    }
+
+    size_t last = context.cur_tok_index();
+    if (last == first) {
+      break;
+    }
+
+    if (stmt.ast == nullptr) {
+      if (diagnostics.size() > num_of_errors) {
+        stmt.error = diagnostics[num_of_errors].message;
+      }
+
+      /* maybe it is not broken, just cut off by `end` */
+      hit_end = context.check(StyioTokenType::TOK_EOF);
+    }
+
+    stmt.begin = tokens[first].offset;
+    stmt.end = tokens[last - 1].offset + tokens[last - 1].length;
+    stmt.hash = hash_tokens(code, tokens, first, last);
+    stmt.defines = defined_names(stmt.ast);
+
+    for (size_t i = first; i < last; i++) {
+      if (tokens[i].type == StyioTokenType::NAME) {
+        stmt.uses.push_back(tokens[i].symbol);
+      }
+    }
+    std::sort(stmt.uses.begin(), stmt.uses.end());
+    stmt.uses.erase(std::unique(stmt.uses.begin(), stmt.uses.end()), stmt.uses.end());
+
+    out.push_back(std::move(stmt));
+  }
+
+  return hit_end;
+}
+
+void
+StyioSession::analyze(StyioSessionStmt& stmt) {
+  stmt.ir = nullptr;
+  stmt.ir_nodes.reset();
+
+  if (stmt.ast == nullptr) {
+    return;
+  }
+
+  /* what the last analysis of this statement bound, e.g. as a dependent */
+  for (auto name : stmt.defines) {
+    analyzer.forget(name);
+  }
+  stmt.error.clear();
+
+  /* types and nodes made by the analyzer belong to the statement too */
+  ASTArena::Scope scope(*stmt.arena);
+
+  stmt.ir_nodes = std::make_unique<StyioIRNodes>();
+  StyioIRNodes::Scope ir_scope(*stmt.ir_nodes);
+
+  try {
+    stmt.ast->typeInfer(&analyzer);
+    stmt.ir = stmt.ast->toStyioIR(&analyzer);
+  }
+  catch (StyioBaseException& e) {
+    stmt.error = e.what();
+  }
+}
+
+void
+StyioSession::update(std::string code) {
+  stats = StyioSessionStats();
+
+  std::unique_ptr<StyioSourceFile> old_source = std::move(source);
+  source.reset(StyioSourceFile::Create(file_name, std::move(code)));
+
+  std::string_view old_text = old_source ? old_source->text() : std::string_view();
+  std::string_view new_text = source->text();
+
+  /* the edit: old_text[prefix, old_size - suffix) became new_text[prefix, new_size - suffix) */
+  size_t limit = std::min(old_text.size(), new_text.size());
+
+  size_t prefix = 0;
+  while (prefix < limit && old_text[prefix] == new_text[prefix]) {
+    prefix += 1;
+  }
+
+  size_t suffix = 0;
+  while (suffix < limit - prefix
+         && old_text[old_text.size() - 1 - suffix] == new_text[new_text.size() - 1 - suffix]) {
+    suffix += 1;
+  }
+
+  /*
+    Statements [first, last) are touched by the edit, with one more on
+    each side, as an edit next to a statement may join it to its neighbour.
+  */
+  size_t first = std::partition_point(
+                   stmts.begin(), stmts.end(),
+                   [prefix](const StyioSessionStmt& s) { return s.end < prefix; }
+                 )
+                 - stmts.begin();
+  size_t last = std::partition_point(
+                  stmts.begin() + first, stmts.end(),
+                  [&](const StyioSessionStmt& s) { return s.begin <= old_text.size() - suffix; }
+                )
+                - stmts.begin();
+
+  first = (first > 0) ? first - 1 : 0;
+  last = std::min(last + 1, stmts.size());
+
+  ptrdiff_t delta = ptrdiff_t(new_text.size()) - ptrdiff_t(old_text.size());
+
+  size_t range_begin = (first > 0) ? stmts[first - 1].end : 0;
+  size_t range_end = (last < stmts.size()) ? stmts[last].begin + delta : new_text.size();
+
+  std::vector<StyioSessionStmt> fresh;
+  if (parse_range(range_begin, range_end, fresh) && last < stmts.size()) {
+    /* the edit may reach into the statements after it, e.g. an unclosed { */
+    fresh.clear();
+    last = stmts.size();
+    range_end = new_text.size();
+    parse_range(range_begin, range_end, fresh);
+  }
+
+  stats.num_of_reparsed = fresh.size();
+
+  /* Statements to analyze again: those which changed */
+  std::vector<bool> changed(fresh.size(), true);
+
+  /* An old statement with the same tokens keeps its AST and IR */
+  std::unordered_multimap<uint64_t, size_t> old_by_hash;
+  for (size_t i = first; i < last; i++) {
+    if (stmts[i].ast != nullptr && stmts[i].ir != nullptr) {
+      old_by_hash.emplace(stmts[i].hash, i);
+    }
+  }
+
+  std::vector<bool> reused(stmts.size(), false);
+  for (size_t k = 0; k < fresh.size(); k++) {
+    auto it = old_by_hash.find(fresh[k].hash);
+    if (it == old_by_hash.end()) {
+      continue;
+    }
+
+    StyioSessionStmt& old_stmt = stmts[it->second];
+    fresh[k].arena = std::move(old_stmt.arena);
+    fresh[k].ast = old_stmt.ast;
+    fresh[k].ir_nodes = std::move(old_stmt.ir_nodes);
+    fresh[k].ir = old_stmt.ir;
+    fresh[k].error = std::move(old_stmt.error);
+    fresh[k].defines = std::move(old_stmt.defines);
+
+    changed[k] = false;
+    reused[it->second] = true;
+    old_by_hash.erase(it);
+  }
+
+  /* Names bound by a changed or deleted statement */
+  std::unordered_set<StyioSymbol> dirty_names;
+  for (size_t i = first; i < last; i++) {
+    if (not reused[i]) {
+      for (auto name : stmts[i].defines) {
+        analyzer.forget(name);
+        dirty_names.insert(name);
+      }
+    }
+  }
+
+  /* Splice: [0, first) as is, then `fresh`, then [last, end) moved by `delta` */
+  std::vector<StyioSessionStmt> updated;
+  updated.reserve(first + fresh.size() + (stmts.size() - last));
+
+  for (size_t i = 0; i < first; i++) {
+    updated.push_back(std::move(stmts[i]));
+  }
+  for (auto& stmt : fresh) {
+    updated.push_back(std::move(stmt));
+  }
+  for (size_t i = last; i < stmts.size(); i++) {
+    stmts[i].begin += delta;
+    stmts[i].end += delta;
+    updated.push_back(std::move(stmts[i]));
+  }
+
+  stmts = std::move(updated);
+  old_source.reset();
+
+  /* Analyze, in order, what changed and what depends on it */
+  size_t fresh_end = first + fresh.size();
+
+  for (size_t i = first; i < stmts.size(); i++) {
+    bool in_fresh = (i < fresh_end);
+    bool is_changed = in_fresh && changed[i - first];
+
+    bool is_dependent = std::any_of(
+      stmts[i].uses.begin(), stmts[i].uses.end(),
+      [&](StyioSymbol name) { return dirty_names.contains(name); }
+    );
+
+    if (not is_changed && not is_dependent) {
+      /* nothing left that could make a difference */
+      if (not in_fresh && dirty_names.empty()) {
+        break;
+      }
+      continue;
+    }
+
+    /* a dependent is parsed again from its own tokens, for a clean AST */
+    if (not is_changed) {
+      std::vector<StyioSessionStmt> again;
+      parse_range(stmts[i].begin, stmts[i].end, again);
+      if (again.size() == 1) {
+        stmts[i] = std::move(again.front());
+        stats.num_of_reparsed += 1;
+      }
+    }
+
+    analyze(stmts[i]);
+    stats.num_of_reanalyzed += 1;
+
+    for (auto name : stmts[i].defines) {
+      dirty_names.insert(name);
+    }
+  }
+
+  stats.num_of_kept = stmts.size() - stats.num_of_reparsed;
+}
+
+StyioDiagnostics
+StyioSession::get_diagnostics() const {
+  StyioDiagnostics diagnostics;
+
+  for (auto const& stmt : stmts) {
+    if (not stmt.error.empty()) {
+      diagnostics.report(stmt.begin, stmt.error);
+    }
+  }
+
+  return diagnostics;
+}
+
+SGMainEntry*
+StyioSession::get_ir() {
+  std::vector<StyioIR*> ir_stmts;
+
+  for (auto const& stmt : stmts) {
+    if (stmt.ir != nullptr) {
+      ir_stmts.push_back(stmt.ir);
+    }
+  }
+
+  /* its own owner: an outer scope of this thread would adopt it otherwise */
+  main_nodes = std::make_unique<StyioIRNodes>();
+  StyioIRNodes::Scope ir_scope(*main_nodes);
+
+  return SGMainEntry::Create(ir_stmts);
+}
@@ -0,0 +1,117 @@
+#pragma once
+#ifndef STYIO_SESSION_H_
+#define STYIO_SESSION_H_
+
+// [C++ STL]
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// [Styio]
+#include "../StyioAST/ASTArena.hpp"
+#include "../StyioAnalyzer/ASTAnalyzer.hpp"
+#include "../StyioException/Diagnostics.hpp"
+#include "../StyioIR/IRDecl.hpp"
+#include "../StyioIR/StyioIR.hpp"
+#include "../StyioSource/SourceFile.hpp"
+#include "../StyioToken/Symbol.hpp"
+
+/*
+  StyioSessionStmt: one top-level statement of a session.
+*/
+struct StyioSessionStmt
+{
+  size_t begin = 0; /* byte range in the current source */
+  size_t end = 0;
+  uint64_t hash = 0; /* of its tokens, trivia excluded */
+
+  std::unique_ptr<ASTArena> arena;        /* owns `ast` */
+  StyioAST* ast = nullptr;                /* null if it does not parse */
+  std::unique_ptr<StyioIRNodes> ir_nodes; /* owns `ir` */
+  StyioIR* ir = nullptr;                  /* null if it is not analyzed */
+  std::string error;
+
+  std::vector<StyioSymbol> defines; /* top-level names it binds */
+  std::vector<StyioSymbol> uses;    /* names it mentions, sorted */
+};
+
+struct StyioSessionStats
+{
+  size_t num_of_kept = 0;       /* reused as they were */
+  size_t num_of_reparsed = 0;   /* tokenized and parsed again */
+  size_t num_of_reanalyzed = 0; /* typeInfer() and toStyioIR() again */
+};
+
+/*
+  StyioSession: a compilation that lives across edits of one source,
+  for editors and watch mode.
+
+  The source is kept as a list of top-level statements. On update(),
+  the new text is compared with the old one; only the statements that
+  the edit touches are tokenized and parsed again, the others keep their
+  AST and IR and just move. Then a statement is analyzed again if it
+  changed, or if it uses a name (re)bound by a statement analyzed again
+  before it.
+
+  Usage:
+    StyioSession session("main.styio");
+    session.update(code);     // everything
+    session.update(new_code); // only what changed
+    SGMainEntry* ir = session.get_ir();
+*/
+class StyioSession
+{
+private:
+  std::string file_name;
+  std::unique_ptr<StyioSourceFile> source;
+
+  std::vector<StyioSessionStmt> stmts;
+
+  StyioAnalyzer analyzer;
+  StyioSessionStats stats;
+
+  std::unique_ptr<StyioIRNodes> main_nodes; /* owns what get_ir() returned last */
+
+  /* Parse source[begin, end) into `out`, true if the last statement ran into `end` */
+  bool parse_range(size_t begin, size_t end, std::vector<StyioSessionStmt>& out);
+
+  void analyze(StyioSessionStmt& stmt);
+
+public:
+  explicit StyioSession(std::string file_name) :
+      file_name(std::move(file_name)) {
+  }
+
+  StyioSession(const StyioSession&) = delete;
+  StyioSession& operator=(const StyioSession&) = delete;
+
+  /* Replace the whole source, and bring the statements up to date. */
+  void update(std::string code);
+
+  std::string_view get_code() const {
+    return source ? source->text() : std::string_view();
+  }
+
+  const std::vector<StyioSessionStmt>& get_stmts() const {
+    return stmts;
+  }
+
+  /* What the last update() did */
+  const StyioSessionStats& get_stats() const {
+    return stats;
+  }
+
+  StyioDiagnostics get_diagnostics() const;
+
+  /*
+    StyioIR of the whole source, from the statements that got through.
+    Owned by the session: the entry until the next get_ir(), the
+    statements until the next update().
+  */
+  SGMainEntry* get_ir();
+};
+
+#endif
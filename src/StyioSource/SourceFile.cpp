@@ -0,0 +1,146 @@
+// [C++ STL]
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// [POSIX]
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// [Styio]
+#include "../StyioException/Exception.hpp"
+#include "SourceFile.hpp"
+
+StyioSourceFile::~StyioSourceFile() {
+  if (mapped_size > 0) {
+    munmap(const_cast<char*>(data), mapped_size);
+  }
+}
+
+StyioSourceFile*
+StyioSourceFile::Open(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw StyioIOError("Can't open file " + path + ": " + std::strerror(errno));
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    throw StyioIOError("Can't stat file " + path + ": " + std::strerror(errno));
+  }
+
+  auto source = new StyioSourceFile();
+  source->file_name = path;
+
+  if (S_ISREG(st.st_mode) && st.st_size > 0) {
+    void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+      close(fd);
+      delete source;
+      throw StyioIOError("Can't map file " + path + ": " + std::strerror(errno));
+    }
+
+    /* the whole file is scanned once by index_lines(), then by the tokenizer */
+    madvise(addr, st.st_size, MADV_SEQUENTIAL);
+
+    source->data = static_cast<const char*>(addr);
+    source->size = st.st_size;
+    source->mapped_size = st.st_size;
+  }
+  else {
+    /* empty file, pipe, or anything else that can't be mapped */
+    char buf[65536];
+    while (true) {
+      ssize_t n = read(fd, buf, sizeof(buf));
+      if (n > 0) {
+        source->owned_text.append(buf, n);
+      }
+      else if (n == 0) {
+        break;
+      }
+      else if (errno != EINTR) {
+        /* e.g. EISDIR for a directory, EIO */
+        int error = errno;
+        close(fd);
+        delete source;
+        throw StyioIOError("Can't read file " + path + ": " + std::strerror(error));
+      }
+    }
+
+    source->data = source->owned_text.data();
+    source->size = source->owned_text.size();
+  }
+
+  close(fd);
+
+  source->index_lines();
+  return source;
+}
+
+StyioSourceFile*
+StyioSourceFile::Create(const std::string& name, std::string text) {
+  auto source = new StyioSourceFile();
+  source->file_name = name;
+  source->owned_text = std::move(text);
+  source->data = source->owned_text.data();
+  source->size = source->owned_text.size();
+
+  source->index_lines();
+  return source;
+}
+
+void
+StyioSourceFile::index_lines() {
+  line_starts.clear();
+  line_starts.push_back(0);
+
+  /* memchr() is vectorized by libc, much faster than a per-char loop */
+  const char* p = data;
+  const char* end = data + size;
+  while (p < end) {
+    auto nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    if (nl == nullptr) {
+      break;
+    }
+
+    line_starts.push_back((nl - data) + 1);
+    p = nl + 1;
+  }
+
+  /* "a\nb\n" has two lines, not three */
+  if (line_starts.size() > 1 && line_starts.back() == size) {
+    line_starts.pop_back();
+  }
+}
+
+size_t
+StyioSourceFile::line_of(size_t offset) const {
+  auto it = std::upper_bound(line_starts.begin(), line_starts.end(), offset);
+  return (it - line_starts.begin()) - 1;
+}
+
+std::pair<size_t, size_t>
+StyioSourceFile::coordinate_of(size_t offset) const {
+  size_t row = line_of(offset);
+  return std::make_pair(row, offset - line_starts[row]);
+}
+
+std::string_view
+StyioSourceFile::line_text(size_t line) const {
+  size_t start = line_starts[line];
+  size_t end = (line + 1 < line_starts.size()) ? line_starts[line + 1] : size;
+
+  /* drop the line break */
+  while (end > start && (data[end - 1] == '\n' || data[end - 1] == '\r')) {
+    end -= 1;
+  }
+
+  return std::string_view(data + start, end - start);
+}
@@ -0,0 +1,81 @@
+#pragma once
+#ifndef STYIO_SOURCE_FILE_H_
+#define STYIO_SOURCE_FILE_H_
+
+// [C++ STL]
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/*
+  StyioSourceFile: the single owner of a source text.
+
+  A file on disk is mapped read-only, in-memory sources (tests, REPL)
+  keep their own copy. Either way, one newline index is built up front
+  and shared by everyone who needs line information: the tokenizer,
+  error reporting (StyioContext::label_cur_line / mark_cur_tok), and
+  the `--debug` dump.
+
+  There is no trailing EOF sentinel in the text anymore,
+  the end of the source is `text().length()`.
+*/
+class StyioSourceFile
+{
+private:
+  std::string file_name;
+
+  const char* data = nullptr;
+  size_t size = 0;
+
+  /* non-zero if `data` is an mmap() region */
+  size_t mapped_size = 0;
+
+  /* storage for sources which are not mapped from disk */
+  std::string owned_text;
+
+  /* offset of the first character of each line */
+  std::vector<size_t> line_starts;
+
+  StyioSourceFile() = default;
+
+  void index_lines();
+
+public:
+  StyioSourceFile(const StyioSourceFile&) = delete;
+  StyioSourceFile& operator=(const StyioSourceFile&) = delete;
+
+  ~StyioSourceFile();
+
+  /* Map `path` read-only. Throws StyioIOError. */
+  static StyioSourceFile* Open(const std::string& path);
+
+  static StyioSourceFile* Create(const std::string& name, std::string text);
+
+  const std::string& get_file_name() const {
+    return file_name;
+  }
+
+  std::string_view text() const {
+    return std::string_view(data, size);
+  }
+
+  size_t line_count() const {
+    return line_starts.size();
+  }
+
+  size_t line_start(size_t line) const {
+    return line_starts[line];
+  }
+
+  /* Line of `offset`, starting from 0. O(log n). */
+  size_t line_of(size_t offset) const;
+
+  /* (row, col) of `offset`, both starting from 0 */
+  std::pair<size_t, size_t> coordinate_of(size_t offset) const;
+
+  /* Line `line` without its line break */
+  std::string_view line_text(size_t line) const;
+};
+
+#endif
@@ -13,6 +13,34 @@
 #include "../StyioToken/Token.hpp"
 #include "../StyioUtil/Util.hpp"
 
+std::string
+StyioRepr::toString(StyioAST* ast, int indent) {
+  out.reset(nullptr);
+  ast->writeRepr(this, indent);
+  return out.take();
+}
+
+std::string
+StyioRepr::toString(StyioIR* node, int indent) {
+  out.reset(nullptr);
+  node->writeRepr(this, indent);
+  return out.take();
+}
+
+void
+StyioRepr::print(std::ostream& os, StyioAST* ast, int indent) {
+  out.reset(&os);
+  ast->writeRepr(this, indent);
+  out.flush();
+}
+
+void
+StyioRepr::print(std::ostream& os, StyioIR* node, int indent) {
+  out.reset(&os);
+  node->writeRepr(this, indent);
+  out.flush();
+}
+
 /*                                                                */
 /*    ___| __ __| \ \   / _ _|   _ \          \      ___| __ __|  */
 /*  \___ \    |    \   /    |   |   |        _ \   \___ \    |    */
@@ -20,128 +48,127 @@
 /*  _____/   _|      _|   ___| \___/      _/    _\ _____/   _|    */
 /*                                                                */
 
-std::string
-StyioRepr::toString(CommentAST* ast, int indent) {
-  return string("Comment { ") + ast->getText() + " }";
+void
+StyioRepr::write(CommentAST* ast, int indent) {
+  out << "Comment { " << ast->getText() << " }";
 }
 
-std::string
-StyioRepr::toString(NoneAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + "{ }";
+void
+StyioRepr::write(NoneAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{ }";
 }
 
-std::string
-StyioRepr::toString(EmptyAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + "{ }";
+void
+StyioRepr::write(EmptyAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{ }";
 }
 
-std::string
-StyioRepr::toString(NameAST* ast, int indent) {
-  return ast->getAsStr();
+void
+StyioRepr::write(NameAST* ast, int indent) {
+  out << ast->getAsStr();
 }
 
-std::string
-StyioRepr::toString(TypeAST* ast, int indent) {
-  return reprASTType(ast->getNodeType()) + " { " + ast->type.name + " }";
+void
+StyioRepr::write(TypeAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType()) << " { " << ast->type.name() << " }";
 }
 
-std::string
-StyioRepr::toString(TypeTupleAST* ast, int indent) {
-  std::string type_str = "\n";
+void
+StyioRepr::write(TypeTupleAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType()) << " {" << "\n";
   for (size_t i = 0; i < ast->type_list.size(); i++) {
-    type_str += make_padding(indent + 1) + ast->type_list.at(i)->toString(this, indent + 2);
+    out << pad(indent + 1) << child(ast->type_list.at(i), indent + 2);
     if (i < ast->type_list.size() - 1) {
-      type_str += "\n";
+      out << "\n";
     }
   }
-
-  return reprASTType(ast->getNodeType()) + " {"
-         + type_str
-         + "}";
+  out << "}";
 }
 
-std::string
-StyioRepr::toString(BoolAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + string("{ }");
+void
+StyioRepr::write(BoolAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{ }";
 }
 
-std::string
-StyioRepr::toString(IntAST* ast, int indent) {
-  return "{ " + ast->getValue() + " : " + ast->getDataType().name + " }";
+void
+StyioRepr::write(IntAST* ast, int indent) {
+  out << "{ " << ast->getValue() << " : " << ast->getDataType().name() << " }";
 }
 
-std::string
-StyioRepr::toString(FloatAST* ast, int indent) {
-  return "{ " + ast->getValue() + " : " + ast->getDataType().name + " }";
+void
+StyioRepr::write(FloatAST* ast, int indent) {
+  out << "{ " << ast->getValue() << " : " << ast->getDataType().name() << " }";
 }
 
-std::string
-StyioRepr::toString(CharAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + "{ \'" + ast->getValue() + "\' }";
+void
+StyioRepr::write(CharAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{ \'" << ast->getValue() << "\' }";
 }
 
-std::string
-StyioRepr::toString(StringAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + "{ " + ast->getValue() + " }";
+void
+StyioRepr::write(StringAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{ " << ast->getValue() << " }";
 }
 
-std::string
-StyioRepr::toString(TypeConvertAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + "{ " + " }";
+void
+StyioRepr::write(TypeConvertAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{ " << " }";
 }
 
-std::string
-StyioRepr::toString(VarAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ")
-         + string("{ ") + ast->getNameAsStr() + " : " + ast->getDType()->getTypeName() + " }";
+void
+StyioRepr::write(VarAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ")
+      << "{ " << ast->getNameAsStr() << " : " << ast->getDType()->getTypeName() << " }";
 }
 
-std::string
-StyioRepr::toString(ParamAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ")
-         + string("{ ") + ast->getName() + " : " + ast->getDType()->getTypeName() + " }";
+void
+StyioRepr::write(ParamAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ")
+      << "{ " << ast->getName() << " : " << ast->getDType()->getTypeName() << " }";
 }
 
-std::string
-StyioRepr::toString(OptArgAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ")
-         + "{ " + " }";
+void
+StyioRepr::write(OptArgAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ")
+      << "{ " << " }";
 }
 
-std::string
-StyioRepr::toString(OptKwArgAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ")
-         + "{ " + " }";
+void
+StyioRepr::write(OptKwArgAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ")
+      << "{ " << " }";
 }
 
-std::string
-StyioRepr::toString(FlexBindAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + string("{")
-         + "\n" + make_padding(indent) + "var : " + ast->getVar()->toString(this)
-         + "\n" + make_padding(indent) + "val = " + ast->getValue()->toString(this, indent + 1)
-         + "}";
+void
+StyioRepr::write(FlexBindAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{"
+      << "\n" << pad(indent) << "var : " << child(ast->getVar())
+      << "\n" << pad(indent) << "val = " << child(ast->getValue(), indent + 1)
+      << "}";
 }
 
-std::string
-StyioRepr::toString(FinalBindAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + string("{")
-         + "\n" + make_padding(indent) + "var : " + ast->getVar()->toString(this, indent + 1)
-         + "\n" + make_padding(indent) + "val = " + ast->getValue()->toString(this, indent + 1)
-         + "}";
+void
+StyioRepr::write(FinalBindAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{"
+      << "\n" << pad(indent) << "var : " << child(ast->getVar(), indent + 1)
+      << "\n" << pad(indent) << "val = " << child(ast->getValue(), indent + 1)
+      << "}";
 }
 
-std::string
-StyioRepr::toString(InfiniteAST* ast, int indent) {
+void
+StyioRepr::write(InfiniteAST* ast, int indent) {
   switch (ast->getType()) {
     case InfiniteType::Original: {
-      return reprASTType(ast->getNodeType(), " ") + string("{ }");
+      out << reprASTType(ast->getNodeType(), " ") << "{ }";
+      return;
     } break;  // You should NOT reach this line!
 
     case InfiniteType::Incremental: {
-      return reprASTType(ast->getNodeType(), " ") + string("{")
-             + "\n" + "|" + string(2 * indent, '-') + "| Start: " + ast->getStart()->toString(this, indent + 1)
-             + "\n" + "|" + string(2 * indent, '-') + "| Increment: " + ast->getIncEl()->toString(this, indent + 1)
-             + "}";
+      out << reprASTType(ast->getNodeType(), " ") << "{"
+          << "\n" << "|" << string(2 * indent, '-') << "| Start: " << child(ast->getStart(), indent + 1)
+          << "\n" << "|" << string(2 * indent, '-') << "| Increment: " << child(ast->getIncEl(), indent + 1)
+          << "}";
+      return;
 
     } break;  // You should NOT reach this line!
 
@@ -149,239 +176,244 @@ StyioRepr::toString(InfiniteAST* ast, int indent) {
       break;
   }
 
-  return reprASTType(ast->getNodeType(), " ") + string("{ Undefined! }");
+  out << reprASTType(ast->getNodeType(), " ") << "{ Undefined! }";
 }
 
-std::string
-StyioRepr::toString(StructAST* ast, int indent) {
-  std::string argstr;
+void
+StyioRepr::write(StructAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " {\n");
   for (size_t i = 0; i < ast->args.size(); i++) {
-    argstr += make_padding(indent) + ast->args.at(i)->toString(this, indent + 1);
+    out << pad(indent) << child(ast->args.at(i), indent + 1);
     if (i != ast->args.size() - 1) {
-      argstr += "\n";
+      out << "\n";
     }
   }
-
-  return reprASTType(ast->getNodeType(), " {\n") + argstr + "}";
+  out << "}";
 }
 
-std::string
-StyioRepr::toString(TupleAST* ast, int indent) {
-  string elem_str;
+void
+StyioRepr::write(TupleAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType()) << " : "
+      << ast->getDataType().name()
+      << " (\n";
 
   auto elems = ast->elements;
   for (int i = 0; i < elems.size(); i++) {
-    elem_str += make_padding(indent) + elems[i]->toString(this, indent + 1);
+    out << pad(indent) << child(elems[i], indent + 1);
     if (i < (elems.size() - 1)) {
-      elem_str += "\n";
+      out << "\n";
     }
   }
 
-  return reprASTType(ast->getNodeType()) + " : "
-         + ast->getDataType().name
-         + " (\n" + elem_str + ")";
+  out << ")";
 }
 
-std::string
-StyioRepr::toString(VarTupleAST* ast, int indent) {
+void
+StyioRepr::write(VarTupleAST* ast, int indent) {
   auto Vars = ast->getParams();
   if (Vars.empty()) {
-    return reprASTType(ast->getNodeType(), " ") + "[ ]";
+    out << reprASTType(ast->getNodeType(), " ") << "[ ]";
   }
   else {
-    string varStr;
+    out << reprASTType(ast->getNodeType(), " ") << "[\n";
 
     for (int i = 0; i < Vars.size(); i++) {
-      varStr += make_padding(indent) + Vars[i]->toString(this, indent + 1);
+      out << pad(indent) << child(Vars[i], indent + 1);
       if (i < (Vars.size() - 1)) {
-        varStr += "\n";
+        out << "\n";
       }
     }
 
-    return reprASTType(ast->getNodeType(), " ") + "[\n" + varStr + "]";
+    out << "]";
   }
 }
 
-std::string
-StyioRepr::toString(ExtractorAST* ast, int indent) {
-  return reprASTType(ast->getNodeType()) + " {\n"
-         + make_padding(indent) + ast->theTuple->toString(this, indent + 1) + "\n"
-         + make_padding(indent) + ast->theOpOnIt->toString(this, indent + 1)
-         + "}";
+void
+StyioRepr::write(ExtractorAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType()) << " {\n"
+      << pad(indent) << child(ast->theTuple, indent + 1) << "\n"
+      << pad(indent) << child(ast->theOpOnIt, indent + 1)
+      << "}";
 }
 
-std::string
-StyioRepr::toString(RangeAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + "{\n"
-         + make_padding(indent) + "Start : " + ast->getStart()->toString(this, indent + 1) + "\n"
-         + make_padding(indent) + "End   : " + ast->getEnd()->toString(this, indent + 1) + "\n"
-         + make_padding(indent) + "Step  : " + ast->getStep()->toString(this, indent + 1)
-         + "}";
+void
+StyioRepr::write(RangeAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{\n"
+      << pad(indent) << "Start : " << child(ast->getStart(), indent + 1) << "\n"
+      << pad(indent) << "End   : " << child(ast->getEnd(), indent + 1) << "\n"
+      << pad(indent) << "Step  : " << child(ast->getStep(), indent + 1)
+      << "}";
 }
 
-std::string
-StyioRepr::toString(SetAST* ast, int indent) {
-  string ElemStr;
+void
+StyioRepr::write(SetAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{\n";
 
   auto Elems = ast->getElements();
   for (int i = 0; i < Elems.size(); i++) {
-    ElemStr += make_padding(indent) + Elems[i]->toString(this, indent + 1);
+    out << pad(indent) << child(Elems[i], indent + 1);
     if (i != (Elems.size() - 1)) {
-      ElemStr += "\n";
+      out << "\n";
     }
   }
 
-  return reprASTType(ast->getNodeType(), " ") + "{\n" + ElemStr + "}";
+  out << "}";
 }
 
-std::string
-StyioRepr::toString(ListAST* ast, int indent) {
+void
+StyioRepr::write(ListAST* ast, int indent) {
   if (ast->getElements().empty()) {
-    return reprASTType(ast->getNodeType()) + " [ ]";
+    out << reprASTType(ast->getNodeType()) << " [ ]";
+    return;
   }
 
-  string ElemStr;
+  out << reprASTType(ast->getNodeType(), " : ") << ast->getDataType().name() << " [\n";
 
   auto Elems = ast->getElements();
   for (int i = 0; i < Elems.size(); i++) {
-    ElemStr += make_padding(indent) + Elems[i]->toString(this, indent + 1);
+    out << pad(indent) << child(Elems[i], indent + 1);
     if (i != (Elems.size() - 1)) {
-      ElemStr += "\n";
+      out << "\n";
     }
   }
 
-  return reprASTType(ast->getNodeType(), " : ") + ast->getDataType().name + " [\n" + ElemStr + "]";
+  out << "]";
 }
 
-std::string
-StyioRepr::toString(SizeOfAST* ast, int indent) {
-  return reprASTType(ast->getNodeType()) + " { " + ast->getValue()->toString(this, indent + 1) + " }";
+void
+StyioRepr::write(SizeOfAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType()) << " { " << child(ast->getValue(), indent + 1) << " }";
 }
 
-std::string
-StyioRepr::toString(ListOpAST* ast, int indent) {
+void
+StyioRepr::write(ListOpAST* ast, int indent) {
   auto OpType = ast->getOp();
   switch (OpType) {
     case StyioNodeType::Access:
-      return reprASTType(ast->getNodeType(), " ") + "{"
-             + "\n" + make_padding(indent) + ast->getList()->toString(this, indent + 1)
-             + "\n" + make_padding(indent) + "Key: " + ast->getSlot1()->toString(this, indent + 1)
-             + "}";
-      break;
+      out << reprASTType(ast->getNodeType(), " ") << "{"
+          << "\n" << pad(indent) << child(ast->getList(), indent + 1)
+          << "\n" << pad(indent) << "Key: " << child(ast->getSlot1(), indent + 1)
+          << "}";
+      return;
 
     case StyioNodeType::Access_By_Index:
-      return reprASTType(ast->getNodeType(), " ")
-             + "{\n" + make_padding(indent) + ast->getList()->toString(this, indent + 1)
-             + "\n" + make_padding(indent) + "Index: " + ast->getSlot1()->toString(this, indent + 1)
-             + "}";
-      break;
+      out << reprASTType(ast->getNodeType(), " ")
+          << "{\n" << pad(indent) << child(ast->getList(), indent + 1)
+          << "\n" << pad(indent) << "Index: " << child(ast->getSlot1(), indent + 1)
+          << "}";
+      return;
     case StyioNodeType::Access_By_Name:
-      return reprASTType(ast->getNodeType(), " ")
-             + "\n" + make_padding(indent) + ast->getList()->toString(this, indent + 1)
-             + "\n" + make_padding(indent) + "Name : " + ast->getSlot1()->toString(this, indent + 1)
-             + "}";
-      break;
+      out << reprASTType(ast->getNodeType(), " ")
+          << "\n" << pad(indent) << child(ast->getList(), indent + 1)
+          << "\n" << pad(indent) << "Name : " << child(ast->getSlot1(), indent + 1)
+          << "}";
+      return;
 
     case StyioNodeType::Get_Index_By_Value:
-      return reprASTType(ast->getNodeType(), " ")
-             + "\n" + make_padding(indent) + ast->getList()->toString(this, indent + 1)
-             + "\n" + make_padding(indent) + "Index: " + ast->getSlot1()->toString(this, indent + 1)
-             + "}";
-      break;
+      out << reprASTType(ast->getNodeType(), " ")
+          << "\n" << pad(indent) << child(ast->getList(), indent + 1)
+          << "\n" << pad(indent) << "Index: " << child(ast->getSlot1(), indent + 1)
+          << "}";
+      return;
     case StyioNodeType::Get_Indices_By_Many_Values:
-      return reprASTType(ast->getNodeType(), " ")
-             + "\n" + make_padding(indent) + ast->getList()->toString(this, indent + 1)
-             + "\n" + make_padding(indent) + "Index: " + ast->getSlot1()->toString(this, indent + 1)
-             + "}";
-      break;
+      out << reprASTType(ast->getNodeType(), " ")
+          << "\n" << pad(indent) << child(ast->getList(), indent + 1)
+          << "\n" << pad(indent) << "Index: " << child(ast->getSlot1(), indent + 1)
+          << "}";
+      return;
     case StyioNodeType::Append_Value:
-      return reprASTType(ast->getNodeType(), " ")
-             + "\n" + make_padding(indent) + ast->getList()->toString(this, indent + 1)
-             + "\n" + make_padding(indent) + "Value: " + ast->getSlot1()->toString(this, indent + 1)
-             + "}";
-      break;
+      out << reprASTType(ast->getNodeType(), " ")
+          << "\n" << pad(indent) << child(ast->getList(), indent + 1)
+          << "\n" << pad(indent) << "Value: " << child(ast->getSlot1(), indent + 1)
+          << "}";
+      return;
     case StyioNodeType::Insert_Item_By_Index:
-      return reprASTType(ast->getNodeType(), " ")
-             + "\n" + make_padding(indent) + ast->getList()->toString(this, indent + 1)
-             + "\n" + make_padding(indent) + "Index: " + ast->getSlot1()->toString(this, indent + 1)
-             + "\n" + make_padding(indent) + "Value: " + ast->getSlot2()->toString(this, indent + 1)
-             + "}";
-      break;
+      out << reprASTType(ast->getNodeType(), " ")
+          << "\n" << pad(indent) << child(ast->getList(), indent + 1)
+          << "\n" << pad(indent) << "Index: " << child(ast->getSlot1(), indent + 1)
+          << "\n" << pad(indent) << "Value: " << child(ast->getSlot2(), indent + 1)
+          << "}";
+      return;
     case StyioNodeType::Remove_Item_By_Index:
-      return reprASTType(ast->getNodeType(), " ")
-             + "\n" + make_padding(indent) + ast->getList()->toString(this, indent + 1)
-             + "\n" + make_padding(indent) + "Index: " + ast->getSlot1()->toString(this, indent + 1)
-             + "}";
-      break;
+      out << reprASTType(ast->getNodeType(), " ")
+          << "\n" << pad(indent) << child(ast->getList(), indent + 1)
+          << "\n" << pad(indent) << "Index: " << child(ast->getSlot1(), indent + 1)
+          << "}";
+      return;
     case StyioNodeType::Remove_Item_By_Value:
-      return reprASTType(ast->getNodeType(), " ")
-             + "\n" + make_padding(indent) + ast->getList()->toString(this, indent + 1)
-             + "\n" + make_padding(indent) + "Value: " + ast->getSlot1()->toString(this, indent + 1)
-             + "}";
-      break;
+      out << reprASTType(ast->getNodeType(), " ")
+          << "\n" << pad(indent) << child(ast->getList(), indent + 1)
+          << "\n" << pad(indent) << "Value: " << child(ast->getSlot1(), indent + 1)
+          << "}";
+      return;
     case StyioNodeType::Remove_Items_By_Many_Indices:
-      return reprASTType(ast->getNodeType(), " ")
-             + "\n" + make_padding(indent) + ast->getList()->toString(this, indent + 1)
-             + "\n" + make_padding(indent) + "Index: " + ast->getSlot1()->toString(this, indent + 1)
-             + "}";
-      break;
+      out << reprASTType(ast->getNodeType(), " ")
+          << "\n" << pad(indent) << child(ast->getList(), indent + 1)
+          << "\n" << pad(indent) << "Index: " << child(ast->getSlot1(), indent + 1)
+          << "}";
+      return;
     case StyioNodeType::Remove_Items_By_Many_Values:
-      return reprASTType(ast->getNodeType(), " ")
-             + "\n" + make_padding(indent) + ast->getList()->toString(this, indent + 1)
-             + "\n" + make_padding(indent) + "Value: " + ast->getSlot1()->toString(this, indent + 1)
-             + "}";
-      break;
+      out << reprASTType(ast->getNodeType(), " ")
+          << "\n" << pad(indent) << child(ast->getList(), indent + 1)
+          << "\n" << pad(indent) << "Value: " << child(ast->getSlot1(), indent + 1)
+          << "}";
+      return;
     case StyioNodeType::Get_Reversed:
-      return reprASTType(ast->getNodeType(), " ")
-             + "\n" + make_padding(indent) + ast->getList()->toString(this, indent + 1)
-             + "}";
-      break;
+      out << reprASTType(ast->getNodeType(), " ")
+          << "\n" << pad(indent) << child(ast->getList(), indent + 1)
+          << "}";
+      return;
     case StyioNodeType::Get_Index_By_Item_From_Right:
-      return reprASTType(ast->getNodeType(), " ")
-             + "\n" + make_padding(indent) + ast->getList()->toString(this, indent + 1)
-             + "\n" + make_padding(indent) + "Index: " + ast->getSlot1()->toString(this, indent + 1)
-             + "}";
-      break;
+      out << reprASTType(ast->getNodeType(), " ")
+          << "\n" << pad(indent) << child(ast->getList(), indent + 1)
+          << "\n" << pad(indent) << "Index: " << child(ast->getSlot1(), indent + 1)
+          << "}";
+      return;
 
     default: {
-      return reprASTType(ast->getNodeType(), " ") + string("{ undefined }");
+      out << reprASTType(ast->getNodeType(), " ") << "{ undefined }";
+      return;
     } break;
   }
 
-  return reprASTType(ast->getNodeType(), " ") + string("{ undefined }");
+  out << reprASTType(ast->getNodeType(), " ") << "{ undefined }";
 }
 
-std::string
-StyioRepr::toString(BinCompAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + reprToken(ast->getSign()) + " {\n"
-         + make_padding(indent) + "LHS: " + ast->getLHS()->toString(this, indent + 1) + "\n"
-         + make_padding(indent) + "RHS: " + ast->getRHS()->toString(this, indent + 1)
-         + "}";
+void
+StyioRepr::write(BinCompAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << reprToken(ast->getSign()) << " {\n"
+      << pad(indent) << "LHS: " << child(ast->getLHS(), indent + 1) << "\n"
+      << pad(indent) << "RHS: " << child(ast->getRHS(), indent + 1)
+      << "}";
 }
 
-std::string
-StyioRepr::toString(CondAST* ast, int indent) {
+void
+StyioRepr::write(CondAST* ast, int indent) {
   LogicType LogicOp = ast->getSign();
 
   if (LogicOp == LogicType::AND || LogicOp == LogicType::OR || LogicOp == LogicType::XOR) {
-    return reprASTType(ast->getNodeType(), " ") + "{\n"
-           + make_padding(indent) + "Op: " + reprToken(LogicOp) + "\n"
-           + make_padding(indent) + "LHS: " + ast->getLHS()->toString(this, indent + 1) + "\n"
-           + make_padding(indent) + "RHS: " + ast->getRHS()->toString(this, indent + 1)
-           + "}";
+    out << reprASTType(ast->getNodeType(), " ") << "{\n"
+        << pad(indent) << "Op: " << reprToken(LogicOp) << "\n"
+        << pad(indent) << "LHS: " << child(ast->getLHS(), indent + 1) << "\n"
+        << pad(indent) << "RHS: " << child(ast->getRHS(), indent + 1)
+        << "}";
+    return;
   }
   else if (LogicOp == LogicType::NOT) {
-    return reprASTType(ast->getNodeType(), " ") + "\n"
-           + make_padding(indent) + "Op: " + reprToken(LogicOp) + "\n"
-           + make_padding(indent) + "Value: " + ast->getValue()->toString(this, indent + 1)
-           + "}";
+    out << reprASTType(ast->getNodeType(), " ") << "\n"
+        << pad(indent) << "Op: " << reprToken(LogicOp) << "\n"
+        << pad(indent) << "Value: " << child(ast->getValue(), indent + 1)
+        << "}";
+    return;
   }
   else if (LogicOp == LogicType::RAW) {
-    return reprASTType(ast->getNodeType(), " {\n")
-           + make_padding(indent) + ast->getValue()->toString(this, indent + 1) + "}";
+    out << reprASTType(ast->getNodeType(), " {\n")
+        << pad(indent) << child(ast->getValue(), indent + 1) << "}";
+    return;
   }
   else {
-    return reprASTType(ast->getNodeType(), " ") + " { Undefined! }";
+    out << reprASTType(ast->getNodeType(), " ") << " { Undefined! }";
+    return;
   }
 }
 
@@ -390,163 +422,159 @@ StyioRepr::toString(CondAST* ast, int indent) {
   Int -> Float => Pass
 
 */
-std::string
-StyioRepr::toString(BinOpAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), ": ") + ast->getType().name + " {" + "\n"
-         + make_padding(indent) + "LHS: " + ast->getLHS()->toString(this, indent + 1) + "\n"
-         + make_padding(indent) + "OP : " + reprToken(ast->getOp()) + "\n"
-         + make_padding(indent) + "RHS: " + ast->getRHS()->toString(this, indent + 1)
-         + "}";
+void
+StyioRepr::write(BinOpAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), ": ") << ast->getType().name() << " {" << "\n"
+      << pad(indent) << "LHS: " << child(ast->getLHS(), indent + 1) << "\n"
+      << pad(indent) << "OP : " << reprToken(ast->getOp()) << "\n"
+      << pad(indent) << "RHS: " << child(ast->getRHS(), indent + 1)
+      << "}";
 }
 
-std::string
-StyioRepr::toString(FmtStrAST* ast, int indent) {
+void
+StyioRepr::write(FmtStrAST* ast, int indent) {
   auto Fragments = ast->getFragments();
   auto Exprs = ast->getExprs();
 
-  string elemstr = "";
+  out << reprASTType(ast->getNodeType(), " ") << "{\n";
+
   for (size_t i = 0; i < Fragments.size(); i++) {
-    elemstr += make_padding(indent) + "\"" + Fragments[i] + "\"\n";
+    out << pad(indent) << "\"" << Fragments[i] << "\"\n";
   }
 
   for (int i = 0; i < Exprs.size(); i++) {
-    elemstr += make_padding(indent) + Exprs[i]->toString(this, indent + 1);
+    out << pad(indent) << child(Exprs[i], indent + 1);
     if (i < (Exprs.size() - 1)) {
-      elemstr += "\n";
+      out << "\n";
     }
   }
 
-  return reprASTType(ast->getNodeType(), " ") + "{\n" + elemstr + "}";
+  out << "}";
 }
 
-std::string
-StyioRepr::toString(ResourceAST* ast, int indent) {
-  string var_str;
+void
+StyioRepr::write(ResourceAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{\n";
 
   auto res_list = ast->res_list;
   for (int i = 0; i < res_list.size(); i++) {
-    var_str += make_padding(indent) + res_list[i].first->toString(this, indent + 1) + "\n";
-    var_str += make_padding(indent) + "type: { " + res_list[i].second + " }";
+    out << pad(indent) << child(res_list[i].first, indent + 1) << "\n";
+    out << pad(indent) << "type: { " << res_list[i].second << " }";
     if (i < (res_list.size() - 1)) {
-      var_str += "\n";
+      out << "\n";
     }
   }
 
-  return reprASTType(ast->getNodeType(), " ") + "{\n" + var_str + "}";
+  out << "}";
 }
 
-std::string
-StyioRepr::toString(ResPathAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + "{ " + ast->getPath() + " }";
+void
+StyioRepr::write(ResPathAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{ " << ast->getPath() << " }";
 }
 
-std::string
-StyioRepr::toString(RemotePathAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + "{ " + ast->getPath() + " }";
+void
+StyioRepr::write(RemotePathAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{ " << ast->getPath() << " }";
 }
 
-std::string
-StyioRepr::toString(WebUrlAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + "{ " + ast->getPath() + " }";
+void
+StyioRepr::write(WebUrlAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{ " << ast->getPath() << " }";
 }
 
-std::string
-StyioRepr::toString(DBUrlAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + "{ " + ast->getPath() + " }";
+void
+StyioRepr::write(DBUrlAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{ " << ast->getPath() << " }";
 }
 
-std::string
-StyioRepr::toString(ExtPackAST* ast, int indent) {
-  string pathStr;
+void
+StyioRepr::write(ExtPackAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{\n";
 
   auto PackPaths = ast->getPaths();
   for (int i = 0; i < PackPaths.size(); i++) {
-    pathStr += make_padding(indent) + PackPaths[i] + "\n";
+    out << pad(indent) << PackPaths[i] << "\n";
   };
 
-  return reprASTType(ast->getNodeType(), " ") + "{\n" + pathStr + "\n}";
+  out << "\n}";
 }
 
-std::string
-StyioRepr::toString(ReadFileAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + "{\n"
-         + make_padding(indent) + "Var: " + ast->getId()->toString(this, indent + 1) + "\n"
-         + make_padding(indent) + "Val: " + ast->getValue()->toString(this, indent + 1) + "}";
+void
+StyioRepr::write(ReadFileAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{\n"
+      << pad(indent) << "Var: " << child(ast->getId(), indent + 1) << "\n"
+      << pad(indent) << "Val: " << child(ast->getValue(), indent + 1) << "}";
 }
 
-std::string
-StyioRepr::toString(EOFAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + string("{ }");
+void
+StyioRepr::write(EOFAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{ }";
 }
 
-std::string
-StyioRepr::toString(BreakAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + string("{ }");
+void
+StyioRepr::write(BreakAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{ }";
 }
 
-std::string
-StyioRepr::toString(PassAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + string("{ }");
+void
+StyioRepr::write(PassAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{ }";
 }
 
-std::string
-StyioRepr::toString(ReturnAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + "{\n"
-         + make_padding(indent) + ast->getExpr()->toString(this, indent + 1)
-         + "}";
+void
+StyioRepr::write(ReturnAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{\n"
+      << pad(indent) << child(ast->getExpr(), indent + 1)
+      << "}";
 }
 
-std::string
-StyioRepr::toString(FuncCallAST* ast, int indent) {
-  std::string out_str;
-
-  out_str += reprASTType(ast->getNodeType(), " {\n");
+void
+StyioRepr::write(FuncCallAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " {\n");
 
   if (ast->func_callee) {
-    out_str += make_padding(indent) + ast->func_callee->toString(this, indent + 1) + "\n";
+    out << pad(indent) << child(ast->func_callee, indent + 1) << "\n";
   }
 
-  out_str += make_padding(indent) + ast->getFuncName()->toString(this, indent + 1) + " {\n";
+  out << pad(indent) << child(ast->getFuncName(), indent + 1) << " {\n";
 
-  string args_str;
   auto call_args = ast->getArgList();
   for (int i = 0; i < call_args.size(); i++) {
-    args_str += make_padding(indent + 1) + call_args[i]->toString(this, indent + 2);
+    out << pad(indent + 1) << child(call_args[i], indent + 2);
     if (i < (call_args.size() - 1)) {
-      args_str += "\n";
+      out << "\n";
     }
   }
-  out_str += args_str + "}}";
-
-  return out_str;
+  out << "}}";
 }
 
-std::string
-StyioRepr::toString(AttrAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " { ")
-         + ast->body->toString(this) + "."
-         + ast->attr->toString(this)
-         + " }";
+void
+StyioRepr::write(AttrAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " { ")
+      << child(ast->body) << "."
+      << child(ast->attr)
+      << " }";
 }
 
-std::string
-StyioRepr::toString(PrintAST* ast, int indent) {
-  string outstr;
+void
+StyioRepr::write(PrintAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{\n";
 
   if (not ast->exprs.empty()) {
     for (int i = 0; i < ast->exprs.size(); i++) {
-      outstr += make_padding(indent) + ast->exprs[i]->toString(this, indent + 1);
+      out << pad(indent) << child(ast->exprs[i], indent + 1);
       if (i < (ast->exprs.size() - 1)) {
-        outstr += "\n";
+        out << "\n";
       }
     }
   }
 
-  return reprASTType(ast->getNodeType(), " ") + string("{\n") + outstr + "}";
+  out << "}";
 }
 
-std::string
-StyioRepr::toString(ForwardAST* ast, int indent) {
+void
+StyioRepr::write(ForwardAST* ast, int indent) {
   // switch (ast->getNodeType()) {
   //   case StyioASTType::Forward: {
   //     return reprASTType(ast->getNodeType(), " ") + "{\n"
@@ -650,301 +678,286 @@ StyioRepr::toString(ForwardAST* ast, int indent) {
   //   default:
   //     break;
   // }
-  return reprASTType(ast->getNodeType(), " ") + string("{ Undefined }");
+  out << reprASTType(ast->getNodeType(), " ") << "{ Undefined }";
 }
 
-std::string
-StyioRepr::toString(BackwardAST* ast, int indent) {
-  return reprASTType(ast->getNodeType()) + string(" { ") + " }";
+void
+StyioRepr::write(BackwardAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType()) << " { " << " }";
 }
 
-std::string
-StyioRepr::toString(CheckEqualAST* ast, int indent) {
-  std::string outstr = reprASTType(ast->getNodeType()) + " {\n";
+void
+StyioRepr::write(CheckEqualAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType()) << " {\n";
 
   for (size_t i = 0; i < ast->right_values.size(); i++) {
-    outstr += make_padding(indent) + ast->right_values[i]->toString(this, indent + 1);
+    out << pad(indent) << child(ast->right_values[i], indent + 1);
   }
 
-  outstr += "}";
-
-  return outstr;
+  out << "}";
 }
 
-std::string
-StyioRepr::toString(CheckIsinAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + string("{\n")
-         + make_padding(indent) + ast->getIterable()->toString(this, indent + 1) + "}";
+void
+StyioRepr::write(CheckIsinAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{\n"
+      << pad(indent) << child(ast->getIterable(), indent + 1) << "}";
 }
 
-std::string
-StyioRepr::toString(HashTagNameAST* ast, int indent) {
-  std::string outstr = reprASTType(ast->getNodeType()) + string(" { ");
+void
+StyioRepr::write(HashTagNameAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType()) << " { ";
 
-  for (auto i : ast->words) {
-    outstr += i + " ";
+  for (auto const& i : ast->words) {
+    out << i << " ";
   }
 
-  outstr += "}";
-
-  return outstr;
+  out << "}";
 }
 
-std::string
-StyioRepr::toString(CODPAST* ast, int indent) {
-  std::string result;
-
-  // result += reprNodeType(ast->getNodeType(), " {\n");
-  result += "\n" + make_padding(indent) + "CODP." + ast->OpName + " {\n";
+void
+StyioRepr::write(CODPAST* ast, int indent) {
+  // out << reprNodeType(ast->getNodeType(), " {\n");
+  out << "\n" << pad(indent) << "CODP." << ast->OpName << " {\n";
 
   auto exprs = ast->OpArgs;
   for (int i = 0; i < exprs.size(); i++) {
-    result += make_padding(indent + 1) + exprs[i]->toString(this, indent + 2);
+    out << pad(indent + 1) << child(exprs[i], indent + 2);
     if (i != exprs.size() - 1) {
-      result += "\n";
+      out << "\n";
     }
     else {
-      result += "}";
+      out << "}";
     }
   }
 
   if (ast->NextOp) {
-    result += ast->NextOp->toString(this, indent);
+    out << child(ast->NextOp, indent);
   }
-
-  return result;
 }
 
-std::string
-StyioRepr::toString(CondFlowAST* ast, int indent) {
+void
+StyioRepr::write(CondFlowAST* ast, int indent) {
   auto WhatFlow = ast->getNodeType();
 
   if (WhatFlow == StyioNodeType::CondFlow_True || WhatFlow == StyioNodeType::CondFlow_False) {
-    return reprASTType(ast->getNodeType(), " ")
-           + string("{\n")
-           + make_padding(indent) + ast->getCond()->toString(this, indent + 1) + "\n"
-           + make_padding(indent) + "Then: " + ast->getThen()->toString(this, indent + 1) + "}";
+    out << reprASTType(ast->getNodeType(), " ")
+        << "{\n"
+        << pad(indent) << child(ast->getCond(), indent + 1) << "\n"
+        << pad(indent) << "Then: " << child(ast->getThen(), indent + 1) << "}";
+    return;
   }
   else if (WhatFlow == StyioNodeType::CondFlow_Both) {
-    return reprASTType(ast->getNodeType(), " ")
-           + string("{\n") + make_padding(indent) + ast->getCond()->toString(this, indent + 1) + "\n"
-           + make_padding(indent) + "Then: " + ast->getThen()->toString(this, indent + 1) + "\n"
-           + make_padding(indent) + "Else: " + ast->getElse()->toString(this, indent + 1) + "}";
+    out << reprASTType(ast->getNodeType(), " ")
+        << "{\n" << pad(indent) << child(ast->getCond(), indent + 1) << "\n"
+        << pad(indent) << "Then: " << child(ast->getThen(), indent + 1) << "\n"
+        << pad(indent) << "Else: " << child(ast->getElse(), indent + 1) << "}";
+    return;
   }
   else {
-    return reprASTType(ast->getNodeType(), " ")
-           + string("{\n") + make_padding(indent) + ast->getCond()->toString(this, indent + 1) + "}";
+    out << reprASTType(ast->getNodeType(), " ")
+        << "{\n" << pad(indent) << child(ast->getCond(), indent + 1) << "}";
+    return;
   }
 }
 
-std::string
-StyioRepr::toString(AnonyFuncAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + "{ " + " }";
+void
+StyioRepr::write(AnonyFuncAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{ " << " }";
 }
 
-std::string
-StyioRepr::toString(FunctionAST* ast, int indent) {
+void
+StyioRepr::write(FunctionAST* ast, int indent) {
   string suffix = "";
 
   if (ast->is_unique) {
     suffix = ".unique";
   }
 
-  string output = reprASTType(ast->getNodeType(), suffix) + "{" + "\n";
+  out << reprASTType(ast->getNodeType(), suffix) << "{" << "\n";
 
   if (ast->func_name) {
-    output += make_padding(indent) + "func_name: " + ast->func_name->toString(this, indent + 1) + "\n";
+    out << pad(indent) << "func_name: " << child(ast->func_name, indent + 1) << "\n";
   }
 
   if (not ast->params.empty()) {
-    std::string param_str = "\n";
+    out << pad(indent) << "params: " << "\n";
     for (size_t i = 0; i < ast->params.size(); i++) {
-      param_str += make_padding(indent + 1) + ast->params.at(i)->toString(this, indent + 2);
-      param_str += "\n";
+      out << pad(indent + 1) << child(ast->params.at(i), indent + 2);
+      out << "\n";
     }
-    output += make_padding(indent) + "params: " + param_str;
   }
 
   if (not ast->ret_type.valueless_by_exception()) {
-    std::string ret_type_str;
+    out << pad(indent) << "ret_type: ";
 
     if (std::holds_alternative<TypeAST*>(ast->ret_type) && std::get<TypeAST*>(ast->ret_type)) {
-      ret_type_str = std::get<TypeAST*>(ast->ret_type)->toString(this, indent + 1);
+      out << child(std::get<TypeAST*>(ast->ret_type), indent + 1);
     }
     else if (std::holds_alternative<TypeTupleAST*>(ast->ret_type) && std::get<TypeTupleAST*>(ast->ret_type)) {
-      ret_type_str = std::get<TypeTupleAST*>(ast->ret_type)->toString(this, indent + 1);
+      out << child(std::get<TypeTupleAST*>(ast->ret_type), indent + 1);
     }
 
-    output += make_padding(indent) + "ret_type: " + ret_type_str + "\n";
+    out << "\n";
   }
 
-  output += make_padding(indent) + "func_body:\n"
-            + make_padding(indent + 1) + ast->func_body->toString(this, indent + 2) + "}";
-  return output;
+  out << pad(indent) << "func_body:\n"
+      << pad(indent + 1) << child(ast->func_body, indent + 2) << "}";
 }
 
-std::string
-StyioRepr::toString(SimpleFuncAST* ast, int indent) {
+void
+StyioRepr::write(SimpleFuncAST* ast, int indent) {
   std::string suffix;
   if (ast->is_unique) {
     suffix = ".unique";
   }
 
-  string output = reprASTType(ast->getNodeType(), suffix) + " {" + "\n";
+  out << reprASTType(ast->getNodeType(), suffix) << " {" << "\n";
 
   if (ast->func_name) {
-    output += make_padding(indent) + "func_name: " + ast->func_name->toString(this, indent + 1) + "\n";
+    out << pad(indent) << "func_name: " << child(ast->func_name, indent + 1) << "\n";
   }
 
   if (not ast->params.empty()) {
-    std::string param_str = "\n";
+    out << pad(indent) << "params: " << "\n";
     for (size_t i = 0; i < ast->params.size(); i++) {
-      param_str += make_padding(indent + 1) + ast->params.at(i)->toString(this, indent + 2);
-      param_str += "\n";
+      out << pad(indent + 1) << child(ast->params.at(i), indent + 2);
+      out << "\n";
     }
-    output += make_padding(indent) + "params: " + param_str;
   }
 
   if (not ast->ret_type.valueless_by_exception()) {
-    std::string ret_type_str;
+    out << pad(indent) << "ret_type: ";
 
     if (std::holds_alternative<TypeAST*>(ast->ret_type)) {
       if (std::get<TypeAST*>(ast->ret_type)) {
-        ret_type_str = std::get<TypeAST*>(ast->ret_type)->toString(this, indent + 1);
+        out << child(std::get<TypeAST*>(ast->ret_type), indent + 1);
       }
     }
     else if (std::holds_alternative<TypeTupleAST*>(ast->ret_type)) {
       if (std::get<TypeTupleAST*>(ast->ret_type)) {
-        ret_type_str = std::get<TypeTupleAST*>(ast->ret_type)->toString(this, indent + 1);
+        out << child(std::get<TypeTupleAST*>(ast->ret_type), indent + 1);
       }
     }
 
-    output += make_padding(indent) + "ret_type: " + ret_type_str + "\n";
+    out << "\n";
   }
 
-  output += make_padding(indent) + "ret_expr: " + ast->ret_expr->toString(this, indent + 1) + "}";
-  return output;
+  out << pad(indent) << "ret_expr: " << child(ast->ret_expr, indent + 1) << "}";
 }
 
-std::string
-StyioRepr::toString(IteratorAST* ast, int indent) {
-  std::string outstr = reprASTType(ast->getNodeType()) + " {" + "\n";
+void
+StyioRepr::write(IteratorAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType()) << " {" << "\n";
 
-  outstr += make_padding(indent) + "iterable object: " + ast->collection->toString(this, indent + 1) + "\n";
+  out << pad(indent) << "iterable object: " << child(ast->collection, indent + 1) << "\n";
 
   for (size_t i = 0; i < ast->params.size(); i++) {
-    outstr += make_padding(indent) + ast->params.at(i)->toString(this, indent + 1) + "\n";
+    out << pad(indent) << child(ast->params.at(i), indent + 1) << "\n";
   }
 
   if (not ast->following.empty()) {
     for (size_t i = 0; i < ast->following.size(); i++) {
-      outstr += make_padding(indent) + ast->following.at(i)->toString(this, indent + 1);
+      out << pad(indent) << child(ast->following.at(i), indent + 1);
       if (i < ast->following.size() - 1) {
-        outstr += "\n";
+        out << "\n";
       }
     }
   }
 
-  outstr += "}";
-
-  return outstr;
+  out << "}";
 }
 
-std::string
-StyioRepr::toString(IterSeqAST* ast, int indent) {
-  std::string outstr = reprASTType(ast->getNodeType(), " ") + "{" + "\n";
+void
+StyioRepr::write(IterSeqAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{" << "\n";
 
   if (ast->collection) {
-    outstr += make_padding(indent) + ast->collection->toString(this, indent + 1) + "\n";
+    out << pad(indent) << child(ast->collection, indent + 1) << "\n";
   }
 
   for (size_t i = 0; i < ast->hash_tags.size(); i++) {
-    outstr += make_padding(indent) + ast->hash_tags.at(i)->toString(this, indent + 1);
+    out << pad(indent) << child(ast->hash_tags.at(i), indent + 1);
     if (i < ast->hash_tags.size() - 1) {
-      outstr += "\n";
+      out << "\n";
     }
   }
 
-  outstr += "}";
-
-  return outstr;
+  out << "}";
 }
 
-std::string
-StyioRepr::toString(InfiniteLoopAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + "{" + "\n"
-         + make_padding(indent) + ast->getForward()->toString(this, indent + 1)
-         + "}";
+void
+StyioRepr::write(InfiniteLoopAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{" << "\n"
+      << pad(indent) << child(ast->getForward(), indent + 1)
+      << "}";
 }
 
-std::string
-StyioRepr::toString(CasesAST* ast, int indent) {
-  string outstr = reprASTType(ast->getNodeType(), " ") + "{\n";
+void
+StyioRepr::write(CasesAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{\n";
 
-  std::string case_str;
   auto Cases = ast->getCases();
   for (int i = 0; i < Cases.size(); i++) {
-    case_str += make_padding(indent) + "(case) " + std::get<0>(Cases[i])->toString(this, indent + 1) + "\n";
-    case_str += make_padding(indent) + std::get<1>(Cases[i])->toString(this, indent + 1) + "\n";
+    out << pad(indent) << "(case) " << child(std::get<0>(Cases[i]), indent + 1) << "\n";
+    out << pad(indent) << child(std::get<1>(Cases[i]), indent + 1) << "\n";
   }
-  outstr += case_str;
 
   if (ast->case_default) {
-    outstr += make_padding(indent) + "(default) " + ast->case_default->toString(this, indent + 1);
+    out << pad(indent) << "(default) " << child(ast->case_default, indent + 1);
   }
 
-  outstr += "}";
-
-  return outstr;
+  out << "}";
 }
 
-std::string
-StyioRepr::toString(MatchCasesAST* ast, int indent) {
-  return reprASTType(ast->getNodeType(), " ") + "{ " + " }";
+void
+StyioRepr::write(MatchCasesAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{ " << " }";
 }
 
-std::string
-StyioRepr::toString(BlockAST* ast, int indent) {
-  string outstr;
+void
+StyioRepr::write(BlockAST* ast, int indent) {
+  out << reprASTType(ast->getNodeType(), " ") << "{\n";
 
   auto stmts = ast->stmts;
   for (int i = 0; i < stmts.size(); i++) {
-    outstr += make_padding(indent) + stmts.at(i)->toString(this, indent + 1);
+    out << pad(indent) << child(stmts.at(i), indent + 1);
     if (i < (stmts.size() - 1)) {
-      outstr += "\n";
+      out << "\n";
     }
   }
 
   auto followings = ast->followings;
   if (not followings.empty()) {
-    outstr += "\n";
+    out << "\n";
     for (int i = 0; i < followings.size(); i++) {
-      outstr += make_padding(indent + i) + followings.at(i)->toString(this, indent + i + 1);
+      out << pad(indent + i) << child(followings.at(i), indent + i + 1);
       if (i < (followings.size() - 1)) {
-        outstr += "\n";
+        out << "\n";
       }
     }
   }
 
-  return reprASTType(ast->getNodeType(), " ") + "{\n" + outstr + "}";
+  out << "}";
 }
 
-std::string
-StyioRepr::toString(MainBlockAST* ast, int indent) {
-  string outstr;
-
+void
+StyioRepr::write(MainBlockAST* ast, int indent) {
   auto Stmts = ast->getStmts();
-  if (Stmts.empty())
-    return reprASTType(ast->getNodeType(), " { }");
+  if (Stmts.empty()) {
+    out << reprASTType(ast->getNodeType(), " { }");
+    return;
+  }
+
+  out << reprASTType(ast->getNodeType(), " ") << "{\n";
 
   for (int i = 0; i < Stmts.size(); i++) {
-    outstr += make_padding(indent) + Stmts[i]->toString(this, indent + 1);
+    out << pad(indent) << child(Stmts[i], indent + 1);
     if (i < (Stmts.size() - 1)) {
-      outstr += "\n";
+      out << "\n";
     }
   }
 
-  return reprASTType(ast->getNodeType(), " ") + "{\n" + outstr + "}";
+  out << "}";
 }
 
 /*                                                     */
@@ -954,127 +967,163 @@ StyioRepr::toString(MainBlockAST* ast, int indent) {
 /*  _____/   _|      _|   ___| \___/      ___| _| \_\  */
 /*                                                     */
 
-std::string
-StyioRepr::toString(SGResId* node, int indent) {
-  return std::string("styio.ir.id { ") + node->as_str() + " }";
+void
+StyioRepr::write(SGResId* node, int indent) {
+  out << "styio.ir.id { " << node->as_str() << " }";
 }
 
-std::string
-StyioRepr::toString(SGType* node, int indent) {
-  return std::string("styio.ir.type { ")
-         + reprDataTypeOption(node->data_type.option) + ", "
-         + node->data_type.name + ", "
-         + std::to_string(node->data_type.num_of_bit)
-         + " }";
+void
+StyioRepr::write(SGType* node, int indent) {
+  out << "styio.ir.type { "
+      << reprDataTypeOption(node->data_type.option()) << ", "
+      << node->data_type.name() << ", "
+      << std::to_string(node->data_type.num_of_bit())
+      << " }";
 }
 
-std::string
-StyioRepr::toString(SGConstBool* node, int indent) {
-  return std::string("styio.ir.bool { ") + std::to_string(node->value) + " }";
+void
+StyioRepr::write(SGConstBool* node, int indent) {
+  out << "styio.ir.bool { " << std::to_string(node->value) << " }";
 }
 
-std::string
-StyioRepr::toString(SGConstInt* node, int indent) {
-  return std::string("styio.ir.int { ") + node->value + " }";
+void
+StyioRepr::write(SGConstInt* node, int indent) {
+  if (node->canonical) {
+    out << "styio.ir.int { " << std::to_string(*node->canonical) << " : i" << std::to_string(node->num_of_bit) << " }";
+  }
+  else {
+    out << "styio.ir.int { " << node->value << " }";
+  }
 }
 
-std::string
-StyioRepr::toString(SGConstFloat* node, int indent) {
-  return std::string("styio.ir.float { ") + node->value + " }";
+void
+StyioRepr::write(SGConstFloat* node, int indent) {
+  if (node->canonical) {
+    out << "styio.ir.float { " << node->value << " : f" << std::to_string(node->num_of_bit) << " }";
+  }
+  else {
+    out << "styio.ir.float { " << node->value << " }";
+  }
 }
 
-std::string
-StyioRepr::toString(SGConstChar* node, int indent) {
-  return std::string("styio.ir.char { ") + node->value + " }";
+void
+StyioRepr::write(SGConstChar* node, int indent) {
+  out << "styio.ir.char { " << node->value << " }";
 }
 
-std::string
-StyioRepr::toString(SGConstString* node, int indent) {
-  return std::string("styio.ir.string { ") + node->value + " }";
+void
+StyioRepr::write(SGConstString* node, int indent) {
+  out << "styio.ir.string { " << node->value << " }";
 }
 
-std::string
-StyioRepr::toString(SGFormatString* node, int indent) {
-  return std::string("styio.ir.fmtstr { ") + " }";
+void
+StyioRepr::write(SGFormatString* node, int indent) {
+  out << "styio.ir.fmtstr { " << " }";
 }
 
-std::string
-StyioRepr::toString(SGStruct* node, int indent) {
-  std::string argstr;
+void
+StyioRepr::write(SGStruct* node, int indent) {
+  out << "styio.ir.struct {\n";
   for (size_t i = 0; i < node->elements.size(); i++) {
-    argstr += make_padding(indent) + node->elements.at(i)->toString(this, indent + 1);
+    out << pad(indent) << child(node->elements.at(i), indent + 1);
     if (i != node->elements.size() - 1) {
-      argstr += "\n";
+      out << "\n";
     }
   }
-  return std::string("styio.ir.struct {\n") + argstr + "}";
+  out << "}";
 }
 
-std::string
-StyioRepr::toString(SGCast* node, int indent) {
-  return std::string("styio.ir.cast { ") + " }";
+void
+StyioRepr::write(SGCast* node, int indent) {
+  out << "styio.ir.cast { " << " }";
 }
 
-std::string
-StyioRepr::toString(SGBinOp* node, int indent) {
-  return std::string("styio.ir.binop {\n")
-         + make_padding(indent) + reprToken(node->operand) + "\n"
-         + make_padding(indent) + node->lhs_expr->toString(this, indent + 1) + "\n"
-         + make_padding(indent) + node->rhs_expr->toString(this, indent + 1)
-         + "}";
+void
+StyioRepr::write(SGBinOp* node, int indent) {
+  out << "styio.ir.binop {\n"
+      << pad(indent) << reprToken(node->operand) << "\n"
+      << pad(indent) << child(node->lhs_expr, indent + 1) << "\n"
+      << pad(indent) << child(node->rhs_expr, indent + 1)
+      << "}";
 }
 
-std::string
-StyioRepr::toString(SGCond* node, int indent) {
-  return std::string("styio.ir.cond { ") + " }";
+void
+StyioRepr::write(SGCond* node, int indent) {
+  out << "styio.ir.cond {\n"
+      << pad(indent) << reprToken(node->operand) << "\n"
+      << pad(indent) << child(node->lhs_expr, indent + 1);
+  if (node->rhs_expr) {
+    out << "\n"
+        << pad(indent) << child(node->rhs_expr, indent + 1);
+  }
+  out << "}";
 }
 
-std::string
-StyioRepr::toString(SGVar* node, int indent) {
-  std::string output = std::string("styio.ir.var {\n");
-  output += make_padding(indent) + node->var_name->toString(this, indent + 1) + "\n";
+void
+StyioRepr::write(SGVar* node, int indent) {
+  out << "styio.ir.var {\n";
+  out << pad(indent) << child(node->var_name, indent + 1) << "\n";
 
   if (node->val_init) {
-    output += make_padding(indent) + node->var_type->toString(this, indent + 1) + "\n";
-    output += make_padding(indent) + node->val_init->toString(this, indent + 1);
+    out << pad(indent) << child(node->var_type, indent + 1) << "\n";
+    out << pad(indent) << child(node->val_init, indent + 1);
   }
   else {
-    output += make_padding(indent) + node->var_type->toString(this, indent + 1);
+    out << pad(indent) << child(node->var_type, indent + 1);
   }
 
-  output += "}";
-
-  return output;
+  out << "}";
 }
 
-std::string
-StyioRepr::toString(SGFlexBind* node, int indent) {
-  return std::string("styio.ir.flex_bind { ") + " }";
+void
+StyioRepr::write(SGFlexBind* node, int indent) {
+  out << "styio.ir.flex_bind {\n"
+      << pad(indent) << child(node->var, indent + 1) << "\n"
+      << pad(indent) << child(node->value, indent + 1)
+      << "}";
 }
 
-std::string
-StyioRepr::toString(SGFinalBind* node, int indent) {
-  return std::string("styio.ir.final_bind { ") + " }";
-}
-
-std::string
-StyioRepr::toString(SGFuncArg* node, int indent) {
-  return std::string("styio.ir.func_arg { ") + " }";
+void
+StyioRepr::write(SGFinalBind* node, int indent) {
+  out << "styio.ir.final_bind {\n"
+      << pad(indent) << child(node->var, indent + 1) << "\n"
+      << pad(indent) << child(node->value, indent + 1)
+      << "}";
 }
 
-std::string
-StyioRepr::toString(SGFunc* node, int indent) {
-  return std::string("styio.ir.func { ") + " }";
+void
+StyioRepr::write(SGFuncArg* node, int indent) {
+  out << "styio.ir.func_arg { " << node->id << " : " << node->arg_type->data_type.name() << " }";
 }
 
-std::string
-StyioRepr::toString(SGCall* node, int indent) {
-  return std::string("styio.ir.call { ") + " }";
+void
+StyioRepr::write(SGFunc* node, int indent) {
+  out << "styio.ir.func {\n"
+      << pad(indent) << child(node->func_name, indent + 1) << "\n";
+  for (auto arg : node->func_args) {
+    out << pad(indent) << child(arg, indent + 1) << "\n";
+  }
+  out << pad(indent) << child(node->ret_type, indent + 1) << "\n"
+      << pad(indent) << child(node->func_block, indent + 1)
+      << "}";
+}
+
+void
+StyioRepr::write(SGCall* node, int indent) {
+  out << "styio.ir.call {\n"
+      << pad(indent) << child(node->func_name, indent + 1);
+  for (auto arg : node->func_args) {
+    out << "\n"
+        << pad(indent) << child(arg, indent + 1);
+  }
+  out << "}";
 }
 
-std::string
-StyioRepr::toString(SGReturn* node, int indent) {
-  return std::string("styio.ir.return { ") + " }";
+void
+StyioRepr::write(SGReturn* node, int indent) {
+  out << "styio.ir.return {\n"
+      << pad(indent) << child(node->expr, indent + 1)
+      << "}";
 }
 
 // std::string
@@ -1092,40 +1141,54 @@ StyioRepr::toString(SGReturn* node, int indent) {
 //   return std::string("styio.ir.while { ") + " }";
 // }
 
-std::string
-StyioRepr::toString(SGBlock* node, int indent) {
-  return std::string("styio.ir.block { ") + " }";
+void
+StyioRepr::write(SGBlock* node, int indent) {
+  if (node->stmts.empty()) {
+    out << "styio.ir.block { }";
+    return;
+  }
+
+  out << "styio.ir.block {\n";
+  for (size_t i = 0; i < node->stmts.size(); i++) {
+    out << pad(indent) << child(node->stmts.at(i), indent + 1);
+    if (i != node->stmts.size() - 1) {
+      out << "\n";
+    }
+  }
+  out << "}";
 }
 
-std::string
-StyioRepr::toString(SGEntry* node, int indent) {
-  return std::string("styio.ir.entry { ") + " }";
+void
+StyioRepr::write(SGEntry* node, int indent) {
+  out << "styio.ir.entry { " << " }";
 }
 
-std::string
-StyioRepr::toString(SGMainEntry* node, int indent) {
-  if (node->stmts.empty())
-    return "styio.ir.main { }";
+void
+StyioRepr::write(SGMainEntry* node, int indent) {
+  if (node->stmts.empty()) {
+    out << "styio.ir.main { }";
+    return;
+  }
 
-  std::string stmtstr;
+  out << "styio.ir.main {\n";
   for (size_t i = 0; i < node->stmts.size(); i++) {
-    stmtstr += make_padding(indent) + node->stmts.at(i)->toString(this, indent + 1) + "\n";
+    out << pad(indent) << child(node->stmts.at(i), indent + 1) << "\n";
   }
-
-  return std::string("styio.ir.main {\n") + stmtstr + "}";
+  out << "}";
 }
 
-std::string
-StyioRepr::toString(SIOPath* node, int indent) {
-  return std::string("styio.ir.path { ") + " }";
+void
+StyioRepr::write(SIOPath* node, int indent) {
+  out << "styio.ir.path { " << " }";
 }
 
-std::string
-StyioRepr::toString(SIOPrint* node, int indent) {
-  return std::string("styio.ir.print { ") + " }";
+void
+StyioRepr::write(SIOPrint* node, int indent) {
+  out << "styio.ir.print { " << " }";
 }
 
-std::string
-StyioRepr::toString(SIORead* node, int indent) {
-  return std::string("styio.ir.read { ") + " }";
+void
+StyioRepr::write(SIORead* node, int indent) {
+  out << "styio.ir.read { " << " }";
+  return;
 }
\ No newline at end of file
@@ -5,7 +5,9 @@
 // [STL]
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 
 using std::string;
 using std::unordered_map;
@@ -14,6 +16,71 @@ using std::unordered_map;
 #include "../StyioAST/ASTDecl.hpp"
 #include "../StyioIR/IRDecl.hpp"
 
+/*
+  StyioReprWriter: where StyioRepr writes to.
+
+  Every node appends its text to one buffer, instead of returning a
+  string that its parent copies again, so a dump takes time linear in
+  its size. With a sink, the buffer goes to the stream every 64 KB.
+*/
+class StyioReprWriter
+{
+private:
+  std::string buffer;
+
+  /* nullptr: keep everything in the buffer */
+  std::ostream* sink = nullptr;
+
+public:
+  static constexpr size_t flush_size = 64 * 1024;
+
+  /* Start over, writing to `to` (or to the buffer) */
+  void reset(std::ostream* to) {
+    buffer.clear();
+    sink = to;
+  }
+
+  void flush() {
+    if (sink) {
+      sink->write(buffer.data(), buffer.size());
+      buffer.clear();
+    }
+  }
+
+  /* What has been written since the last reset, without a sink */
+  std::string take() {
+    return std::move(buffer);
+  }
+
+  StyioReprWriter& spaces(size_t n) {
+    buffer.append(n, ' ');
+    return *this;
+  }
+
+  StyioReprWriter& operator<<(std::string_view text) {
+    buffer.append(text);
+    if (sink && buffer.size() >= flush_size) {
+      flush();
+    }
+    return *this;
+  }
+
+  StyioReprWriter& operator<<(char c) {
+    return *this << std::string_view(&c, 1);
+  }
+};
+
+/* `out << pad(indent)`: the same as `make_padding(indent)`, without a temporary */
+struct StyioReprPad
+{
+  int indent;
+};
+
+inline StyioReprWriter&
+operator<<(StyioReprWriter& out, StyioReprPad p) {
+  return out.spaces(2 * p.indent) << "|- ";
+}
+
 // Generic Visitor
 template <typename... Types>
 class ToStringVisitor;
@@ -22,15 +89,15 @@ template <typename T>
 class ToStringVisitor<T>
 {
 public:
-  virtual std::string toString(T* t, int indent = 0) = 0;
+  virtual void write(T* t, int indent = 0) = 0;
 };
 
 template <typename T, typename... Types>
 class ToStringVisitor<T, Types...> : public ToStringVisitor<Types...>
 {
 public:
-  using ToStringVisitor<Types...>::toString;
-  virtual std::string toString(T* t, int indent = 0) = 0;
+  using ToStringVisitor<Types...>::write;
+  virtual void write(T* t, int indent = 0) = 0;
 };
 
 using StyioToStringVisitor = ToStringVisitor<
@@ -125,183 +192,221 @@ using StyioToStringVisitor = ToStringVisitor<
   class PrintAST,
   class ReadFileAST>;
 
+class StyioRepr;
+
+/* `out << child(ast, indent)`: the node writes itself, in place */
+template <typename T>
+struct StyioReprNode
+{
+  StyioRepr* visitor;
+  T* node;
+  int indent;
+};
+
+template <typename T>
+StyioReprWriter&
+operator<<(StyioReprWriter& out, StyioReprNode<T> n) {
+  n.node->writeRepr(n.visitor, n.indent);
+  return out;
+}
+
 class StyioRepr : public StyioToStringVisitor
 {
+private:
+  StyioReprWriter out;
+
+  template <typename T>
+  StyioReprNode<T> child(T* t, int indent = 0) {
+    return StyioReprNode<T>{this, t, indent};
+  }
+
+  static StyioReprPad pad(int indent) {
+    return StyioReprPad{indent};
+  }
+
 public:
   StyioRepr() {}
 
   ~StyioRepr() {}
 
-  /* styio.ast.toString() */
+  /* The text of a tree, as a string */
+  std::string toString(StyioAST* ast, int indent = 0);
+  std::string toString(StyioIR* node, int indent = 0);
+
+  /* The same text, streamed into `os` as it is written */
+  void print(std::ostream& os, StyioAST* ast, int indent = 0);
+  void print(std::ostream& os, StyioIR* node, int indent = 0);
+
+  /* styio.ast.write() */
 
-  std::string toString(BoolAST* ast, int indent = 0);
+  void write(BoolAST* ast, int indent = 0);
 
-  std::string toString(NoneAST* ast, int indent = 0);
+  void write(NoneAST* ast, int indent = 0);
 
-  std::string toString(EOFAST* ast, int indent = 0);
+  void write(EOFAST* ast, int indent = 0);
 
-  std::string toString(EmptyAST* ast, int indent = 0);
+  void write(EmptyAST* ast, int indent = 0);
 
-  std::string toString(PassAST* ast, int indent = 0);
+  void write(PassAST* ast, int indent = 0);
 
-  std::string toString(BreakAST* ast, int indent = 0);
+  void write(BreakAST* ast, int indent = 0);
 
-  std::string toString(ReturnAST* ast, int indent = 0);
+  void write(ReturnAST* ast, int indent = 0);
 
-  std::string toString(CommentAST* ast, int indent = 0);
+  void write(CommentAST* ast, int indent = 0);
 
-  std::string toString(NameAST* ast, int indent = 0);
+  void write(NameAST* ast, int indent = 0);
 
-  std::string toString(VarAST* ast, int indent = 0);
+  void write(VarAST* ast, int indent = 0);
 
-  std::string toString(ParamAST* ast, int indent = 0);
+  void write(ParamAST* ast, int indent = 0);
 
-  std::string toString(OptArgAST* ast, int indent = 0);
+  void write(OptArgAST* ast, int indent = 0);
 
-  std::string toString(OptKwArgAST* ast, int indent = 0);
+  void write(OptKwArgAST* ast, int indent = 0);
 
-  std::string toString(VarTupleAST* ast, int indent = 0);
+  void write(VarTupleAST* ast, int indent = 0);
 
-  std::string toString(ExtractorAST* ast, int indent = 0);
+  void write(ExtractorAST* ast, int indent = 0);
 
-  std::string toString(TypeAST* ast, int indent = 0);
+  void write(TypeAST* ast, int indent = 0);
 
-  std::string toString(TypeTupleAST* ast, int indent = 0);
+  void write(TypeTupleAST* ast, int indent = 0);
 
-  std::string toString(IntAST* ast, int indent = 0);
+  void write(IntAST* ast, int indent = 0);
 
-  std::string toString(FloatAST* ast, int indent = 0);
+  void write(FloatAST* ast, int indent = 0);
 
-  std::string toString(CharAST* ast, int indent = 0);
+  void write(CharAST* ast, int indent = 0);
 
-  std::string toString(StringAST* ast, int indent = 0);
+  void write(StringAST* ast, int indent = 0);
 
-  std::string toString(TypeConvertAST* ast, int indent = 0);
+  void write(TypeConvertAST* ast, int indent = 0);
 
-  std::string toString(FmtStrAST* ast, int indent = 0);
+  void write(FmtStrAST* ast, int indent = 0);
 
-  std::string toString(ResPathAST* ast, int indent = 0);
+  void write(ResPathAST* ast, int indent = 0);
 
-  std::string toString(RemotePathAST* ast, int indent = 0);
+  void write(RemotePathAST* ast, int indent = 0);
 
-  std::string toString(WebUrlAST* ast, int indent = 0);
+  void write(WebUrlAST* ast, int indent = 0);
 
-  std::string toString(DBUrlAST* ast, int indent = 0);
+  void write(DBUrlAST* ast, int indent = 0);
 
-  std::string toString(ListAST* ast, int indent = 0);
+  void write(ListAST* ast, int indent = 0);
 
-  std::string toString(TupleAST* ast, int indent = 0);
+  void write(TupleAST* ast, int indent = 0);
 
-  std::string toString(SetAST* ast, int indent = 0);
+  void write(SetAST* ast, int indent = 0);
 
-  std::string toString(RangeAST* ast, int indent = 0);
+  void write(RangeAST* ast, int indent = 0);
 
-  std::string toString(SizeOfAST* ast, int indent = 0);
+  void write(SizeOfAST* ast, int indent = 0);
 
-  std::string toString(BinOpAST* ast, int indent = 0);
+  void write(BinOpAST* ast, int indent = 0);
 
-  std::string toString(BinCompAST* ast, int indent = 0);
+  void write(BinCompAST* ast, int indent = 0);
 
-  std::string toString(CondAST* ast, int indent = 0);
+  void write(CondAST* ast, int indent = 0);
 
-  std::string toString(FuncCallAST* ast, int indent = 0);
+  void write(FuncCallAST* ast, int indent = 0);
 
-  std::string toString(AttrAST* ast, int indent = 0);
+  void write(AttrAST* ast, int indent = 0);
 
-  std::string toString(ListOpAST* ast, int indent = 0);
+  void write(ListOpAST* ast, int indent = 0);
 
-  std::string toString(ResourceAST* ast, int indent = 0);
+  void write(ResourceAST* ast, int indent = 0);
 
-  std::string toString(FlexBindAST* ast, int indent = 0);
+  void write(FlexBindAST* ast, int indent = 0);
 
-  std::string toString(FinalBindAST* ast, int indent = 0);
+  void write(FinalBindAST* ast, int indent = 0);
 
-  std::string toString(StructAST* ast, int indent = 0);
+  void write(StructAST* ast, int indent = 0);
 
-  std::string toString(ReadFileAST* ast, int indent = 0);
+  void write(ReadFileAST* ast, int indent = 0);
 
-  std::string toString(PrintAST* ast, int indent = 0);
+  void write(PrintAST* ast, int indent = 0);
 
-  std::string toString(ExtPackAST* ast, int indent = 0);
+  void write(ExtPackAST* ast, int indent = 0);
 
-  std::string toString(BlockAST* ast, int indent = 0);
+  void write(BlockAST* ast, int indent = 0);
 
-  std::string toString(CasesAST* ast, int indent = 0);
+  void write(CasesAST* ast, int indent = 0);
 
-  std::string toString(CondFlowAST* ast, int indent = 0);
+  void write(CondFlowAST* ast, int indent = 0);
 
-  std::string toString(CheckEqualAST* ast, int indent = 0);
+  void write(CheckEqualAST* ast, int indent = 0);
 
-  std::string toString(CheckIsinAST* ast, int indent = 0);
+  void write(CheckIsinAST* ast, int indent = 0);
 
-  std::string toString(HashTagNameAST* ast, int indent = 0);
+  void write(HashTagNameAST* ast, int indent = 0);
 
-  std::string toString(ForwardAST* ast, int indent = 0);
+  void write(ForwardAST* ast, int indent = 0);
 
-  std::string toString(BackwardAST* ast, int indent = 0);
+  void write(BackwardAST* ast, int indent = 0);
 
-  std::string toString(CODPAST* ast, int indent = 0);
+  void write(CODPAST* ast, int indent = 0);
 
-  std::string toString(InfiniteAST* ast, int indent = 0);
+  void write(InfiniteAST* ast, int indent = 0);
 
-  std::string toString(AnonyFuncAST* ast, int indent = 0);
+  void write(AnonyFuncAST* ast, int indent = 0);
 
-  std::string toString(FunctionAST* ast, int indent = 0);
+  void write(FunctionAST* ast, int indent = 0);
 
-  std::string toString(SimpleFuncAST* ast, int indent = 0);
+  void write(SimpleFuncAST* ast, int indent = 0);
 
-  std::string toString(InfiniteLoopAST* ast, int indent = 0);
+  void write(InfiniteLoopAST* ast, int indent = 0);
 
-  std::string toString(IteratorAST* ast, int indent = 0);
+  void write(IteratorAST* ast, int indent = 0);
 
-  std::string toString(IterSeqAST* ast, int indent = 0);
+  void write(IterSeqAST* ast, int indent = 0);
 
-  std::string toString(MatchCasesAST* ast, int indent = 0);
+  void write(MatchCasesAST* ast, int indent = 0);
 
-  std::string toString(MainBlockAST* ast, int indent = 0);
+  void write(MainBlockAST* ast, int indent = 0);
 
-  /* styio.ir.toString() */
+  /* styio.ir.write() */
 
-  std::string toString(SGResId* node, int indent = 0);
-  std::string toString(SGType* node, int indent = 0);
+  void write(SGResId* node, int indent = 0);
+  void write(SGType* node, int indent = 0);
   
-  std::string toString(SGConstBool* node, int indent = 0);
+  void write(SGConstBool* node, int indent = 0);
 
-  std::string toString(SGConstInt* node, int indent = 0);
-  std::string toString(SGConstFloat* node, int indent = 0);
+  void write(SGConstInt* node, int indent = 0);
+  void write(SGConstFloat* node, int indent = 0);
 
-  std::string toString(SGConstChar* node, int indent = 0);
-  std::string toString(SGConstString* node, int indent = 0);
-  std::string toString(SGFormatString* node, int indent = 0);
+  void write(SGConstChar* node, int indent = 0);
+  void write(SGConstString* node, int indent = 0);
+  void write(SGFormatString* node, int indent = 0);
   
-  std::string toString(SGStruct* node, int indent = 0);
+  void write(SGStruct* node, int indent = 0);
 
-  std::string toString(SGCast* node, int indent = 0);
+  void write(SGCast* node, int indent = 0);
 
-  std::string toString(SGBinOp* node, int indent = 0);
-  std::string toString(SGCond* node, int indent = 0);
+  void write(SGBinOp* node, int indent = 0);
+  void write(SGCond* node, int indent = 0);
 
-  std::string toString(SGVar* node, int indent = 0);
-  std::string toString(SGFlexBind* node, int indent = 0);
-  std::string toString(SGFinalBind* node, int indent = 0);
+  void write(SGVar* node, int indent = 0);
+  void write(SGFlexBind* node, int indent = 0);
+  void write(SGFinalBind* node, int indent = 0);
 
-  std::string toString(SGFuncArg* node, int indent = 0);
-  std::string toString(SGFunc* node, int indent = 0);
-  std::string toString(SGCall* node, int indent = 0);
+  void write(SGFuncArg* node, int indent = 0);
+  void write(SGFunc* node, int indent = 0);
+  void write(SGCall* node, int indent = 0);
 
-  std::string toString(SGReturn* node, int indent = 0);
+  void write(SGReturn* node, int indent = 0);
 
-  // std::string toString(SGIfElse* node, int indent = 0);
-  // std::string toString(SGForLoop* node, int indent = 0);
-  // std::string toString(SGWhileLoop* node, int indent = 0);
+  // void write(SGIfElse* node, int indent = 0);
+  // void write(SGForLoop* node, int indent = 0);
+  // void write(SGWhileLoop* node, int indent = 0);
 
-  std::string toString(SGBlock* node, int indent = 0);
-  std::string toString(SGEntry* node, int indent = 0);
-  std::string toString(SGMainEntry* node, int indent = 0);
+  void write(SGBlock* node, int indent = 0);
+  void write(SGEntry* node, int indent = 0);
+  void write(SGMainEntry* node, int indent = 0);
 
-  std::string toString(SIOPath* node, int indent = 0);
-  std::string toString(SIOPrint* node, int indent = 0);
-  std::string toString(SIORead* node, int indent = 0);
+  void write(SIOPath* node, int indent = 0);
+  void write(SIOPrint* node, int indent = 0);
+  void write(SIORead* node, int indent = 0);
 };
 
 #endif  // STYIO_TO_STRING_VISITOR_H_
\ No newline at end of file
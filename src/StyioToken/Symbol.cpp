@@ -0,0 +1,73 @@
+// [C++ STL]
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// [Styio]
+#include "Symbol.hpp"
+
+/*
+  Names live in a deque, which never moves its elements,
+  so both the views used as keys and name_of() stay valid.
+*/
+struct StyioSymbolStorage
+{
+  std::shared_mutex mutex;
+  std::deque<std::string> names;
+  std::unordered_map<std::string_view, StyioSymbol> ids;
+
+  StyioSymbolStorage() {
+    names.emplace_back("");
+    ids.emplace(names.back(), 0);
+  }
+};
+
+static StyioSymbolStorage&
+symbol_storage() {
+  static StyioSymbolStorage storage;
+  return storage;
+}
+
+StyioSymbol
+StyioSymbolTable::intern(std::string_view name) {
+  auto& storage = symbol_storage();
+
+  {
+    std::shared_lock<std::shared_mutex> lock(storage.mutex);
+    auto it = storage.ids.find(name);
+    if (it != storage.ids.end()) {
+      return it->second;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lock(storage.mutex);
+  /* someone else may have added it in between */
+  auto it = storage.ids.find(name);
+  if (it != storage.ids.end()) {
+    return it->second;
+  }
+
+  StyioSymbol symbol = static_cast<StyioSymbol>(storage.names.size());
+  storage.names.emplace_back(name);
+  storage.ids.emplace(storage.names.back(), symbol);
+  return symbol;
+}
+
+const std::string&
+StyioSymbolTable::name_of(StyioSymbol symbol) {
+  auto& storage = symbol_storage();
+
+  std::shared_lock<std::shared_mutex> lock(storage.mutex);
+  return storage.names[symbol];
+}
+
+size_t
+StyioSymbolTable::num_of_symbols() {
+  auto& storage = symbol_storage();
+
+  std::shared_lock<std::shared_mutex> lock(storage.mutex);
+  return storage.names.size();
+}
@@ -0,0 +1,112 @@
+#pragma once
+#ifndef STYIO_SYMBOL_H_
+#define STYIO_SYMBOL_H_
+
+// [C++ STL]
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*
+  StyioSymbol: a 32-bit id for an identifier.
+
+  Names are interned once, when the tokenizer sees them, and every later
+  stage (AST, StyioIR, codegen) carries the id instead of a std::string.
+  The same name always gets the same id, for the whole program and on
+  every thread, and id 0 is the empty name.
+*/
+using StyioSymbol = uint32_t;
+
+class StyioSymbolTable
+{
+public:
+  /* Thread-safe. Lookups of known names only take a shared lock. */
+  static StyioSymbol intern(std::string_view name);
+
+  /* Stable until the end of the program */
+  static const std::string& name_of(StyioSymbol symbol);
+
+  static size_t num_of_symbols();
+};
+
+/*
+  StyioSymbolMap: a dense map from symbols to pointers.
+
+  Symbols are small and dense, so this is just a vector indexed by the
+  symbol, where nullptr means "not in the map".
+*/
+template <typename T>
+class StyioSymbolMap
+{
+private:
+  std::vector<T*> slots;
+
+public:
+  bool contains(StyioSymbol symbol) const {
+    return symbol < slots.size() && slots[symbol] != nullptr;
+  }
+
+  T* get(StyioSymbol symbol) const {
+    return symbol < slots.size() ? slots[symbol] : nullptr;
+  }
+
+  T*& operator[](StyioSymbol symbol) {
+    if (symbol >= slots.size()) {
+      slots.resize(symbol + 1, nullptr);
+    }
+    return slots[symbol];
+  }
+
+  void erase(StyioSymbol symbol) {
+    if (symbol < slots.size()) {
+      slots[symbol] = nullptr;
+    }
+  }
+
+  void clear() {
+    slots.clear();
+  }
+};
+
+/*
+  StyioSymbolHashMap: a sparse map from symbols to pointers.
+
+  Same as StyioSymbolMap, but its size is the number of names in it, not
+  the largest symbol. For small scopes that come and go, e.g. the names
+  of one function, which would otherwise allocate (and clear) a table as
+  large as the whole program's symbols each time.
+*/
+template <typename T>
+class StyioSymbolHashMap
+{
+private:
+  std::unordered_map<StyioSymbol, T*> slots;
+
+public:
+  bool contains(StyioSymbol symbol) const {
+    auto it = slots.find(symbol);
+    return it != slots.end() && it->second != nullptr;
+  }
+
+  T* get(StyioSymbol symbol) const {
+    auto it = slots.find(symbol);
+    return it != slots.end() ? it->second : nullptr;
+  }
+
+  T*& operator[](StyioSymbol symbol) {
+    return slots.try_emplace(symbol, nullptr).first->second;
+  }
+
+  void erase(StyioSymbol symbol) {
+    slots.erase(symbol);
+  }
+
+  void clear() {
+    slots.clear();
+  }
+};
+
+#endif
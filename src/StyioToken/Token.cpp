@@ -1,5 +1,11 @@
 // [C++ STL]
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 // [Styio]
 #include "Token.hpp"
@@ -383,6 +389,36 @@ reprToken(StyioOpType token) {
     case StyioOpType::Self_Div_Assign:
       return "/=";
 
+    case StyioOpType::Equal:
+      return "<EQ>";
+
+    case StyioOpType::Not_Equal:
+      return "<NE>";
+
+    case StyioOpType::Greater_Than:
+      return "<GT>";
+
+    case StyioOpType::Greater_Than_Equal:
+      return "<GE>";
+
+    case StyioOpType::Less_Than:
+      return "<LT>";
+
+    case StyioOpType::Less_Than_Equal:
+      return "<LE>";
+
+    case StyioOpType::Logic_NOT:
+      return "<NOT>";
+
+    case StyioOpType::Logic_AND:
+      return "<AND>";
+
+    case StyioOpType::Logic_OR:
+      return "<OR>";
+
+    case StyioOpType::Logic_XOR:
+      return "<XOR>";
+
     default:
       return "<Undefined>";
       break;
@@ -438,13 +474,197 @@ reprToken(CompType token) {
   }
 }
 
+/*
+  =================
+    Type Table
+  =================
+*/
+
+struct InternedType
+{
+  StyioTypeInfo info;
+  std::string name;
+  std::vector<StyioDataType> elements;
+};
+
+/*
+  Key of a non-builtin type: the option, the bits, the name for nominal
+  types, and the descriptors of the elements for structural types.
+*/
+static std::string
+make_type_key(
+  StyioDataTypeOption option,
+  size_t num_of_bit,
+  std::string_view name,
+  std::span<const StyioDataType> elements
+) {
+  std::string key;
+  key.reserve(16 + name.size() + elements.size() * sizeof(void*));
+  key += char(option);
+  key.append(reinterpret_cast<const char*>(&num_of_bit), sizeof(num_of_bit));
+  key.append(name);
+  key += '\0';
+  for (auto const& elem : elements) {
+    key.append(reinterpret_cast<const char*>(&elem.info), sizeof(elem.info));
+  }
+  return key;
+}
+
+static std::mutex type_table_mutex;
+
+static std::unordered_map<std::string, std::unique_ptr<InternedType>>&
+type_table() {
+  static std::unordered_map<std::string, std::unique_ptr<InternedType>> table;
+  return table;
+}
+
+static StyioDataType
+intern_type(
+  StyioDataTypeOption option,
+  size_t num_of_bit,
+  std::string_view name,
+  std::span<const StyioDataType> elements
+) {
+  std::string key = make_type_key(option, num_of_bit, name, elements);
+
+  std::lock_guard<std::mutex> lock(type_table_mutex);
+  auto& slot = type_table()[std::move(key)];
+  if (not slot) {
+    slot = std::make_unique<InternedType>();
+    slot->name = std::string(name);
+    slot->elements.assign(elements.begin(), elements.end());
+    slot->info = StyioTypeInfo{
+      option,
+      slot->name,
+      num_of_bit,
+      slot->elements.data(),
+      slot->elements.size()};
+  }
+  return StyioDataType{&slot->info};
+}
+
+static std::string
+join_type_names(std::span<const StyioDataType> types) {
+  std::string output;
+  for (size_t i = 0; i < types.size(); i++) {
+    if (i > 0) {
+      output += ", ";
+    }
+    output += types[i].name();
+  }
+  return output;
+}
+
+StyioDataType
+StyioDataType::getInteger(size_t num_of_bit) {
+  switch (num_of_bit) {
+    case 0:
+      return Int;
+    case 1:
+      return I1;
+    case 8:
+      return I8;
+    case 16:
+      return I16;
+    case 32:
+      return I32;
+    case 64:
+      return I64;
+    case 128:
+      return I128;
+  }
+
+  return intern_type(StyioDataTypeOption::Integer, num_of_bit, "i" + std::to_string(num_of_bit), {});
+}
+
+StyioDataType
+StyioDataType::getFloat(size_t num_of_bit) {
+  switch (num_of_bit) {
+    case 32:
+      return F32;
+    case 64:
+      return F64;
+  }
+
+  return intern_type(StyioDataTypeOption::Float, num_of_bit, "f" + std::to_string(num_of_bit), {});
+}
+
+StyioDataType
+StyioDataType::getDefined(std::string_view name) {
+  return intern_type(StyioDataTypeOption::Defined, 0, name, {});
+}
+
+StyioDataType
+StyioDataType::getStruct(std::string_view name) {
+  return intern_type(StyioDataTypeOption::Struct, 0, name, {});
+}
+
+StyioDataType
+StyioDataType::getTuple(std::span<const StyioDataType> elements) {
+  return intern_type(StyioDataTypeOption::Tuple, 0, "(" + join_type_names(elements) + ")", elements);
+}
+
+StyioDataType
+StyioDataType::getList(StyioDataType element) {
+  return intern_type(StyioDataTypeOption::List, 0, "[" + std::string(element.name()) + "]", {&element, 1});
+}
+
+StyioDataType
+StyioDataType::getFunc(std::span<const StyioDataType> params, StyioDataType ret) {
+  std::vector<StyioDataType> elements(params.begin(), params.end());
+  elements.push_back(ret);
+
+  return intern_type(
+    StyioDataTypeOption::Func,
+    0,
+    "(" + join_type_names(params) + ") => " + std::string(ret.name()),
+    elements
+  );
+}
+
+StyioDataType
+StyioDataType::lookup(std::string_view name) {
+  /* Pre-defined DType Table */
+  static std::unordered_map<std::string_view, StyioDataType> const table = {
+    {"bool", Bool},
+
+    {"int", I32},
+    {"long", I64},
+
+    {"i1", I1},
+    {"i8", I8},
+    {"i16", I16},
+    {"i32", I32},
+    {"i64", I64},
+    {"i128", I128},
+
+    {"float", F32},
+    {"double", F64},
+
+    {"f32", F32},
+    {"f64", F64},
+
+    {"char", Char},
+
+    {"string", String},
+    {"str", String},
+  };
+
+  auto it = table.find(name);
+  if (it != table.end()) {
+    return it->second;
+  }
+
+  return getDefined(name);
+}
+
 StyioDataType
 getMaxType(StyioDataType T1, StyioDataType T2) {
-  if (T1.option == T2.option) {
+  if (T1.option() == T2.option()) {
     return T1;
   }
 
-  return StyioDataType{StyioDataTypeOption::Undefined, "Undefined", 0};
+  return StyioDataType::Undefined;
 }
 
 std::string
@@ -539,6 +759,9 @@ StyioToken::getTokName(StyioTokenType type) {
     case StyioTokenType::STRING:
       return "<STRING>";
 
+    case StyioTokenType::CHARACTER:
+      return "<CHAR>";
+
     case StyioTokenType::COMMENT_LINE:
       return "// COMMENT ";
 
@@ -707,6 +930,9 @@ StyioToken::getTokName(StyioTokenType type) {
     case StyioTokenType::ARROW_SINGLE_LEFT:
       return "<-";
 
+    case StyioTokenType::PIPE_FORWARD:
+      return "|>";
+
     case StyioTokenType::WALRUS:
       return ":=";
 
@@ -721,13 +947,8 @@ StyioToken::getTokName(StyioTokenType type) {
   }
 };
 
-size_t
-StyioToken::length() {
-  return original.length();
-}
-
 std::string
-StyioToken::as_str() {
+StyioToken::as_str(std::string_view code) const {
   if (type == StyioTokenType::TOK_LF) {
     return "<LF>";
   }
@@ -737,10 +958,10 @@ StyioToken::as_str() {
   else if (type == StyioTokenType::NAME
            || type == StyioTokenType::INTEGER
            || type == StyioTokenType::DECIMAL) {
-    return getTokName(this->type) + " = " + this->original;
+    return getTokName(this->type) + " = " + std::string(text(code));
   }
   else if (type == StyioTokenType::STRING) {
-    return "\"" + this->original + "\"";
+    return "\"" + std::string(text(code)) + "\"";
   }
   else {
     return getTokName(this->type);
@@ -2,10 +2,18 @@
 #ifndef STYIO_TOKEN_H_
 #define STYIO_TOKEN_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <span>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
+// [Styio]
+#include "Symbol.hpp"
+
 enum class StyioDataTypeOption
 {
   Undefined,
@@ -27,55 +35,132 @@ enum class StyioDataTypeOption
   Func,  // Function
 };
 
-struct StyioDataType
+struct StyioDataType;
+
+/*
+  StyioTypeInfo: the one and only descriptor of a type.
+
+  Builtin types are constants below; every other type is created once by
+  the type table (see StyioDataType::getTuple() and friends) and lives
+  until the end of the program. Descriptors are never copied, so two
+  types are the same type if and only if they share the descriptor.
+*/
+struct StyioTypeInfo
 {
   StyioDataTypeOption option;
-  std::string name;
+  std::string_view name;
   size_t num_of_bit = 0;
 
-  bool isUndefined() {
-    return option == StyioDataTypeOption::Undefined;
-  }
+  /* Tuple: elements, List: [elem], Func: [params..., ret] */
+  const StyioDataType* elements = nullptr;
+  size_t num_of_elements = 0;
+};
 
-  bool isInteger() {
-    return option == StyioDataTypeOption::Integer;
-  }
+inline constexpr StyioTypeInfo StyioBuiltinTypes[] = {
+  {StyioDataTypeOption::Undefined, "undefined", 0},
+  {StyioDataTypeOption::Bool, "bool", 1},
+  {StyioDataTypeOption::Integer, "int", 0},
+  {StyioDataTypeOption::Integer, "i1", 1},
+  {StyioDataTypeOption::Integer, "i8", 8},
+  {StyioDataTypeOption::Integer, "i16", 16},
+  {StyioDataTypeOption::Integer, "i32", 32},
+  {StyioDataTypeOption::Integer, "i64", 64},
+  {StyioDataTypeOption::Integer, "i128", 128},
+  {StyioDataTypeOption::Float, "f32", 32},
+  {StyioDataTypeOption::Float, "f64", 64},
+  {StyioDataTypeOption::Char, "char", 0},
+  {StyioDataTypeOption::String, "string", 0},
+};
+
+/*
+  StyioDataType: a handle to an interned StyioTypeInfo.
 
-  bool isFloat() {
-    return option == StyioDataTypeOption::Float;
+  It is one pointer wide, trivially copyable, and compares by identity.
+*/
+struct StyioDataType
+{
+  const StyioTypeInfo* info = &StyioBuiltinTypes[0];
+
+  static const StyioDataType Undefined;
+  static const StyioDataType Bool;
+  static const StyioDataType Int; /* integer literal, width not decided yet */
+  static const StyioDataType I1;
+  static const StyioDataType I8;
+  static const StyioDataType I16;
+  static const StyioDataType I32;
+  static const StyioDataType I64;
+  static const StyioDataType I128;
+  static const StyioDataType F32;
+  static const StyioDataType F64;
+  static const StyioDataType Char;
+  static const StyioDataType String;
+
+  /* Interned on first use, then found in the table. Thread-safe. */
+  static StyioDataType getInteger(size_t num_of_bit);
+  static StyioDataType getFloat(size_t num_of_bit);
+  static StyioDataType getDefined(std::string_view name);
+  static StyioDataType getStruct(std::string_view name);
+  static StyioDataType getTuple(std::span<const StyioDataType> elements);
+  static StyioDataType getList(StyioDataType element);
+  static StyioDataType getFunc(std::span<const StyioDataType> params, StyioDataType ret);
+
+  /* Type written in the source, e.g. `i32`, `double`, `str`, `Point` */
+  static StyioDataType lookup(std::string_view name);
+
+  StyioDataTypeOption option() const {
+    return info->option;
   }
 
-  bool equals(const StyioDataType other) const {
-    return option == other.option and name == other.name;
+  std::string_view name() const {
+    return info->name;
   }
-};
 
-/* Pre-defined DType Table */
-static std::unordered_map<std::string, StyioDataType> const DTypeTable = {
-  {"bool", StyioDataType{StyioDataTypeOption::Bool, "bool", 1}},
+  size_t num_of_bit() const {
+    return info->num_of_bit;
+  }
 
-  {"int", StyioDataType{StyioDataTypeOption::Integer, "i32", 32}},
-  {"long", StyioDataType{StyioDataTypeOption::Integer, "i64", 64}},
+  std::span<const StyioDataType> elements() const {
+    return {info->elements, info->num_of_elements};
+  }
 
-  {"i1", StyioDataType{StyioDataTypeOption::Integer, "i1", 1}},
-  {"i8", StyioDataType{StyioDataTypeOption::Integer, "i8", 8}},
-  {"i16", StyioDataType{StyioDataTypeOption::Integer, "i16", 16}},
-  {"i32", StyioDataType{StyioDataTypeOption::Integer, "i32", 32}},
-  {"i64", StyioDataType{StyioDataTypeOption::Integer, "i64", 64}},
-  {"i128", StyioDataType{StyioDataTypeOption::Integer, "i128", 128}},
+  bool isUndefined() const {
+    return info->option == StyioDataTypeOption::Undefined;
+  }
 
-  {"float", StyioDataType{StyioDataTypeOption::Float, "f32", 32}},
-  {"double", StyioDataType{StyioDataTypeOption::Float, "f64", 64}},
+  bool isInteger() const {
+    return info->option == StyioDataTypeOption::Integer;
+  }
 
-  {"f32", StyioDataType{StyioDataTypeOption::Float, "f64", 32}},
-  {"f64", StyioDataType{StyioDataTypeOption::Float, "f64", 64}},
+  bool isFloat() const {
+    return info->option == StyioDataTypeOption::Float;
+  }
 
-  {"char", StyioDataType{StyioDataTypeOption::Char, "char", 0}},
+  bool equals(const StyioDataType other) const {
+    return info == other.info;
+  }
 
-  {"string", StyioDataType{StyioDataTypeOption::String, "string", 0}},
-  {"str", StyioDataType{StyioDataTypeOption::String, "string", 0}},
+  friend bool operator==(StyioDataType a, StyioDataType b) {
+    return a.info == b.info;
+  }
 };
 
+static_assert(sizeof(StyioDataType) == sizeof(void*));
+static_assert(std::is_trivially_copyable_v<StyioDataType>);
+
+inline constexpr StyioDataType StyioDataType::Undefined{&StyioBuiltinTypes[0]};
+inline constexpr StyioDataType StyioDataType::Bool{&StyioBuiltinTypes[1]};
+inline constexpr StyioDataType StyioDataType::Int{&StyioBuiltinTypes[2]};
+inline constexpr StyioDataType StyioDataType::I1{&StyioBuiltinTypes[3]};
+inline constexpr StyioDataType StyioDataType::I8{&StyioBuiltinTypes[4]};
+inline constexpr StyioDataType StyioDataType::I16{&StyioBuiltinTypes[5]};
+inline constexpr StyioDataType StyioDataType::I32{&StyioBuiltinTypes[6]};
+inline constexpr StyioDataType StyioDataType::I64{&StyioBuiltinTypes[7]};
+inline constexpr StyioDataType StyioDataType::I128{&StyioBuiltinTypes[8]};
+inline constexpr StyioDataType StyioDataType::F32{&StyioBuiltinTypes[9]};
+inline constexpr StyioDataType StyioDataType::F64{&StyioBuiltinTypes[10]};
+inline constexpr StyioDataType StyioDataType::Char{&StyioBuiltinTypes[11]};
+inline constexpr StyioDataType StyioDataType::String{&StyioBuiltinTypes[12]};
+
 StyioDataType getMaxType(StyioDataType T1, StyioDataType T2);
 
 std::string reprDataTypeOption(StyioDataTypeOption option);
@@ -122,51 +207,90 @@ enum class StyioOpType
   Comment_MultiLine,   // /* Like This */
 };
 
-/* Token Precedence Map */
-static std::unordered_map<StyioOpType, int> const TokenPrecedenceMap = {
-  {StyioOpType::Unary_Positive, 999},  // + a
-  {StyioOpType::Unary_Negative, 999},  // - a
-  {StyioOpType::Bitwise_NOT, 999},     // ~ a
-  {StyioOpType::Logic_NOT, 999},       // ! a
-
-  {StyioOpType::Binary_Pow, 704},  // a ** b
-
-  {StyioOpType::Binary_Mul, 703},  // a * b
-  {StyioOpType::Binary_Div, 703},  // a / b
-  {StyioOpType::Binary_Mod, 703},  // a % b
-
-  {StyioOpType::Binary_Add, 702},  // a + b
-  {StyioOpType::Binary_Sub, 702},  // a - b
-
-  {StyioOpType::Bitwise_Left_Shift, 701},   // shl(x, y)
-  {StyioOpType::Bitwise_Right_Shift, 701},  // shr(x, y)
-
-  {StyioOpType::Greater_Than, 502},        // a > b
-  {StyioOpType::Less_Than, 502},           // a < b
-  {StyioOpType::Greater_Than_Equal, 502},  // a >= b
-  {StyioOpType::Less_Than_Equal, 502},     // a <= b
-
-  {StyioOpType::Equal, 501},      // a == b
-  {StyioOpType::Not_Equal, 501},  // a != b
-
-  {StyioOpType::Bitwise_AND, 303},  // a & b
-  {StyioOpType::Bitwise_XOR, 302},  // a ^ b
-  {StyioOpType::Bitwise_OR, 301},   // a | b
-
-  {StyioOpType::Logic_AND, 203},  // a && b
-  {StyioOpType::Logic_XOR, 202},  // a ⊕ b
-  {StyioOpType::Logic_OR, 201},   // a || b
-
-  {StyioOpType::If_Else_Flow, 101},  // ?() => a : b
-
-  {StyioOpType::Self_Add_Assign, 1},  // a += b
-  {StyioOpType::Self_Sub_Assign, 1},  // a -= b
-  {StyioOpType::Self_Mul_Assign, 1},  // a *= b
-  {StyioOpType::Self_Div_Assign, 1},  // a /= b
+/*
+  Operator Precedence: higher binds tighter, 0 for anything else.
 
-  {StyioOpType::Undefined, 0},    // Undefined
-  {StyioOpType::End_Of_File, 0},  // Undefined
-};
+  A switch instead of a hash map, as the expression parser asks for it
+  once per operator.
+*/
+constexpr int
+getOpPrecedence(StyioOpType op) {
+  switch (op) {
+    case StyioOpType::Unary_Positive:  // + a
+    case StyioOpType::Unary_Negative:  // - a
+    case StyioOpType::Bitwise_NOT:     // ~ a
+    case StyioOpType::Logic_NOT:       // ! a
+      return 999;
+
+    case StyioOpType::Binary_Pow:  // a ** b
+      return 704;
+
+    case StyioOpType::Binary_Mul:  // a * b
+    case StyioOpType::Binary_Div:  // a / b
+    case StyioOpType::Binary_Mod:  // a % b
+      return 703;
+
+    case StyioOpType::Binary_Add:  // a + b
+    case StyioOpType::Binary_Sub:  // a - b
+      return 702;
+
+    case StyioOpType::Bitwise_Left_Shift:   // shl(x, y)
+    case StyioOpType::Bitwise_Right_Shift:  // shr(x, y)
+      return 701;
+
+    case StyioOpType::Greater_Than:        // a > b
+    case StyioOpType::Less_Than:           // a < b
+    case StyioOpType::Greater_Than_Equal:  // a >= b
+    case StyioOpType::Less_Than_Equal:     // a <= b
+      return 502;
+
+    case StyioOpType::Equal:      // a == b
+    case StyioOpType::Not_Equal:  // a != b
+      return 501;
+
+    case StyioOpType::Bitwise_AND:  // a & b
+      return 303;
+    case StyioOpType::Bitwise_XOR:  // a ^ b
+      return 302;
+    case StyioOpType::Bitwise_OR:  // a | b
+      return 301;
+
+    case StyioOpType::Logic_AND:  // a && b
+      return 203;
+    case StyioOpType::Logic_XOR:  // a ⊕ b
+      return 202;
+    case StyioOpType::Logic_OR:  // a || b
+      return 201;
+
+    case StyioOpType::If_Else_Flow:  // ?() => a : b
+      return 101;
+
+    case StyioOpType::Self_Add_Assign:  // a += b
+    case StyioOpType::Self_Sub_Assign:  // a -= b
+    case StyioOpType::Self_Mul_Assign:  // a *= b
+    case StyioOpType::Self_Div_Assign:  // a /= b
+      return 1;
+
+    default:
+      return 0;
+  }
+}
+
+/* a ** b ** c == a ** (b ** c), a += b += c == a += (b += c) */
+constexpr bool
+isOpRightAssoc(StyioOpType op) {
+  switch (op) {
+    case StyioOpType::Binary_Pow:
+    case StyioOpType::Self_Add_Assign:
+    case StyioOpType::Self_Sub_Assign:
+    case StyioOpType::Self_Mul_Assign:
+    case StyioOpType::Self_Div_Assign:
+      return true;
+
+    default:
+      return false;
+  }
+}
 
 static std::unordered_map<StyioOpType, std::string> const TokenStrMap = {
   {StyioOpType::Undefined, "undefined"},  // undefined
@@ -662,6 +786,7 @@ enum class StyioTokenType
   INTEGER,        // 0
   DECIMAL,        // 0.0
   STRING,         // "string"
+  CHARACTER,      // 'c'
   COMMENT_LINE,   //
   COMMENT_CLOSED, /* */
 
@@ -702,6 +827,8 @@ enum class StyioTokenType
   ARROW_SINGLE_RIGHT,  // ->
   ARROW_SINGLE_LEFT,   // <-
 
+  PIPE_FORWARD,  // |>
+
   ELLIPSIS,       // ...
   INFINITE_LIST,  // [...]
 
@@ -711,153 +838,76 @@ enum class StyioTokenType
   UNKNOWN,
 };
 
-class StyioToken
-{
-private:
-  StyioToken(
-    StyioTokenType token_type,
-    std::string token_literal
-  ) :
-      type(token_type), original(token_literal) {
-  }
+/*
+  StyioToken is a plain (type, offset, length) record.
 
-public:
+  Tokens never own their text: they point into the source buffer,
+  and the string is recovered on demand as a std::string_view,
+  see StyioContext::tok_str().
+*/
+struct StyioToken
+{
   StyioTokenType type;
-  std::string original;
+  uint32_t offset; /* start position in the source buffer */
+  uint32_t length; /* number of characters */
+  StyioSymbol symbol = 0; /* NAME: the interned name */
 
-  static StyioToken* Create(StyioTokenType token_type, std::string original_string) {
-    return new StyioToken(token_type, original_string);
+  static StyioToken Create(StyioTokenType token_type, size_t offset, size_t length, StyioSymbol symbol = 0) {
+    return StyioToken{token_type, static_cast<uint32_t>(offset), static_cast<uint32_t>(length), symbol};
   }
 
   static std::string getTokName(StyioTokenType type);
 
-  size_t length();
+  std::string_view text(std::string_view code) const {
+    return code.substr(offset, length);
+  }
 
-  std::string as_str();
+  std::string as_str(std::string_view code) const;
 };
 
-static std::unordered_map<StyioTokenType, std::vector<StyioTokenType> > const
-  StyioTokenMap = {
-    // =>
-    {StyioTokenType::ARROW_DOUBLE_RIGHT,
-     std::vector<StyioTokenType>{
-       StyioTokenType::TOK_EQUAL,
-       StyioTokenType::TOK_RANGBRAC
-     }
-    },
-    // <=
-    {StyioTokenType::ARROW_DOUBLE_LEFT,
-     std::vector<StyioTokenType>{
-       StyioTokenType::TOK_LANGBRAC,
-       StyioTokenType::TOK_EQUAL
-     }
-    },
-    // ->
-    {StyioTokenType::ARROW_SINGLE_LEFT,
-     std::vector<StyioTokenType>{
-       StyioTokenType::TOK_MINUS,
-       StyioTokenType::TOK_RANGBRAC
-     }
-    },
-    // <-
-    {StyioTokenType::ARROW_SINGLE_LEFT,
-     std::vector<StyioTokenType>{
-       StyioTokenType::TOK_LANGBRAC,
-       StyioTokenType::TOK_MINUS
-     }
-    },
-    /*
-      Binary Operations
-    */
-    // ==
-    {StyioTokenType::BINOP_EQ,
-     std::vector<StyioTokenType>{
-       StyioTokenType::TOK_EQUAL,
-       StyioTokenType::TOK_EQUAL
-     }
-    },
-    // !=
-    {StyioTokenType::BINOP_NE,
-     std::vector<StyioTokenType>{
-       StyioTokenType::TOK_EXCLAM,
-       StyioTokenType::TOK_EQUAL
-     }
-    },
-    // >=
-    {StyioTokenType::BINOP_GE,
-     std::vector<StyioTokenType>{
-       StyioTokenType::TOK_RANGBRAC,
-       StyioTokenType::TOK_EQUAL
-     }
-    },
-    // >
-    {StyioTokenType::BINOP_GT,
-     std::vector<StyioTokenType>{
-       StyioTokenType::TOK_RANGBRAC
-     }
-    },
-    // <=
-    {StyioTokenType::BINOP_LE,
-     std::vector<StyioTokenType>{
-       StyioTokenType::TOK_LANGBRAC,
-       StyioTokenType::TOK_EQUAL
-     }
-    },
-    // <
-    {StyioTokenType::BINOP_LT,
-     std::vector<StyioTokenType>{
-       StyioTokenType::TOK_LANGBRAC
-     }
-    },
-
-    /*
-      Special
-    */
-    // >_
-    {StyioTokenType::PRINT,
-     std::vector<StyioTokenType>{
-       StyioTokenType::TOK_RANGBRAC,
-       StyioTokenType::TOK_UNDLINE
-     }
-    },
-    // :=
-    {StyioTokenType::WALRUS,
-     std::vector<StyioTokenType>{
-       StyioTokenType::TOK_COLON,
-       StyioTokenType::TOK_EQUAL
-     }
-    },
-    // ?=
-    {StyioTokenType::MATCH,
-     std::vector<StyioTokenType>{
-       StyioTokenType::TOK_QUEST,
-       StyioTokenType::TOK_EQUAL
-     }
-    },
-
-    /*
-      LOGIC
-    */
-    // ! (Alternative)
-    {StyioTokenType::LOGIC_NOT,
-     std::vector<StyioTokenType>{
-       StyioTokenType::TOK_EXCLAM
-     }
-    },
-    // &&
-    {StyioTokenType::LOGIC_AND,
-     std::vector<StyioTokenType>{
-       StyioTokenType::TOK_AMP,
-       StyioTokenType::TOK_AMP
-     }
-    },
-    // ||
-    {StyioTokenType::LOGIC_OR,
-     std::vector<StyioTokenType>{
-       StyioTokenType::TOK_PIPE,
-       StyioTokenType::TOK_AMP
-     }
-    },
+static_assert(std::is_trivially_copyable_v<StyioToken>);
+
+/*
+  StyioTokenStream: output of StyioTokenizer.
+
+  `tokens` holds significant tokens only and always ends with TOK_EOF.
+  Trivia (spaces, line breaks, comments) goes to a side-table instead:
+  the trivia right before tokens[i] is
+
+    trivia[trivia_bounds[i] .. trivia_bounds[i + 1])
+
+  so the parser never has to walk over it, but layout-sensitive code
+  can still ask what was in between two tokens.
+*/
+struct StyioTokenStream
+{
+  std::vector<StyioToken> tokens;
+  std::vector<StyioToken> trivia;
+  std::vector<uint32_t> trivia_bounds = {0};
+
+  static bool is_trivia(StyioTokenType type) {
+    switch (type) {
+      case StyioTokenType::TOK_SPACE:
+      case StyioTokenType::TOK_LF:
+      case StyioTokenType::TOK_CR:
+      case StyioTokenType::COMMENT_LINE:
+      case StyioTokenType::COMMENT_CLOSED:
+        return true;
+
+      default:
+        return false;
+    }
+  }
+
+  void push(StyioToken tok) {
+    if (is_trivia(tok.type)) {
+      trivia.push_back(tok);
+    }
+    else {
+      tokens.push_back(tok);
+      trivia_bounds.push_back(static_cast<uint32_t>(trivia.size()));
+    }
+  }
 };
 
 #endif
@@ -0,0 +1,232 @@
+// [C++ STL]
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// [Styio]
+#include "Phases.hpp"
+
+/*
+  Global Allocation Counters
+
+  Replacing the global operator new is the only way to see allocations
+  made inside LLVM and the standard library as well. The counters are
+  thread-local, so the hot path is two plain additions.
+*/
+
+static thread_local uint64_t num_of_allocs = 0;
+static thread_local uint64_t num_of_alloc_bytes = 0;
+
+static void*
+counted_malloc(size_t size) {
+  num_of_allocs += 1;
+  num_of_alloc_bytes += size;
+
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+
+  throw std::bad_alloc();
+}
+
+void*
+operator new(size_t size) {
+  return counted_malloc(size);
+}
+
+void*
+operator new[](size_t size) {
+  return counted_malloc(size);
+}
+
+void
+operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void
+operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void
+operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+void
+operator delete[](void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+/*
+  Phase Records
+*/
+
+struct StyioPhaseRecord
+{
+  std::string name;
+  uint64_t calls = 0;
+  double wall_ms = 0;
+  StyioAllocStats allocs;
+  std::vector<std::pair<std::string, uint64_t>> counters;
+};
+
+struct StyioPhaseStorage
+{
+  std::atomic<bool> enabled = false;
+
+  std::mutex mutex;
+  std::vector<StyioPhaseRecord> records;
+};
+
+static StyioPhaseStorage&
+phase_storage() {
+  static StyioPhaseStorage storage;
+  return storage;
+}
+
+void
+StyioPhases::enable() {
+  phase_storage().enabled = true;
+}
+
+bool
+StyioPhases::is_enabled() {
+  return phase_storage().enabled.load(std::memory_order_relaxed);
+}
+
+StyioAllocStats
+StyioPhases::thread_allocs() {
+  return StyioAllocStats{num_of_allocs, num_of_alloc_bytes};
+}
+
+StyioPhase::StyioPhase(const char* name) :
+    name(name), active(StyioPhases::is_enabled()) {
+  if (active) {
+    start_allocs = StyioPhases::thread_allocs();
+    start_time = std::chrono::steady_clock::now();
+  }
+}
+
+void
+StyioPhase::end() {
+  if (not active) {
+    return;
+  }
+  active = false;
+
+  auto end_time = std::chrono::steady_clock::now();
+  StyioAllocStats end_allocs = StyioPhases::thread_allocs();
+
+  auto& storage = phase_storage();
+  std::lock_guard<std::mutex> lock(storage.mutex);
+
+  StyioPhaseRecord* record = nullptr;
+  for (auto& r : storage.records) {
+    if (r.name == name) {
+      record = &r;
+      break;
+    }
+  }
+
+  if (record == nullptr) {
+    storage.records.push_back(StyioPhaseRecord{name});
+    record = &storage.records.back();
+  }
+
+  record->calls += 1;
+  record->wall_ms += std::chrono::duration<double, std::milli>(end_time - start_time).count();
+  record->allocs.count += end_allocs.count - start_allocs.count;
+  record->allocs.bytes += end_allocs.bytes - start_allocs.bytes;
+
+  for (auto const& [what, n] : counters) {
+    bool found = false;
+    for (auto& c : record->counters) {
+      if (c.first == what) {
+        c.second += n;
+        found = true;
+        break;
+      }
+    }
+
+    if (not found) {
+      record->counters.emplace_back(what, n);
+    }
+  }
+}
+
+void
+StyioPhases::print_table(std::ostream& out) {
+  auto& storage = phase_storage();
+  std::lock_guard<std::mutex> lock(storage.mutex);
+
+  auto flags = out.flags();
+  auto precision = out.precision();
+
+  out << "\033[1;32mPhases\033[0m\n"
+      << std::left << std::setw(18) << "phase"
+      << std::right << std::setw(7) << "calls"
+      << std::setw(12) << "wall ms"
+      << std::setw(12) << "allocs"
+      << std::setw(14) << "alloc bytes"
+      << "  counters\n";
+
+  for (auto const& r : storage.records) {
+    out << std::left << std::setw(18) << r.name
+        << std::right << std::setw(7) << r.calls
+        << std::setw(12) << std::fixed << std::setprecision(3) << r.wall_ms
+        << std::setw(12) << r.allocs.count
+        << std::setw(14) << r.allocs.bytes
+        << " ";
+
+    for (auto const& [what, n] : r.counters) {
+      out << " " << what << "=" << n;
+    }
+    out << "\n";
+  }
+
+  out.flags(flags);
+  out.precision(precision);
+  out << std::flush;
+}
+
+void
+StyioPhases::print_json(std::ostream& out) {
+  auto& storage = phase_storage();
+  std::lock_guard<std::mutex> lock(storage.mutex);
+
+  auto flags = out.flags();
+  auto precision = out.precision();
+
+  out << "{\"phases\": [";
+
+  for (size_t i = 0; i < storage.records.size(); i++) {
+    auto const& r = storage.records[i];
+
+    out << (i == 0 ? "\n  " : ",\n  ")
+        << "{\"name\": \"" << r.name << "\""
+        << ", \"calls\": " << r.calls
+        << ", \"wall_ms\": " << std::fixed << std::setprecision(3) << r.wall_ms
+        << ", \"allocs\": " << r.allocs.count
+        << ", \"alloc_bytes\": " << r.allocs.bytes
+        << ", \"counters\": {";
+
+    for (size_t k = 0; k < r.counters.size(); k++) {
+      out << (k == 0 ? "" : ", ") << "\"" << r.counters[k].first << "\": " << r.counters[k].second;
+    }
+
+    out << "}}";
+  }
+
+  out.flags(flags);
+  out.precision(precision);
+  out << "\n]}" << std::endl;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#ifndef STYIO_PHASES_H_
+#define STYIO_PHASES_H_
+
+// [C++ STL]
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+/* Heap allocations made by one thread so far */
+struct StyioAllocStats
+{
+  uint64_t count = 0;
+  uint64_t bytes = 0;
+};
+
+/*
+  StyioPhases: where the time of a compilation goes (`--time-phases`).
+
+  Each phase of the compiler is wrapped in a StyioPhase, which measures
+  its wall time and the heap allocations of its thread, and may attach
+  counters (tokens, AST nodes, ...). Phases with the same name, e.g.
+  `parse` of every file of a project, are summed up into one row, so
+  phases that ran on several threads add up to more than the wall time
+  around them.
+
+  All of this costs a branch per phase while it is off. Allocations are
+  counted always, by the global operator new in Phases.cpp, in plain
+  thread-local counters.
+*/
+class StyioPhases
+{
+public:
+  static void enable();
+  static bool is_enabled();
+
+  /* Allocations of the calling thread */
+  static StyioAllocStats thread_allocs();
+
+  /* One row per phase name, in the order they first ended */
+  static void print_table(std::ostream& out);
+
+  /* The same, as {"phases": [{"name": ..., "calls": ..., ...}, ...]} */
+  static void print_json(std::ostream& out);
+};
+
+/*
+  StyioPhase: one run of a phase, from its construction to its end.
+
+  Usage:
+    {
+      StyioPhase phase("tokenize");
+      auto stream = StyioTokenizer::tokenize(code);
+      phase.count("tokens", stream.tokens.size());
+    }
+*/
+class StyioPhase
+{
+private:
+  const char* name;
+  bool active;
+
+  std::chrono::steady_clock::time_point start_time;
+  StyioAllocStats start_allocs;
+
+  std::vector<std::pair<const char*, uint64_t>> counters;
+
+public:
+  explicit StyioPhase(const char* name);
+
+  StyioPhase(const StyioPhase&) = delete;
+  StyioPhase& operator=(const StyioPhase&) = delete;
+
+  ~StyioPhase() {
+    end();
+  }
+
+  /* Add `n` to the counter `what` of this phase */
+  void count(const char* what, uint64_t n) {
+    if (active) {
+      counters.emplace_back(what, n);
+    }
+  }
+
+  /* Stop the clock now, instead of at the end of the scope */
+  void end();
+};
+
+#endif
@@ -7,6 +7,7 @@
 // [C++ STL]
 #include <algorithm>
 #include <atomic>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <filesystem>
@@ -14,9 +15,12 @@
 #include <iostream>
 #include <list>
 #include <map>
+#include <memory>
 #include <regex>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <tuple>
 #include <type_traits>
 #include <unordered_map>
@@ -27,12 +31,18 @@
 #include "StyioAST/AST.hpp"
 #include "StyioAnalyzer/ASTAnalyzer.hpp"   /* StyioASTAnalyzer */
 #include "StyioCodeGen/CodeGenVisitor.hpp" /* StyioToLLVMIR Code Generator */
+#include "StyioException/Diagnostics.hpp"
 #include "StyioException/Exception.hpp"
 #include "StyioIR/StyioIR.hpp" /* StyioIR */
+#include "StyioIR/Passes/Passes.hpp" /* StyioIRPassManager */
+#include "StyioJIT/ObjectCache.hpp"  /* StyioObjectCache */
 #include "StyioParser/Parser.hpp"
 #include "StyioParser/Tokenizer.hpp"
+#include "StyioSession/Project.hpp"
+#include "StyioSource/SourceFile.hpp"
 #include "StyioToString/ToStringVisitor.hpp" /* StyioRepr */
 #include "StyioToken/Token.hpp"
+#include "StyioUtil/Phases.hpp"
 #include "StyioUtil/Util.hpp"
 
 // [LLVM]
@@ -57,124 +67,57 @@ hello_world() {
   std::cout << "hello, world!" << std::endl;
 }
 
-struct tmp_code_wrap
-{
-  std::string code_text;
-  std::vector<std::pair<size_t, size_t>> line_seps;
-};
-
 void
 show_cwd() {
   std::filesystem::path cwd = std::filesystem::current_path();
   std::cout << cwd.string() << std::endl;
 }
 
-/*
-  linenum_map:
-
-  O(n)
-  foreach {
-    (0, a1): 1,
-    (a1 + 1, a2): 2,
-    (a2 + 1, a3): 3,
-    ...
-  }
-
-  O(logN)
-  vector<pair<size_t, size_t>>
-  [0, a1, a2, ..., an]
-
-  l: total length of the code
-  n: last line number
-  p: current position
-
-  p < (l / 2)
-  then [0 ~ l/2]
-  else [l/2 ~ l]
-
-  what if two consecutive "\n"?
-  that is: "\n\n"
-*/
-
-tmp_code_wrap
-read_styio_file(
-  std::string file_path
-) {
-  std::string text = "";
-  std::vector<std::pair<size_t, size_t>> lineseps;
-
-  const char* fpath_cstr = file_path.c_str();
-  if (std::filesystem::exists(fpath_cstr)) {
-    std::ifstream file(fpath_cstr);
-    if (!file.is_open()) {
-      printf("Error: Can't open file %s.\n", fpath_cstr);
-    }
-
-    size_t p = 0;
-    std::string line;
-    while (std::getline(file, line)) {
-      text += line;
-      lineseps.push_back(std::make_pair(p, line.size()));
-      p += line.size();
-
-      text.push_back('\n');
-      p += 1;
-    }
-    text += EOF;
-  }
-  else {
-    text = std::string("...");
-    printf("Error: File %s not found.", fpath_cstr);
-  }
-
-  struct tmp_code_wrap result = {text, lineseps};
-  return result;
-}
-
 void
-show_code_with_linenum(tmp_code_wrap c) {
-  auto& code = c.code_text;
-  auto& lineseps = c.line_seps;
-
+show_code_with_linenum(const StyioSourceFile* source) {
   std::cout << "\033[1;32mCode\033[0m\n";
-  for (size_t i = 0; i < lineseps.size(); i++) {
-    std::string line = code.substr(lineseps.at(i).first, lineseps.at(i).second);
-
-    std::regex newline_regex("\n");
-    std::string replaced_text = std::regex_replace(line, newline_regex, "[NEWLINE]");
+  for (size_t i = 0; i < source->line_count(); i++) {
+    size_t start = source->line_start(i);
+    std::string_view line = source->line_text(i);
 
     std::cout
-      << "|" << i << "|-[" << lineseps.at(i).first << ":" << (lineseps.at(i).first + lineseps.at(i).second) << "] "
+      << "|" << i << "|-[" << start << ":" << (start + line.length()) << "] "
       << line << std::endl;
   }
 };
 
 void
-show_tokens(std::vector<StyioToken*> tokens) {
+show_tokens(std::string_view code, const StyioTokenStream& stream) {
   std::cout
     << "\n"
     << "\033[1;32mTokens\033[0m"
     << std::endl;
   std::string sep = " ║ "; // ┃ ║
-  for (auto tok : tokens) {
-    if (tok->type == StyioTokenType::TOK_LF) {
-      std::cout << sep + "\\n" + "\n";
-    }
-    else if (tok->type == StyioTokenType::TOK_SPACE) {
-      std::cout << sep + " ";
+  for (size_t i = 0; i < stream.tokens.size(); i++) {
+    /* trivia is kept aside, show it in place */
+    for (size_t t = stream.trivia_bounds[i]; t < stream.trivia_bounds[i + 1]; t++) {
+      auto const& tok = stream.trivia[t];
+      if (tok.type == StyioTokenType::TOK_LF) {
+        std::cout << sep + "\\n" + "\n";
+      }
+      else if (tok.type == StyioTokenType::TOK_SPACE) {
+        std::cout << sep + " ";
+      }
     }
-    else if (tok->type == StyioTokenType::NAME) {
-      std::cout << sep + tok->original;
+
+    auto const& tok = stream.tokens[i];
+    if (tok.type == StyioTokenType::NAME) {
+      std::cout << sep << tok.text(code);
     }
-    else if (tok->type == StyioTokenType::STRING) {
-      std::cout << sep + tok->original;
+    else if (tok.type == StyioTokenType::STRING) {
+      std::cout << sep << tok.text(code);
     }
-    else if (tok->type == StyioTokenType::INTEGER
-             || tok->type == StyioTokenType::DECIMAL) {
-      std::cout << sep + tok->original + ": " + StyioToken::getTokName(tok->type);
+    else if (tok.type == StyioTokenType::INTEGER
+             || tok.type == StyioTokenType::DECIMAL) {
+      std::cout << sep << tok.text(code) << ": " << StyioToken::getTokName(tok.type);
     }
     else {
-      std::cout << sep + StyioToken::getTokName(tok->type);
+      std::cout << sep + StyioToken::getTokName(tok.type);
     }
   }
   std::cout << "\n"
@@ -192,7 +135,11 @@ main(
   options.allow_unrecognised_options();
 
   options.add_options()(
-    "f,file", "Take the given source file.", cxxopts::value<std::string>()
+    "f,file", "Take the given source files.", cxxopts::value<std::vector<std::string>>()
+  )(
+    "package", "Take every .styio file under the given directory.", cxxopts::value<std::string>()
+  )(
+    "j,jobs", "Parse on this many threads, 0 for one per core.", cxxopts::value<size_t>()->default_value("0")
   )(
     "h,help", "Show All Command-Line Options"
   );
@@ -203,12 +150,52 @@ main(
     "styio-ast", "Show Styio AST", cxxopts::value<bool>()->default_value("false")
   )(
     "styio-ir", "Show Styio IR", cxxopts::value<bool>()->default_value("false")
+  )(
+    "styio-ir-passes", "Show Styio IR before and after the Styio IR passes", cxxopts::value<bool>()->default_value("false")
   )(
     "llvm-ir", "Show LLVM IR", cxxopts::value<bool>()->default_value("false")
+  )(
+    "print-after-opt", "Show LLVM IR after the -O passes", cxxopts::value<bool>()->default_value("false")
+  );
+
+  options.add_options()(
+    "O,opt-level", "Optimize the LLVM IR as -O0, -O1, -O2 or -O3", cxxopts::value<unsigned>()->default_value("0")
+  )(
+    "cache", "Keep compiled programs in $STYIO_CACHE_DIR or ~/.cache/styio and run them from there the next time", cxxopts::value<bool>()->default_value("false")
+  )(
+    "cache-dir", "Same as --cache, in this directory instead", cxxopts::value<std::string>()
+  )(
+    "cache-max-size", "Size of the cache directory in MiB, least recently used programs go first", cxxopts::value<uint64_t>()->default_value("1024")
+  )(
+    "lazy", "Compile each function on its first call, and show how many were compiled", cxxopts::value<bool>()->default_value("false")
+  )(
+    "tiered", "Compile fast first, then recompile hot functions at -O3 in the background", cxxopts::value<bool>()->default_value("false")
+  )(
+    "tier-up-calls", "--tiered: calls that make a function hot, 0 for never", cxxopts::value<uint64_t>()->default_value("1000")
+  )(
+    "tier-up-loops", "--tiered: loop back-edges that make a function hot, 0 for never", cxxopts::value<uint64_t>()->default_value("10000")
+  )(
+    "codegen-jobs", "Lower, optimize and compile the functions as this many modules on as many threads, 0 for one per core", cxxopts::value<unsigned>()->default_value("1")
+  )(
+    "target-cpu", "Generate code for this CPU (e.g. x86-64, skylake) instead of this machine's", cxxopts::value<std::string>()->default_value("")
+  )(
+    "target-features", "Add or remove CPU features, e.g. +avx2,-avx512f", cxxopts::value<std::string>()->default_value("")
+  );
+
+  options.add_options()(
+    "emit-obj", "Write a native object file instead of running", cxxopts::value<std::string>()
+  )(
+    "emit-asm", "Write native assembly instead of running", cxxopts::value<std::string>()
+  )(
+    "emit-bc", "Write LLVM bitcode instead of running", cxxopts::value<std::string>()
+  )(
+    "o,output", "Write an executable, linked with the StyioExtern runtime, instead of running", cxxopts::value<std::string>()
   );
 
   options.add_options()(
     "debug", "Debug Mode", cxxopts::value<bool>()->default_value("false")
+  )(
+    "time-phases", "Show the time, allocations and sizes of each phase on stderr, as a table or json", cxxopts::value<std::string>()->implicit_value("table")
   );
 
   options.parse_positional({"file"});
@@ -224,91 +211,337 @@ main(
 
   bool show_styio_ast = cmlopts["styio-ast"].as<bool>();
   bool show_styio_ir = cmlopts["styio-ir"].as<bool>();
+  bool show_styio_ir_passes = cmlopts["styio-ir-passes"].as<bool>();
   bool show_llvm_ir = cmlopts["llvm-ir"].as<bool>();
+  bool show_llvm_ir_after_opt = cmlopts["print-after-opt"].as<bool>();
+
+  unsigned opt_level = cmlopts["opt-level"].as<unsigned>();
+  if (opt_level > 3) {
+    std::cerr << "-O: expected 0, 1, 2 or 3, got " << opt_level << std::endl;
+    return 1;
+  }
+
+  std::string cache_dir; /* empty: no object cache */
+  if (cmlopts.count("cache-dir")) {
+    cache_dir = cmlopts["cache-dir"].as<std::string>();
+    if (cache_dir.empty()) {
+      std::cerr << "--cache-dir: expected a directory" << std::endl;
+      return 1;
+    }
+  }
+  else if (cmlopts["cache"].as<bool>()) {
+    cache_dir = StyioObjectCache::get_default_dir();
+  }
+
+  /* Ahead of time: write these files, do not run */
+  bool is_aot = cmlopts.count("emit-obj") || cmlopts.count("emit-asm") || cmlopts.count("emit-bc") || cmlopts.count("output");
+
+  /* Modules (and threads) for the functions, one unless --codegen-jobs */
+  unsigned codegen_jobs = cmlopts["codegen-jobs"].as<unsigned>();
+  if (codegen_jobs == 0) {
+    codegen_jobs = std::max(1u, std::thread::hardware_concurrency());
+  }
+  /* an object or an executable is written from one module */
+  if (is_aot) {
+    codegen_jobs = 1;
+  }
 
   bool is_debug_mode = cmlopts["debug"].as<bool>();
 
-  std::string fpath; /* File Path */
+  std::string time_phases; /* "table" or "json" */
+  if (cmlopts.count("time-phases")) {
+    time_phases = cmlopts["time-phases"].as<std::string>();
+    if (time_phases != "table" && time_phases != "json") {
+      std::cerr << "--time-phases: expected table or json, got " << time_phases << std::endl;
+      return 1;
+    }
+    StyioPhases::enable();
+  }
+
+  auto report_phases = [&time_phases]() {
+    if (time_phases == "table") {
+      StyioPhases::print_table(std::cerr);
+    }
+    else if (time_phases == "json") {
+      StyioPhases::print_json(std::cerr);
+    }
+  };
+
+  std::vector<std::string> fpaths; /* File Paths */
   if (cmlopts.count("file")) {
-    fpath = cmlopts["file"].as<std::string>();
-    // std::cout << fpath << std::endl;
+    fpaths = cmlopts["file"].as<std::vector<std::string>>();
+  }
 
-    auto styio_code = read_styio_file(fpath);
-    if (is_debug_mode) {
-      show_code_with_linenum(styio_code);
+  if (cmlopts.count("package")) {
+    try {
+      auto package_files = StyioProject::find_sources(cmlopts["package"].as<std::string>());
+      fpaths.insert(fpaths.end(), package_files.begin(), package_files.end());
     }
+    catch (StyioIOError& e) {
+      std::cerr << e.what() << std::endl;
+      return 1;
+    }
+  }
 
-    auto styio_tokenizer = StyioTokenizer();
-    auto token_list = styio_tokenizer.tokenize(styio_code.code_text);
+  if (not fpaths.empty()) {
+    /* Parser: one thread per file, every syntax error of every file */
+    StyioProject project;
 
-    auto styio_context = StyioContext::Create(
-      fpath,
-      styio_code.code_text,
-      styio_code.line_seps,
-      token_list,
-      is_debug_mode /* is debug mode */
-    );
+    StyioPhase frontend_phase("frontend");
+    project.parse(fpaths, cmlopts["jobs"].as<size_t>());
+    frontend_phase.count("files", fpaths.size());
+    frontend_phase.end();
 
     if (is_debug_mode) {
-      show_tokens(token_list);
+      for (auto const& unit : project.get_units()) {
+        if (unit->source) {
+          show_code_with_linenum(unit->source.get());
+          show_tokens(unit->source->text(), StyioTokenizer::tokenize(unit->source->text()));
+        }
+      }
     }
 
-    StyioRepr styio_repr = StyioRepr();
+    if (project.has_errors()) {
+      project.print_diagnostics(std::cerr);
+      report_phases();
+      return 1;
+    }
+
+    /* JIT Initialization */
+    StyioPhase jit_init_phase("jit-init");
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    llvm::InitializeNativeTargetAsmParser();
 
-    /* Parser */
-    auto styio_ast = parse_main_block(*styio_context);
+    StyioJITOptions jit_options;
+    jit_options.lazy = cmlopts["lazy"].as<bool>();
+    jit_options.tiered = cmlopts["tiered"].as<bool>();
+    jit_options.tier_up_calls = cmlopts["tier-up-calls"].as<uint64_t>();
+    jit_options.tier_up_loops = cmlopts["tier-up-loops"].as<uint64_t>();
+    jit_options.compile_threads = codegen_jobs;
+    jit_options.opt_level = opt_level;
+    jit_options.cpu = cmlopts["target-cpu"].as<std::string>();
+    jit_options.features = cmlopts["target-features"].as<std::string>();
+
+    if (jit_options.lazy && jit_options.tiered) {
+      std::cerr << "--lazy and --tiered: choose one" << std::endl;
+      return 1;
+    }
+
+    if (jit_options.tiered && codegen_jobs > 1) {
+      std::cerr << "--codegen-jobs and --tiered: choose one" << std::endl;
+      return 1;
+    }
+
+    /*
+      not with --tiered: tier 0 calls into this very process, by address;
+      not with --codegen-jobs: the key names one module, not several
+    */
+    StyioObjectCache* object_cache = nullptr;
+    std::unique_ptr<StyioObjectCache> owned_object_cache;
+    if (not cache_dir.empty() && not jit_options.tiered && codegen_jobs == 1) {
+      owned_object_cache = std::make_unique<StyioObjectCache>(
+        cache_dir, cmlopts["cache-max-size"].as<uint64_t>() << 20
+      );
+      object_cache = owned_object_cache.get();
+    }
+
+    llvm::ExitOnError exit_on_error("styio: ");
+    std::unique_ptr<StyioJIT_ORC> styio_orc_jit = exit_on_error(StyioJIT_ORC::Create(std::move(owned_object_cache), jit_options));
+
+    std::string cache_key;
+    if (object_cache) {
+      std::vector<std::string_view> sources;
+      for (auto const& unit : project.get_units()) {
+        if (unit->source) {
+          sources.push_back(unit->source->text());
+        }
+      }
+      cache_key = StyioObjectCache::make_key(sources, opt_level, styio_orc_jit->getTargetMachineBuilder());
+    }
+
+    /* CodeGen Initialization */
+    StyioToLLVM generator = StyioToLLVM(std::move(styio_orc_jit));
+    jit_init_phase.end();
+
+    /*
+      Object Cache: the same sources, compiler and target give the same
+      object, so a hit skips everything up to the JIT. Unless some IR is
+      to be shown, which needs the whole pipeline.
+    */
+    bool shows_any_ir = show_all or show_styio_ast or show_styio_ir or show_styio_ir_passes
+                        or show_llvm_ir or show_llvm_ir_after_opt;
+
+    if (object_cache) {
+      generator.set_cache_key(cache_key);
+
+      if (not shows_any_ir && not is_aot) {
+        StyioPhase object_cache_phase("object-cache");
+        auto object = object_cache->load(cache_key);
+        object_cache_phase.count("hits", object_cache->get_num_of_hits());
+        object_cache_phase.end();
+
+        if (object) {
+          generator.load_object(std::move(object));
+          generator.execute();
+
+          report_phases();
+          return 0;
+        }
+      }
+    }
+
+    /* AST nodes made after parsing, freed at the end of this block */
+    ASTArena ast_arena;
+    ASTArena::Scope ast_arena_scope(ast_arena);
+
+    auto styio_ast = project.merge();
+
+    StyioRepr styio_repr = StyioRepr();
 
     if (show_all or show_styio_ast) {
       std::cout
         << "\033[1;32mAST\033[0m \033[31m-Original\033[0m"
-        << "\n"
-        << styio_ast->toString(&styio_repr) << "\n"
-        << std::endl;
+        << "\n";
+      styio_repr.print(std::cout, styio_ast);
+      std::cout << "\n" << std::endl;
     }
 
     /* Type Inference */
     StyioAnalyzer analyzer = StyioAnalyzer();
-    analyzer.typeInfer(styio_ast);
+
+    StyioPhase type_infer_phase("typeInfer");
+    try {
+      analyzer.typeInfer(styio_ast);
+    }
+    catch (StyioTypeError& e) {
+      std::cerr << e.what() << std::endl;
+      report_phases();
+      return 1;
+    }
+    type_infer_phase.end();
 
     if (show_all or show_styio_ast) {
       std::cout
         << "\033[1;32mAST\033[0m \033[1;33m-Type-Checking\033[0m"
-        << "\n"
-        << styio_ast->toString(&styio_repr) << "\n"
-        << std::endl;
+        << "\n";
+      styio_repr.print(std::cout, styio_ast);
+      std::cout << "\n" << std::endl;
     }
 
     /* Generate Styio IR */
+    StyioPhase to_styio_ir_phase("toStyioIR");
+    size_t num_of_ir_nodes = StyioIR::get_num_of_created();
     StyioIR* styio_ir = analyzer.toStyioIR(styio_ast);
+    to_styio_ir_phase.count("ir nodes", StyioIR::get_num_of_created() - num_of_ir_nodes);
+    to_styio_ir_phase.end();
 
-    if (show_all or show_styio_ir) {
+    if (show_styio_ir_passes) {
       std::cout
-        << "\033[1;32mStyio IR\033[0m \033[1;33m\033[0m"
-        << "\n"
-        << styio_ir->toString(&styio_repr) << "\n"
-        << std::endl;
+        << "\033[1;32mStyio IR\033[0m \033[31m-Before Passes\033[0m"
+        << "\n";
+      styio_repr.print(std::cout, styio_ir);
+      std::cout << "\n" << std::endl;
     }
 
-    /* JIT Initialization */
-    llvm::InitializeNativeTarget();
-    llvm::InitializeNativeTargetAsmPrinter();
-    llvm::InitializeNativeTargetAsmParser();
+    /* Styio IR Passes: fold what is known before LLVM sees it */
+    StyioPhase styio_ir_passes_phase("styioIRPasses");
+    StyioIRPassManager styio_ir_passes = StyioIRPassManager::Default();
+    styio_ir_passes.run(styio_ir);
+    for (auto const& [pass_name, num_of_rewrites] : styio_ir_passes.get_stats()) {
+      styio_ir_passes_phase.count(pass_name, num_of_rewrites);
+    }
+    styio_ir_passes_phase.end();
 
-    llvm::ExitOnError exit_on_error;
-    std::unique_ptr<StyioJIT_ORC> styio_orc_jit = exit_on_error(StyioJIT_ORC::Create());
+    if (show_styio_ir_passes) {
+      std::cout
+        << "\033[1;32mStyio IR\033[0m \033[1;33m-After Passes\033[0m"
+        << "\n";
+      styio_repr.print(std::cout, styio_ir);
+      std::cout << "\n";
+      for (auto const& [pass_name, num_of_rewrites] : styio_ir_passes.get_stats()) {
+        std::cout << "  " << pass_name << ": " << num_of_rewrites << "\n";
+      }
+      std::cout << std::endl;
+    }
 
-    /* CodeGen Initialization */
-    StyioToLLVM generator = StyioToLLVM(std::move(styio_orc_jit));
+    if (show_all or show_styio_ir) {
+      std::cout
+        << "\033[1;32mStyio IR\033[0m \033[1;33m\033[0m"
+        << "\n";
+      styio_repr.print(std::cout, styio_ir);
+      std::cout << "\n" << std::endl;
+    }
 
     /* CodeGen (LLVM IR) */
-    styio_ir->toLLVMIR(&generator);
+    StyioPhase to_llvm_ir_phase("toLLVMIR");
+    if (codegen_jobs > 1) {
+      generator.lower_in_parallel(styio_ir, codegen_jobs);
+    }
+    else {
+      styio_ir->toLLVMIR(&generator);
+    }
+    to_llvm_ir_phase.count("llvm instructions", generator.num_of_instructions());
+    to_llvm_ir_phase.end();
 
     if (show_llvm_ir) {
       generator.print_llvm_ir();
     }
 
+    /* Verify: the optimizer and the JIT assume a well-formed module */
+    StyioPhase verify_phase("llvm-verify");
+    bool is_valid_llvm_ir = generator.verify_module();
+    verify_phase.end();
+
+    if (not is_valid_llvm_ir) {
+      std::cerr << "styio: the generated LLVM IR is broken, see above" << std::endl;
+      report_phases();
+      return 1;
+    }
+
+    /* Optimize (LLVM IR) */
+    const llvm::OptimizationLevel opt_levels[] = {
+      llvm::OptimizationLevel::O0,
+      llvm::OptimizationLevel::O1,
+      llvm::OptimizationLevel::O2,
+      llvm::OptimizationLevel::O3,
+    };
+
+    StyioPhase llvm_opt_phase("llvm-opt");
+    generator.optimize(opt_levels[opt_level]);
+    llvm_opt_phase.count("llvm instructions", generator.num_of_instructions());
+    llvm_opt_phase.end();
+
+    if (show_llvm_ir_after_opt) {
+      generator.print_llvm_ir("-O" + std::to_string(opt_level));
+    }
+
+    /* AOT: bitcode first, before the code generator lowers anything */
+    if (is_aot) {
+      StyioPhase aot_phase("aot");
+      bool is_written = true;
+      if (cmlopts.count("emit-bc")) {
+        is_written = is_written && generator.emit_bitcode(cmlopts["emit-bc"].as<std::string>());
+      }
+      if (cmlopts.count("emit-asm")) {
+        is_written = is_written && generator.emit_native(cmlopts["emit-asm"].as<std::string>(), llvm::CodeGenFileType::AssemblyFile);
+      }
+      if (cmlopts.count("emit-obj")) {
+        is_written = is_written && generator.emit_native(cmlopts["emit-obj"].as<std::string>(), llvm::CodeGenFileType::ObjectFile);
+      }
+      if (cmlopts.count("output")) {
+        is_written = is_written && generator.emit_executable(cmlopts["output"].as<std::string>());
+      }
+      aot_phase.end();
+
+      report_phases();
+      return is_written ? 0 : 1;
+    }
+
     /* JIT Execute */
     generator.execute();
+
+    report_phases();
   }
 
   return 0;
@@ -1,5 +1,34 @@
 // [C++ STL]
 #include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+// [Styio]
+#include "StyioException/Diagnostics.hpp"
+#include "StyioException/Exception.hpp"
+#include "StyioAST/AST.hpp"
+#include "StyioAST/ASTArena.hpp"
+#include "StyioAnalyzer/ASTAnalyzer.hpp"
+#include "StyioCodeGen/CodeGenVisitor.hpp"
+#include "StyioIR/FlatIR/FlatIR.hpp"
+#include "StyioIR/GenIR/GenIR.hpp"
+#include "StyioIR/Passes/Passes.hpp"
+#include "StyioJIT/ObjectCache.hpp"
+#include "StyioJIT/TieredJIT.hpp"
+#include "StyioParser/Parser.hpp"
+#include "StyioParser/Tokenizer.hpp"
+#include "StyioSession/Project.hpp"
+#include "StyioSession/Session.hpp"
+#include "StyioSource/SourceFile.hpp"
+
+// [LLVM]
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/raw_ostream.h"
 
 // [Google Test]
 #include <gtest/gtest.h>
@@ -27,9 +56,641 @@ TEST(sum, simple) {
   EXPECT_EQ(add(2, 3), 5);
 }
 
+/* Code to parse in a test, with the source, token cursor and AST arena it takes, freed with it */
+class TestSource
+{
+public:
+  std::unique_ptr<StyioSourceFile> source;
+  std::unique_ptr<StyioContext> context;
+
+  ASTArena arena;
+  ASTArena::Scope scope{arena};
+
+  TestSource(const std::string& name, std::string code) :
+      source(StyioSourceFile::Create(name, std::move(code))),
+      context(StyioContext::Create(source.get(), StyioTokenizer::tokenize(source->text()))) {
+  }
+};
+
+/* StyioIR built in a test, freed with it */
+class TestIR
+{
+public:
+  StyioIRNodes nodes;
+  StyioIRNodes::Scope scope{nodes};
+};
+
+/* A JIT for this machine, for the tests that lower to LLVM IR */
+static std::unique_ptr<StyioJIT_ORC>
+make_host_jit(StyioJITOptions options = {}) {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  llvm::InitializeNativeTargetAsmParser();
+  return llvm::cantFail(StyioJIT_ORC::Create(nullptr, options));
+}
+
+static std::string
+print_module(const llvm::Module& module) {
+  std::string text;
+  llvm::raw_string_ostream out(text);
+  module.print(out, nullptr);
+  return out.str();
+}
+
+/* What `program` returns after the default passes, if that is all it does and it is a T */
+template <class T>
+static T*
+return_after_passes(SGMainEntry* program) {
+  StyioIRPassManager passes = StyioIRPassManager::Default();
+  passes.run(program);
+
+  if (program->stmts.size() != 1) {
+    return nullptr;
+  }
+
+  auto ret = dynamic_cast<SGReturn*>(program->stmts[0]);
+  return ret ? dynamic_cast<T*>(ret->expr) : nullptr;
+}
+
+/* A read error is an error, not an empty source. */
+TEST(source, read_error) {
+  EXPECT_THROW(StyioSourceFile::Open(std::filesystem::temp_directory_path().string()), StyioIOError);
+}
+
+/* The expression parser must not recurse once per operator. */
+TEST(parser, million_term_binop) {
+  const size_t num_of_terms = 1000000;
+
+  std::string code = "1";
+  for (size_t i = 1; i < num_of_terms; i++) {
+    code += (i % 3 == 0) ? " * 1" : " + 1";
+  }
+
+  /* 1M nodes: the arena frees them all at once, not one by one */
+  TestSource test("million_term_binop", code);
+
+  StyioAST* expr = parse_expr(*test.context);
+
+  ASSERT_NE(expr, nullptr);
+  EXPECT_EQ(expr->getNodeType(), StyioNodeType::BinOp);
+  EXPECT_EQ(test.context->cur_tok_type(), StyioTokenType::TOK_EOF);
+}
+
+/* Deep nesting is a syntax error, and long && chains do not recurse. */
+TEST(parser, deep_nesting) {
+  const size_t num_of_levels = 30000;
+
+  std::string parens = std::string(num_of_levels, '(') + "1" + std::string(num_of_levels, ')');
+
+  TestSource deep_parens("deep_parens", parens);
+  EXPECT_THROW(parse_expr(*deep_parens.context), StyioSyntaxError);
+
+  std::string cond = "(x > 0";
+  for (size_t i = 1; i < num_of_levels; i++) {
+    cond += (i % 2 == 0) ? " && x > 0" : " || (x < 0)";
+  }
+  cond += ")";
+
+  TestSource long_cond("long_cond", cond);
+  long_cond.context->move_forward(1); /* ( */
+
+  CondAST* result = parse_cond(*long_cond.context);
+
+  ASSERT_NE(result, nullptr);
+  EXPECT_EQ(long_cond.context->cur_tok_type(), StyioTokenType::TOK_RPAREN);
+}
+
+/* In recovery mode, one pass reports every broken statement. */
+TEST(parser, recover_at_statement_boundaries) {
+  std::string code = "1\n) 2\n>_(1, ]\n3 ] 4\n5";
+
+  TestSource test("recover_at_statement_boundaries", code);
+
+  StyioDiagnostics diagnostics;
+  test.context->enable_recovery(&diagnostics);
+
+  MainBlockAST* program = parse_main_block(*test.context);
+
+  ASSERT_NE(program, nullptr);
+  EXPECT_EQ(diagnostics.size(), 3);
+  EXPECT_EQ(program->getStmts().size(), 3); /* 1, 3, 5 */
+  EXPECT_EQ(test.context->cur_tok_type(), StyioTokenType::TOK_EOF);
+}
+
+/* An edit of one statement parses and analyzes that statement alone. */
+TEST(session, reparse_only_changed_stmt) {
+  StyioSession session("reparse_only_changed_stmt");
+
+  session.update("1\n2\n3\n4\n5\n");
+  ASSERT_EQ(session.get_stmts().size(), 5);
+  ASSERT_TRUE(session.get_diagnostics().empty());
+
+  const StyioAST* first = session.get_stmts()[0].ast;
+  const StyioAST* last = session.get_stmts()[4].ast;
+
+  session.update("1\n2\n30\n4\n5\n");
+
+  auto const& stats = session.get_stats();
+  EXPECT_EQ(session.get_stmts().size(), 5);
+  EXPECT_EQ(stats.num_of_reanalyzed, 1); /* 30 */
+  EXPECT_EQ(stats.num_of_kept + stats.num_of_reparsed, 5);
+  EXPECT_EQ(session.get_stmts()[0].ast, first);
+  EXPECT_EQ(session.get_stmts()[4].ast, last);
+  EXPECT_EQ(session.get_stmts()[2].end, 6);
+  EXPECT_EQ(session.get_stmts()[4].begin, 9);
+
+  /* the IR of each statement is owned by it, and freed with it */
+  ASSERT_NE(session.get_stmts()[2].ir_nodes, nullptr);
+  EXPECT_GT(session.get_stmts()[2].ir_nodes->num_of_nodes(), 0);
+
+  /* and the entry by the session, even under an owner of the caller */
+  StyioIRNodes outer;
+  StyioIRNodes::Scope outer_scope(outer);
+  EXPECT_EQ(session.get_ir()->stmts.size(), 5);
+  EXPECT_EQ(outer.num_of_nodes(), 0);
+}
+
+/* An edit of a definition analyzes its users again, and nothing else. */
+TEST(session, reanalyze_dependents) {
+  StyioSession session("reanalyze_dependents");
+
+  auto ret_type_of = [&session](size_t i)
+  {
+    auto func = static_cast<SimpleFuncAST*>(session.get_stmts()[i].ast);
+    return std::get<TypeAST*>(func->ret_type)->type;
+  };
+
+  session.update("# f(a: i32) => a\n# g(x: i32) => f(x)\n# h(y: i16) => y\n7\n");
+  ASSERT_EQ(session.get_stmts().size(), 4);
+  ASSERT_TRUE(session.get_diagnostics().empty());
+  EXPECT_EQ(ret_type_of(1), StyioDataType::I32);
+
+  const StyioAST* h = session.get_stmts()[2].ast;
+  const StyioAST* seven = session.get_stmts()[3].ast;
+
+  /* f returns i64 now, and so does g, which calls it */
+  session.update("# f(a: i64) => a\n# g(x: i32) => f(x)\n# h(y: i16) => y\n7\n");
+  ASSERT_EQ(session.get_stmts().size(), 4);
+  EXPECT_EQ(session.get_stats().num_of_reanalyzed, 2);
+  EXPECT_EQ(ret_type_of(1), StyioDataType::I64);
+  EXPECT_EQ(session.get_stmts()[2].ast, h);
+  EXPECT_EQ(session.get_stmts()[3].ast, seven);
+
+  /* f takes a string now: g's call is a type error */
+  session.update("# f(a: string) => a\n# g(x: i32) => f(x)\n# h(y: i16) => y\n7\n");
+  EXPECT_EQ(session.get_stats().num_of_reanalyzed, 2);
+  EXPECT_TRUE(session.get_stmts()[0].error.empty());
+  EXPECT_FALSE(session.get_stmts()[1].error.empty());
+
+  /* and fine again */
+  session.update("# f(a: i32) => a\n# g(x: i32) => f(x)\n# h(y: i16) => y\n7\n");
+  EXPECT_TRUE(session.get_diagnostics().empty());
+  EXPECT_EQ(ret_type_of(1), StyioDataType::I32);
+  EXPECT_EQ(session.get_stmts()[2].ast, h);
+}
+
+/* Files parse on several threads, but merge and report in their own order. */
+TEST(project, parse_in_parallel) {
+  auto dir = std::filesystem::temp_directory_path() / "styio_test_project";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+
+  /* the largest file is parsed first, but is not the first one */
+  std::string big;
+  for (int i = 0; i < 1000; i++) {
+    big += "20\n";
+  }
+
+  std::vector<std::pair<std::string, std::string>> files = {
+    {"a.styio", "10\n# fa(x: i32) => x\n"},
+    {"b.styio", big + "# fb(x: i32) => x\n"},
+    {"c.styio", "30\n) 31\n32\n"},
+    {"d.styio", "40\n"},
+  };
+
+  std::vector<std::string> paths;
+  for (auto const& [name, code] : files) {
+    paths.push_back((dir / name).string());
+    std::ofstream(paths.back()) << code;
+  }
+
+  StyioProject project;
+  project.parse(paths, 4);
+
+  auto const& units = project.get_units();
+  ASSERT_EQ(units.size(), 4);
+  for (size_t i = 0; i < units.size(); i++) {
+    EXPECT_EQ(units[i]->path, paths[i]);
+    EXPECT_EQ(units[i]->diagnostics.empty(), i != 2);
+  }
+
+  /* the error is reported with the name of its file, and only that one */
+  ASSERT_TRUE(project.has_errors());
+  std::ostringstream report;
+  project.print_diagnostics(report);
+  EXPECT_NE(report.str().find("File \"" + paths[2] + "\""), std::string::npos);
+  EXPECT_EQ(report.str().find(paths[0]), std::string::npos);
+  EXPECT_NE(report.str().find("1 error found."), std::string::npos);
+
+  /* declarations first, then the rest, each in the order of the files */
+  ASTArena arena;
+  ASTArena::Scope scope(arena);
+
+  auto stmts = project.merge()->getStmts();
+  ASSERT_EQ(stmts.size(), 2 + 1 + 1000 + 2 + 1);
+
+  EXPECT_EQ(StyioSymbolTable::name_of(static_cast<SimpleFuncAST*>(stmts[0])->func_name->getSymbol()), "fa");
+  EXPECT_EQ(StyioSymbolTable::name_of(static_cast<SimpleFuncAST*>(stmts[1])->func_name->getSymbol()), "fb");
+
+  std::vector<std::string> values;
+  for (size_t i = 2; i < stmts.size(); i++) {
+    ASSERT_EQ(stmts[i]->getNodeType(), StyioNodeType::Integer);
+    values.push_back(static_cast<IntAST*>(stmts[i])->getValue());
+  }
+
+  EXPECT_EQ(values.front(), "10");
+  EXPECT_EQ(values[1], "20");
+  EXPECT_EQ(values[1000], "20");
+  EXPECT_EQ(std::vector<std::string>(values.end() - 3, values.end()), (std::vector<std::string>{"30", "32", "40"}));
+
+  std::filesystem::remove_all(dir);
+}
+
+/* Streaming a dump gives the same text as building it as a string. */
+TEST(repr, print_matches_to_string) {
+  std::string code = "1";
+  for (size_t i = 1; i < 300; i++) {
+    code += " + 1";
+  }
+
+  TestSource test("print_matches_to_string", code);
+
+  StyioAST* expr = parse_expr(*test.context);
+  ASSERT_NE(expr, nullptr);
+
+  StyioRepr repr;
+  std::string text = expr->toString(&repr);
+
+  std::ostringstream stream;
+  repr.print(stream, expr);
+
+  EXPECT_GT(text.size(), StyioReprWriter::flush_size); /* flushed on the way */
+  EXPECT_EQ(stream.str(), text);
+}
+
+/* Untyped parameters take their types from the typed ones they meet. */
+TEST(analyzer, infer_func_types) {
+  std::string code = "# f(a: i32, b) => a + b\n# g(x) => x * 2.0\n# h(p: i16) => f(p, 3)\n";
+
+  TestSource test("infer_func_types", code);
+
+  MainBlockAST* program = parse_main_block(*test.context);
+  ASSERT_NE(program, nullptr);
+
+  StyioAnalyzer analyzer;
+  for (StyioAST* stmt : program->getStmts()) {
+    stmt->typeInfer(&analyzer);
+  }
+
+  EXPECT_EQ(analyzer.getFuncType(StyioSymbolTable::intern("f")).name(), "(i32, i32) => i32");
+  EXPECT_EQ(analyzer.getFuncType(StyioSymbolTable::intern("g")).name(), "(f64) => f64");
+  EXPECT_EQ(analyzer.getFuncType(StyioSymbolTable::intern("h")).name(), "(i16) => i32");
+}
+
+/* A signature is solved with its statement, and a conflict is an error. */
+TEST(analyzer, report_type_conflicts) {
+  std::string code = "# f(s: string) => s\n# g(x: i32) => f(x)\n";
+
+  TestSource test("report_type_conflicts", code);
+
+  MainBlockAST* program = parse_main_block(*test.context);
+  ASSERT_NE(program, nullptr);
+  ASSERT_EQ(program->getStmts().size(), 2);
+
+  StyioAnalyzer analyzer;
+  program->getStmts()[0]->typeInfer(&analyzer);
+  EXPECT_THROW(program->getStmts()[1]->typeInfer(&analyzer), StyioTypeError);
+}
+
+/* A call of an unknown function, or with the wrong number of arguments, is an error. */
+TEST(analyzer, report_bad_calls) {
+  std::string code = "# f(a: i32) => a\n# g(x: i32) => f(x, x)\n# h(x: i32) => k(x)\n# r(n: i32) => r(n, n)\n";
+
+  TestSource test("report_bad_calls", code);
+
+  MainBlockAST* program = parse_main_block(*test.context);
+  ASSERT_NE(program, nullptr);
+  ASSERT_EQ(program->getStmts().size(), 4);
+
+  StyioAnalyzer analyzer;
+  program->getStmts()[0]->typeInfer(&analyzer);
+  EXPECT_THROW(program->getStmts()[1]->typeInfer(&analyzer), StyioTypeError);
+  EXPECT_THROW(program->getStmts()[2]->typeInfer(&analyzer), StyioTypeError);
+  EXPECT_THROW(program->getStmts()[3]->typeInfer(&analyzer), StyioTypeError);
+}
+
+/* x : i32 := 2 + 3, then <| x * 4: x folds into the return and is dropped. */
+TEST(ir_passes, fold_propagate_and_drop) {
+  TestIR test;
+  auto i32 = SGType::Create(StyioDataType::I32);
+
+  auto program = SGMainEntry::Create({
+    SGFinalBind::Create(
+      SGVar::Create(SGResId::Create("x"), i32),
+      SGBinOp::Create(SGConstInt::Create(std::string("2")), SGConstInt::Create(std::string("3")), StyioOpType::Binary_Add, i32)
+    ),
+    SGReturn::Create(
+      SGBinOp::Create(SGResId::Create("x"), SGConstInt::Create(std::string("4")), StyioOpType::Binary_Mul, i32)
+    ),
+  });
+
+  auto result = return_after_passes<SGConstInt>(program);
+  ASSERT_NE(result, nullptr);
+  EXPECT_EQ(result->canonical, 20);
+  EXPECT_EQ(result->num_of_bit, 32);
+}
+
+/* 0.0 / 0.0 is NaN, and NaN compares unequal to nothing: the fold agrees with fcmp one. */
+TEST(ir_passes, fold_nan_not_equal) {
+  TestIR test;
+  auto f64 = SGType::Create(StyioDataType::F64);
+  auto bool_type = SGType::Create(StyioDataType::Bool);
+
+  auto program = SGMainEntry::Create({
+    SGReturn::Create(
+      SGBinOp::Create(
+        SGBinOp::Create(SGConstFloat::Create(std::string("0.0")), SGConstFloat::Create(std::string("0.0")), StyioOpType::Binary_Div, f64),
+        SGConstFloat::Create(std::string("1.0")),
+        StyioOpType::Not_Equal,
+        bool_type
+      )
+    ),
+  });
+
+  auto result = return_after_passes<SGConstBool>(program);
+  ASSERT_NE(result, nullptr);
+  EXPECT_FALSE(result->value);
+}
+
+/* StyioToLLVM does not lower % and ** yet, and compares i1 signed: neither folds. */
+TEST(ir_passes, keep_what_codegen_differs_on) {
+  TestIR test;
+  auto i32 = SGType::Create(StyioDataType::I32);
+  auto bool_type = SGType::Create(StyioDataType::Bool);
+
+  for (StyioOpType op : {StyioOpType::Binary_Mod, StyioOpType::Binary_Pow}) {
+    auto program = SGMainEntry::Create({
+      SGReturn::Create(SGBinOp::Create(SGConstInt::Create(std::string("7")), SGConstInt::Create(std::string("3")), op, i32)),
+    });
+    EXPECT_EQ(return_after_passes<SGConstInt>(program), nullptr);
+  }
+
+  auto program = SGMainEntry::Create({
+    SGReturn::Create(SGBinOp::Create(SGConstBool::Create(true), SGConstBool::Create(false), StyioOpType::Greater_Than, bool_type)),
+  });
+  EXPECT_EQ(return_after_passes<SGConstBool>(program), nullptr);
+}
+
+TEST(flat_ir, children_before_parents) {
+  TestIR test;
+  auto i32 = SGType::Create(StyioDataType::I32);
+
+  auto program = SGMainEntry::Create({
+    SGFinalBind::Create(
+      SGVar::Create(SGResId::Create("x"), i32),
+      SGBinOp::Create(SGConstInt::Create(std::string("2")), SGConstInt::Create(std::string("3")), StyioOpType::Binary_Add, i32)
+    ),
+    SGReturn::Create(SGResId::Create("x")),
+  });
+
+  StyioFlatIR ir = StyioFlatIR::from(program);
+
+  /* 2, 3, +, x = .., x, <| .., main */
+  ASSERT_EQ(ir.nodes.size(), 7);
+  EXPECT_EQ(ir.root, 6);
+  EXPECT_EQ(ir[ir.root].kind, StyioFlatKind::MainEntry);
+
+  const StyioFlatNode& binop = ir[2];
+  EXPECT_EQ(binop.kind, StyioFlatKind::BinOp);
+  EXPECT_EQ(binop.getOp(), StyioOpType::Binary_Add);
+  EXPECT_EQ(ir[binop.a].int_value, 2);
+  EXPECT_EQ(ir[binop.b].int_value, 3);
+
+  auto stmts = ir.list(ir[ir.root].b);
+  ASSERT_EQ(stmts.size(), 2);
+  EXPECT_EQ(ir[stmts[0]].kind, StyioFlatKind::FinalBind);
+  EXPECT_EQ(ir[stmts[1]].kind, StyioFlatKind::Return);
+  EXPECT_EQ(StyioSymbolTable::name_of(ir[stmts[0]].symbol), "x");
+}
+
+/* The flat IR lowers to the very module its StyioIR tree does. */
+TEST(flat_ir, same_module_as_tree) {
+  TestIR test;
+  auto i32 = SGType::Create(StyioDataType::I32);
+  auto f64 = SGType::Create(StyioDataType::F64);
+
+  /* # add(a: i32, b: i32) => a + b, x : i32 := add(2, 3), y := x * 2.0, <| x > 4 */
+  auto program = SGMainEntry::Create({
+    SGFunc::Create(
+      i32,
+      SGResId::Create("add"),
+      {SGFuncArg::Create("a", i32), SGFuncArg::Create("b", i32)},
+      SGBlock::Create({
+        SGReturn::Create(SGBinOp::Create(SGResId::Create("a"), SGResId::Create("b"), StyioOpType::Binary_Add, i32)),
+      })
+    ),
+    SGFinalBind::Create(
+      SGVar::Create(SGResId::Create("x"), i32),
+      SGCall::Create(SGResId::Create("add"), {SGConstInt::Create(std::string("2")), SGConstInt::Create(std::string("3"))})
+    ),
+    SGFlexBind::Create(
+      SGVar::Create(SGResId::Create("y"), f64),
+      SGBinOp::Create(SGResId::Create("x"), SGConstFloat::Create(std::string("2.0")), StyioOpType::Binary_Mul, f64)
+    ),
+    SGReturn::Create(SGCond::Create(SGResId::Create("x"), SGConstInt::Create(std::string("4")), StyioOpType::Greater_Than)),
+  });
+
+  StyioToLLVM tree(make_host_jit());
+  program->toLLVMIR(&tree);
+  EXPECT_TRUE(tree.verify_module());
+
+  StyioToLLVM flat(make_host_jit());
+  flat.toLLVMIR(StyioFlatIR::from(program));
+
+  EXPECT_EQ(print_module(flat.get_module()), print_module(tree.get_module()));
+}
+
+TEST(object_cache, store_load_evict) {
+  auto dir = std::filesystem::temp_directory_path() / "styio_test_object_cache";
+  std::filesystem::remove_all(dir);
+
+  /* room for two 1 KiB objects */
+  StyioObjectCache cache(dir.string(), 2048 + 512);
+
+  llvm::orc::JITTargetMachineBuilder JTMB(llvm::Triple("x86_64-unknown-linux-gnu"));
+  std::string a = StyioObjectCache::make_key({"x := 1"}, 0, JTMB);
+  std::string b = StyioObjectCache::make_key({"x := 2"}, 0, JTMB);
+  std::string c = StyioObjectCache::make_key({"x := 1"}, 2, JTMB);
+  EXPECT_NE(a, b);
+  EXPECT_NE(a, c);
+  EXPECT_EQ(a, StyioObjectCache::make_key({"x := 1"}, 0, JTMB));
+
+  std::string object(1024, 'o');
+  EXPECT_EQ(cache.load(a), nullptr);
+  EXPECT_TRUE(cache.store(a, llvm::MemoryBufferRef(object, "a")));
+  EXPECT_TRUE(cache.store(b, llvm::MemoryBufferRef(object, "b")));
+
+  auto loaded = cache.load(a);
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_EQ(loaded->getBuffer(), object);
+
+  /* `b` is the least recently used one now */
+  EXPECT_TRUE(cache.store(c, llvm::MemoryBufferRef(object, "c")));
+  EXPECT_NE(cache.load(a), nullptr);
+  EXPECT_EQ(cache.load(b), nullptr);
+  EXPECT_NE(cache.load(c), nullptr);
+
+  std::filesystem::remove_all(dir);
+}
+
+/* Tier 0 of f: renamed, called through a stub `f`, and counting its calls after its allocas. */
+TEST(tiered_jit, instrument) {
+  StyioJITOptions options;
+  options.tiered = true;
+  options.tier_up_loops = 0;
+
+  auto jit = make_host_jit(options);
+  StyioTieredJIT tiers(*jit);
+
+  llvm::LLVMContext context;
+  llvm::Module module("instrument", context);
+  llvm::IRBuilder<> builder(context);
+
+  /* i32 f(i32 a) { x = a; return x } */
+  llvm::Function* f = llvm::Function::Create(
+    llvm::FunctionType::get(builder.getInt32Ty(), {builder.getInt32Ty()}, false),
+    llvm::GlobalValue::ExternalLinkage,
+    "f",
+    module
+  );
+  builder.SetInsertPoint(llvm::BasicBlock::Create(context, "f_entry", f));
+  llvm::AllocaInst* x = builder.CreateAlloca(builder.getInt32Ty(), nullptr, "x");
+  builder.CreateStore(f->getArg(0), x);
+  builder.CreateRet(builder.CreateLoad(builder.getInt32Ty(), x));
+
+  /* i32 main() { return f(1) } */
+  llvm::Function* main_func = llvm::Function::Create(
+    llvm::FunctionType::get(builder.getInt32Ty(), false),
+    llvm::GlobalValue::ExternalLinkage,
+    "main",
+    module
+  );
+  builder.SetInsertPoint(llvm::BasicBlock::Create(context, "main_entry", main_func));
+  llvm::CallInst* call = builder.CreateCall(f, {builder.getInt32(1)});
+  builder.CreateRet(call);
+
+  tiers.instrument(module);
+  EXPECT_FALSE(llvm::verifyModule(module, &llvm::errs()));
+
+  /* the body is f.tier0, and callers reach it through a declaration `f` */
+  EXPECT_EQ(f->getName(), "f.tier0");
+  llvm::Function* stub = module.getFunction("f");
+  ASSERT_NE(stub, nullptr);
+  EXPECT_TRUE(stub->isDeclaration());
+  EXPECT_EQ(call->getCalledFunction(), stub);
+  EXPECT_EQ(module.getFunction("main"), main_func);
+
+  /* the alloca stays first, then the call counter, which calls styio.tier_up once hot */
+  llvm::BasicBlock& entry = f->getEntryBlock();
+  auto inst = entry.begin();
+  EXPECT_EQ(&*inst, x);
+  ++inst;
+  EXPECT_TRUE(llvm::isa<llvm::AtomicRMWInst>(*inst));
+
+  auto branch = llvm::dyn_cast<llvm::BranchInst>(entry.getTerminator());
+  ASSERT_NE(branch, nullptr);
+  ASSERT_TRUE(branch->isConditional());
+
+  auto tier_up = llvm::dyn_cast<llvm::CallInst>(&branch->getSuccessor(0)->front());
+  ASSERT_NE(tier_up, nullptr);
+  ASSERT_NE(tier_up->getCalledFunction(), nullptr);
+  EXPECT_EQ(tier_up->getCalledFunction()->getName(), "styio.tier_up");
+}
+
+/* Each module declares every function, and each function has one body, in one of the modules. */
+TEST(codegen, lower_in_parallel) {
+  TestIR test;
+  auto i32 = SGType::Create(StyioDataType::I32);
+
+  /* # f0(a: i32) => a, # f<i>(a: i32) => f<i - 1>(a) + 1, <| f6(1) */
+  const size_t num_of_funcs = 7;
+  std::vector<StyioIR*> stmts;
+  for (size_t i = 0; i < num_of_funcs; i++) {
+    StyioIR* body = SGResId::Create("a");
+    if (i > 0) {
+      body = SGBinOp::Create(
+        SGCall::Create(SGResId::Create("f" + std::to_string(i - 1)), {SGResId::Create("a")}),
+        SGConstInt::Create(std::string("1")),
+        StyioOpType::Binary_Add,
+        i32
+      );
+    }
+
+    stmts.push_back(SGFunc::Create(
+      i32, SGResId::Create("f" + std::to_string(i)), {SGFuncArg::Create("a", i32)}, SGBlock::Create({SGReturn::Create(body)})
+    ));
+  }
+  stmts.push_back(SGReturn::Create(SGCall::Create(SGResId::Create("f6"), {SGConstInt::Create(std::string("1"))})));
+
+  const size_t num_of_modules = 3;
+  StyioToLLVM generator(make_host_jit());
+  generator.lower_in_parallel(SGMainEntry::Create(stmts), num_of_modules);
+  EXPECT_TRUE(generator.verify_module());
+
+  std::vector<const llvm::Module*> modules = generator.get_modules();
+  ASSERT_EQ(modules.size(), num_of_modules);
+
+  for (size_t i = 0; i < num_of_funcs; i++) {
+    std::string name = "f" + std::to_string(i);
+
+    size_t num_of_bodies = 0;
+    for (const llvm::Module* module : modules) {
+      const llvm::Function* func = module->getFunction(name);
+      ASSERT_NE(func, nullptr) << name << " is not declared in " << module->getName().str();
+      num_of_bodies += func->isDeclaration() ? 0 : 1;
+    }
+    EXPECT_EQ(num_of_bodies, 1) << name;
+  }
+
+  /* main stays in the first one */
+  ASSERT_NE(modules[0]->getFunction("main"), nullptr);
+  EXPECT_FALSE(modules[0]->getFunction("main")->isDeclaration());
+  for (size_t m = 1; m < modules.size(); m++) {
+    EXPECT_EQ(modules[m]->getFunction("main"), nullptr);
+  }
+}
+
+TEST(object_cache, key_covers_target) {
+  llvm::orc::JITTargetMachineBuilder generic(llvm::Triple("x86_64-unknown-linux-gnu"));
+
+  llvm::orc::JITTargetMachineBuilder skylake = generic;
+  skylake.setCPU("skylake");
+
+  llvm::orc::JITTargetMachineBuilder skylake_no_avx2 = skylake;
+  skylake_no_avx2.addFeatures({"-avx2"});
+
+  /* code for one CPU may not run on another */
+  std::string a = StyioObjectCache::make_key({"x := 1"}, 2, generic);
+  std::string b = StyioObjectCache::make_key({"x := 1"}, 2, skylake);
+  std::string c = StyioObjectCache::make_key({"x := 1"}, 2, skylake_no_avx2);
+  EXPECT_NE(a, b);
+  EXPECT_NE(b, c);
+  EXPECT_NE(a, c);
+}
+
 int main(int argc, char **argv) {
   walkdirs();
 
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
-}
\ No newline at end of file
+}